@@ -70,7 +70,7 @@ namespace OpenMS
    * - Learns best parameters via grid search if the parameters were not given in the param section.
    * - Writes posteriors to peptides and/or proteins and adds indistinguishable protein groups to the underlying
    *   data structures.
-   * - Can make use of OpenMP to parallelize over connected components.
+   * - Can make use of OpenMP to parallelize over connected components or over the points of the grid search.
    */
   class OPENMS_DLLAPI BayesianProteinInferenceAlgorithm :
       public DefaultParamHandler,
@@ -97,6 +97,10 @@ namespace OpenMS
     /// A function object to pass into the GridSearch class
     struct GridSearchEvaluator;
 
+    /// Evaluates all points of the grid search in parallel (param_optimize:parallel_grid_search),
+    /// reusing the factor structure of the connected components
+    class ParallelGridSearchEvaluator;
+
     /// Perform inference. Filter, build graph, run the private inferPosteriorProbabilities_ function.
     /// Writes its results into protein and (optionally also) peptide hits (as new score).
     /// Optionally adds indistinguishable protein groups with separate scores, too. See Param object of class.
@@ -0,0 +1,159 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/KERNEL/StandardTypes.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <utility>
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @brief Index of a spectral library for MetaboliteSpectralMatching
+
+    For every library spectrum, the index stores the (first) precursor m/z
+    and charge and the fragment m/z values discretized to bins of fixed
+    width. Library spectra are ordered by precursor m/z, so the candidates
+    for a query precursor are found by binary search.
+
+    The fragment bins serve as an exact pre-filter for the hyperscore: a
+    library spectrum can only be scored if enough peaks of the query
+    spectrum have a library fragment within the fragment tolerance, which
+    can be decided from the bins (countMatchingPeaks()) without touching
+    the library spectrum.
+
+    Building the index is linear in the number of library peaks. For large
+    libraries that are searched repeatedly, the index can be stored in a
+    binary sidecar file and loaded again; isIndexOf() checks whether a
+    loaded index (still) belongs to a library. For this, a fingerprint
+    (hash) of the fragment m/z values of every spectrum is stored as well.
+  */
+  class OPENMS_DLLAPI MetaboliteSpectralLibraryIndex
+  {
+public:
+
+    /// Bin ranges of the peaks of a query spectrum (see getQueryBins())
+    typedef std::vector<std::pair<UInt32, UInt32> > QueryBins;
+
+    /// Default constructor (empty index)
+    MetaboliteSpectralLibraryIndex();
+
+    /// Builds the index of @p library with fragment bins of @p bin_size Th
+    void build(const PeakMap& library, double bin_size = 0.01);
+
+    /// Number of indexed library spectra
+    Size size() const;
+
+    /// Width of the fragment bins
+    double getBinSize() const;
+
+    /// Returns whether the index belongs to @p library (same number of spectra, precursors, number of peaks and fragment m/z fingerprints)
+    bool isIndexOf(const PeakMap& library) const;
+
+    /**
+      @brief Finds the library spectra with a precursor m/z in [@p mz_lower, @p mz_upper]
+
+      @param mz_lower Lower bound of the precursor m/z
+      @param mz_upper Upper bound of the precursor m/z
+      @param candidates Indices of the library spectra, ordered by precursor m/z (ties in library order)
+    */
+    void findCandidates(double mz_lower, double mz_upper, std::vector<Size>& candidates) const;
+
+    /// Precursor m/z of library spectrum @p index
+    double getPrecursorMZ(Size index) const;
+
+    /// Precursor charge of library spectrum @p index
+    Int getPrecursorCharge(Size index) const;
+
+    /**
+      @brief Computes the bins that may hold library fragments matching the peaks of @p spectrum
+
+      For every peak, the range of bins covering all library fragments
+      within the fragment tolerance of the peak is computed.
+    */
+    void getQueryBins(const MSSpectrum& spectrum, double fragment_mass_error, bool fragment_mass_tolerance_unit_ppm, QueryBins& query) const;
+
+    /**
+      @brief Counts the query peaks that may have a matching fragment in library spectrum @p index
+
+      This is an upper bound of the number of peaks matched by the hyperscore.
+      Counting stops at @p max_count.
+    */
+    Size countMatchingPeaks(const QueryBins& query, Size index, Size max_count) const;
+
+    /**
+      @brief Stores the index in a binary file
+
+      @exception Exception::UnableToCreateFile is thrown if the file could not be created
+    */
+    void store(const String& filename) const;
+
+    /**
+      @brief Loads the index from a binary file written by store()
+
+      @exception Exception::FileNotFound is thrown if the file could not be opened
+      @exception Exception::ParseError is thrown if the file is not a valid index file
+    */
+    void load(const String& filename);
+
+protected:
+
+    /// Bin of @p mz
+    UInt32 getBin_(double mz) const;
+
+    /// Recomputes the order of the spectra by precursor m/z
+    void sortByPrecursor_();
+
+    double bin_size_;
+    /// Precursor m/z of each library spectrum (negative if it has no precursor)
+    std::vector<double> precursor_mz_;
+    /// Precursor charge of each library spectrum
+    std::vector<Int> precursor_charge_;
+    /// Number of peaks of each library spectrum
+    std::vector<UInt32> peak_count_;
+    /// Hash of the fragment m/z values of each library spectrum
+    std::vector<UInt64> fingerprint_;
+    /// Start of the fragment bins of each library spectrum in bins_ (one additional entry at the end)
+    std::vector<UInt64> bin_offset_;
+    /// Sorted, unique fragment bins of all library spectra
+    std::vector<UInt32> bins_;
+    /// Library spectra with precursor, ordered by precursor m/z
+    std::vector<Size> order_;
+    /// Precursor m/z values in the order of order_
+    std::vector<double> sorted_mz_;
+  };
+}
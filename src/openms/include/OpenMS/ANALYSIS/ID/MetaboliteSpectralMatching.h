@@ -34,6 +34,7 @@
 
 #pragma once
 
+#include <OpenMS/ANALYSIS/ID/MetaboliteSpectralLibraryIndex.h>
 #include <OpenMS/KERNEL/MassTrace.h>
 #include <OpenMS/KERNEL/Feature.h>
 #include <OpenMS/KERNEL/FeatureMap.h>
@@ -175,8 +176,25 @@ namespace OpenMS
       std::vector<PeptideHit::PeakAnnotation>& annotations,
       double mz_lower_bound = 0.0);
 
-    /// main method of MetaboliteSpectralMatching
-    void run(PeakMap &, PeakMap &, MzTab &);
+    /**
+      @brief main method of MetaboliteSpectralMatching
+
+      Searches the spectra of @p msexp (which are filtered and merged in
+      place) against the spectral library @p spec_db and reports the
+      matches in @p mztab_out. An index of the library is built on the fly.
+    */
+    void run(PeakMap & msexp, PeakMap & spec_db, MzTab & mztab_out);
+
+    /**
+      @brief main method of MetaboliteSpectralMatching, using a prebuilt library index
+
+      Query spectra are searched in parallel. Building the @p index once
+      (or loading it, see MetaboliteSpectralLibraryIndex::load()) pays off
+      when a large library is searched repeatedly.
+
+      @exception Exception::InvalidParameter is thrown if @p index does not belong to @p spec_db
+    */
+    void run(PeakMap & msexp, const PeakMap & spec_db, const MetaboliteSpectralLibraryIndex & index, MzTab & mztab_out);
 
   protected:
     void updateMembers_() override;
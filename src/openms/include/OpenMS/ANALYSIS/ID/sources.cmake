@@ -31,6 +31,7 @@ IDRipper.h
 IDScoreGetterSetter.h
 IDScoreSwitcherAlgorithm.h
 MessagePasserFactory.h
+MetaboliteSpectralLibraryIndex.h
 MetaboliteSpectralMatching.h
 PeptideProteinResolution.h
 PrecursorPurity.h
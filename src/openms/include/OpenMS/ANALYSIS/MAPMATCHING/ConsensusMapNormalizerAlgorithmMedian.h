@@ -98,6 +98,19 @@ public:
      * @param desc_filter string describing the regular expression for filtering descriptions
      */
     static bool passesFilters_(ConsensusMap::ConstIterator cf_it, const ConsensusMap& map, const String& acc_filter, const String& desc_filter);
+
+    /**
+     * @brief returns for all consensus features whether they pass the filters
+     *
+     * Same result as calling passesFilters_() for every consensus feature of @p map,
+     * but the regular expressions are compiled only once and evaluated only once per protein accession.
+     *
+     * @param map consensus map
+     * @param acc_filter string describing the regular expression for filtering accessions
+     * @param desc_filter string describing the regular expression for filtering descriptions
+     * @return one entry per consensus feature, non-zero if the feature passes
+     */
+    static std::vector<char> computeFilterResults_(const ConsensusMap& map, const String& acc_filter, const String& desc_filter);
   };
 
 } // namespace OpenMS
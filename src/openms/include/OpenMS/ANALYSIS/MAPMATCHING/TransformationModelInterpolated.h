@@ -94,6 +94,19 @@ public:
      */
     double evaluate(double value) const override;
 
+    /**
+     * @brief Evaluate the interpolation model at many values
+     *
+     * Gives the same results as calling evaluate(double) for every value, but
+     * evaluates blocks of values in parallel. Within a block, the search for
+     * the enclosing data points continues from the previous value, so
+     * (mostly) sorted input is much faster to evaluate than random input.
+     *
+     * @param values The positions where the interpolation should be evaluated.
+     * @param results The interpolated values (same order as @p values).
+     */
+    void evaluate(const std::vector<double>& values, std::vector<double>& results) const;
+
     /// Gets the default parameters
     static void getDefaultParameters(Param& params);
 
@@ -125,6 +138,20 @@ public:
        */
       virtual double eval(const double& x) const = 0;
 
+      /**
+       * @brief Evaluate the underlying interpolation at a specific position x,
+       * starting the search for the enclosing data points at a hint.
+       *
+       * @param x The position where the interpolation should be evaluated.
+       * @param hint Position hint from the previous call (0 initially); updated for x.
+       *
+       * @return The interpolated value.
+       */
+      virtual double evalWithHint(const double& x, Size& /* hint */) const
+      {
+        return eval(x);
+      }
+
       /**
        * @brief d'tor.
        */
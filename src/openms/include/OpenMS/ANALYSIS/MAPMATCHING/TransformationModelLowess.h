@@ -66,6 +66,16 @@ public:
       return model_->evaluate(value);
     }
 
+    /**
+      @brief Evaluates the model at many values (in parallel, fastest for sorted values)
+
+      @see TransformationModelInterpolated::evaluate(const std::vector<double>&, std::vector<double>&) const
+    */
+    void evaluate(const std::vector<double>& values, std::vector<double>& results) const
+    {
+      model_->evaluate(values, results);
+    }
+
     using TransformationModel::getParameters;
 
     /// Gets the default parameters
@@ -209,6 +209,17 @@ public:
       ms1_map_ = ms1_map;
     }
 
+    /** @brief Returns the cache of (added up) DIA spectra used during scoring
+     *
+     * Its hit and miss counters can be used to tune the parameter
+     * spectrum_cache_size. Returns a null pointer if caching is disabled.
+     *
+    */
+    boost::shared_ptr<const SwathSpectrumCache> getSpectrumCache() const
+    {
+      return spectrum_cache_;
+    }
+
     /** @brief Map the chromatograms to the transitions.
      *
      * Map an input chromatogram experiment (mzML) and transition list (TraML)
@@ -314,6 +325,7 @@ private:
 
     // data
     OpenSwath::SpectrumAccessPtr ms1_map_;
+    boost::shared_ptr<SwathSpectrumCache> spectrum_cache_;
 
   };
 }
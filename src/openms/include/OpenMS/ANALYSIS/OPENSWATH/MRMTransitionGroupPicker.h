@@ -150,8 +150,8 @@ public:
 
           picker_.pickChromatogram(chromatogram, picked_chrom, smoothed_chrom);
           picked_chrom.sortByIntensity();
-          picked_chroms.push_back(picked_chrom);
-          smoothed_chroms.push_back(smoothed_chrom);
+          picked_chroms.push_back(std::move(picked_chrom));
+          smoothed_chroms.push_back(std::move(smoothed_chrom));
         }
       }
 
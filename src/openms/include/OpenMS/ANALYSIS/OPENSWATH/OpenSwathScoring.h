@@ -44,6 +44,7 @@
 // scoring
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathScores.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/DIAScoring.h>
+#include <OpenMS/ANALYSIS/OPENSWATH/SwathSpectrumCache.h>
 
 #include <vector>
 #include <boost/shared_ptr.hpp>
@@ -67,6 +68,7 @@ namespace OpenMS
     std::string spectra_addition_method_;
     double im_drift_extra_pcnt_;
     OpenSwath_Scores_Usage su_;
+    boost::shared_ptr<SwathSpectrumCache> spectrum_cache_;
 
   public:
 
@@ -94,6 +96,15 @@ namespace OpenMS
                     const OpenSwath_Scores_Usage & su,
                     const std::string& spectrum_addition_method);
 
+    /** @brief Sets a cache for the spectra retrieved by fetchSpectrumSwath
+     *
+     * The cache may be shared by several scoring objects (also across
+     * threads) as long as they use the same spectrum addition settings. Pass
+     * a null pointer to disable caching (the default).
+     *
+    */
+    void setSpectrumCache(const boost::shared_ptr<SwathSpectrumCache>& cache);
+
     /** @brief Score a single peakgroup in a chromatogram using only chromatographic properties.
      *
      * This function only uses the chromatographic properties (coelution,
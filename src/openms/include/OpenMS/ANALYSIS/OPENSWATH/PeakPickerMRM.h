@@ -167,6 +167,8 @@ protected:
     std::vector<int> left_width_;
     /// Temporary vector to hold the peak right widths
     std::vector<int> right_width_;
+    /// Temporary chromatogram to hold the smoothed data (keeps its capacity between calls)
+    MSChromatogram smoothed_chrom_;
 
     PeakPickerHiRes pp_;
     SavitzkyGolayFilter sgolay_;
@@ -0,0 +1,147 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/config.h> // OPENMS_DLLAPI
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/OPENSWATHALGO/DATAACCESS/ISpectrumAccess.h>
+
+#include <boost/weak_ptr.hpp>
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace OpenMS
+{
+  /**
+    @brief Least-recently-used cache for the (added up) DIA spectra used in OpenSwath scoring
+
+    For each peak group, OpenSwathScoring retrieves the spectrum (or the sum
+    of several spectra) closest to the peak apex from a SWATH map. Peak groups
+    that elute close to each other often resolve to the same apex scan, so the
+    same spectrum addition would be performed repeatedly. This cache stores
+    the result keyed by the SWATH map, the apex scan, the number of added
+    spectra and the ion mobility window.
+
+    Only a weak reference to the SWATH map is held: entries whose map has been
+    destroyed are never returned. A cache must only be shared between scorers
+    that use the same spectrum addition settings.
+
+    All member functions are thread-safe. The hit and miss counters can be
+    used to choose a suitable capacity.
+  */
+  class OPENMS_DLLAPI SwathSpectrumCache
+  {
+public:
+
+    /// Constructor, holding at most @p capacity spectra
+    explicit SwathSpectrumCache(Size capacity = 16);
+
+    /**
+      @brief Looks up a spectrum
+
+      @return The cached spectrum or a null pointer if it is not in the cache
+    */
+    OpenSwath::SpectrumPtr get(const OpenSwath::SpectrumAccessPtr& swath_map, int apex_index,
+                               int nr_spectra_to_add, double drift_lower, double drift_upper);
+
+    /// Stores a spectrum, evicting the least recently used one if the cache is full
+    void insert(const OpenSwath::SpectrumAccessPtr& swath_map, int apex_index,
+                int nr_spectra_to_add, double drift_lower, double drift_upper,
+                const OpenSwath::SpectrumPtr& spectrum);
+
+    /// Removes all spectra (statistics are kept)
+    void clear();
+
+    /// Number of cached spectra
+    Size size() const;
+
+    /// Maximal number of cached spectra
+    Size getCapacity() const;
+
+    /// Sets the maximal number of cached spectra (evicts spectra if necessary)
+    void setCapacity(Size capacity);
+
+    /// Number of lookups that were answered from the cache
+    Size getHits() const;
+
+    /// Number of lookups that were not answered from the cache
+    Size getMisses() const;
+
+    /// Fraction of lookups answered from the cache (0 if there were no lookups)
+    double getHitRate() const;
+
+    /// Resets hit and miss counters
+    void resetStatistics();
+
+protected:
+
+    struct Key
+    {
+      const OpenSwath::ISpectrumAccess* swath_map;
+      int apex_index;
+      int nr_spectra_to_add;
+      double drift_lower;
+      double drift_upper;
+
+      bool operator==(const Key& rhs) const;
+    };
+
+    struct KeyHash
+    {
+      std::size_t operator()(const Key& key) const;
+    };
+
+    struct Entry
+    {
+      Key key;
+      boost::weak_ptr<OpenSwath::ISpectrumAccess> swath_map;
+      OpenSwath::SpectrumPtr spectrum;
+    };
+
+    /// Evicts least recently used entries until at most capacity_ entries remain (caller holds mutex_)
+    void shrink_();
+
+    Size capacity_;
+    /// Entries, most recently used first
+    std::list<Entry> entries_;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index_;
+    Size hits_;
+    Size misses_;
+    /// Guards all members above
+    mutable std::mutex mutex_;
+  };
+}
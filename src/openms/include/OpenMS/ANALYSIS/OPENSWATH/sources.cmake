@@ -32,6 +32,7 @@ set(sources_list_h
   PeakPickerMRM.h
   SONARScoring.h
   SwathMapMassCorrection.h
+  SwathSpectrumCache.h
   SwathWindowLoader.h
   SwathQC.h
   SpectrumAddition.h
@@ -38,6 +38,11 @@
 #include <OpenMS/KERNEL/Peak2D.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/KERNEL/StandardTypes.h>
+#include <OpenMS/KERNEL/RangeUtils.h>
+#include <OpenMS/INTERFACES/IMSDataConsumer.h>
+
+#include <deque>
+#include <memory>
 
 namespace OpenMS
 {
@@ -62,6 +67,10 @@ namespace OpenMS
     for improvement of protein identification and accuracy of isobaric mass tag quantification on Orbitrap-type mass
     spectrometers. Analytical chemistry 83: 8959-67. http://www.ncbi.nlm.nih.gov/pubmed/22017476
 
+    Reporter ions are extracted in parallel over batches of MSn scans. Besides the in-memory
+    extractChannels(), the nested ChannelExtractingConsumer allows the extraction on a stream of
+    spectra (e.g. from MzMLFile::transform()) without loading the whole experiment.
+
     @note Centroided MS and MS/MS data is required.
 
     @htmlinclude OpenMS_IsobaricChannelExtractor.parameters
@@ -133,6 +142,151 @@ private:
       bool followUpValid(const double rt);
     };
 
+    /// small quality control class, holding temporary data for reporting
+    struct ChannelQC_
+    {
+      std::vector<double> mz_deltas; ///< m/z distance between expected and observed reporter ion closest to expected position
+      int signal_not_unique = 0;  ///< counts if more than one peak was found within the search window of each reporter position
+    };
+    typedef std::map<String, ChannelQC_> ChannelQCSet_;
+
+    /// An MSn scan selected for quantification, together with the scans needed to quantify it
+    struct QuantScan_
+    {
+      const MSSpectrum* spectrum = nullptr; ///< the scan containing the reporter ions
+      const MSSpectrum* precursor_scan = nullptr; ///< the potential MS1 precursor scan (nullptr if there is none)
+      const MSSpectrum* follow_up_scan = nullptr; ///< the first MS1 scan with a larger RT (nullptr if there is none)
+      double ms2_rt = 0.0; ///< RT of the MS2 scan (differs from the RT of @p spectrum for MS3 scans)
+      double ms2_precursor_mz = 0.0; ///< m/z of the precursor ion of the MS2 scan
+      String error; ///< reason why the precursor information is missing (empty if it is available)
+    };
+
+    /// Reporter ions extracted from a single QuantScan_
+    struct ScanResult_
+    {
+      bool passed_purity = false; ///< false if the scan was skipped due to low precursor purity
+      double precursor_purity = -1.0; ///< purity of the precursor (-1 if it could not be computed)
+      std::vector<Peak2D::IntensityType> intensities; ///< intensity per channel
+      std::vector<double> mz_deltas; ///< m/z distance between expected and observed reporter ion per channel
+      std::vector<char> has_signal; ///< whether a reporter ion was found close to (0.5 Th) the expected position per channel
+      std::vector<char> signal_not_unique; ///< whether more than one peak was found within the reporter mass shift per channel
+    };
+
+public:
+    /**
+      @brief Consumer which extracts the isobaric channels from a stream of spectra.
+
+      Yields the same result as extractChannels() on the fully loaded experiment, but only keeps the
+      MS1 scans in memory which are still needed for the precursor purity of pending MSn scans.
+      An MSn scan is pending until the next MS1 scan with a larger RT (its follow-up scan) was seen.
+      Resolved MSn scans are quantified in parallel in batches of @p batch_size scans.
+
+      Spectra need to arrive sorted by RT. Since the highest MS level with a valid activation method
+      is used for quantification, results of a lower level are discarded as soon as a higher level is seen.
+
+      For MS3 scans, the MS2 scan referenced by the 'spectrum_ref' of the precursor is only searched
+      within the current and the previous MS1 cycle. If it is not found there, the last preceding MS2
+      scan is used (as in MSExperiment::getPrecursorSpectrum()).
+
+      @note The consensus map is only complete after finish() was called.
+    */
+    class OPENMS_DLLAPI ChannelExtractingConsumer :
+      public Interfaces::IMSDataConsumer
+    {
+public:
+      /**
+        @brief Constructor
+
+        @param extractor The (configured) extractor to use. Must outlive the consumer.
+        @param consensus_map Output map containing the identified channels and the corresponding intensities. It will be cleared.
+        @param batch_size Number of MSn scans quantified together in parallel
+      */
+      ChannelExtractingConsumer(const IsobaricChannelExtractor& extractor, ConsensusMap& consensus_map, Size batch_size = 1000);
+
+      ~ChannelExtractingConsumer() override;
+
+      void consumeSpectrum(SpectrumType& s) override;
+
+      /// Chromatograms are ignored
+      void consumeChromatogram(ChromatogramType& /* c */) override {}
+
+      void setExpectedSize(Size /* expectedSpectra */, Size /* expectedChromatograms */) override {}
+
+      void setExperimentalSettings(const ExperimentalSettings& /* exp */) override {}
+
+      /**
+        @brief Quantifies the remaining scans and adds the channel information to the consensus map.
+
+        Needs to be called after the last spectrum was consumed. Further calls have no effect.
+
+        @exception Exception::MissingInformation if no spectrum was consumed
+      */
+      void finish();
+
+private:
+      /// An MS2 scan which might be the precursor scan of a following MS3 scan
+      struct ParentScan_
+      {
+        String native_id;
+        UInt ms_level;
+        double rt;
+        bool has_precursor;
+        double precursor_mz;
+      };
+
+      /// An MSn scan (and the MS1 scans around it) waiting for quantification
+      struct PendingScan_
+      {
+        std::shared_ptr<const MSSpectrum> spectrum;
+        std::shared_ptr<const MSSpectrum> precursor_scan;
+        std::shared_ptr<const MSSpectrum> follow_up_scan;
+        double ms2_rt = 0.0;
+        double ms2_precursor_mz = 0.0;
+        String error;
+      };
+
+      /// Finds the parent scan of the MS3 scan @p s (nullptr if there is none)
+      const ParentScan_* findParentScan_(const MSSpectrum& s) const;
+
+      /// Quantifies all scans with known follow-up scan
+      void flush_();
+
+      const IsobaricChannelExtractor& extractor_;
+      ConsensusMap& consensus_map_;
+      Size batch_size_;
+
+      /// Predicate for the selected activation method
+      HasActivationMethod<MSSpectrum> is_valid_activation_;
+
+      /// Number of scans with valid activation method per MS level
+      std::map<UInt, UInt> ms_level_counts_;
+      /// Number of scans per activation method
+      std::map<String, int> activation_modes_;
+      /// The MS level used for quantification so far (0 if none was seen)
+      UInt quant_ms_level_;
+
+      Size nr_spectra_;
+      double last_rt_;
+      bool finished_;
+
+      /// The last MS1 scan, i.e. the precursor scan of the following MSn scans
+      std::shared_ptr<const MSSpectrum> last_ms1_;
+      /// Potential parent scans since the last and the second to last MS1 scan
+      std::vector<ParentScan_> parents_current_cycle_;
+      std::vector<ParentScan_> parents_previous_cycle_;
+      /// The last potential parent scan per MS level
+      std::map<UInt, ParentScan_> last_parent_;
+
+      /// MSn scans waiting for their follow-up MS1 scan
+      std::deque<PendingScan_> pending_;
+      /// MSn scans ready for quantification (in the order of the input)
+      std::vector<PendingScan_> ready_;
+
+      UInt64 element_index_;
+      ChannelQCSet_ channel_qc_;
+    };
+
+private:
     /// The used quantitation method (itraq4plex, tmt6plex,..).
     const IsobaricQuantitationMethod* quant_method_;
 
@@ -164,7 +318,29 @@ private:
     bool interpolate_precursor_purity_;
 
     /// add channel information to the map after it has been filled
-    void registerChannelsInOutputMap_(ConsensusMap& consensus_map);
+    void registerChannelsInOutputMap_(ConsensusMap& consensus_map) const;
+
+    /// print stats about m/z calibration / presence of signal
+    void printCalibrationStats_(const ChannelQCSet_& channel_qc) const;
+
+    /**
+      @brief Computes the precursor purity of @p scan and extracts its reporter ions.
+
+      Thread-safe, i.e. can be called for different scans in parallel.
+    */
+    void extractScan_(const QuantScan_& scan, ScanResult_& result) const;
+
+    /**
+      @brief Quantifies @p scans (in parallel) and appends the resulting features to @p consensus_map in the order of @p scans.
+
+      @param scans The scans to quantify
+      @param consensus_map The output map
+      @param channel_qc Quality control data, updated for every scan passing the purity filter
+      @param element_index Index of the next feature (incremented for every added feature)
+
+      @exception Exception::MissingInformation if a scan passing the purity filter lacks precursor information
+    */
+    void quantifyScans_(const std::vector<QuantScan_>& scans, ConsensusMap& consensus_map, ChannelQCSet_& channel_qc, UInt64& element_index) const;
 
     /**
       @brief Checks if the given precursor fulfills all constraints for extractions.
@@ -183,22 +359,23 @@ private:
     bool hasLowIntensityReporter_(const ConsensusFeature& cf) const;
 
     /**
-      @brief Computes the purity of the precursor given an iterator pointing to the MS/MS spectrum and one to the precursor spectrum.
+      @brief Computes the purity of the precursor given the MS/MS spectrum, its precursor spectrum and the following MS1 spectrum.
 
-      @param ms2_spec Iterator pointing to the MS2 spectrum.
-      @param precursor Iterator pointing to the precursor spectrum of ms2_spec.
+      @param ms2_spec The MS2 spectrum.
+      @param precursor_spec The precursor spectrum of ms2_spec.
+      @param follow_up_spec The first MS1 spectrum after ms2_spec (nullptr if there is none).
       @return Fraction of the total intensity in the isolation window of the precursor spectrum that was assigned to the precursor.
     */
-    double computePrecursorPurity_(const PeakMap::ConstIterator& ms2_spec, const PuritySate_& pState) const;
+    double computePrecursorPurity_(const PeakMap::SpectrumType& ms2_spec, const PeakMap::SpectrumType& precursor_spec, const PeakMap::SpectrumType* follow_up_spec) const;
 
     /**
-      @brief Computes the purity of the precursor given an iterator pointing to the MS/MS spectrum and a reference to the potential precursor spectrum.
+      @brief Computes the purity of the precursor given the MS/MS spectrum and the potential precursor spectrum.
 
-      @param ms2_spec Iterator pointing to the MS2 spectrum.
-      @param precursor Iterator pointing to the precursor spectrum of ms2_spec.
+      @param ms2_spec The MS2 spectrum.
+      @param precursor_spec The precursor spectrum of ms2_spec.
       @return Fraction of the total intensity in the isolation window of the precursor spectrum that was assigned to the precursor.
     */
-    double computeSingleScanPrecursorPurity_(const PeakMap::ConstIterator& ms2_spec, const PeakMap::SpectrumType& precursor_spec) const;
+    double computeSingleScanPrecursorPurity_(const PeakMap::SpectrumType& ms2_spec, const PeakMap::SpectrumType& precursor_spec) const;
 
     /**
       @brief Get the first (of potentially many) activation methods (HCD,CID,...) of this spectrum.
@@ -41,6 +41,9 @@
 #include <OpenMS/METADATA/ProteinIdentification.h>
 #include <OpenMS/METADATA/ExperimentalDesign.h>
 
+#include <numeric>
+#include <unordered_map>
+
 namespace OpenMS
 {
   /**
@@ -218,6 +221,46 @@ private:
     /// Protein quantification data
     ProteinQuant prot_quant_;
 
+    /**
+         @brief Dense abundances of a single peptide, used while reading quantitative data.
+
+         Abundances are accumulated in a flat (fraction/charge x sample) matrix instead of the nested maps of PeptideData::abundances.
+         The matrix is transferred to the peptide data by transferDenseAbundances_().
+    */
+    struct DenseAbundances_
+    {
+      /// peptide data in @p pep_quant_ that the abundances belong to
+      PeptideData* data = nullptr;
+
+      /// (fraction, charge) of each row of the matrix
+      std::vector<std::pair<Int, Int>> rows;
+
+      /// row-major matrix of abundances (rows x samples)
+      std::vector<double> values;
+
+      /// whether an abundance was recorded for a matrix entry
+      std::vector<char> observed;
+    };
+
+    /**
+         @brief Hash of a (modified) peptide sequence, consistent with AASequence::operator==.
+
+         Residues and modifications are unique objects of their databases, so their addresses identify them.
+    */
+    struct AASequenceHash_
+    {
+      std::size_t operator()(const AASequence& seq) const;
+    };
+
+    /// Interned peptide sequences: sequence (modified) -> index in @p dense_abundances_
+    std::unordered_map<AASequence, Size, AASequenceHash_> peptide_ids_;
+
+    /// Dense abundances of interned peptides
+    std::vector<DenseAbundances_> dense_abundances_;
+
+    /// Number of columns (samples) of the dense abundance matrices
+    Size dense_columns_ = 0;
+
 
     /**
          @brief Get the "canonical" annotation (a single peptide hit) of a feature/consensus feature from the associated list of peptide identifications.
@@ -227,18 +270,23 @@ private:
     */
     PeptideHit getAnnotation_(std::vector<PeptideIdentification>& peptides);
 
+    /// Get the index of the (interned) peptide with sequence @p seq in @p dense_abundances_, adding it if necessary
+    Size internPeptide_(const AASequence& seq);
+
     /**
          @brief Gather quantitative information from a feature.
 
-         Store quantitative information from @p feature in member @p pep_quant_, based on the peptide annotation in @p hit. 
-         @p fraction, use 0 for first fraction (or if no fractionation was performed)
-         @p sample, use 0 for first sample, 1 for second, ... 
-         If @p hit is empty ("ambiguous/no annotation"), nothing is stored.
+         Adds the intensity of @p feature to the dense abundances of the interned peptide @p peptide_id for charge state @p charge.
+         @p fraction and @p sample are one-based (as in the experimental design); @p sample must be smaller than @p dense_columns_.
     */
-    void quantifyFeature_(const FeatureHandle& feature, 
-      size_t fraction, 
-      size_t sample, 
-      const PeptideHit& hit);
+    void quantifyFeature_(const FeatureHandle& feature,
+      size_t fraction,
+      size_t sample,
+      Size peptide_id,
+      Int charge);
+
+    /// Transfer the dense abundances of all interned peptides to @p pep_quant_ (in parallel) and release them
+    void transferDenseAbundances_();
 
     /**
      *   @brief Determine fraction and charge state of a peptide with the highest
@@ -49,6 +49,12 @@ namespace OpenMS
 
      This class supports (multi-class) classification with a linear or RBF kernel.
      It uses cross-validation to optimize the SVM parameters @e C and (RBF kernel only) @e gamma.
+     All combinations of parameter values and cross-validation partitions are evaluated in parallel.
+
+     For two-class classification with a linear kernel, a dedicated solver is used by default (parameter @p linear_solver):
+     The SVM is trained by dual coordinate descent on a dense copy of the data (as in LIBLINEAR; the bias term is treated as an additional predictor with constant value 1).
+     Probabilities are estimated by fitting a sigmoid (Platt scaling) to the decision values from cross-validation.
+     This is much faster than LIBSVM for large training sets.
 
      SVM models are generated by the the setup() method.
      To simplify the scaling of input data (predictors), the data for both the training and the test set together are passed in as parameter @p predictors.
@@ -144,6 +150,24 @@ namespace OpenMS
     /// Pointer to SVM model (LIBSVM format)
     struct svm_model* model_;
 
+    /// Use the linear solver (dual coordinate descent) instead of LIBSVM?
+    bool use_linear_solver_;
+
+    /// Values of predictors (dense, row-major; only for the linear solver)
+    std::vector<double> dense_data_;
+
+    /// Observation indexes of the training data (same order as in @p data_)
+    std::vector<Size> training_obs_;
+
+    /// Weights of the linear model (one per predictor, followed by the bias)
+    std::vector<double> linear_weights_;
+
+    /// Class labels of the linear model (first: positive decision values, second: negative decision values)
+    std::pair<Int, Int> linear_labels_;
+
+    /// Parameters of the sigmoid function for probability estimates of the linear model
+    std::pair<double, double> sigmoid_params_;
+
     /// Names of predictors in the model (excluding uninformative ones)
     std::vector<String> predictor_names_;
 
@@ -173,6 +197,22 @@ namespace OpenMS
 
     /// Run cross-validation to optimize SVM parameters
     void optimizeParameters_();
+
+    /// Assign training observations to cross-validation partitions (stratified by class, deterministic)
+    std::vector<Size> assignPartitions_() const;
+
+    /**
+       @brief Train a linear SVM (two classes) by dual coordinate descent
+
+       @param training Indexes of training observations (positions in @p data_)
+       @param C SVM parameter @e C
+       @param weights Output: weights of the predictors, followed by the bias
+    */
+    void trainLinear_(const std::vector<Size>& training, double C,
+                      std::vector<double>& weights) const;
+
+    /// Decision value of a linear model for an observation (index in @p dense_data_)
+    double linearDecisionValue_(const std::vector<double>& weights, Size obs_index) const;
   };
 }
 
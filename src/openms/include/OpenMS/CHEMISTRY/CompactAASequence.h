@@ -0,0 +1,276 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CHEMISTRY/Residue.h>
+#include <OpenMS/CONCEPT/Types.h>
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <boost/container/small_vector.hpp>
+
+#include <atomic>
+#include <vector>
+
+namespace OpenMS
+{
+  class AASequence;
+  class ResidueModification;
+
+  /**
+      @brief Compact, immutable representation of a (modified) peptide sequence
+
+      Search engines and scoring functions query the masses of the same
+      peptide candidates over and over again. AASequence stores one Residue
+      pointer per position and recomputes its weight on every call to
+      getMonoWeight(). This class instead stores a 16 bit index per residue in
+      a small inline buffer (no heap allocation for typical peptide lengths)
+      and computes the masses exactly once:
+
+      - residues (including modified residues) are interned in a process-wide
+        table that maps each distinct Residue to a small integer index and
+        caches its internal mono-isotopic and average weight,
+      - mono-isotopic and average weights of the full peptide are computed on
+        construction,
+      - the prefix mass array (sum of the internal residue weights up to each
+        position) is built lazily on first request and can be used to
+        compute b/y (a/c/x/z) ladders without touching the residues again.
+
+      N- and C-terminal modifications are stored as pointers into the
+      ModificationsDB, which already interns them.
+
+      Instances can be converted from and to AASequence at the cost of a
+      single pass over the residues. All accessors are const and safe to be
+      called concurrently.
+
+      @ingroup Chemistry
+  */
+  class OPENMS_DLLAPI CompactAASequence
+  {
+public:
+    /// index of a residue in the interned residue table
+    typedef uint16_t ResidueIndex;
+
+    /// inline buffer size; peptides up to this length do not allocate
+    static const Size INLINE_RESIDUES = 32;
+
+    /// storage of the residue indices
+    typedef boost::container::small_vector<ResidueIndex, INLINE_RESIDUES> ResidueIndices;
+
+    /** @name Constructors and Destructors
+    */
+    //@{
+    /// Default constructor (empty sequence)
+    CompactAASequence();
+
+    /// Conversion constructor from AASequence
+    explicit CompactAASequence(const AASequence& seq);
+
+    /// Copy constructor (the lazily built prefix masses are not copied)
+    CompactAASequence(const CompactAASequence& rhs);
+
+    /// Move constructor (the lazily built prefix masses are not moved)
+    CompactAASequence(CompactAASequence&& rhs) noexcept;
+
+    /// Destructor
+    ~CompactAASequence();
+    //@}
+
+    /// Assignment operator
+    CompactAASequence& operator=(const CompactAASequence& rhs);
+
+    /// Move assignment operator
+    CompactAASequence& operator=(CompactAASequence&& rhs) noexcept;
+
+    /**
+      @brief create a CompactAASequence object by parsing an OpenMS string
+
+      @throws Exception::ParseError if an invalid string representation of an AA sequence is passed
+    */
+    static CompactAASequence fromString(const String& s, bool permissive = true);
+
+    /// converts back into an AASequence
+    AASequence toAASequence() const;
+
+    /// returns the peptide as string with modifications embedded in brackets (see AASequence::toString())
+    String toString() const;
+
+    /** @name Accessors
+    */
+    //@{
+    /// returns the number of residues
+    Size size() const { return residues_.size(); }
+
+    /// check if sequence is empty
+    bool empty() const { return residues_.empty(); }
+
+    /// returns the table index of the residue at position @p index (unchecked)
+    ResidueIndex getResidueIndex(Size index) const { return residues_[index]; }
+
+    /// returns all residue table indices
+    const ResidueIndices& getResidueIndices() const { return residues_; }
+
+    /// returns the residue at position @p index
+    /// @throw Exception::IndexOverflow if @p index is out of range
+    const Residue& getResidue(Size index) const;
+
+    /// returns a pointer to the N-terminal modification, or zero if none is set
+    const ResidueModification* getNTerminalModification() const { return n_term_mod_; }
+
+    /// returns a pointer to the C-terminal modification, or zero if none is set
+    const ResidueModification* getCTerminalModification() const { return c_term_mod_; }
+
+    /// returns true if the peptide contains the given residue
+    bool has(const Residue& residue) const;
+
+    /// returns true if the sequence contains an unknown residue without mass ('X')
+    bool hasUnknownResidue() const { return has_unknown_; }
+
+    /**
+      @brief returns the mono-isotopic weight of the peptide in the given ionic form
+
+      Same semantics as AASequence::getMonoWeight(), but O(1).
+
+      @throw Exception::InvalidValue if the sequence contains an unknown residue 'X' without mass
+    */
+    double getMonoWeight(Residue::ResidueType type = Residue::Full, Int charge = 0) const;
+
+    /**
+      @brief returns the average weight of the peptide in the given ionic form
+
+      Same semantics as AASequence::getAverageWeight(), but O(1).
+
+      @throw Exception::InvalidValue if the sequence contains an unknown residue 'X' without mass
+    */
+    double getAverageWeight(Residue::ResidueType type = Residue::Full, Int charge = 0) const;
+
+    /**
+      @brief returns mass-to-charge ratio of the peptide in the given ionic form
+
+      @throws Exception::InvalidValue if @p charge==0
+    */
+    double getMZ(Int charge, Residue::ResidueType type = Residue::Full) const;
+
+    /**
+      @brief returns the cached prefix masses
+
+      Element i holds the summed internal mono-isotopic weight of the residues
+      0 to i (terminal modifications are not included). The array is built on
+      the first call and shared by all subsequent calls.
+    */
+    const std::vector<double>& getPrefixMonoMasses() const;
+
+    /**
+      @brief returns the mono-isotopic weight of the N-terminal fragment of length @p length
+
+      The N-terminal modification is included. @p type is expected to be one
+      of Residue::AIon, BIon, CIon or NTerminal; @p charge protons are added.
+    */
+    double getPrefixMonoWeight(Size length, Residue::ResidueType type = Residue::BIon, Int charge = 0) const;
+
+    /**
+      @brief returns the mono-isotopic weight of the C-terminal fragment of length @p length
+
+      The C-terminal modification is included. @p type is expected to be one
+      of Residue::XIon, YIon, ZIon or CTerminal; @p charge protons are added.
+    */
+    double getSuffixMonoWeight(Size length, Residue::ResidueType type = Residue::YIon, Int charge = 0) const;
+    //@}
+
+    /** @name Predicates
+    */
+    //@{
+    /// equality operator. Two sequences are equal iff all residues (including PTMs) and terminal modifications are equal
+    bool operator==(const CompactAASequence& rhs) const;
+
+    /// inequality operator
+    bool operator!=(const CompactAASequence& rhs) const;
+
+    /// lesser than operator (by length, interned residue indices and terminal modification pointers); can be used for maps but is not identical to the order of AASequence
+    bool operator<(const CompactAASequence& rhs) const;
+    //@}
+
+    /** @name Interned residue table
+    */
+    //@{
+    /**
+      @brief returns the table index of @p residue, adding it to the table if necessary
+
+      @throw Exception::IndexOverflow if more than 65536 distinct residues are requested
+    */
+    static ResidueIndex internResidue(const Residue* residue);
+
+    /// returns the residue stored at table index @p index
+    static const Residue* getResidueByIndex(ResidueIndex index);
+
+    /// returns the cached internal mono-isotopic weight of the residue at table index @p index
+    static double getInternalMonoWeight(ResidueIndex index);
+
+    /// returns the number of distinct residues interned so far
+    static Size getNumberOfInternedResidues();
+    //@}
+
+protected:
+    /// computes the prefix mass array
+    void computePrefixMasses_() const;
+
+    /// returns the mono-isotopic weight of the formula that is added to an internal fragment to obtain @p type
+    static double getTerminalMonoWeight_(Residue::ResidueType type);
+
+    /// interned residue indices
+    ResidueIndices residues_;
+
+    /// N-terminal modification
+    const ResidueModification* n_term_mod_;
+
+    /// C-terminal modification
+    const ResidueModification* c_term_mod_;
+
+    /// summed internal mono-isotopic weight of all residues (no terminal modifications)
+    double internal_mono_;
+
+    /// summed internal average weight of all residues (no terminal modifications)
+    double internal_average_;
+
+    /// whether an 'X' residue without mass is contained
+    bool has_unknown_;
+
+    /// whether prefix_mono_ has been built (double-checked in getPrefixMonoMasses())
+    mutable std::atomic<bool> prefix_ready_;
+
+    /// cached prefix masses (see getPrefixMonoMasses())
+    mutable std::vector<double> prefix_mono_;
+  };
+
+} // namespace OpenMS
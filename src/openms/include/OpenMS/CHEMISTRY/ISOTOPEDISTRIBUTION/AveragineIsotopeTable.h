@@ -0,0 +1,181 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/DATASTRUCTURES/String.h>
+
+#include <vector>
+
+namespace OpenMS
+{
+  /**
+    @ingroup Chemistry
+    @brief Precomputed averagine isotope patterns with constant-time, interpolated lookup.
+
+    Estimating an averagine isotope distribution (e.g. with
+    CoarseIsotopePatternGenerator::estimateFromPeptideWeight) requires
+    estimating a sum formula and convolving the isotope distributions of its
+    elements. This is expensive when it is done per query in tight loops or
+    once per mass window at the start of every tool.
+
+    This table stores the coarse (1 Da spaced) isotope intensities of an
+    averagine model at equidistant masses (0, @p mass_resolution, 2 * @p
+    mass_resolution, ...) up to a maximum mass. getIntensities() returns the
+    pattern at any mass by linear interpolation between the two neighboring
+    grid masses. At the grid masses the first @e n intensities are the ones
+    of CoarseIsotopePatternGenerator(n); in between they differ from the
+    exact pattern at most by the effect of adding or removing single atoms in
+    the averagine estimate. Masses beyond the table are computed directly.
+
+    A table does not change after construction and can be shared between
+    threads. getTable() returns process-wide instances that are created on
+    first use (thread-safe; threads requesting a missing table at the same
+    time may each compute it, but only one copy is kept), so all algorithms
+    of a tool share the same tables. Tables can be stored to disk and loaded (and registered for
+    getTable()) to avoid their computation altogether.
+
+    @note Tables use the isotope abundances of the ElementDB at the time of
+    their construction. Algorithms that modify these abundances need to
+    compute their isotope patterns directly.
+  */
+  class OPENMS_DLLAPI AveragineIsotopeTable
+  {
+public:
+    /// Averagine models (element compositions, see CoarseIsotopePatternGenerator)
+    enum AveragineModel
+    {
+      PEPTIDE, ///< Senko's averagine for peptides (estimateFromPeptideWeight)
+      RNA, ///< averagine for RNA (estimateFromRNAWeight)
+      DNA, ///< averagine for DNA (estimateFromDNAWeight)
+      SIZE_OF_AVERAGINEMODEL
+    };
+
+    /// Names of the averagine models
+    static const std::string NamesOfAveragineModel[SIZE_OF_AVERAGINEMODEL];
+
+    /**
+      @brief Computes a table
+
+      @param model Averagine model
+      @param mass_resolution Mass spacing of the precomputed patterns (in Da)
+      @param max_mass Largest precomputed mass (in Da)
+      @param max_isotopes Number of isotopes stored per pattern
+
+      @exception Exception::InvalidValue is thrown if a parameter is out of range
+    */
+    AveragineIsotopeTable(AveragineModel model, double mass_resolution, double max_mass, Size max_isotopes);
+
+    /**
+      @brief Loads a table stored with store()
+
+      @exception Exception::FileNotFound is thrown if the file cannot be opened
+      @exception Exception::ParseError is thrown if the file is not a valid table
+    */
+    explicit AveragineIsotopeTable(const String& filename);
+
+    /**
+      @brief Returns the relative intensities of the first @p n_isotopes isotopes at @p mass (normalized to a sum of 1)
+
+      Fewer intensities are returned for very small masses that have fewer
+      isotopes (like CoarseIsotopePatternGenerator does).
+
+      @exception Exception::InvalidValue is thrown if @p n_isotopes exceeds getMaxIsotopes()
+    */
+    void getIntensities(double mass, Size n_isotopes, std::vector<double>& intensities) const;
+
+    /// Writes the table to a binary file (for the same platform)
+    void store(const String& filename) const;
+
+    /// Averagine model of the table
+    AveragineModel getModel() const;
+
+    /// Mass spacing of the precomputed patterns
+    double getMassResolution() const;
+
+    /// Largest precomputed mass
+    double getMaxMass() const;
+
+    /// Number of isotopes stored per pattern
+    Size getMaxIsotopes() const;
+
+    /**
+      @brief Returns a process-wide table for the given model
+
+      Any registered table of the same model and mass resolution which covers
+      @p max_mass and @p max_isotopes is returned; otherwise a new table is
+      computed and registered. Tables are never removed, so the reference
+      stays valid until the end of the program. This function is thread-safe,
+      but algorithms should keep the reference instead of calling it per
+      query.
+
+      @exception Exception::InvalidValue is thrown if a parameter is out of range
+    */
+    static const AveragineIsotopeTable& getTable(AveragineModel model, double mass_resolution = 1.0, double max_mass = 10000.0, Size max_isotopes = 20);
+
+    /**
+      @brief Loads a table stored with store() and makes it available to getTable()
+
+      @exception Exception::FileNotFound is thrown if the file cannot be opened
+      @exception Exception::ParseError is thrown if the file is not a valid table
+    */
+    static const AveragineIsotopeTable& registerTable(const String& filename);
+
+protected:
+    /// Checks the table parameters
+    static void checkParameters_(AveragineModel model, double mass_resolution, double max_mass, Size max_isotopes);
+
+    /// Computes the exact pattern with CoarseIsotopePatternGenerator
+    static void computeIntensities_(AveragineModel model, double mass, Size n_isotopes, std::vector<double>& intensities);
+
+    /// Averagine model
+    AveragineModel model_;
+
+    /// Mass spacing of the precomputed patterns
+    double mass_resolution_;
+
+    /// Number of precomputed patterns (masses 0 to (n - 1) * mass_resolution_)
+    Size n_masses_;
+
+    /// Number of isotopes stored per pattern
+    Size max_isotopes_;
+
+    /// Number of isotopes (at most max_isotopes_) of each pattern
+    std::vector<Size> sizes_;
+
+    /// Intensities of all patterns (max_isotopes_ per pattern, padded with zeros)
+    std::vector<double> intensities_;
+  };
+
+} // namespace OpenMS
@@ -0,0 +1,152 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopeDistribution.h>
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace OpenMS
+{
+  class EmpiricalFormula;
+  class Element;
+  class FineIsotopePatternGenerator;
+
+  /**
+    @ingroup Chemistry
+
+    @brief Thread-safe least-recently-used cache for fine isotope patterns
+
+    Fine isotope patterns (see FineIsotopePatternGenerator) are expensive to
+    compute, while many algorithms request the patterns of the same formulas
+    over and over. This cache stores the patterns keyed by the empirical
+    formula and the settings of the generator (stop condition, total
+    probability or threshold mode, absolute threshold, maximal number of
+    isotopes), so one cache can be shared by differently configured generators.
+
+    The cache is divided into shards, each with its own lock and its own
+    least-recently-used list, so that concurrent lookups of different formulas
+    rarely block each other. The capacity is distributed evenly over the shards.
+
+    All member functions are thread-safe. Usually the cache is not used
+    directly but attached to a generator with FineIsotopePatternGenerator::setCache().
+  */
+  class OPENMS_DLLAPI FineIsotopePatternCache
+  {
+public:
+
+    /// Constructor, holding at most @p capacity patterns in @p shards shards (at least one)
+    explicit FineIsotopePatternCache(Size capacity = 10000, Size shards = 16);
+
+    /**
+      @brief Looks up the pattern of @p formula as generated by @p generator
+
+      @return Whether the pattern was found (and copied to @p pattern)
+    */
+    bool get(const FineIsotopePatternGenerator& generator, const EmpiricalFormula& formula, IsotopeDistribution& pattern);
+
+    /// Stores the pattern of @p formula as generated by @p generator, evicting the least recently used pattern of the shard if it is full
+    void insert(const FineIsotopePatternGenerator& generator, const EmpiricalFormula& formula, const IsotopeDistribution& pattern);
+
+    /// Removes all patterns (statistics are kept)
+    void clear();
+
+    /// Number of cached patterns
+    Size size() const;
+
+    /// Maximal number of cached patterns
+    Size getCapacity() const;
+
+    /// Number of lookups that were answered from the cache
+    Size getHits() const;
+
+    /// Number of lookups that were not answered from the cache
+    Size getMisses() const;
+
+    /// Fraction of lookups answered from the cache (0 if there were no lookups)
+    double getHitRate() const;
+
+    /// Resets hit and miss counters
+    void resetStatistics();
+
+protected:
+
+    struct Key
+    {
+      std::vector<std::pair<const Element*, SignedSize> > elements;
+      Int charge;
+      double stop_condition;
+      bool use_total_prob;
+      bool absolute;
+      Size max_isotopes;
+
+      bool operator==(const Key& rhs) const;
+    };
+
+    struct KeyHash
+    {
+      std::size_t operator()(const Key& key) const;
+    };
+
+    struct Entry
+    {
+      Key key;
+      IsotopeDistribution pattern;
+    };
+
+    struct Shard
+    {
+      mutable std::mutex mutex;
+      /// Entries, most recently used first
+      std::list<Entry> entries;
+      std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+      Size hits = 0;
+      Size misses = 0;
+    };
+
+    /// Builds the key of @p formula for the settings of @p generator
+    static Key makeKey_(const FineIsotopePatternGenerator& generator, const EmpiricalFormula& formula);
+
+    Size capacity_;
+    /// Maximal number of entries per shard
+    Size shard_capacity_;
+    std::vector<std::unique_ptr<Shard> > shards_;
+  };
+}
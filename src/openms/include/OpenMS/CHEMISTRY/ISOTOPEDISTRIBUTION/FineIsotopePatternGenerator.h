@@ -35,9 +35,14 @@
 #pragma once
 
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopePatternGenerator.h>
+#include <OpenMS/CONCEPT/Types.h>
+
+#include <memory>
+#include <vector>
 
 namespace OpenMS
 {
+  class FineIsotopePatternCache;
 
   /**
     * @ingroup Chemistry
@@ -88,6 +93,17 @@ namespace OpenMS
     * highest isotopic peak (relative). This is how the stop_condition
     * parameter is interpreted when use_total_prob is set to false.
     *
+    * For very large formulas, the number of isotopic configurations needed to
+    * reach the stop condition (and the memory to hold them) can be huge. If
+    * a maximal number of isotopes is set (setMaxIsotopes()), the configurations
+    * are generated in order of decreasing probability and generation stops
+    * at this number, so the memory needed is bounded. This is slower than
+    * the default mode for formulas that do not hit the limit.
+    *
+    * Patterns can be cached by attaching a (thread-safe, possibly shared)
+    * FineIsotopePatternCache with setCache(). Patterns of many formulas can
+    * be generated in parallel using the batch version of run().
+    *
     * @note Computation of fine isotope patterns can be slow for large
     *       molecules, if you don't need fine isotope distributions consider using
     *       CoarseIsotopePatternGenerator.
@@ -151,6 +167,15 @@ namespace OpenMS
       **/
     IsotopeDistribution run(const EmpiricalFormula&) const;
 
+    /**
+      * @brief Creates the isotope distributions of many empirical sum formulas in parallel
+      *
+      * Identical formulas are computed only once. The result for @p formulas[i]
+      * is identical to run(formulas[i]).
+      *
+      **/
+    std::vector<IsotopeDistribution> run(const std::vector<EmpiricalFormula>& formulas) const;
+
     /// Set probability stop condition (lower values generate fewer results)
     void setThreshold(double stop_condition)
     {
@@ -187,10 +212,39 @@ namespace OpenMS
       return use_total_prob_;
     }
 
+    /// Set the maximal number of isotopes per pattern (0 = unlimited, see class docu)
+    void setMaxIsotopes(Size max_isotopes)
+    {
+      max_isotopes_ = max_isotopes;
+    }
+
+    /// Returns the maximal number of isotopes per pattern (0 = unlimited, see class docu)
+    Size getMaxIsotopes() const
+    {
+      return max_isotopes_;
+    }
+
+    /// Set the cache used to look up and store patterns (a null pointer disables caching)
+    void setCache(const std::shared_ptr<FineIsotopePatternCache>& cache)
+    {
+      cache_ = cache;
+    }
+
+    /// Returns the cache used to look up and store patterns (may be a null pointer)
+    const std::shared_ptr<FineIsotopePatternCache>& getCache() const
+    {
+      return cache_;
+    }
+
  protected:
+    /// Computes the isotope distribution (without using the cache)
+    IsotopeDistribution generate_(const EmpiricalFormula& formula) const;
+
     double stop_condition_ = 0.01;
     bool absolute_ = false;
     bool use_total_prob_ = true;
+    Size max_isotopes_ = 0;
+    std::shared_ptr<FineIsotopePatternCache> cache_;
 
   };
 
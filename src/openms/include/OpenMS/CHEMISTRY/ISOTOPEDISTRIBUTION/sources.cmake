@@ -4,7 +4,9 @@ set(directory include/OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION)
 
 ### list all header files of the directory here
 set(sources_list_h
+  AveragineIsotopeTable.h
   CoarseIsotopePatternGenerator.h
+  FineIsotopePatternCache.h
   FineIsotopePatternGenerator.h
   IsoSpecWrapper.h
   IsotopeDistribution.h
@@ -99,7 +99,7 @@ public:
         @param mass Mass to be decomposed.
         @return true if decomposition over a given mass exists, otherwise - false.
       */
-      bool exist(value_type mass) override;
+      bool exist(value_type mass) const override;
 
       /**
         Gets one possible decomposition for @c mass.
@@ -107,7 +107,7 @@ public:
         @param mass Mass to be decomposed.
         @return One possible decomposition for a given mass.
       */
-      decomposition_type getDecomposition(value_type mass) override;
+      decomposition_type getDecomposition(value_type mass) const override;
 
       /**
         Gets all possible decompositions for @c mass.
@@ -115,7 +115,7 @@ public:
         @param mass Mass to be decomposed.
         @return All possible decompositions for a given mass.
       */
-      decompositions_type getAllDecompositions(value_type mass) override;
+      decompositions_type getAllDecompositions(value_type mass) const override;
 
       /**
         Gets number of all possible decompositions for a given @c mass.
@@ -125,7 +125,7 @@ public:
         @param mass Mass to be decomposed
         @return number of decompositions for a given mass.
       */
-      decomposition_value_type getNumberOfDecompositions(value_type mass) override;
+      decomposition_value_type getNumberOfDecompositions(value_type mass) const override;
 
 private:
 
@@ -196,7 +196,7 @@ private:
         @param decompositionsStore Container where decompositions are collected.
       */
       void collectDecompositionsRecursively_(value_type mass, size_type alphabetMassIndex,
-                                             decomposition_type decomposition, decompositions_type & decompositionsStore);
+                                             decomposition_type decomposition, decompositions_type & decompositionsStore) const;
     };
 
 
@@ -415,7 +415,7 @@ private:
 
     template <typename ValueType, typename DecompositionValueType>
     bool IntegerMassDecomposer<ValueType, DecompositionValueType>::
-    exist(value_type mass)
+    exist(value_type mass) const
     {
 
       value_type residue = ertable_.back().at(mass % alphabet_.getWeight(0));
@@ -424,7 +424,7 @@ private:
 
     template <typename ValueType, typename DecompositionValueType>
     typename IntegerMassDecomposer<ValueType, DecompositionValueType>::decomposition_type
-    IntegerMassDecomposer<ValueType, DecompositionValueType>::getDecomposition(value_type mass)
+    IntegerMassDecomposer<ValueType, DecompositionValueType>::getDecomposition(value_type mass) const
     {
 
       decomposition_type decomposition;
@@ -460,7 +460,7 @@ private:
 
     template <typename ValueType, typename DecompositionValueType>
     typename IntegerMassDecomposer<ValueType, DecompositionValueType>::decompositions_type
-    IntegerMassDecomposer<ValueType, DecompositionValueType>::getAllDecompositions(value_type mass)
+    IntegerMassDecomposer<ValueType, DecompositionValueType>::getAllDecompositions(value_type mass) const
     {
       decompositions_type decompositionsStore;
       decomposition_type decomposition(alphabet_.size());
@@ -471,7 +471,7 @@ private:
     template <typename ValueType, typename DecompositionValueType>
     void IntegerMassDecomposer<ValueType, DecompositionValueType>::
     collectDecompositionsRecursively_(value_type mass, size_type alphabetMassIndex,
-                                      decomposition_type decomposition, decompositions_type & decompositionsStore)
+                                      decomposition_type decomposition, decompositions_type & decompositionsStore) const
     {
       if (alphabetMassIndex == 0)
       {
@@ -548,7 +548,7 @@ private:
     */
     template <typename ValueType, typename DecompositionValueType>
     typename IntegerMassDecomposer<ValueType, DecompositionValueType>::decomposition_value_type IntegerMassDecomposer<ValueType,
-                                                                                                                      DecompositionValueType>::getNumberOfDecompositions(value_type mass)
+                                                                                                                      DecompositionValueType>::getNumberOfDecompositions(value_type mass) const
     {
       return static_cast<typename IntegerMassDecomposer<ValueType, DecompositionValueType>::decomposition_value_type>(getAllDecompositions(mass).size());
     }
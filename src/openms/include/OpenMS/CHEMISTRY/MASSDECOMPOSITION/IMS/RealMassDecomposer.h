@@ -62,6 +62,10 @@ namespace OpenMS
       them using @c IntegerMassDecomposer, does some checks (i.e. on false
       positives appeared due to rounding) and collects decompositions together.
 
+      The extended residue table is built once in the constructor; all
+      decomposition methods are const and may be called concurrently from
+      several threads on a shared instance.
+
       @author Anton Pervukhin <Anton.Pervukhin@CeBiTec.Uni-Bielefeld.DE>
     */
     class OPENMS_DLLAPI RealMassDecomposer
@@ -77,6 +81,9 @@ public:
       /// Type of result decompositions from integer decomposer.
       typedef integer_decomposer_type::decompositions_type decompositions_type;
 
+      /// Type of a single decomposition.
+      typedef integer_decomposer_type::decomposition_type decomposition_type;
+
       /// Type of the number of decompositions.
       typedef unsigned long long number_of_decompositions_type;
 
@@ -96,9 +103,9 @@ public:
         @param error Error allowed between given and result decomposition.
         @return All possible decompositions for a given mass and error.
       */
-      decompositions_type getDecompositions(double mass, double error);
+      decompositions_type getDecompositions(double mass, double error) const;
 
-      decompositions_type getDecompositions(double mass, double error, const constraints_type & constraints);
+      decompositions_type getDecompositions(double mass, double error, const constraints_type & constraints) const;
 
       /**
        Gets a number of all decompositions for a @c mass with an @c error
@@ -109,7 +116,23 @@ public:
        @param error Error allowed between given and result decomposition.
        @return Number of all decompositions for a given mass and error.
       */
-      number_of_decompositions_type getNumberOfDecompositions(double mass, double error);
+      number_of_decompositions_type getNumberOfDecompositions(double mass, double error) const;
+
+      /**
+        Gets the half-open range [first, second) of scaled integer masses
+        that have to be decomposed to find all decompositions of @c mass
+        with an @c error allowed (including false negatives due to rounding).
+      */
+      std::pair<integer_value_type, integer_value_type> getIntegerMassRange(double mass, double error) const;
+
+      /**
+        Gets all decompositions of a scaled integer mass (as returned by
+        getIntegerMassRange()), without checking the real mass.
+      */
+      decompositions_type getIntegerMassDecompositions(integer_value_type integer_mass) const;
+
+      /// Gets the real mass of a @c decomposition
+      double getParentMass(const decomposition_type & decomposition) const;
 
 private:
       /// Weights over which values/masses to be decomposed.
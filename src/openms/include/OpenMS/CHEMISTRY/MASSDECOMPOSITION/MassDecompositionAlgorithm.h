@@ -50,6 +50,9 @@
 #pragma warning( pop )
 #endif
 
+#include <map>
+#include <memory>
+#include <utility>
 #include <vector>
 
 namespace OpenMS
@@ -61,6 +64,13 @@ namespace OpenMS
     possible amino acids and frequencies of them, which add up to the given mass.
     This class is a wrapper for the algorithm published in
 
+    The decomposer (including its extended residue table) is built once per
+    distinct alphabet and precision and shared by all instances, also across
+    threads. Each instance additionally memoizes the decompositions of the
+    discretized (integer) masses it has seen ('cache_size'), which pays off
+    for the many similar mass differences of de novo sequencing. Because of
+    this memo, getDecompositions() is not thread-safe: use one instance per thread.
+
     @htmlinclude OpenMS_MassDecompositionAlgorithm.parameters
 
     @ingroup Analysis_DeNovo
@@ -87,15 +97,43 @@ public:
     //@{
     /// returns the possible decompositions given the weight
     void getDecompositions(std::vector<MassDecomposition> & decomps, double weight);
+
+    /**
+      @brief returns the possible decompositions for each of the given weights
+
+      The weights are decomposed in ascending order in a single sweep, so that
+      neighbouring weights share the decompositions of their common integer masses.
+      @p decomps[i] is identical to the result of getDecompositions() for @p weights[i].
+    */
+    void getDecompositions(std::vector<std::vector<MassDecomposition> > & decomps, const std::vector<double> & weights);
     //@}
 
 protected:
 
+    /// decompositions of one integer mass, together with their real masses
+    typedef std::vector<std::pair<double, MassDecomposition> > DecompositionList;
+
+    /// memo of decompositions, keyed by integer mass
+    typedef std::map<ims::RealMassDecomposer::integer_value_type, DecompositionList> DecompositionCache;
+
     void updateMembers_() override;
 
+    /// appends the decompositions of @p weight to @p decomps, using and filling @p cache
+    void decompose_(std::vector<MassDecomposition> & decomps, double weight, DecompositionCache & cache) const;
+
     ims::IMSAlphabet * alphabet_;
 
-    ims::RealMassDecomposer * decomposer_;
+    /// decomposer, shared between all instances with the same alphabet and precision
+    std::shared_ptr<const ims::RealMassDecomposer> decomposer_;
+
+    /// memoized decompositions of integer masses
+    DecompositionCache cache_;
+
+    /// maximal number of integer masses in the memo (0 = disabled)
+    Size cache_size_;
+
+    /// allowed tolerance of the decompositions
+    double tolerance_;
 
 private:
 
@@ -35,6 +35,7 @@
 #pragma once
 
 #include <OpenMS/CHEMISTRY/Residue.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/FineIsotopePatternGenerator.h>
 #include <OpenMS/DATASTRUCTURES/DefaultParamHandler.h>
 #include <OpenMS/KERNEL/StandardTypes.h>
 #include <OpenMS/METADATA/DataArrays.h>
@@ -43,6 +44,7 @@
 namespace OpenMS
 {
   class AASequence;
+  class CompactAASequence;
 
   /**
       @brief Generates theoretical spectra for peptides with various options
@@ -57,6 +59,19 @@ namespace OpenMS
       are extended. Therefore it is not recommended to add to or change the PeakSpectrum or these DataArrays
       between calls of the getSpectrum function with the same PeakSpectrum.
 
+      getSpectrum can also be called with a CompactAASequence. In that case the
+      fragment ion ladders are computed directly from the cached prefix masses
+      of the sequence instead of summing up residue weights for every ion.
+      Isotope clusters and neutral losses require the residue formulas, so for
+      these options the sequence is converted to an AASequence first.
+
+      For search engines that only score the fragment positions, getFragments()
+      provides a fast path: it writes the sorted fragment m/z values (and
+      optionally intensities, ion types and charges) into a caller-provided
+      FragmentBuffer that is reused between calls. No PeakSpectrum, DataArrays
+      or ion name strings are created and, once the buffer has grown to the
+      size of the largest spectrum, no memory is allocated.
+
       @note The generation of neutral loss peaks is very slow in this class.
       Something similar to the neutral loss precalculation used in TheoreticalSpectrumGeneratorXLMS
       should be implemented here as well.
@@ -70,6 +85,45 @@ namespace OpenMS
   {
     public:
 
+    /**
+      @brief Reusable output buffer of getFragments()
+
+      The arrays are cleared, but keep their capacity between calls. Use one
+      buffer per thread.
+    */
+    struct OPENMS_DLLAPI FragmentBuffer
+    {
+      /// fragment m/z values, sorted ascending
+      std::vector<double> mz;
+
+      /// fragment intensities (only filled if requested)
+      std::vector<float> intensity;
+
+      /// ion type of each fragment as Residue::ResidueType (only filled if requested); precursor peaks are reported as Residue::Full, immonium ions as Residue::Internal
+      std::vector<uint8_t> ion_type;
+
+      /// charge of each fragment (filled together with ion_type)
+      std::vector<uint8_t> charge;
+
+      /// number of fragments
+      Size size() const { return mz.size(); }
+
+      /// removes all fragments but keeps the allocated memory
+      void clear();
+
+      /** @name Scratch space used by getFragments()
+      */
+      //@{
+      std::vector<double> run_mz;
+      std::vector<float> run_intensity;
+      std::vector<uint8_t> run_ion_type;
+      std::vector<uint8_t> run_charge;
+      std::vector<Size> run_begin;
+      std::vector<Size> cursor;
+      std::vector<double> prefix_masses;
+      //@}
+    };
+
     /** @name Constructors and Destructors
     */
     //@{
@@ -94,20 +148,61 @@ namespace OpenMS
     /// @throw Exception::InvalidParameter   if precursor_charge < max_charge
     virtual void getSpectrum(PeakSpectrum& spec, const AASequence& peptide, Int min_charge, Int max_charge, Int precursor_charge = 0) const;
 
+    /// Generates a spectrum for a compact peptide sequence, using its cached prefix masses for the ion ladders
+    /// If precursor_charge is set to 0 max_charge + 1 will be used.
+    /// @throw Exception::InvalidParameter   if precursor_charge < max_charge
+    void getSpectrum(PeakSpectrum& spec, const CompactAASequence& peptide, Int min_charge, Int max_charge, Int precursor_charge = 0) const;
+
+    /**
+      @brief Fast path: writes the sorted fragment m/z values of a peptide into a reusable buffer
+
+      Generates the ion ladders, precursor peaks and immonium ions selected by
+      the parameters (like getSpectrum()), but without creating peaks, meta
+      data or ion names. The parameters 'add_losses', 'isotope_model',
+      'add_metainfo' and 'sort_by_position' are ignored: no loss or isotope
+      peaks are generated and the output is always sorted.
+
+      @param buffer Output; previous content is replaced
+      @param peptide The peptide
+      @param min_charge Minimal fragment charge
+      @param max_charge Maximal fragment charge
+      @param add_intensities Fill FragmentBuffer::intensity
+      @param add_ion_types Fill FragmentBuffer::ion_type and FragmentBuffer::charge
+    */
+    void getFragments(FragmentBuffer& buffer, const AASequence& peptide, Int min_charge, Int max_charge, bool add_intensities = false, bool add_ion_types = false) const;
+
+    /// Fast path for a CompactAASequence (uses its cached prefix masses), see above
+    void getFragments(FragmentBuffer& buffer, const CompactAASequence& peptide, Int min_charge, Int max_charge, bool add_intensities = false, bool add_ion_types = false) const;
+
     /// overwrite
     void updateMembers_() override;
     //@}
 
     protected:
 
+    /// implementation of getSpectrum for both sequence representations
+    template <typename SequenceType>
+    void getSpectrum_(PeakSpectrum& spec, const SequenceType& peptide, Int min_charge, Int max_charge, Int precursor_charge) const;
+
+    /// implementation of getFragments for both sequence representations
+    template <typename SequenceType>
+    void getFragments_(FragmentBuffer& buffer, const SequenceType& peptide, const std::vector<double>& prefix_masses, Int min_charge, Int max_charge, bool add_intensities, bool add_ion_types) const;
+
     /// adds peaks to a spectrum of the given ion-type, peptide, charge, and intensity, also adds charges and ion names to the DataArrays, if the add_metainfo parameter is set to true
     virtual void addPeaks_(PeakSpectrum& spectrum, const AASequence& peptide, DataArrays::StringDataArray& ion_names, DataArrays::IntegerDataArray& charges, MSSpectrum::Chunks& chunks, const Residue::ResidueType res_type, Int charge = 1) const;
 
+    /// adds peaks of the given ion-type computed from the prefix masses of a CompactAASequence (no isotopes and losses), also adds charges and ion names to the DataArrays, if the add_metainfo parameter is set to true
+    void addPeaks_(PeakSpectrum& spectrum, const CompactAASequence& peptide, DataArrays::StringDataArray& ion_names, DataArrays::IntegerDataArray& charges, MSSpectrum::Chunks& chunks, const Residue::ResidueType res_type, Int charge = 1) const;
+
     /// adds the precursor peaks to the spectrum, also adds charges and ion names to the DataArrays, if the add_metainfo parameter is set to true
     virtual void addPrecursorPeaks_(PeakSpectrum& spec, const AASequence& peptide, DataArrays::StringDataArray& ion_names, DataArrays::IntegerDataArray& charges, Int charge = 1) const;
 
+    /// adds the precursor peaks of a CompactAASequence to the spectrum (no isotopes), also adds charges and ion names to the DataArrays, if the add_metainfo parameter is set to true
+    void addPrecursorPeaks_(PeakSpectrum& spec, const CompactAASequence& peptide, DataArrays::StringDataArray& ion_names, DataArrays::IntegerDataArray& charges, Int charge = 1) const;
+
     /// Adds the common, most abundant immonium ions to the theoretical spectra if the residue is contained in the peptide sequence, also adds charges and ion names to the DataArrays, if the add_metainfo parameter is set to true
-    void addAbundantImmoniumIons_(PeakSpectrum& spec, const AASequence& peptide, DataArrays::StringDataArray& ion_names, DataArrays::IntegerDataArray& charges) const;
+    template <typename SequenceType>
+    void addAbundantImmoniumIons_(PeakSpectrum& spec, const SequenceType& peptide, DataArrays::StringDataArray& ion_names, DataArrays::IntegerDataArray& charges) const;
 
     /// helper to add an isotope cluster to a spectrum, also adds charges and ion names to the DataArrays, if the add_metainfo parameter is set to true
     void addIsotopeCluster_(PeakSpectrum& spectrum, const AASequence& ion, DataArrays::StringDataArray& ion_names, DataArrays::IntegerDataArray& charges, const Residue::ResidueType res_type, Int charge, double intensity) const;
@@ -146,6 +241,8 @@ namespace OpenMS
     Int max_isotope_;
     double rel_loss_intensity_;
     double max_isotope_probability_;
+    /// generator for 'fine' isotope clusters, with a pattern cache shared by all threads
+    FineIsotopePatternGenerator fine_isotope_generator_;
     double pre_int_;
     double pre_int_H2O_;
     double pre_int_NH3_;
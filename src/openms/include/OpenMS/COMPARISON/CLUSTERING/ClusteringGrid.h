@@ -41,10 +41,11 @@
 #include <OpenMS/CONCEPT/Exception.h>
 #include <OpenMS/CONCEPT/Macros.h>
 
-#include <map>
 #include <vector>
 #include <list>
 
+#include <boost/unordered_map.hpp>
+
 namespace OpenMS
 {
 /**
@@ -113,7 +114,7 @@ class OPENMS_DLLAPI ClusteringGrid
     * @param cell_index    cell index (i,j) on the grid
     * @return list of cluster indices (from the list of clusters) which are centred in this cell
     */
-    std::list<int> getClusters(const CellIndex &cell_index) const;
+    const std::list<int>& getClusters(const CellIndex &cell_index) const;
 
     /**
     * @brief returns grid cell index (i,j) for the positions (x,y)
@@ -157,7 +158,7 @@ class OPENMS_DLLAPI ClusteringGrid
     /**
     * @brief grid cell index mapped to a list of clusters in it
     */
-    std::map<CellIndex, std::list<int> > cells_;
+    boost::unordered_map<CellIndex, std::list<int> > cells_;
 
 };
 
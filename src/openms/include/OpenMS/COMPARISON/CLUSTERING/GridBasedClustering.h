@@ -78,7 +78,7 @@ public:
 
     /**
      * @brief operators for comparisons
-     * (for multiset)
+     * (for the minimum distance heap)
      */
     bool operator<(const MinimumDistance& other) const;
     bool operator>(const MinimumDistance& other) const;
@@ -132,8 +132,7 @@ public:
     typedef GridBasedCluster::Point Point; // DPosition<2>
     typedef GridBasedCluster::Rectangle Rectangle; // DBoundingBox<2>
     typedef ClusteringGrid::CellIndex CellIndex; // std::pair<int,int>
-    typedef std::multiset<MinimumDistance>::const_iterator MultisetIterator;
-    typedef boost::unordered::unordered_multimap<int, MultisetIterator>::const_iterator NNIterator;
+    typedef boost::unordered::unordered_multimap<int, int>::const_iterator NNIterator;
 
     /**
      * @brief initialises all data structures
@@ -187,19 +186,15 @@ public:
       Size clusters_start = clusters_.size();
       startProgress(0, clusters_start, OpenMS::String("clustering"));
 
-      MinimumDistance zero_distance(-1, -1, 0);
-
       // combine clusters until all have been moved to the final list
       while (clusters_.size() > 0)
       {
         setProgress(clusters_start - clusters_.size());
 
-        MultisetIterator smallest_distance_it = distances_.lower_bound(zero_distance);
-
-        int cluster_index1 = smallest_distance_it->getClusterIndex();
-        int cluster_index2 = smallest_distance_it->getNearestNeighbourIndex();
+        int cluster_index1 = distances_.front().distance.getClusterIndex();
+        int cluster_index2 = distances_.front().distance.getNearestNeighbourIndex();
 
-        eraseMinDistance_(smallest_distance_it);
+        eraseMinDistance_(cluster_index1);
 
         // update cluster list
         std::map<int, GridBasedCluster>::iterator cluster1_it = clusters_.find(cluster_index1);
@@ -257,20 +252,22 @@ public:
 
         // erase distance object of cluster with cluster_index2 without updating (does not exist anymore!)
         // (the one with cluster_index1 has already been erased at the top of the while loop)
-        eraseMinDistance_(distance_it_for_cluster_idx_[cluster_index2]);
+        eraseMinDistance_(cluster_index2);
 
         // find out which clusters need to be updated
-        std::pair<NNIterator, NNIterator> nn_range = reverse_nns_.equal_range(cluster_index1);
-        for (NNIterator nn_it = nn_range.first; nn_it != nn_range.second;)
-        {
-          clusters_to_be_updated.insert(nn_it->second->getClusterIndex());
-          eraseMinDistance_((nn_it++)->second);
-        }
-        nn_range = reverse_nns_.equal_range(cluster_index2);
-        for (NNIterator nn_it = nn_range.first; nn_it != nn_range.second;)
+        for (int merged_index : {cluster_index1, cluster_index2})
         {
-          clusters_to_be_updated.insert(nn_it->second->getClusterIndex());
-          eraseMinDistance_((nn_it++)->second);
+          std::pair<NNIterator, NNIterator> nn_range = reverse_nns_.equal_range(merged_index);
+          std::vector<int> neighbours;
+          for (NNIterator nn_it = nn_range.first; nn_it != nn_range.second; ++nn_it)
+          {
+            neighbours.push_back(nn_it->second);
+          }
+          for (int neighbour : neighbours)
+          {
+            clusters_to_be_updated.insert(neighbour);
+            eraseMinDistance_(neighbour);
+          }
         }
 
         // update clusters
@@ -471,22 +468,44 @@ private:
     std::map<int, GridBasedCluster> clusters_final_;
 
     /**
-    * @brief list of minimum distances
+    * @brief entry of the minimum distance heap
+    * Equal distances are ordered by insertion, i.e. the earlier entry is merged first.
+    */
+    struct DistanceEntry_
+    {
+      MinimumDistance distance;
+      Size insertion;
+
+      bool operator<(const DistanceEntry_& other) const
+      {
+        if (distance < other.distance) return true;
+        if (other.distance < distance) return false;
+        return insertion < other.insertion;
+      }
+    };
+
+    /**
+    * @brief heap of minimum distances (at most one per cluster)
     * stores the smallest of the distances in the head
     */
-    std::multiset<MinimumDistance> distances_;
+    std::vector<DistanceEntry_> distances_;
 
     /**
-     * @brief reverse nearest neighbor lookup table
-     * for finding out which clusters need to be updated faster
+     * @brief cluster index to position in distances_ lookup table (-1 if the cluster has no entry)
+     * for removing or updating the distance of a cluster
      */
-    boost::unordered::unordered_multimap<int, std::multiset<MinimumDistance>::const_iterator> reverse_nns_;
+    std::vector<SignedSize> distance_position_;
 
     /**
-     * @brief cluster index to distance iterator lookup table
+     * @brief number of entries inserted into distances_ so far
+     */
+    Size distance_insertions_ = 0;
+
+    /**
+     * @brief reverse nearest neighbor lookup table (nearest neighbour index to cluster index)
      * for finding out which clusters need to be updated faster
      */
-    boost::unordered::unordered_map<int, std::multiset<MinimumDistance>::const_iterator> distance_it_for_cluster_idx_;
+    boost::unordered::unordered_multimap<int, int> reverse_nns_;
 
     /**
      * @brief initialises all data structures
@@ -499,6 +518,8 @@ private:
     void init_(const std::vector<double>& data_x, const std::vector<double>& data_y,
                const std::vector<int>& properties_A, const std::vector<int>& properties_B)
     {
+      distance_position_.assign(data_x.size(), -1);
+
       // fill the grid with points to be clustered (initially each cluster contains a single point)
       for (unsigned i = 0; i < data_x.size(); ++i)
       {
@@ -646,12 +667,12 @@ private:
         return true;
       }
 
-      // add to the list of minimal distances
-      std::multiset<MinimumDistance>::const_iterator it = distances_.insert(MinimumDistance(cluster_index, nearest_neighbour, min_dist));
+      // add to the list of minimal distances (and the cluster index -> distance lookup table)
+      distances_.push_back(DistanceEntry_{MinimumDistance(cluster_index, nearest_neighbour, min_dist), distance_insertions_++});
+      distance_position_[cluster_index] = distances_.size() - 1;
+      siftUp_(distances_.size() - 1);
       // add to reverse nearest neighbor lookup table
-      reverse_nns_.insert(std::make_pair(nearest_neighbour, it));
-      // add to cluster index -> distance lookup table
-      distance_it_for_cluster_idx_[cluster_index] = it;
+      reverse_nns_.insert(std::make_pair(nearest_neighbour, cluster_index));
 
       return false;
     }
@@ -659,19 +680,21 @@ private:
     /**
      * @brief remove minimum distance object and its related data
      *
-     * Remove the distance object behind @p it from distances_ and remove all
-     * corresponding data from the auxiliary data structures reverse_nns_ and
-     * distance_it_for_cluster_idx_.
+     * Remove the distance object of cluster @p cluster_index from distances_
+     * and remove all corresponding data from the auxiliary data structures
+     * reverse_nns_ and distance_position_.
      *
-     * @param it    Iterator of distance to be removed from distances_
+     * @param cluster_index    index of the cluster whose distance is to be removed
      */
-    void eraseMinDistance_(const std::multiset<MinimumDistance>::const_iterator it)
+    void eraseMinDistance_(int cluster_index)
     {
+      Size position = distance_position_[cluster_index];
+
       // remove corresponding entries from nearest neighbor lookup table
-      std::pair<NNIterator, NNIterator> nn_range = reverse_nns_.equal_range(it->getNearestNeighbourIndex());
+      std::pair<NNIterator, NNIterator> nn_range = reverse_nns_.equal_range(distances_[position].distance.getNearestNeighbourIndex());
       for (NNIterator nn_it = nn_range.first; nn_it != nn_range.second; ++nn_it)
       {
-        if (nn_it->second == it)
+        if (nn_it->second == cluster_index)
         {
           reverse_nns_.erase(nn_it);
           break;
@@ -679,10 +702,65 @@ private:
       }
 
       // remove corresponding entry from cluster index -> distance lookup table
-      distance_it_for_cluster_idx_.erase(it->getClusterIndex());
+      distance_position_[cluster_index] = -1;
 
-      // remove from distances_
-      distances_.erase(it);
+      // remove from distances_ (replace by the last entry and restore the heap property)
+      if (position + 1 != distances_.size())
+      {
+        distances_[position] = std::move(distances_.back());
+        distance_position_[distances_[position].distance.getClusterIndex()] = position;
+        distances_.pop_back();
+        siftDown_(siftUp_(position));
+      }
+      else
+      {
+        distances_.pop_back();
+      }
+    }
+
+    /**
+     * @brief moves the heap entry at @p position up until its parent is smaller
+     *
+     * @return new position of the entry
+     */
+    Size siftUp_(Size position)
+    {
+      while (position > 0)
+      {
+        Size parent = (position - 1) / 2;
+        if (!(distances_[position] < distances_[parent])) break;
+        swapEntries_(position, parent);
+        position = parent;
+      }
+      return position;
+    }
+
+    /**
+     * @brief moves the heap entry at @p position down until its children are larger
+     */
+    void siftDown_(Size position)
+    {
+      while (true)
+      {
+        Size smallest = position;
+        Size left = 2 * position + 1;
+        Size right = left + 1;
+        if (left < distances_.size() && distances_[left] < distances_[smallest]) smallest = left;
+        if (right < distances_.size() && distances_[right] < distances_[smallest]) smallest = right;
+        if (smallest == position) break;
+        swapEntries_(position, smallest);
+        position = smallest;
+      }
+    }
+
+    /**
+     * @brief swaps two heap entries and updates the lookup table
+     */
+    void swapEntries_(Size a, Size b)
+    {
+      std::swap(distances_[a], distances_[b]);
+      distance_position_[distances_[a].distance.getClusterIndex()] = a;
+      distance_position_[distances_[b].distance.getClusterIndex()] = b;
     }
   };
 }
@@ -199,8 +199,8 @@ public:
     template <typename InputIterator, typename OutputIterator>
     void filterRange(InputIterator input_begin, InputIterator input_end, OutputIterator output_begin)
     {
-      // the buffer is static only to avoid reallocation
-      static std::vector<typename InputIterator::value_type> buffer;
+      // the buffer is static only to avoid reallocation (one per thread)
+      thread_local static std::vector<typename InputIterator::value_type> buffer;
       const UInt size = input_end - input_begin;
 
       //determine the struct size in data points if not already set
@@ -323,17 +323,10 @@ public:
 
         The size of the structuring element is computed for each spectrum individually, if it is given in 'Thomson'.
         See the filtering method for MSSpectrum for details.
+
+        Spectra are filtered in parallel (if OpenMP is enabled).
     */
-    void filterExperiment(PeakMap & exp)
-    {
-      startProgress(0, exp.size(), "filtering baseline");
-      for (UInt i = 0; i < exp.size(); ++i)
-      {
-        filter(exp[i]);
-        setProgress(i);
-      }
-      endProgress();
-    }
+    void filterExperiment(PeakMap & exp);
 
 protected:
 
@@ -351,7 +344,7 @@ protected:
       const Int size = input_end - input;
       const Int struc_size_half = struc_size / 2;           // yes, integer division
 
-      static std::vector<ValueType> buffer;
+      thread_local static std::vector<ValueType> buffer;
       if (Int(buffer.size()) < struc_size) buffer.resize(struc_size);
 
       Int anchor;           // anchoring position of the current block
@@ -451,7 +444,7 @@ protected:
       const Int size = input_end - input;
       const Int struc_size_half = struc_size / 2;           // yes, integer division
 
-      static std::vector<ValueType> buffer;
+      thread_local static std::vector<ValueType> buffer;
       if (Int(buffer.size()) < struc_size) buffer.resize(struc_size);
 
       Int anchor;           // anchoring position of the current block
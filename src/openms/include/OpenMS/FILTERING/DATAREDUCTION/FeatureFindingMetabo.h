@@ -40,6 +40,7 @@
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 #include <OpenMS/KERNEL/MSChromatogram.h>
 #include <OpenMS/CHEMISTRY/Element.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/AveragineIsotopeTable.h>
 
 #include <vector>
 #include <svm.h>
@@ -337,6 +338,9 @@ e conditions are fulfilled. Mainly the
 
     bool remove_single_traces_;
     std::vector<const Element*> elements_;
+
+    /// Precomputed averagine patterns (shared, for the "peptides" isotope filtering model)
+    const AveragineIsotopeTable* averagine_table_;
   };
 
 }
@@ -177,6 +177,54 @@ public:
       return histogram_oob_percent_;
     }
 
+    /**
+      @brief Computes the S/N values for a batch of containers (e.g. all spectra of an MSExperiment) in parallel
+
+      Each thread uses its own copy of this estimator, so the state of this
+      instance (e.g. the result of the last init()) is not changed.
+
+      @param containers Range of containers supporting size() and operator[] (e.g. MSExperiment or std::vector<MSSpectrum>)
+      @param estimates S/N values of all data points, one vector per container
+      @exception Throws Exception::InvalidValue (see init())
+    */
+    template <typename ContainerRange>
+    void computeSTNBatch(const ContainerRange& containers, std::vector<std::vector<double> >& estimates) const
+    {
+      estimates.clear();
+      estimates.resize(containers.size());
+      Size error_count(0);
+      String error_message;
+
+#pragma omp parallel
+      {
+        SignalToNoiseEstimatorMedian estimator(*this);
+#pragma omp for schedule(dynamic)
+        for (SignedSize i = 0; i < (SignedSize)containers.size(); ++i)
+        {
+          if (containers[i].empty()) continue;
+          try
+          {
+            estimator.init(containers[i]);
+            estimates[i].swap(estimator.stn_estimates_);
+          }
+          catch (Exception::BaseException& e)
+          {
+#pragma omp critical (OpenMS_SignalToNoiseEstimatorMedian_batch)
+            {
+              if (error_message.empty()) error_message = e.what();
+              ++error_count;
+            }
+          }
+        }
+      }
+
+      if (error_count > 0)
+      {
+        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "S/N estimation failed for " + String(error_count) + " container(s)", error_message);
+      }
+    }
+
 protected:
 
 
@@ -289,9 +337,9 @@ protected:
       // bin in which a datapoint would fall
       int to_bin = 0;
 
-      // index of bin where the median is located
+      // index of bin where the median is located (tracked while the window slides)
       int median_bin = 0;
-      // additive number of elements from left to x in histogram
+      // number of elements in the bins 0..median_bin (updated whenever an element enters or leaves the window)
       int element_inc_count = 0;
 
       // tracks elements in current window, which may vary because of unevenly spaced data
@@ -317,6 +365,7 @@ protected:
           to_bin = std::max(std::min<int>((int)((*window_pos_borderleft).getIntensity() / bin_size), bin_count_minus_1), 0);
           --histogram[to_bin];
           --elements_in_window;
+          if (to_bin <= median_bin) --element_inc_count;
           ++window_pos_borderleft;
         }
 
@@ -328,6 +377,7 @@ protected:
           to_bin = std::max(std::min<int>((int)((*window_pos_borderright).getIntensity() / bin_size), bin_count_minus_1), 0);
           ++histogram[to_bin];
           ++elements_in_window;
+          if (to_bin <= median_bin) ++element_inc_count;
           ++window_pos_borderright;
         }
 
@@ -338,15 +388,20 @@ protected:
         }
         else
         {
-          // find bin i where ceil[elements_in_window/2] <= sum_c(0..i){ histogram[c] }
-          median_bin = -1;
-          element_inc_count = 0;
+          // find the smallest bin i where ceil[elements_in_window/2] <= sum_c(0..i){ histogram[c] },
+          // starting from the median bin of the previous window (the median moves only a few bins between
+          // neighboring windows, so this avoids a scan over all bins)
           element_in_window_half = (elements_in_window + 1) / 2;
           while (median_bin < bin_count_minus_1 && element_inc_count < element_in_window_half)
           {
             ++median_bin;
             element_inc_count += histogram[median_bin];
           }
+          while (median_bin > 0 && element_inc_count - histogram[median_bin] >= element_in_window_half)
+          {
+            element_inc_count -= histogram[median_bin];
+            --median_bin;
+          }
 
           // increase the error count
           if (median_bin == bin_count_minus_1) {++histogram_oob_percent_; }
@@ -375,6 +430,7 @@ protected:
       // warn if percentage of sparse windows is above 20%
       if (sparse_window_percent_ > 20 && write_log_messages_)
       {
+#pragma omp critical (LOG_WARN_access)
         OPENMS_LOG_WARN << "WARNING in SignalToNoiseEstimatorMedian: "
                  << sparse_window_percent_
                  << "% of all windows were sparse. You should consider increasing 'win_len' or decreasing 'min_required_elements'"
@@ -384,6 +440,7 @@ protected:
       // warn if percentage of possibly wrong median estimates is above 1%
       if (histogram_oob_percent_ > 1 && write_log_messages_)
       {
+#pragma omp critical (LOG_WARN_access)
         OPENMS_LOG_WARN << "WARNING in SignalToNoiseEstimatorMedian: "
                  << histogram_oob_percent_
                  << "% of all Signal-to-Noise estimates are too high, because the median was found in the rightmost histogram-bin. "
@@ -0,0 +1,326 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+//
+
+#pragma once
+
+
+#include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimator.h>
+#include <OpenMS/CONCEPT/LogStream.h>
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/DATASTRUCTURES/ListUtils.h>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+
+namespace OpenMS
+{
+  /**
+    @brief Estimates the signal/noise (S/N) ratio of each data point in a scan by using the exact median of a sliding window
+
+    This estimator uses the same windows as SignalToNoiseEstimatorMedian: for
+    each data point, all data points within <i>win_len</i> / 2 Thomson around
+    it are collected, and the noise is the median of their intensities (the
+    mean of the two central intensities if the window has an even number of
+    elements). Windows with less than <i>min_required_elements</i> elements
+    get the noise value <i>noise_for_empty_window</i>.
+
+    In contrast to SignalToNoiseEstimatorMedian, the median is not taken from
+    an intensity histogram, so there are no bin or maximal intensity
+    parameters and no error caused by the bin width. The intensities are
+    ranked once per scan; the window content is kept in a Fenwick tree over
+    these ranks, which is updated as data points enter and leave the window.
+    The median is then found by a binary search in the tree. The runtime is
+    O(n log n) for a scan with n data points, independent of the window size.
+
+    Use this class instead of SignalToNoiseEstimatorMedian if exact noise
+    levels are needed; the results of both estimators are not identical.
+
+    @note If more than 20 percent of windows have less than <i>min_required_elements</i> of elements, a warning is issued to <i>OPENMS_LOG_WARN</i>.
+
+        @htmlinclude OpenMS_SignalToNoiseEstimatorMedianExact.parameters
+
+    @ingroup SignalProcessing
+  */
+
+  template <typename Container = MSSpectrum>
+  class SignalToNoiseEstimatorMedianExact :
+    public SignalToNoiseEstimator<Container>
+  {
+
+public:
+
+    using SignalToNoiseEstimator<Container>::stn_estimates_;
+    using SignalToNoiseEstimator<Container>::defaults_;
+    using SignalToNoiseEstimator<Container>::param_;
+
+    typedef typename SignalToNoiseEstimator<Container>::PeakIterator PeakIterator;
+    typedef typename SignalToNoiseEstimator<Container>::PeakType PeakType;
+
+    /// default constructor
+    inline SignalToNoiseEstimatorMedianExact()
+    {
+      //set the name for DefaultParamHandler error messages
+      this->setName("SignalToNoiseEstimatorMedianExact");
+
+      defaults_.setValue("win_len", 200.0, "window length in Thomson");
+      defaults_.setMinFloat("win_len", 1.0);
+
+      defaults_.setValue("min_required_elements", 10, "minimum number of elements required in a window (otherwise it is considered sparse)");
+      defaults_.setMinInt("min_required_elements", 1);
+
+      defaults_.setValue("noise_for_empty_window", std::pow(10.0, 20), "noise value used for sparse windows", ListUtils::create<String>("advanced"));
+
+      defaults_.setValue("write_log_messages", "true", "Write out log messages in case of sparse windows");
+      defaults_.setValidStrings("write_log_messages", ListUtils::create<String>("true,false"));
+
+      SignalToNoiseEstimator<Container>::defaultsToParam_();
+    }
+
+    /// Copy Constructor
+    inline SignalToNoiseEstimatorMedianExact(const SignalToNoiseEstimatorMedianExact & source) :
+      SignalToNoiseEstimator<Container>(source)
+    {
+      updateMembers_();
+    }
+
+    /** @name Assignment
+     */
+    //@{
+    ///
+    inline SignalToNoiseEstimatorMedianExact & operator=(const SignalToNoiseEstimatorMedianExact & source)
+    {
+      if (&source == this) return *this;
+
+      SignalToNoiseEstimator<Container>::operator=(source);
+      updateMembers_();
+      return *this;
+    }
+
+    //@}
+
+    /// Destructor
+    ~SignalToNoiseEstimatorMedianExact() override
+    {}
+
+    /// Returns how many percent of the windows were sparse
+    double getSparseWindowPercent() const
+    {
+      return sparse_window_percent_;
+    }
+
+    /**
+      @brief Computes the S/N values for a batch of containers (e.g. all spectra of an MSExperiment) in parallel
+
+      Each thread uses its own copy of this estimator, so the state of this
+      instance (e.g. the result of the last init()) is not changed.
+
+      @param containers Range of containers supporting size() and operator[] (e.g. MSExperiment or std::vector<MSSpectrum>)
+      @param estimates S/N values of all data points, one vector per container
+    */
+    template <typename ContainerRange>
+    void computeSTNBatch(const ContainerRange& containers, std::vector<std::vector<double> >& estimates) const
+    {
+      estimates.clear();
+      estimates.resize(containers.size());
+
+#pragma omp parallel
+      {
+        SignalToNoiseEstimatorMedianExact estimator(*this);
+#pragma omp for schedule(dynamic)
+        for (SignedSize i = 0; i < (SignedSize)containers.size(); ++i)
+        {
+          if (containers[i].empty()) continue;
+          estimator.init(containers[i]);
+          estimates[i].swap(estimator.stn_estimates_);
+        }
+      }
+    }
+
+protected:
+
+    /** Calculate signal-to-noise values for all data points given, by using a sliding window approach
+
+        @param c Raw data, usually an MSSpectrum
+    */
+    void computeSTN_(const Container& c) override
+    {
+      // reset counter for sparse windows
+      sparse_window_percent_ = 0;
+
+      // reset the results
+      stn_estimates_.clear();
+      stn_estimates_.resize(c.size());
+      if (c.empty()) return;
+
+      const Size n = c.size();
+      std::vector<double> intensities(n);
+      std::vector<double> mzs(n);
+      Size pos = 0;
+      for (PeakIterator it = c.begin(); it != c.end(); ++it, ++pos)
+      {
+        intensities[pos] = it->getIntensity();
+        mzs[pos] = it->getMZ();
+      }
+
+      // rank of every data point by intensity (ties are broken by position, so ranks are unique)
+      std::vector<Size> by_intensity(n);
+      std::iota(by_intensity.begin(), by_intensity.end(), 0);
+      std::stable_sort(by_intensity.begin(), by_intensity.end(),
+                       [&intensities](Size a, Size b) { return intensities[a] < intensities[b]; });
+      std::vector<Size> rank(n);
+      for (Size r = 0; r < n; ++r)
+      {
+        rank[by_intensity[r]] = r;
+      }
+
+      // Fenwick tree over the ranks of the data points in the current window
+      std::vector<int> tree(n + 1, 0);
+      Size highest_bit = 1;
+      while (highest_bit * 2 <= n) highest_bit *= 2;
+
+      auto update = [&tree, n](Size r, int delta)
+      {
+        for (Size i = r + 1; i <= n; i += i & (~i + 1))
+        {
+          tree[i] += delta;
+        }
+      };
+      // rank of the k-th smallest intensity in the window (k starts at 1)
+      auto select = [&tree, n, highest_bit](int k)
+      {
+        Size i = 0;
+        for (Size step = highest_bit; step > 0; step /= 2)
+        {
+          if (i + step <= n && tree[i + step] < k)
+          {
+            i += step;
+            k -= tree[i];
+          }
+        }
+        return i; // 1-based position i + 1, i.e. rank i
+      };
+
+      const double window_half_size = win_len_ / 2;
+      Size border_left = 0;
+      Size border_right = 0;
+      int elements_in_window = 0;
+
+      ///start progress estimation
+      SignalToNoiseEstimator<Container>::startProgress(0, n, "noise estimation of data");
+
+      for (Size center = 0; center < n; ++center)
+      {
+        // remove all elements that leave the window on the LEFT side
+        while (mzs[border_left] < mzs[center] - window_half_size)
+        {
+          update(rank[border_left], -1);
+          --elements_in_window;
+          ++border_left;
+        }
+
+        // add all elements that enter the window on the RIGHT side
+        while (border_right < n && mzs[border_right] <= mzs[center] + window_half_size)
+        {
+          update(rank[border_right], 1);
+          ++elements_in_window;
+          ++border_right;
+        }
+
+        double noise;
+        if (elements_in_window < min_required_elements_)
+        {
+          noise = noise_for_empty_window_;
+          ++sparse_window_percent_;
+        }
+        else
+        {
+          double median = intensities[by_intensity[select((elements_in_window + 1) / 2)]];
+          if (elements_in_window % 2 == 0)
+          {
+            median = (median + intensities[by_intensity[select(elements_in_window / 2 + 1)]]) / 2;
+          }
+          // just avoid division by 0 (as in SignalToNoiseEstimatorMedian)
+          noise = std::max(1.0, median);
+        }
+
+        // store result
+        stn_estimates_[center] = intensities[center] / noise;
+
+        // update progress
+        SignalToNoiseEstimator<Container>::setProgress(center + 1);
+      }
+
+      SignalToNoiseEstimator<Container>::endProgress();
+
+      sparse_window_percent_ = sparse_window_percent_ * 100 / n;
+
+      // warn if percentage of sparse windows is above 20%
+      if (sparse_window_percent_ > 20 && write_log_messages_)
+      {
+#pragma omp critical (LOG_WARN_access)
+        OPENMS_LOG_WARN << "WARNING in SignalToNoiseEstimatorMedianExact: "
+                 << sparse_window_percent_
+                 << "% of all windows were sparse. You should consider increasing 'win_len' or decreasing 'min_required_elements'"
+                 << std::endl;
+      }
+    }
+
+    /// overridden function from DefaultParamHandler to keep members up to date, when a parameter is changed
+    void updateMembers_() override
+    {
+      win_len_                 = (double)param_.getValue("win_len");
+      min_required_elements_   = param_.getValue("min_required_elements");
+      noise_for_empty_window_  = (double)param_.getValue("noise_for_empty_window");
+      write_log_messages_      = (bool)param_.getValue("write_log_messages").toBool();
+      stn_estimates_.clear();
+    }
+
+    /// range of data points which belong to a window in Thomson
+    double win_len_;
+    /// minimal number of elements a window needs to cover to be used
+    int min_required_elements_;
+    /// used as noise value for windows which cover less than "min_required_elements_"
+    /// use a very high value if you want to get a low S/N result
+    double noise_for_empty_window_;
+
+    // whether to write out log messages in the case of failure
+    bool write_log_messages_;
+
+    // counter for sparse windows
+    double sparse_window_percent_;
+
+  };
+
+} // namespace OpenMS
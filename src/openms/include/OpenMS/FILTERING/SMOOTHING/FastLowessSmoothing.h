@@ -97,6 +97,12 @@ namespace OpenMS
       robust fit (setting it to zero turns off the robust fit and the nonrobust
       fit is returned). A value of 2 or 3 should be sufficient for most purposes.
 
+      The points at which a local regression is computed (and their
+      neighborhoods) only depend on x and delta, so they are determined once
+      and reused in all robustness iterations. The local regressions of one
+      iteration are independent and computed in parallel (if OpenMP is
+      enabled), giving the same result as a serial computation.
+
     */
     int OPENMS_DLLAPI lowess(const std::vector<double>& x, const std::vector<double>& y,
                double f, int nsteps, double delta, std::vector<double>& result);
@@ -120,6 +120,7 @@ public:
         {
           error_message += String(" The error occurred in the spectrum with retention time ") + spectrum.getRT() + ".";
         }
+#pragma omp critical (LOG_ERROR_access)
         OPENMS_LOG_ERROR << error_message << std::endl;
       }
       else
@@ -170,6 +171,7 @@ public:
         {
           error_message += String(" The error occurred in the chromatogram with m/z time ") + chromatogram.getMZ() + ".";
         }
+#pragma omp critical (LOG_ERROR_access)
         OPENMS_LOG_ERROR << error_message << std::endl;
       }
       else
@@ -188,24 +190,11 @@ public:
     /**
       @brief Smoothes an MSExperiment containing profile data.
 
-      @exception Exception::IllegalArgument is thrown, if the @em gaussian_width parameter is too small.
+      Spectra and chromatograms are smoothed in parallel (if OpenMP is enabled).
+
+      @exception Exception::IllegalArgument is thrown, if the ppm tolerance is used on chromatograms.
     */
-    void filterExperiment(PeakMap & map)
-    {
-      Size progress = 0;
-      startProgress(0, map.size() + map.getChromatograms().size(), "smoothing data");
-      for (Size i = 0; i < map.size(); ++i)
-      {
-        filter(map[i]);
-        setProgress(++progress);
-      }
-      for (Size i = 0; i < map.getChromatograms().size(); ++i)
-      {
-        filter(map.getChromatogram(i));
-        setProgress(++progress);
-      }
-      endProgress();
-    }
+    void filterExperiment(PeakMap & map);
 
 protected:
 
@@ -38,6 +38,7 @@
 #include <OpenMS/CONCEPT/Constants.h>
 #include <OpenMS/INTERFACES/DataStructures.h>
 #include <OpenMS/INTERFACES/ISpectrumAccess.h>
+#include <algorithm>
 #include <cmath>
 #include <vector>
 
@@ -128,6 +129,13 @@ public:
       @brief Smoothes an two data arrays containing data.
 
       Convolutes the filter and the profile data and writes the results into the output iterators mz_out and int_out. 
+
+      For uniformly spaced data, the kernel coefficients only depend on the
+      distance in data points and are tabulated once per call (instead of
+      being interpolated for each pair of data points).
+
+      This function does not change the state of the filter, so it can be
+      called concurrently from several threads.
     */
     template <typename ConstIterT, typename IterT>
     bool filter(
@@ -139,20 +147,40 @@ public:
     {
       bool found_signal = false;
 
-      ConstIterT mz_it = mz_in_start;
-      ConstIterT int_it = int_in_start;
-      for (; mz_it != mz_in_end; mz_it++, int_it++)
+      if (use_ppm_tolerance_)
       {
-        // if ppm tolerance is used, calculate a reasonable width value for this m/z
-        if (use_ppm_tolerance_)
+        // the kernel depends on the m/z, so it is recomputed for each data point (in a copy of the filter)
+        GaussFilterAlgorithm ppm_algo(*this);
+        ConstIterT mz_it = mz_in_start;
+        ConstIterT int_it = int_in_start;
+        for (; mz_it != mz_in_end; mz_it++, int_it++)
         {
-          initialize((*mz_it) * ppm_tolerance_ * 10e-6, spacing_, ppm_tolerance_, use_ppm_tolerance_ );
+          // calculate a reasonable width value for this m/z
+          ppm_algo.initialize((*mz_it) * ppm_tolerance_ * 10e-6, spacing_, ppm_tolerance_, use_ppm_tolerance_);
+
+          double new_int = ppm_algo.integrate_(mz_it, int_it, mz_in_start, mz_in_end);
+
+          // store new intensity and m/z into output iterator
+          *mz_out = *mz_it;
+          *int_out = new_int;
+          ++mz_out;
+          ++int_out;
+
+          if (fabs(new_int) > 0) found_signal = true;
         }
+        return found_signal;
+      }
+
+      std::vector<double> weights;
+      const bool uniform = tabulateUniformKernel_(mz_in_start, mz_in_end, weights);
+      const Size size = std::distance(mz_in_start, mz_in_end);
+      for (Size i = 0; i < size; ++i)
+      {
+        double new_int = uniform ? integrateUniform_(i, mz_in_start, int_in_start, size, weights)
+                                 : integrate_(mz_in_start + i, int_in_start + i, mz_in_start, mz_in_end);
 
-        double new_int = integrate_(mz_it, int_it, mz_in_start, mz_in_end);
-        
         // store new intensity and m/z into output iterator
-        *mz_out = *mz_it;
+        *mz_out = *(mz_in_start + i);
         *int_out = new_int;
         ++mz_out;
         ++int_out;
@@ -177,6 +205,99 @@ protected:
     bool use_ppm_tolerance_;
     double ppm_tolerance_;
 
+    /// Returns the (linearly interpolated) kernel coefficient at the given distance from the center
+    double interpolatedCoefficient_(double distance_in_gaussian) const
+    {
+      const Size middle = coeffs_.size();
+      Size left_position = (Size)floor(distance_in_gaussian / spacing_);
+      // correct rounding errors
+      if (left_position > 0 && left_position * spacing_ > distance_in_gaussian) --left_position;
+      else if ((left_position + 1) * spacing_ < distance_in_gaussian) ++left_position;
+      if (left_position >= middle) left_position = middle - 1;
+
+      Size right_position = left_position + 1;
+      double d = fabs((left_position * spacing_) - distance_in_gaussian) / spacing_;
+      return (right_position < middle) ? (1 - d) * coeffs_[left_position] + d * coeffs_[right_position]
+                                       : coeffs_[left_position];
+    }
+
+    /**
+      @brief Tabulates the kernel for uniformly spaced data
+
+      @param first Begin of the positions
+      @param last End of the positions
+      @param weights Kernel coefficient for a distance of k data points at index k
+
+      @return false if the data is not uniformly spaced (nothing is tabulated then)
+    */
+    template <typename InputPeakIterator>
+    bool tabulateUniformKernel_(InputPeakIterator first, InputPeakIterator last, std::vector<double>& weights) const
+    {
+      const Size size = std::distance(first, last);
+      if (size < 3) return false;
+
+      const double data_spacing = *(first + 1) - *first;
+      if (!(data_spacing > 0)) return false;
+      // allow for rounding errors of the positions only
+      const double tolerance = data_spacing * 1e-9;
+      for (InputPeakIterator it = first + 1; it + 1 != last; ++it)
+      {
+        if (fabs((*(it + 1) - *it) - data_spacing) > tolerance) return false;
+      }
+
+      // all data points within the kernel (plus one for the interpolation at the border)
+      const Size nr_weights = std::min(size, (Size)(coeffs_.size() * spacing_ / data_spacing) + 3);
+      weights.resize(nr_weights);
+      for (Size k = 0; k < nr_weights; ++k)
+      {
+        weights[k] = interpolatedCoefficient_(k * data_spacing);
+      }
+      return true;
+    }
+
+    /// Computes the convolution of the raw data at index i and the gaussian kernel tabulated by tabulateUniformKernel_
+    template <typename InputPeakIterator>
+    double integrateUniform_(Size i, InputPeakIterator x /* mz */, InputPeakIterator y /* int */, Size size, const std::vector<double>& weights) const
+    {
+      double v = 0.;
+      // norm the gaussian kernel area to one
+      double norm = 0.;
+      const Size middle = coeffs_.size();
+      const double x_i = *(x + i);
+
+      const double start_pos = ((x_i - (middle * spacing_)) > (*x)) ? (x_i - (middle * spacing_)) : (*x);
+      const double end_pos = ((x_i + (middle * spacing_)) < *(x + (size - 1))) ? (x_i + (middle * spacing_)) : *(x + (size - 1));
+
+      //integrate from middle to start_pos
+      for (Size h = i; (h != 0) && (*(x + (h - 1)) > start_pos) && (i - h + 1 < weights.size()); --h)
+      {
+        const double coeffs_right = weights[i - h];
+        const double coeffs_left = weights[i - h + 1];
+        const double width = fabs(*(x + (h - 1)) - *(x + h)) / 2.;
+        norm += width * (coeffs_left + coeffs_right);
+        v += width * (*(y + (h - 1)) * coeffs_left + *(y + h) * coeffs_right);
+      }
+
+      //integrate from middle to end_pos
+      for (Size h = i; (h != size - 1) && (*(x + (h + 1)) < end_pos) && (h - i + 1 < weights.size()); ++h)
+      {
+        const double coeffs_left = weights[h - i];
+        const double coeffs_right = weights[h - i + 1];
+        const double width = fabs(*(x + h) - *(x + (h + 1))) / 2.;
+        norm += width * (coeffs_left + coeffs_right);
+        v += width * (*(y + h) * coeffs_left + *(y + (h + 1)) * coeffs_right);
+      }
+
+      if (v > 0)
+      {
+        return v / norm;
+      }
+      else
+      {
+        return 0;
+      }
+    }
+
     /// Computes the convolution of the raw data at position x and the gaussian kernel
     template <typename InputPeakIterator>
     double integrate_(InputPeakIterator x /* mz */, InputPeakIterator y /* int */, InputPeakIterator first, InputPeakIterator last)
@@ -187,12 +187,7 @@ public:
     */
     void filter(MSSpectrum & spectrum)
     {
-      // copy the data AND META DATA to the output container
-      MSSpectrum output = spectrum;
-      // filter
-      filter(spectrum.begin(), spectrum.end(), output.begin());
-      // swap back
-      std::swap(spectrum, output);
+      filterContainer_(spectrum);
     }
 
     /**
@@ -200,35 +195,43 @@ public:
     */
     void filter(MSChromatogram & chromatogram)
     {
-      // copy the data AND META DATA to the output container
-      MSChromatogram output = chromatogram;
-      // filter
-      filter(chromatogram.begin(), chromatogram.end(), output.begin());
-      // swap back
-      std::swap(chromatogram, output);
+      filterContainer_(chromatogram);
     }
 
     /**
       @brief Removed the noise from an MSExperiment containing profile data.
+
+      Spectra and chromatograms are smoothed in parallel (if OpenMP is enabled).
     */
-    void filterExperiment(PeakMap & map)
+    void filterExperiment(PeakMap & map);
+
+protected:
+    /**
+      @brief Smoothes contiguous intensity data (same result as the iterator-based filter())
+
+      The steady state is computed coefficient by coefficient over all data
+      points, which allows the compiler to vectorize the convolution.
+
+      @return false if there are less data points than the frame size (@p out is not changed then)
+    */
+    bool filterIntensities_(const std::vector<double>& in, std::vector<double>& out) const;
+
+    /// Smoothes the intensities of a spectrum or chromatogram in place
+    template <typename ContainerT>
+    void filterContainer_(ContainerT& container) const
     {
-      Size progress = 0;
-      startProgress(0, map.size() + map.getChromatograms().size(), "smoothing data");
-      for (Size i = 0; i < map.size(); ++i)
+      std::vector<double> intensities(container.size()), smoothed;
+      for (Size i = 0; i < container.size(); ++i)
       {
-        filter(map[i]);
-        setProgress(++progress);
+        intensities[i] = container[i].getIntensity();
       }
-      for (Size i = 0; i < map.getChromatograms().size(); ++i)
+      if (!filterIntensities_(intensities, smoothed)) return;
+      for (Size i = 0; i < container.size(); ++i)
       {
-        filter(map.getChromatogram(i));
-        setProgress(++progress);
+        container[i].setIntensity(smoothed[i]);
       }
-      endProgress();
     }
 
-protected:
     /// Coefficients
     std::vector<double> coeffs_;
 
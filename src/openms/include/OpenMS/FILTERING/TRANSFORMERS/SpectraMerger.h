@@ -205,9 +205,8 @@ public:
     {
 
       // convert spectra's precursors to clusterizable data
-      Size data_size;
-      std::vector<BinaryTreeNode> tree;
-      Map<Size, Size> index_mapping;
+      std::vector<Size> index_mapping; // index in cluster data ==> experiment index
+      std::vector<std::vector<Size> > clusters;
       // local scope to save memory - we do not need the clustering stuff later
       {
         std::vector<BaseFeature> data;
@@ -220,12 +219,12 @@ public:
           }
 
           // remember which index in distance data ==> experiment index
-          index_mapping[data.size()] = i;
+          index_mapping.push_back(i);
 
           // make cluster element
           BaseFeature bf;
           bf.setRT(exp[i].getRT());
-          std::vector<Precursor> pcs = exp[i].getPrecursors();
+          const std::vector<Precursor>& pcs = exp[i].getPrecursors();
           if (pcs.empty())
           {
             throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("Scan #") + String(i) + " does not contain any precursor information! Unable to cluster!");
@@ -237,39 +236,9 @@ public:
           bf.setMZ(pcs[0].getMZ());
           data.push_back(bf);
         }
-        data_size = data.size();
-
-        SpectraDistance_ llc;
-        llc.setParameters(param_.copy("precursor_method:", true));
-        SingleLinkage sl;
-        DistanceMatrix<float> dist; // will be filled
-        ClusterHierarchical ch;
 
-        //ch.setThreshold(0.99);
-        // clustering ; threshold is implicitly at 1.0, i.e. distances of 1.0 (== similarity 0) will not be clustered
-        ch.cluster<BaseFeature, SpectraDistance_>(data, llc, sl, tree, dist);
-      }
-
-      // extract the clusters
-      ClusterAnalyzer ca;
-      std::vector<std::vector<Size> > clusters;
-      // count number of real tree nodes (not the -1 ones):
-      Size node_count = 0;
-      for (Size ii = 0; ii < tree.size(); ++ii)
-      {
-        if (tree[ii].distance >= 1)
-        {
-          tree[ii].distance = -1;  // manually set to disconnect, as SingleLinkage does not support it
-        }
-        if (tree[ii].distance != -1)
-        {
-          ++node_count;
-        }
+        clusterPrecursors_(data, clusters);
       }
-      ca.cut(data_size - node_count, tree, clusters);
-
-      //std::cerr << "Treesize: " << (tree.size()+1) << "   #clusters: " << clusters.size() << std::endl;
-      //std::cerr << "tree:\n" << ca.newickTree(tree, true) << "\n";
 
       // convert to blocks
       MergeBlocks spectra_to_merge;
@@ -495,14 +464,10 @@ protected:
       double mz_binning_width(param_.getValue("mz_binning_width"));
       String mz_binning_unit(param_.getValue("mz_binning_width_unit"));
 
-      // merge spectra
-      MapType merged_spectra;
-
       Map<Size, Size> cluster_sizes;
       std::set<Size> merged_indices;
 
       // set up alignment
-      SpectrumAlignment sas;
       Param p;
       p.setValue("tolerance", mz_binning_width);
       if (!(mz_binning_unit == "Da" || mz_binning_unit == "ppm"))
@@ -511,126 +476,53 @@ protected:
       }
 
       p.setValue("is_relative_tolerance", mz_binning_unit == "Da" ? "false" : "true");
-      sas.setParameters(p);
-      std::vector<std::pair<Size, Size> > alignment;
 
-      Size count_peaks_aligned(0);
-      Size count_peaks_overall(0);
-
-      // each BLOCK
+      // blocks are independent of each other: collect them in (master index) order, ...
+      std::vector<MergeBlocks::ConstIterator> blocks;
+      blocks.reserve(spectra_to_merge.size());
       for (auto it = spectra_to_merge.begin(); it != spectra_to_merge.end(); ++it)
       {
         ++cluster_sizes[it->second.size() + 1]; // for stats
-
-        typename MapType::SpectrumType consensus_spec = exp[it->first];
-        consensus_spec.setMSLevel(ms_level);
-
-        //consensus_spec.unify(exp[it->first]); // append meta info
         merged_indices.insert(it->first);
+        merged_indices.insert(it->second.begin(), it->second.end());
+        blocks.push_back(it);
+      }
 
-        //typename MapType::SpectrumType all_peaks = exp[it->first];
-        double rt_average = consensus_spec.getRT();
-        double precursor_mz_average = 0.0;
-        Size precursor_count(0);
-        if (!consensus_spec.getPrecursors().empty())
-        {
-          precursor_mz_average = consensus_spec.getPrecursors()[0].getMZ();
-          ++precursor_count;
-        }
+      // ... merge them in parallel ...
+      std::vector<typename MapType::SpectrumType> merged_spectra(blocks.size());
 
-        count_peaks_overall += consensus_spec.size();
+      Size count_peaks_aligned(0);
+      Size count_peaks_overall(0);
+      Size error_count(0);
+      String error_message;
 
-        // block elements
-        for (auto sit = it->second.begin(); sit != it->second.end(); ++sit)
-        {
-          consensus_spec.unify(exp[*sit]); // append meta info
-          merged_indices.insert(*sit);
+#pragma omp parallel
+      {
+        SpectrumAlignment sas;
+        sas.setParameters(p);
 
-          rt_average += exp[*sit].getRT();
-          if (ms_level >= 2 && exp[*sit].getPrecursors().size() > 0)
+#pragma omp for schedule(dynamic) reduction(+: count_peaks_aligned, count_peaks_overall)
+        for (SignedSize i = 0; i < (SignedSize)blocks.size(); ++i)
+        {
+          try
           {
-            precursor_mz_average += exp[*sit].getPrecursors()[0].getMZ();
-            ++precursor_count;
+            mergeBlock_(exp, blocks[i]->first, blocks[i]->second, ms_level, sas, merged_spectra[i], count_peaks_aligned, count_peaks_overall);
           }
-
-          // merge data points
-          sas.getSpectrumAlignment(alignment, consensus_spec, exp[*sit]);
-          //std::cerr << "alignment of " << it->first << " with " << *sit << " yielded " << alignment.size() << " common peaks!\n";
-          count_peaks_aligned += alignment.size();
-          count_peaks_overall += exp[*sit].size();
-
-          Size align_index(0);
-          Size spec_b_index(0);
-
-          // sanity check for number of peaks
-          Size spec_a = consensus_spec.size(), spec_b = exp[*sit].size(), align_size = alignment.size();
-          for (auto pit = exp[*sit].begin(); pit != exp[*sit].end(); ++pit)
+          catch (Exception::BaseException& e)
           {
-            if (alignment.size() == 0 || alignment[align_index].second != spec_b_index)
-              // ... add unaligned peak
+#pragma omp critical (OpenMS_SpectraMerger_mergeSpectra)
             {
-              consensus_spec.push_back(*pit);
+              if (error_message.empty()) error_message = e.what();
+              ++error_count;
             }
-            // or add aligned peak height to ALL corresponding existing peaks
-            else
-            {
-              Size counter(0);
-              Size copy_of_align_index(align_index);
-
-              while (alignment.size() > 0 && 
-                     copy_of_align_index < alignment.size() && 
-                     alignment[copy_of_align_index].second == spec_b_index)
-              {
-                ++copy_of_align_index;
-                ++counter;
-              } // Count the number of peaks in a which correspond to a single b peak.
-
-              while (alignment.size() > 0 &&
-                     align_index < alignment.size() &&  
-                     alignment[align_index].second == spec_b_index)
-              {
-                consensus_spec[alignment[align_index].first].setIntensity(consensus_spec[alignment[align_index].first].getIntensity() +
-                    (pit->getIntensity() / (double)counter)); // add the intensity divided by the number of peaks
-                ++align_index; // this aligned peak was explained, wait for next aligned peak ...
-                if (align_index == alignment.size())
-                {
-                  alignment.clear();  // end reached -> avoid going into this block again
-                }
-              }
-              align_size = align_size + 1 - counter; //Decrease align_size by number of
-            }
-            ++spec_b_index;
-          }
-          consensus_spec.sortByPosition(); // sort, otherwise next alignment will fail
-          if (spec_a + spec_b - align_size != consensus_spec.size())
-          {
-            OPENMS_LOG_WARN << "wrong number of features after merge. Expected: " << spec_a + spec_b - align_size << " got: " << consensus_spec.size() << "\n";
-          }
-        }
-        rt_average /= it->second.size() + 1;
-        consensus_spec.setRT(rt_average);
-
-        if (ms_level >= 2)
-        {
-          if (precursor_count)
-          {
-            precursor_mz_average /= precursor_count;
           }
-          std::vector<Precursor> pcs = consensus_spec.getPrecursors();
-          //if (pcs.size()>1) OPENMS_LOG_WARN << "Removing excessive precursors - leaving only one per MS2 spectrum.\n";
-          pcs.resize(1);
-          pcs[0].setMZ(precursor_mz_average);
-          consensus_spec.setPrecursors(pcs);
         }
+      }
 
-        if (consensus_spec.empty())
-        {
-          continue;
-        }
-        else
-        {
-          merged_spectra.addSpectrum(consensus_spec);
-        }
+      if (error_count > 0)
+      {
+        throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Merging failed for " + String(error_count) + " block(s): " + error_message);
       }
 
       OPENMS_LOG_INFO << "Cluster sizes:\n";
@@ -663,11 +555,175 @@ protected:
 
       // exp.erase(remove_if(exp.begin(), exp.end(), InMSLevelRange<typename MapType::SpectrumType>(ListUtils::create<int>(String(ms_level)), false)), exp.end());
 
-      // ... and add consensus spectra
-      exp.getSpectra().insert(exp.end(), merged_spectra.begin(), merged_spectra.end());
+      // ... and add consensus spectra (in block order, skipping empty ones)
+      for (typename MapType::SpectrumType& consensus_spec : merged_spectra)
+      {
+        if (!consensus_spec.empty())
+        {
+          exp.addSpectrum(std::move(consensus_spec));
+        }
+      }
 
     }
 
+    /**
+      @brief merges a single block of spectra into a consensus spectrum
+
+      The master spectrum @p master is the starting point, the @p sacrifices are aligned (using @p sas)
+      and merged into it one after another. Aligned peaks add their intensity to the corresponding
+      consensus peaks, unaligned peaks are inserted.
+
+      @exception Exception::IllegalArgument is thrown if a spectrum is not sorted by m/z
+    */
+    template <typename MapType>
+    void mergeBlock_(const MapType& exp, const Size master, const std::vector<Size>& sacrifices, const UInt ms_level,
+                     const SpectrumAlignment& sas, typename MapType::SpectrumType& consensus_spec,
+                     Size& count_peaks_aligned, Size& count_peaks_overall) const
+    {
+      typedef typename MapType::SpectrumType SpectrumType;
+
+      std::vector<std::pair<Size, Size> > alignment;
+
+      consensus_spec = exp[master];
+      consensus_spec.setMSLevel(ms_level);
+
+      double rt_average = consensus_spec.getRT();
+      double precursor_mz_average = 0.0;
+      Size precursor_count(0);
+      if (!consensus_spec.getPrecursors().empty())
+      {
+        precursor_mz_average = consensus_spec.getPrecursors()[0].getMZ();
+        ++precursor_count;
+      }
+
+      count_peaks_overall += consensus_spec.size();
+
+      // block elements
+      for (auto sit = sacrifices.begin(); sit != sacrifices.end(); ++sit)
+      {
+        const SpectrumType& spec_b_ref = exp[*sit];
+        consensus_spec.unify(spec_b_ref); // append meta info
+
+        rt_average += spec_b_ref.getRT();
+        if (ms_level >= 2 && spec_b_ref.getPrecursors().size() > 0)
+        {
+          precursor_mz_average += spec_b_ref.getPrecursors()[0].getMZ();
+          ++precursor_count;
+        }
+
+        // merge data points
+        sas.getSpectrumAlignment(alignment, consensus_spec, spec_b_ref);
+        count_peaks_aligned += alignment.size();
+        count_peaks_overall += spec_b_ref.size();
+
+        Size align_index(0);
+        Size spec_b_index(0);
+
+        // the consensus spectrum is sorted (the alignment checked it), and so are the unaligned
+        // peaks appended below if spectrum b is: merging the two chunks is cheaper than a full sort
+        typename SpectrumType::Chunks chunks(consensus_spec);
+        chunks.add(true);
+
+        // sanity check for number of peaks
+        Size spec_a = consensus_spec.size(), spec_b = spec_b_ref.size(), align_size = alignment.size();
+        for (auto pit = spec_b_ref.begin(); pit != spec_b_ref.end(); ++pit)
+        {
+          if (alignment.size() == 0 || alignment[align_index].second != spec_b_index)
+            // ... add unaligned peak
+          {
+            consensus_spec.push_back(*pit);
+          }
+          // or add aligned peak height to ALL corresponding existing peaks
+          else
+          {
+            Size counter(0);
+            Size copy_of_align_index(align_index);
+
+            while (alignment.size() > 0 &&
+                   copy_of_align_index < alignment.size() &&
+                   alignment[copy_of_align_index].second == spec_b_index)
+            {
+              ++copy_of_align_index;
+              ++counter;
+            } // Count the number of peaks in a which correspond to a single b peak.
+
+            while (alignment.size() > 0 &&
+                   align_index < alignment.size() &&
+                   alignment[align_index].second == spec_b_index)
+            {
+              consensus_spec[alignment[align_index].first].setIntensity(consensus_spec[alignment[align_index].first].getIntensity() +
+                  (pit->getIntensity() / (double)counter)); // add the intensity divided by the number of peaks
+              ++align_index; // this aligned peak was explained, wait for next aligned peak ...
+              if (align_index == alignment.size())
+              {
+                alignment.clear();  // end reached -> avoid going into this block again
+              }
+            }
+            align_size = align_size + 1 - counter; //Decrease align_size by number of
+          }
+          ++spec_b_index;
+        }
+        chunks.add(true); // spectrum b passed the alignment's sorting check
+        consensus_spec.sortByPositionPresorted(chunks.getChunks()); // sort, otherwise next alignment will fail
+        if (spec_a + spec_b - align_size != consensus_spec.size())
+        {
+#pragma omp critical (LOG_WARN_access)
+          OPENMS_LOG_WARN << "wrong number of features after merge. Expected: " << spec_a + spec_b - align_size << " got: " << consensus_spec.size() << "\n";
+        }
+      }
+      rt_average /= sacrifices.size() + 1;
+      consensus_spec.setRT(rt_average);
+
+      if (ms_level >= 2)
+      {
+        if (precursor_count)
+        {
+          precursor_mz_average /= precursor_count;
+        }
+        std::vector<Precursor> pcs = consensus_spec.getPrecursors();
+        //if (pcs.size()>1) OPENMS_LOG_WARN << "Removing excessive precursors - leaving only one per MS2 spectrum.\n";
+        pcs.resize(1);
+        pcs[0].setMZ(precursor_mz_average);
+        consensus_spec.setPrecursors(pcs);
+      }
+    }
+
+    /**
+      @brief clusters MS2 spectra by their precursors (single linkage)
+
+      Two precursors are linked if their RT and m/z distances are within the
+      tolerances (i.e. their SpectraDistance_ similarity is larger than zero);
+      a cluster is a connected component of this graph. Candidates are only
+      compared within the m/z tolerance window after sorting by m/z, which
+      avoids the full pairwise distance matrix.
+
+      @param data Precursors (RT and m/z) to be clustered
+      @param clusters Resulting clusters of indices into @p data, each sorted ascending, ordered by their first (smallest) element
+    */
+    void clusterPrecursors_(const std::vector<BaseFeature>& data, std::vector<std::vector<Size> >& clusters) const;
+
+    /// merges consecutive sorted runs of @p values (delimited by @p run_bounds, starting with 0 and ending with values.size()) into one sorted range
+    template <typename ValueType, typename Compare>
+    static void mergeSortedRuns_(std::vector<ValueType>& values, std::vector<Size> run_bounds, Compare comp)
+    {
+      // pairwise (bottom-up) merging; std::inplace_merge is stable
+      while (run_bounds.size() > 2)
+      {
+        std::vector<Size> merged_bounds(1, 0);
+        Size i = 0;
+        for (; i + 2 < run_bounds.size(); i += 2)
+        {
+          std::inplace_merge(values.begin() + run_bounds[i], values.begin() + run_bounds[i + 1], values.begin() + run_bounds[i + 2], comp);
+          merged_bounds.push_back(run_bounds[i + 2]);
+        }
+        if (i + 2 == run_bounds.size()) // odd number of runs: the last one is left for the next round
+        {
+          merged_bounds.push_back(run_bounds.back());
+        }
+        run_bounds.swap(merged_bounds);
+      }
+    }
+
     /**
      * @brief average spectra (profile mode)
      *
@@ -691,23 +747,32 @@ protected:
     template <typename MapType>
     void averageProfileSpectra_(MapType& exp, const AverageBlocks& spectra_to_average_over, const UInt ms_level)
     {
-      MapType exp_tmp; // temporary experiment for averaged spectra
-
       double mz_binning_width(param_.getValue("mz_binning_width"));
       String mz_binning_unit(param_.getValue("mz_binning_width_unit"));
 
-      unsigned progress = 0;
+      // blocks are independent of each other, average them in parallel
+      std::vector<AverageBlocks::ConstIterator> blocks;
+      blocks.reserve(spectra_to_average_over.size());
+      for (AverageBlocks::ConstIterator it = spectra_to_average_over.begin(); it != spectra_to_average_over.end(); ++it)
+      {
+        blocks.push_back(it);
+      }
+      std::vector<typename MapType::SpectrumType> averaged_spectra(blocks.size()); // temporary storage for averaged spectra
+
+      Size progress = 0;
       std::stringstream progress_message;
       progress_message << "averaging profile spectra of MS level " << ms_level;
       startProgress(0, spectra_to_average_over.size(), progress_message.str());
 
       // loop over blocks
-      for (AverageBlocks::ConstIterator it = spectra_to_average_over.begin(); it != spectra_to_average_over.end(); ++it)
+#pragma omp parallel for schedule(dynamic)
+      for (SignedSize b = 0; b < (SignedSize)blocks.size(); ++b)
       {
-        setProgress(++progress);
+        AverageBlocks::ConstIterator it = blocks[b];
 
         // loop over spectra in blocks
         std::vector<double> mz_positions_all; // m/z positions from all spectra
+        std::vector<Size> run_bounds(1, 0); // each spectrum contributes a run of m/z positions
         for (std::vector<std::pair<Size, double> >::const_iterator it2 = it->second.begin(); it2 != it->second.end(); ++it2)
         {
           // loop over m/z positions
@@ -715,9 +780,15 @@ protected:
           {
             mz_positions_all.push_back(it_mz->getMZ());
           }
+          if (!exp[it2->first].isSorted())
+          {
+            std::sort(mz_positions_all.begin() + run_bounds.back(), mz_positions_all.end());
+          }
+          run_bounds.push_back(mz_positions_all.size());
         }
 
-        sort(mz_positions_all.begin(), mz_positions_all.end());
+        // the spectra are (usually) sorted already, so a k-way merge of their m/z positions replaces a full sort
+        mergeSortedRuns_(mz_positions_all, run_bounds, std::less<double>());
 
         std::vector<double> mz_positions; // positions at which the averaged spectrum should be evaluated
         std::vector<double> intensities;
@@ -755,11 +826,13 @@ protected:
         }
 
         // update spectrum
-        typename MapType::SpectrumType average_spec = exp[it->first];
+        typename MapType::SpectrumType& average_spec = averaged_spectra[b];
+        average_spec = exp[it->first];
         average_spec.clear(false); // Precursors are part of the meta data, which are not deleted.
         //average_spec.setMSLevel(ms_level);
 
         // refill spectrum
+        average_spec.reserve(mz_positions.size());
         for (Size i = 0; i < mz_positions.size(); ++i)
         {
           typename MapType::PeakType peak;
@@ -768,20 +841,16 @@ protected:
           average_spec.push_back(peak);
         }
 
-        // store spectrum temporarily
-        exp_tmp.addSpectrum(average_spec);
+#pragma omp critical (OpenMS_SpectraMerger_progress)
+        setProgress(++progress);
       }
 
       endProgress();
 
       // loop over blocks
-      int n(0);
-      //typename MapType::SpectrumType empty_spec;
-      for (AverageBlocks::ConstIterator it = spectra_to_average_over.begin(); it != spectra_to_average_over.end(); ++it)
+      for (Size n = 0; n < blocks.size(); ++n)
       {
-        exp[it->first] = exp_tmp[n];
-        //exp_tmp[n] = empty_spec;
-        ++n;
+        exp[blocks[n]->first] = std::move(averaged_spectra[n]);
       }
 
     }
@@ -804,25 +873,34 @@ protected:
     template <typename MapType>
     void averageCentroidSpectra_(MapType& exp, const AverageBlocks& spectra_to_average_over, const UInt ms_level)
     {
-      MapType exp_tmp; // temporary experiment for averaged spectra
-
       double mz_binning_width(param_.getValue("mz_binning_width"));
       String mz_binning_unit(param_.getValue("mz_binning_width_unit"));
 
-      unsigned progress = 0;
+      // blocks are independent of each other, average them in parallel
+      std::vector<AverageBlocks::ConstIterator> blocks;
+      blocks.reserve(spectra_to_average_over.size());
+      for (AverageBlocks::ConstIterator it = spectra_to_average_over.begin(); it != spectra_to_average_over.end(); ++it)
+      {
+        blocks.push_back(it);
+      }
+      std::vector<typename MapType::SpectrumType> averaged_spectra(blocks.size()); // temporary storage for averaged spectra
+
+      Size progress = 0;
       ProgressLogger logger;
       std::stringstream progress_message;
       progress_message << "averaging centroid spectra of MS level " << ms_level;
       logger.startProgress(0, spectra_to_average_over.size(), progress_message.str());
 
       // loop over blocks
-      for (AverageBlocks::ConstIterator it = spectra_to_average_over.begin(); it != spectra_to_average_over.end(); ++it)
+#pragma omp parallel for schedule(dynamic)
+      for (SignedSize b = 0; b < (SignedSize)blocks.size(); ++b)
       {
-        logger.setProgress(++progress);
+        AverageBlocks::ConstIterator it = blocks[b];
 
         // collect peaks from all spectra
         // loop over spectra in blocks
         std::vector<std::pair<double, double> > mz_intensity_all; // m/z positions and peak intensities from all spectra
+        std::vector<Size> run_bounds(1, 0); // each spectrum contributes a run of peaks
         for (std::vector<std::pair<Size, double> >::const_iterator it2 = it->second.begin(); it2 != it->second.end(); ++it2)
         {
           // loop over m/z positions
@@ -831,9 +909,15 @@ protected:
             std::pair<double, double> mz_intensity(it_mz->getMZ(), (it_mz->getIntensity() * it2->second)); // m/z, intensity * weight
             mz_intensity_all.push_back(mz_intensity);
           }
+          if (!exp[it2->first].isSorted())
+          {
+            std::stable_sort(mz_intensity_all.begin() + run_bounds.back(), mz_intensity_all.end(), SpectraMerger::compareByFirst);
+          }
+          run_bounds.push_back(mz_intensity_all.size());
         }
 
-        sort(mz_intensity_all.begin(), mz_intensity_all.end(), SpectraMerger::compareByFirst);
+        // the spectra are (usually) sorted already, so a k-way merge of their peaks replaces a full sort
+        mergeSortedRuns_(mz_intensity_all, run_bounds, SpectraMerger::compareByFirst);
 
         // generate new spectrum
         std::vector<double> mz_new;
@@ -873,11 +957,13 @@ protected:
         }
 
         // update spectrum
-        typename MapType::SpectrumType average_spec = exp[it->first];
+        typename MapType::SpectrumType& average_spec = averaged_spectra[b];
+        average_spec = exp[it->first];
         average_spec.clear(false); // Precursors are part of the meta data, which are not deleted.
         //average_spec.setMSLevel(ms_level);
 
         // refill spectrum
+        average_spec.reserve(mz_new.size());
         for (Size i = 0; i < mz_new.size(); ++i)
         {
           typename MapType::PeakType peak;
@@ -886,19 +972,16 @@ protected:
           average_spec.push_back(peak);
         }
 
-        // store spectrum temporarily
-        exp_tmp.addSpectrum(average_spec);
-
+#pragma omp critical (OpenMS_SpectraMerger_progress)
+        logger.setProgress(++progress);
       }
 
       logger.endProgress();
 
       // loop over blocks
-      int n(0);
-      for (AverageBlocks::ConstIterator it = spectra_to_average_over.begin(); it != spectra_to_average_over.end(); ++it)
+      for (Size n = 0; n < blocks.size(); ++n)
       {
-        exp[it->first] = exp_tmp[n];
-        ++n;
+        exp[blocks[n]->first] = std::move(averaged_spectra[n]);
       }
 
     }
@@ -0,0 +1,150 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/INTERFACES/IMSDataConsumer.h>
+
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/MSChromatogram.h>
+
+#include <functional>
+#include <vector>
+
+namespace OpenMS
+{
+
+  /**
+    @brief Consumer class that processes spectra and chromatograms in parallel
+    and passes them on in their original order
+
+    Spectra (or chromatograms) are buffered in batches of bounded size. Once a
+    batch is full, the processing function is applied to all its elements in
+    parallel (using OpenMP) and the results are handed to the downstream
+    consumer in the same order in which they were consumed. Memory usage is
+    therefore bounded by the batch size, independent of the file size.
+
+    The processing functions are called concurrently from several threads and
+    must be thread-safe (e.g. only call const methods of shared algorithm
+    objects). Spectra and chromatograms are never mixed within a batch, so the
+    overall order of the data is preserved as well.
+
+    The last (incomplete) batch is passed on when flush() is called or when the
+    consumer is destroyed. Make sure to destroy (or flush) this consumer before
+    the downstream consumer, e.g. before a MSDataWritingConsumer closes its file.
+
+    Usage:
+
+    @code
+    PlainMSDataWritingConsumer writer(outfile);
+    MSDataParallelConsumer parallel_consumer(&writer);
+    parallel_consumer.setSpectraProcessingFunc([&picker](MSSpectrum& s)
+    {
+      MSSpectrum picked;
+      picker.pick(s, picked);
+      s = std::move(picked);
+    });
+    MzMLFile().transform(infile, &parallel_consumer);
+    parallel_consumer.flush();
+    @endcode
+  */
+  class OPENMS_DLLAPI MSDataParallelConsumer :
+    public Interfaces::IMSDataConsumer
+  {
+  public:
+
+    /**
+      @brief Constructor
+
+      @param next_consumer Downstream consumer (ownership is not transferred)
+      @param batch_size Maximal number of spectra/chromatograms buffered before processing (0: 32 per thread)
+    */
+    explicit MSDataParallelConsumer(Interfaces::IMSDataConsumer* next_consumer, Size batch_size = 0);
+
+    /// Destructor (passes on remaining data, see flush())
+    ~MSDataParallelConsumer() override;
+
+    /// Set experimental settings for the downstream consumer
+    void setExperimentalSettings(const ExperimentalSettings& settings) override;
+
+    /// Set expected size for the downstream consumer
+    void setExpectedSize(Size s_size, Size c_size) override;
+
+    /// Buffer a spectrum; process and pass on the batch if it is full
+    void consumeSpectrum(SpectrumType& s) override;
+
+    /// Buffer a chromatogram; process and pass on the batch if it is full
+    void consumeChromatogram(ChromatogramType& c) override;
+
+    /**
+      @brief Sets the function applied (in parallel) to every spectrum
+
+      Pass a nullptr if spectra should be passed on unchanged.
+    */
+    void setSpectraProcessingFunc(std::function<void (SpectrumType&)> f_spec);
+
+    /**
+      @brief Sets the function applied (in parallel) to every chromatogram
+
+      Pass a nullptr if chromatograms should be passed on unchanged.
+    */
+    void setChromatogramProcessingFunc(std::function<void (ChromatogramType&)> f_chrom);
+
+    /**
+      @brief Process all buffered data and pass it on to the downstream consumer
+
+      @exception Exception::BaseException Exceptions thrown by the processing functions are rethrown (after the whole batch was processed)
+    */
+    void flush();
+
+    /// Return the maximal number of spectra/chromatograms that are buffered
+    Size getBatchSize() const;
+
+  protected:
+
+    /// Process and pass on buffered spectra
+    void flushSpectra_();
+
+    /// Process and pass on buffered chromatograms
+    void flushChromatograms_();
+
+    Interfaces::IMSDataConsumer* next_consumer_;
+    Size batch_size_;
+    std::vector<SpectrumType> spectra_;
+    std::vector<ChromatogramType> chromatograms_;
+    std::function<void (SpectrumType&)> lambda_spec_;
+    std::function<void (ChromatogramType&)> lambda_chrom_;
+  };
+
+} //end namespace OpenMS
+
@@ -102,6 +102,7 @@ namespace OpenMS
       PQP,                ///< OpenSWATH Peptide Query Parameter (PQP) SQLite DB, see TransitionPQPFile
       MS,                 ///< SIRIUS file format (.ms)
       OSW,                ///< OpenSWATH OpenSWATH report (OSW) SQLite DB
+      OMS,                ///< OpenMS SQLite format for IdentificationData, see OMSFile
       PSMS,               ///< Percolator tab-delimited output (PSM level)
       PIN,                ///< Percolator tab-delimited input (PSM level)
       PARAMXML,           ///< internal format for writing and reading parameters (also used as part of CTD)
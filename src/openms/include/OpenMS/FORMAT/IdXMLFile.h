@@ -90,6 +90,15 @@ public:
         The information is read in and the information is stored in the
         corresponding variables
 
+        If several OpenMP threads are available, uncompressed files are split
+        at the boundaries of their PeptideIdentification elements and the
+        resulting chunks are parsed concurrently (the rest of the document is
+        parsed serially first). The file is scanned block-wise and every chunk
+        is read from disk only when it is parsed, so the complete file is never
+        held in memory. The order of the identifications is the same
+        as for serial parsing. Peptide sequence strings are converted only once
+        per thread, regardless of how often they occur in the file.
+
         @exception Exception::FileNotFound is thrown if the file could not be opened
         @exception Exception::ParseError is thrown if an error occurs during parsing
     */
@@ -145,6 +154,27 @@ protected:
       * Helper function to parse fragment annotations from string
       */  
     static void parseFragmentAnnotation_(const String& s, std::vector<PeptideHit::PeakAnnotation> & annotations);
+
+    /**
+      @brief Parses the file with PeptideIdentification elements split into chunks that are processed in parallel
+
+      The members @p prot_ids_, @p pep_ids_ and @p document_id_ have to be set.
+
+      A first pass over the file records the offsets of the PeptideIdentification
+      elements and collects the remaining document. Each thread then reads its
+      chunks from the file with its own stream.
+
+      @return false (without touching any data) if the file is compressed or its
+      PeptideIdentification elements cannot be delimited reliably; the caller
+      then has to fall back to serial parsing.
+    */
+    bool parseChunked_(const String& filename);
+
+    /// Parses a chunk of PeptideIdentification elements belonging to the run with identifier @p identifier
+    void parsePeptideChunk_(const std::string& buffer, const String& identifier, std::vector<PeptideIdentification>& peptide_ids);
+
+    /// Returns the sequence for @p sequence, using the cache of already converted sequences
+    const AASequence& getSequence_(const String& sequence);
     
 
     /// @name members for loading data
@@ -179,6 +209,10 @@ protected:
     String* document_id_;
     /// true if a prot id is contained in the current run
     bool prot_id_in_run_;
+    /// Cache of converted peptide sequences (key is the sequence string)
+    std::unordered_map<std::string, AASequence> sequence_cache_;
+    /// Run identifiers of the PeptideIdentification chunks (in order of appearance)
+    std::vector<String> chunk_identifiers_;
     //@}
   };
 
@@ -43,6 +43,8 @@
 #include <OpenMS/DATASTRUCTURES/ListUtils.h> // StringList
 #include <OpenMS/INTERFACES/IMSDataConsumer.h>
 
+#include <fstream>
+
 namespace OpenMS
 {
   /**
@@ -133,7 +135,9 @@ public:
 
       @note Transformation can be speed up by setting skip_full_count which
       does not require a full first pass through the file to compute the
-      correct number of spectra and chromatograms in the input file.
+      correct number of spectra and chromatograms in the input file. For
+      indexed mzML files, the counts are taken from the index instead, so
+      the first pass only reads the header of the file.
 
       @param filename_in Filename of input mzML file to transform
       @param consumer Consumer class to operate on the input filename (implementing a transformation)
@@ -157,6 +161,29 @@ public:
     */
     void transform(const String& filename_in, Interfaces::IMSDataConsumer * consumer, PeakMap& map, bool skip_full_count = false, bool skip_first_pass = false);
 
+    /**
+      @brief Transforms an indexed mzML file in a single pass using several parser threads
+
+      The offsets in the <indexList> of the file provide the number of spectra
+      and chromatograms, so only the header of the file is parsed to obtain the
+      experimental settings (instead of a full first pass). The spectra and
+      chromatograms are then read in disjoint byte ranges, which are parsed in
+      parallel (each thread parses @p chunk_size elements at a time) and passed
+      to the consumer in their original order. At most one chunk per thread is
+      kept in memory.
+
+      The current PeakFileOptions are honored. If the file is not an indexed
+      mzML file (or the index is invalid), the regular transform() is used.
+
+      @param filename_in Filename of input mzML file to transform
+      @param consumer Consumer class to operate on the input filename (implementing a transformation)
+      @param chunk_size Number of spectra/chromatograms parsed by one thread at a time
+
+      @exception Exception::FileNotFound is thrown if the file could not be opened
+      @exception Exception::ParseError is thrown if an error occurs during parsing
+    */
+    void transformIndexed(const String& filename_in, Interfaces::IMSDataConsumer * consumer, Size chunk_size = 50);
+
     /**
       @brief Checks if a file validates against the XML schema.
 
@@ -201,9 +228,28 @@ public:
 
 protected:
 
-    /// Perform first pass through the file and retrieve the meta-data to initialize the consumer
+    /// Perform first pass through the file and retrieve the meta-data to initialize the consumer (uses the index of indexed mzML files for the counts)
     void transformFirstPass_(const String& filename_in, Interfaces::IMSDataConsumer * consumer, bool skip_full_count);
 
+    /// Parse only the header of the file to retrieve the meta-data and initialize the consumer with the given counts
+    void transformHeader_(const String& filename_in, Interfaces::IMSDataConsumer * consumer, Size scount, Size ccount);
+
+    /**
+      @brief Parse the spectra or chromatograms at the given offsets in parallel and pass them to the consumer in order
+
+      @param ifs Input file stream (binary mode)
+      @param offsets Start offsets of the elements (sorted)
+      @param list_end Offset of the end tag of the list (i.e. end of the last element)
+      @param document_start Content of the file up to the start of the list element of the first list in the file
+      @param list_start Start tag of the list element (containing a "count" attribute)
+      @param is_spectrum Whether the elements are spectra (otherwise: chromatograms)
+      @param consumer Consumer to pass the elements to
+      @param chunk_size Number of elements parsed by one thread at a time
+    */
+    void transformIndexedList_(std::ifstream& ifs, const std::vector<std::pair<std::string, std::streampos> >& offsets, std::streampos list_end,
+                               const std::string& document_start, const std::string& list_start, bool is_spectrum,
+                               Interfaces::IMSDataConsumer * consumer, Size chunk_size);
+
     /// Safe parse that catches exceptions and handles them accordingly
     void safeParse_(const String & filename, Internal::XMLHandler * handler);
 
@@ -0,0 +1,106 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/METADATA/ID/IdentificationData.h>
+#include <OpenMS/CONCEPT/ProgressLogger.h>
+
+namespace OpenMS
+{
+  /**
+    @brief Binary (SQLite-based) storage format for IdentificationData
+
+    An OMS file is an SQLite database with one table per type of data in
+    IdentificationData (input files, score types, processing steps, data
+    queries, parent molecules, identified molecules, query matches, groups).
+    Every stored object gets a stable integer ID, which is used for all
+    references between the tables. Scores and meta values are kept in
+    separate "long" tables (one row per value, and one row per element for
+    list meta values), so that they can be queried directly with SQL without
+    reconstructing the whole data structure. Units of meta values are kept.
+
+    This allows chaining tools that operate on identification data without
+    a round-trip through idXML/mzTab.
+
+    Loading supports restricting the data to a single input file: reference
+    data (software, processing steps, search parameters, score types, parent
+    molecules) is always loaded, but data queries and matches are only read
+    for the given file.
+
+    @ingroup FileIO
+  */
+  class OPENMS_DLLAPI OMSFile :
+    public ProgressLogger
+  {
+  public:
+    /// Schema version of the database
+    static const int VERSION;
+
+    /**
+      @brief Write out an IdentificationData object to an OMS file
+
+      An existing file will be overwritten.
+
+      @exception Exception::UnableToCreateFile is thrown if the file could not be created
+      @exception Exception::SqlOperationFailed is thrown if a database operation fails
+    */
+    void store(const String& filename, const IdentificationData& id_data);
+
+    /**
+      @brief Read in an OMS file and construct an IdentificationData object
+
+      @exception Exception::FileNotFound is thrown if the file does not exist
+      @exception Exception::ParseError is thrown if the file has an unsupported schema version
+      @exception Exception::SqlOperationFailed is thrown if a database operation fails
+    */
+    void load(const String& filename, IdentificationData& id_data);
+
+    /**
+      @brief Read in the part of an OMS file that belongs to one input file
+
+      Only data queries that reference @p input_file (and the matches and match groups based on them) are loaded;
+      identified molecules are only loaded if they occur in one of those matches.
+
+      @exception Exception::FileNotFound is thrown if the file does not exist
+      @exception Exception::ElementNotFound is thrown if @p input_file is not contained in the file
+      @exception Exception::ParseError is thrown if the file has an unsupported schema version
+      @exception Exception::SqlOperationFailed is thrown if a database operation fails
+    */
+    void load(const String& filename, IdentificationData& id_data, const String& input_file);
+
+  protected:
+    /// Implementation of both @p load() variants (empty @p input_file: load everything)
+    void load_(const String& filename, IdentificationData& id_data, const String& input_file, bool restrict);
+  };
+}
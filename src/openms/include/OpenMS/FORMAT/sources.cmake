@@ -63,6 +63,7 @@ MzMLFile.h
 MzTab.h
 MzTabFile.h
 MzXMLFile.h
+OMSFile.h
 OMSSACSVFile.h
 OMSSAXMLFile.h
 OSWFile.h
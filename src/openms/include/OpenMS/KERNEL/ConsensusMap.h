@@ -132,6 +132,9 @@ public:
       /// Copy constructor
       ColumnHeader(const ColumnHeader&);
 
+      /// Assignment operator
+      ColumnHeader& operator=(const ColumnHeader&) = default;
+
       /// File name of the mzML file
       String filename;
       /// Label e.g. 'heavy' and 'light' for ICAT, or 'sample1' and 'sample2' for label-free quantitation
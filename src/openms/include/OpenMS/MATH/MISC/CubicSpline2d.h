@@ -36,6 +36,7 @@
 
 #include <OpenMS/OpenMSConfig.h>
 
+#include <cstddef>
 #include <vector>
 #include <map>
 
@@ -87,6 +88,18 @@ public:
      */
     double eval(double x) const;
 
+    /**
+     * @brief evaluates the spline at position x, starting the knot search at a hint
+     *
+     * When evaluating many positions in ascending order, pass the same @p segment
+     * to consecutive calls: the search then continues from the previous knot
+     * interval instead of bisecting all knots. Any value is a valid hint.
+     *
+     * @param x x-position
+     * @param segment index of the knot interval to start from; set to the interval containing x
+     */
+    double eval(double x, size_t& segment) const;
+
     /**
      * @brief evaluates derivative of spline at position x
      *
@@ -58,6 +58,8 @@ namespace OpenMS
       @brief Implements a mixture model of the inverse gumbel and the gauss distribution or a gaussian mixture.
 
       This class fits either a Gumbel distribution and a Gauss distribution to a set of data points or two Gaussian distributions using the EM algorithm.
+      Densities, posteriors and sums of each EM iteration are evaluated in parallel (in fixed blocks, so results do not depend on the number of threads).
+      For very large data sets (see parameter @p max_fit_points), the model is first fitted to quantiles of the scores and then refined on all scores.
       One can output the fit as a gnuplot formula using getGumbelGnuplotFormula() and getGaussGnuplotFormula() after fitting.
       @note All parameters are stored in GaussFitResult. In the case of the Gumbel distribution x0 and sigma represent the local parameter alpha and the scale parameter beta, respectively.
 
@@ -252,6 +254,24 @@ public:
       void tryGnuplot(const String& gp_file);
 
 private:
+      /**
+          @brief runs the EM algorithm for the Gauss (incorrect) / Gauss (correct) mixture, starting from the current parameters
+          @param x_scores the (transformed) scores to fit
+          @param plot_file if not null, a plot line is added for every iteration
+          @param good_fit false if the log likelihood decreased during fitting
+          @return false if the fit failed due to numerical instabilities
+      */
+      bool fitGaussGaussEM_(const std::vector<double>& x_scores, TextFile* plot_file, bool& good_fit);
+
+      /// runs the EM algorithm for the Gumbel (incorrect) / Gauss (correct) mixture, starting from the current parameters (see fitGaussGaussEM_())
+      bool fitGumbelGaussEM_(const std::vector<double>& x_scores, TextFile* plot_file, bool& good_fit);
+
+      /// adds the gnuplot command for the current parameters to @p file
+      void addPlotLine_(TextFile& file) const;
+
+      /// returns @p n evenly spaced quantiles of @p sorted_scores (empty if there are not more than @p n scores or @p n is 0)
+      static std::vector<double> sampleQuantiles_(const std::vector<double>& sorted_scores, Size n);
+
       /// transform different score types to a range and score orientation that the model can handle (engine string is assumed in upper-case)
       void processOutliers_(std::vector<double>& x_scores, const String& outlier_handling) const;
 
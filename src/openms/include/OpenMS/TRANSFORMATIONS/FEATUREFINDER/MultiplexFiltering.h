@@ -38,6 +38,7 @@
 #include <OpenMS/KERNEL/StandardTypes.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/CONCEPT/ProgressLogger.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/AveragineIsotopeTable.h>
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/MultiplexIsotopicPeakPattern.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/MultiplexFilteredPeak.h>
@@ -175,6 +176,19 @@ protected:
      */
     void blacklistPeak_(const MultiplexFilteredPeak& peak, unsigned pattern_idx);
     
+    /**
+     * @brief averagine isotope pattern for a given mass
+     *
+     * Looks up the first @em isotopes_per_peptide_max_ relative intensities in the
+     * shared averagine table for @em averagine_type_.
+     *
+     * @param mass    mass of the peptide (or nucleic acid)
+     * @param intensities    relative isotope intensities (output, @em isotopes_per_peptide_max_ entries)
+     *
+     * @throw Exception::InvalidParameter if the averagine type is invalid
+     */
+    void getAveragineIntensities_(double mass, std::vector<double>& intensities) const;
+
     /**
      * @brief check if the satellite peaks conform with the averagine model
      *
@@ -280,6 +294,11 @@ protected:
 
     String averagine_type_;
 
+    /**
+     * @brief precomputed averagine patterns for @em averagine_type_ (shared, null if the type is invalid)
+     */
+    const AveragineIsotopeTable* averagine_table_;
+
   };
 
 }
@@ -130,9 +130,9 @@ public:
     void pick(const MSChromatogram& input, MSChromatogram& output, std::vector<PeakBoundary>& boundaries, bool check_spacings = false) const;
 
     /**
-     * @brief Applies the peak-picking algorithm to a map (MSExperiment). This
-     * method picks peaks for each scan in the map consecutively. The resulting
-     * picked peaks are written to the output map.
+     * @brief Applies the peak-picking algorithm to a map (MSExperiment). The
+     * spectra and chromatograms of the map are picked in parallel (if OpenMP
+     * is enabled). The resulting picked peaks are written to the output map.
      *
      * @param input  input map in profile mode
      * @param output  output map with picked peaks
@@ -141,9 +141,9 @@ public:
     void pickExperiment(const PeakMap& input, PeakMap& output, const bool check_spectrum_type = true) const;
 
     /**
-     * @brief Applies the peak-picking algorithm to a map (MSExperiment). This
-     * method picks peaks for each scan in the map consecutively. The resulting
-     * picked peaks are written to the output map.
+     * @brief Applies the peak-picking algorithm to a map (MSExperiment). The
+     * spectra and chromatograms of the map are picked in parallel (if OpenMP
+     * is enabled). The resulting picked peaks are written to the output map.
      *
      * @param input  input map in profile mode
      * @param output  output map with picked peaks
@@ -158,9 +158,9 @@ public:
                         const bool check_spectrum_type = true) const;
 
     /**
-      @brief Applies the peak-picking algorithm to a map (MSExperiment). This
-      method picks peaks for each scan in the map consecutively. The resulting
-      picked peaks are written to the output map.
+      @brief Applies the peak-picking algorithm to a map (MSExperiment). The
+      spectra are read from disk sequentially and picked in parallel (if
+      OpenMP is enabled). The resulting picked peaks are written to the output map.
 
       Currently we have to give up const-correctness but we know that everything on disc is constant
     */
@@ -168,8 +168,18 @@ public:
 
 protected:
 
+    /// Scratch memory for picking (S/N estimator, contiguous copies of the data), reused across spectra/chromatograms of one thread
     template <typename ContainerType>
-    void pick_(const ContainerType& input, ContainerType& output, std::vector<PeakBoundary>& boundaries, bool check_spacings = true) const;
+    struct Workspace_;
+
+    template <typename ContainerType>
+    void pick_(const ContainerType& input, ContainerType& output, std::vector<PeakBoundary>& boundaries, bool check_spacings, Workspace_<ContainerType>& workspace) const;
+
+    /// Picks a single spectrum (including copying its meta data) using the given workspace
+    void pickSpectrum_(const MSSpectrum& input, MSSpectrum& output, std::vector<PeakBoundary>& boundaries, bool check_spacings, Workspace_<MSSpectrum>& workspace) const;
+
+    /// Picks a single chromatogram (including copying its meta data) using the given workspace
+    void pickChromatogram_(const MSChromatogram& input, MSChromatogram& output, std::vector<PeakBoundary>& boundaries, bool check_spacings, Workspace_<MSChromatogram>& workspace) const;
 
     // signal-to-noise parameter
     double signal_to_noise_;
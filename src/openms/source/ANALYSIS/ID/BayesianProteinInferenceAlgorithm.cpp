@@ -46,7 +46,11 @@
 #include <OpenMS/FORMAT/IdXMLFile.h>
 #include <OpenMS/CONCEPT/VersionInfo.h>
 
+#include <array>
+#include <map>
+#include <memory>
 #include <set>
+#include <unordered_map>
 
 using namespace std;
 using namespace OpenMS::Internal;
@@ -54,6 +58,82 @@ using namespace OpenMS::Internal;
 namespace OpenMS
 {
 
+  namespace
+  {
+    /// Runs loopy belief propagation on @p ig with the settings from the "loopy_belief_propagation" section of
+    /// @p param and returns the posteriors of @p posteriorVars. @p nrMessages is set to the number of passed messages.
+    /// Throws std::runtime_error if the inference fails.
+    vector<evergreen::LabeledPMF<IDBoostGraph::vertex_t>> runLoopyBeliefPropagation(
+        evergreen::InferenceGraph<IDBoostGraph::vertex_t>& ig,
+        const Param& param,
+        unsigned long nrEdges,
+        const vector<vector<IDBoostGraph::vertex_t>>& posteriorVars,
+        unsigned long& nrMessages)
+    {
+      unsigned long maxMessages = param.getValue("loopy_belief_propagation:max_nr_iterations");
+      double initDampeningLambda = param.getValue("loopy_belief_propagation:dampening_lambda");
+      double initConvergenceThreshold = param.getValue("loopy_belief_propagation:convergence_threshold");
+      String scheduler_type = param.getValue("loopy_belief_propagation:scheduling_type");
+
+      std::unique_ptr<evergreen::Scheduler<IDBoostGraph::vertex_t>> scheduler;
+      if (scheduler_type == "subtree")
+      {
+        scheduler.reset(new evergreen::RandomSubtreeScheduler<IDBoostGraph::vertex_t>(initDampeningLambda,
+                                                                                       initConvergenceThreshold,
+                                                                                       maxMessages));
+      }
+      else if (scheduler_type == "fifo")
+      {
+        scheduler.reset(new evergreen::FIFOScheduler<IDBoostGraph::vertex_t>(initDampeningLambda,
+                                                                              initConvergenceThreshold,
+                                                                              maxMessages));
+      }
+      else // "priority" is also the fallback
+      {
+        scheduler.reset(new evergreen::PriorityScheduler<IDBoostGraph::vertex_t>(initDampeningLambda,
+                                                                                  initConvergenceThreshold,
+                                                                                  maxMessages));
+      }
+      scheduler->add_ab_initio_edges(ig);
+
+      evergreen::BeliefPropagationInferenceEngine<IDBoostGraph::vertex_t> bpie(*scheduler, ig);
+
+      vector<evergreen::LabeledPMF<IDBoostGraph::vertex_t>> posteriorFactors;
+      unsigned long nrEdgesSq = nrEdges*nrEdges;
+      if (maxMessages < nrEdgesSq * 3ul)
+      {
+        posteriorFactors = bpie.estimate_posteriors_in_steps(posteriorVars,
+        {
+            std::make_tuple(maxMessages, initDampeningLambda, initConvergenceThreshold)});
+      }
+      else
+      {
+        posteriorFactors = bpie.estimate_posteriors_in_steps(posteriorVars,
+        {
+            std::make_tuple(std::max<unsigned long>(10000ul, nrEdgesSq*2ul), initDampeningLambda, initConvergenceThreshold),
+            std::make_tuple(nrEdgesSq, std::min(0.49,initDampeningLambda*10), std::min(0.01,initConvergenceThreshold*10)),
+            std::make_tuple(nrEdgesSq/2ul, std::min(0.49,initDampeningLambda*100), std::min(0.01,initConvergenceThreshold*100))
+        });
+      }
+      nrMessages = bpie.getNrMessagesPassed();
+      return posteriorFactors;
+    }
+
+    /// Probability of presence from a posterior factor
+    double posteriorOfPresence(const evergreen::LabeledPMF<IDBoostGraph::vertex_t>& posteriorFactor)
+    {
+      double posterior = 1.0;
+      const evergreen::PMF &pmf = posteriorFactor.pmf();
+      // If Index 0 is in the range of this result PMFFactor its probability is non-zero
+      // and the prob of presence is 1-P(p=0). Important in multi-value factors like protein groups.
+      if (0 >= pmf.first_support()[0] && 0 <= pmf.last_support()[0])
+      {
+        posterior = 1. - pmf.table()[0ul];
+      }
+      return posterior;
+    }
+  }
+
   /// A functor that specifies what to do on a connected component (IDBoostGraph::FilteredGraph)
   class BayesianProteinInferenceAlgorithm::GraphInferenceFunctor
       //: public std::function<unsigned long(IDBoostGraph::Graph&)>
@@ -197,82 +277,15 @@ namespace OpenMS
           evergreen::InferenceGraph <IDBoostGraph::vertex_t> ig = bigb.to_graph();
           graph_mp_ownership_acquired = true;
 
-          unsigned long maxMessages = param_
-              .getValue("loopy_belief_propagation:max_nr_iterations");
-          double initDampeningLambda = param_
-              .getValue("loopy_belief_propagation:dampening_lambda");
-          double initConvergenceThreshold = param_.getValue(
-              "loopy_belief_propagation:convergence_threshold");
-          String scheduler_type = param_.getValue(
-              "loopy_belief_propagation:scheduling_type");
-
-          evergreen::Scheduler<IDBoostGraph::vertex_t>* scheduler;
-          if (scheduler_type == "priority")
-          {
-             scheduler =
-                new evergreen::PriorityScheduler<IDBoostGraph::vertex_t>(initDampeningLambda,
-                                                                     initConvergenceThreshold,
-                                                                     maxMessages);
-          }
-          else if (scheduler_type == "subtree")
-          {
-            scheduler =
-                new evergreen::RandomSubtreeScheduler<IDBoostGraph::vertex_t>(initDampeningLambda,
-                                                                          initConvergenceThreshold,
-                                                                          maxMessages);
-          }
-          else if (scheduler_type == "fifo")
-          {
-            scheduler =
-                new evergreen::FIFOScheduler<IDBoostGraph::vertex_t>(initDampeningLambda,
-                                                                 initConvergenceThreshold,
-                                                                 maxMessages);
-          }
-          else
-          {
-            scheduler =
-                new evergreen::PriorityScheduler<IDBoostGraph::vertex_t>(initDampeningLambda,
-                                                                     initConvergenceThreshold,
-                                                                     maxMessages);
-          }
-          scheduler->add_ab_initio_edges(ig);
-
-          evergreen::BeliefPropagationInferenceEngine<IDBoostGraph::vertex_t> bpie(*scheduler, ig);
-
-          vector<evergreen::LabeledPMF<IDBoostGraph::vertex_t>> posteriorFactors;
-          unsigned long nrEdgesSq = nrEdges*nrEdges;
-          if (maxMessages < nrEdgesSq * 3ul)
-          {
-            posteriorFactors = bpie.estimate_posteriors_in_steps(posteriorVars,
-            {
-                std::make_tuple(maxMessages, initDampeningLambda, initConvergenceThreshold)});
-          }
-          else
-          {
-            posteriorFactors = bpie.estimate_posteriors_in_steps(posteriorVars,
-            {
-                std::make_tuple(std::max<unsigned long>(10000ul, nrEdgesSq*2ul), initDampeningLambda, initConvergenceThreshold),
-                std::make_tuple(nrEdgesSq, std::min(0.49,initDampeningLambda*10), std::min(0.01,initConvergenceThreshold*10)),
-                std::make_tuple(nrEdgesSq/2ul, std::min(0.49,initDampeningLambda*100), std::min(0.01,initConvergenceThreshold*100))
-            });
-          }
-
-          // TODO move the writing of statistics from IDBoostGraph here and write more stats
-          //  like nr messages and failure/success
-          unsigned long nrMessagesNeeded = bpie.getNrMessagesPassed();
+          unsigned long nrMessagesNeeded = 0;
+          vector<evergreen::LabeledPMF<IDBoostGraph::vertex_t>> posteriorFactors =
+              runLoopyBeliefPropagation(ig, param_, nrEdges, posteriorVars, nrMessagesNeeded);
 
           for (auto const &posteriorFactor : posteriorFactors)
           {
-            double posterior = 1.0;
+            double posterior = posteriorOfPresence(posteriorFactor);
             IDBoostGraph::SetPosteriorVisitor pv;
             IDBoostGraph::vertex_t nodeId = posteriorFactor.ordered_variables()[0];
-            const evergreen::PMF &pmf = posteriorFactor.pmf();
-            // If Index 0 is in the range of this result PMFFactor its probability is non-zero
-            // and the prob of presence is 1-P(p=0). Important in multi-value factors like protein groups.
-            if (0 >= pmf.first_support()[0] && 0 <= pmf.last_support()[0])
-            {
-              posterior = 1. - pmf.table()[0ul];
-            }
             auto bound_visitor = std::bind(pv, std::placeholders::_1, posterior);
             boost::apply_visitor(bound_visitor, fg[nodeId]);
           }
@@ -521,6 +534,320 @@ namespace OpenMS
   };
 
 
+  /// Evaluates all grid points of the parameter search concurrently. The factor structure of every connected
+  /// component is extracted once; per grid point only the factors that depend on alpha, beta or gamma are recreated.
+  /// Posteriors are kept in per-thread buffers instead of being written into the graph.
+  /// The evaluation is the same as in GridSearchEvaluator (protein groups are scored if they are annotated).
+  class BayesianProteinInferenceAlgorithm::ParallelGridSearchEvaluator
+  {
+  public:
+    ParallelGridSearchEvaluator(const Param& param, IDBoostGraph& ibg):
+        param_(param)
+    {
+      regularize_ = param_.getValue("model_parameters:regularize").toBool();
+      user_defined_priors_ = param_.getValue("user_defined_priors").toBool();
+      pnorm_ = param_.getValue("loopy_belief_propagation:p_norm_inference");
+      if (pnorm_ <= 0)
+      {
+        pnorm_ = std::numeric_limits<double>::infinity();
+      }
+      pep_prior_ = param_.getValue("model_parameters:pep_prior");
+      aucweight_ = param_.getValue("param_optimize:aucweight");
+      annotate_groups_ = param_.getValue("annotate_group_probabilities").toBool();
+
+      // The following assumes that ALL proteins in the ID structure are used in the graph (as in GridSearchEvaluator)
+      const vector<ProteinHit>& hits = ibg.getProteinIDs().getHits();
+      unordered_map<const ProteinHit*, Size> hit_indices;
+      initial_scores_.reserve(hits.size());
+      labels_.reserve(hits.size());
+      for (const ProteinHit& hit : hits)
+      {
+        IDScoreGetterSetter::checkTDAnnotation_(hit);
+        hit_indices[&hit] = initial_scores_.size();
+        initial_scores_.push_back(hit.getScore());
+        labels_.push_back(IDScoreGetterSetter::getTDLabel_(hit));
+      }
+
+      components_.resize(ibg.getNrConnectedComponents());
+      #pragma omp parallel for schedule(dynamic)
+      for (SignedSize i = 0; i < static_cast<SignedSize>(components_.size()); ++i)
+      {
+        buildComponentModel_(ibg.getComponent(i), hit_indices, components_[i]);
+      }
+    }
+
+    /// Returns the evaluation score for each grid point (alpha, beta, gamma) in @p points
+    vector<double> evaluate(const vector<std::array<double, 3>>& points) const
+    {
+      vector<double> results(points.size(), 0.);
+      #pragma omp parallel for schedule(dynamic)
+      for (SignedSize i = 0; i < static_cast<SignedSize>(points.size()); ++i)
+      {
+        results[i] = evaluatePoint_(points[i][0], points[i][1], points[i][2]);
+      }
+      return results;
+    }
+
+  private:
+    /// Kind of a factor in a component. Cached factors do not depend on the grid parameters.
+    enum class FactorType {CACHED_TABLE, CACHED_ADDER, SUM_EVIDENCE, REGULARIZING_SUM_EVIDENCE, PROTEIN_PRIOR};
+
+    /// A factor of a component, in the order in which it is inserted into the factor graph
+    struct FactorSlot
+    {
+      FactorType type;
+      Size index; ///< index into the cached factors (cached types only)
+      size_t nr_parents;
+      IDBoostGraph::vertex_t in;
+      IDBoostGraph::vertex_t out;
+    };
+
+    /// Factor structure of one connected component
+    struct ComponentModel
+    {
+      vector<FactorSlot> factor_slots;
+      vector<evergreen::TableDependency<IDBoostGraph::vertex_t>> tables;
+      vector<evergreen::AdditiveDependency<IDBoostGraph::vertex_t>> adders;
+      vector<vector<IDBoostGraph::vertex_t>> posterior_vars; ///< protein nodes (and protein group nodes if groups are annotated)
+      unordered_map<IDBoostGraph::vertex_t, Size> hit_indices; ///< protein node -> index of the hit
+      unordered_map<IDBoostGraph::vertex_t, Size> group_indices; ///< protein group node -> index in group_scores
+      vector<Size> ungrouped_hits; ///< indices of the hits of proteins that are not part of a protein group
+      vector<double> group_scores; ///< scores of the protein groups before inference
+      vector<double> group_target_fractions; ///< fractions of target proteins in the protein groups
+      unsigned long nr_edges = 0;
+    };
+
+    void buildComponentModel_(const IDBoostGraph::Graph& fg,
+                              const unordered_map<const ProteinHit*, Size>& hit_indices,
+                              ComponentModel& model) const
+    {
+      IDBoostGraph::Graph::vertex_iterator ui, ui_end;
+
+      // entries used for evaluation with protein groups (see IDBoostGraph::getProteinGroupScoresAndTgtFraction),
+      // which includes components without inference
+      if (annotate_groups_)
+      {
+        for (boost::tie(ui,ui_end) = boost::vertices(fg); ui != ui_end; ++ui)
+        {
+          if (fg[*ui].which() == 0) // prot
+          {
+            IDBoostGraph::Graph::adjacency_iterator nbIt, nbIt_end;
+            boost::tie(nbIt, nbIt_end) = boost::adjacent_vertices(*ui, fg);
+            bool part_of_group = false;
+            for (; nbIt != nbIt_end; ++nbIt)
+            {
+              if (fg[*nbIt].which() == 1)
+              {
+                part_of_group = true;
+                break;
+              }
+            }
+            auto pos = hit_indices.find(boost::get<ProteinHit *>(fg[*ui]));
+            if (!part_of_group && pos != hit_indices.end())
+            {
+              model.ungrouped_hits.push_back(pos->second);
+            }
+          }
+          else if (fg[*ui].which() == 1) // prot group
+          {
+            const IDBoostGraph::ProteinGroup& pg = boost::get<IDBoostGraph::ProteinGroup>(fg[*ui]);
+            model.group_indices[*ui] = model.group_scores.size();
+            model.group_scores.push_back(pg.score);
+            model.group_target_fractions.push_back(static_cast<double>(pg.tgts) / pg.size);
+          }
+        }
+      }
+
+      // this skips CCs with just peps or prots (see GraphInferenceFunctor)
+      if (boost::num_vertices(fg) < 2) return;
+      model.nr_edges = boost::num_edges(fg);
+
+      // grid parameters are irrelevant for the factors created here
+      MessagePasserFactory<IDBoostGraph::vertex_t> mpf(0.5, 0.5, 0.5, pnorm_, pep_prior_);
+
+      boost::tie(ui,ui_end) = boost::vertices(fg);
+      vector<IDBoostGraph::vertex_t> in{};
+      for (; ui != ui_end; ++ui)
+      {
+        IDBoostGraph::Graph::adjacency_iterator nbIt, nbIt_end;
+        boost::tie(nbIt, nbIt_end) = boost::adjacent_vertices(*ui, fg);
+        in.clear();
+        for (; nbIt != nbIt_end; ++nbIt)
+        {
+          if (fg[*nbIt].which() < fg[*ui].which())
+          {
+            in.push_back(*nbIt);
+          }
+        }
+
+        if (fg[*ui].which() == 6) // pep hit = psm
+        {
+          const PeptideHit* hit = boost::get<PeptideHit *>(fg[*ui]);
+          model.factor_slots.push_back({regularize_ ? FactorType::REGULARIZING_SUM_EVIDENCE : FactorType::SUM_EVIDENCE,
+                                 0, hit->getPeptideEvidences().size(), in[0], *ui});
+          model.factor_slots.push_back({FactorType::CACHED_TABLE, model.tables.size(), 0, 0, 0});
+          model.tables.push_back(mpf.createPeptideEvidenceFactor(*ui, hit->getScore()));
+        }
+        else if (fg[*ui].which() == 2) // pep group
+        {
+          model.factor_slots.push_back({FactorType::CACHED_ADDER, model.adders.size(), 0, 0, 0});
+          model.adders.push_back(mpf.createPeptideProbabilisticAdderFactor(in, *ui));
+        }
+        else if (fg[*ui].which() == 1) // prot group
+        {
+          model.factor_slots.push_back({FactorType::CACHED_ADDER, model.adders.size(), 0, 0, 0});
+          model.adders.push_back(mpf.createPeptideProbabilisticAdderFactor(in, *ui));
+          if (annotate_groups_)
+          {
+            model.posterior_vars.push_back({*ui});
+          }
+        }
+        else if (fg[*ui].which() == 0) // prot
+        {
+          const ProteinHit* hit = boost::get<ProteinHit *>(fg[*ui]);
+          if (user_defined_priors_)
+          {
+            model.factor_slots.push_back({FactorType::CACHED_TABLE, model.tables.size(), 0, 0, 0});
+            model.tables.push_back(mpf.createProteinFactor(*ui, (double) hit->getMetaValue("Prior")));
+          }
+          else
+          {
+            model.factor_slots.push_back({FactorType::PROTEIN_PRIOR, 0, 0, 0, *ui});
+          }
+          model.posterior_vars.push_back({*ui});
+          auto pos = hit_indices.find(hit);
+          if (pos != hit_indices.end())
+          {
+            model.hit_indices[*ui] = pos->second;
+          }
+        }
+      }
+    }
+
+    double evaluatePoint_(double alpha, double beta, double gamma) const
+    {
+      if (beta - alpha >= 0.3 && alpha + beta <= 1.0)
+      {
+        #pragma omp critical (LOG_INFO_access)
+        OPENMS_LOG_INFO << "Skipping improbable parameter combination " << alpha << " " << beta << " " << gamma << std::endl;
+        return 0.;
+      }
+
+      MessagePasserFactory<IDBoostGraph::vertex_t> mpf(alpha, beta, gamma, pnorm_, pep_prior_);
+      vector<double> scores(initial_scores_);
+      ScoreToTgtDecLabelPairs scores_labels;
+      for (Size idx = 0; idx < components_.size(); ++idx)
+      {
+        const ComponentModel& model = components_[idx];
+        vector<double> group_scores(model.group_scores);
+        if (!model.factor_slots.empty())
+        {
+          evergreen::BetheInferenceGraphBuilder<IDBoostGraph::vertex_t> bigb;
+          bool graph_mp_ownership_acquired = false;
+          try
+          {
+            for (const FactorSlot& slot : model.factor_slots)
+            {
+              switch (slot.type)
+              {
+                case FactorType::CACHED_TABLE:
+                  bigb.insert_dependency(model.tables[slot.index]);
+                  break;
+                case FactorType::CACHED_ADDER:
+                  bigb.insert_dependency(model.adders[slot.index]);
+                  break;
+                case FactorType::SUM_EVIDENCE:
+                  bigb.insert_dependency(mpf.createSumEvidenceFactor(slot.nr_parents, slot.in, slot.out));
+                  break;
+                case FactorType::REGULARIZING_SUM_EVIDENCE:
+                  bigb.insert_dependency(mpf.createRegularizingSumEvidenceFactor(slot.nr_parents, slot.in, slot.out));
+                  break;
+                case FactorType::PROTEIN_PRIOR:
+                  bigb.insert_dependency(mpf.createProteinFactor(slot.out));
+                  break;
+              }
+            }
+            evergreen::InferenceGraph<IDBoostGraph::vertex_t> ig = bigb.to_graph();
+            graph_mp_ownership_acquired = true;
+
+            unsigned long nrMessages = 0;
+            for (const auto& posteriorFactor : runLoopyBeliefPropagation(ig, param_, model.nr_edges, model.posterior_vars, nrMessages))
+            {
+              IDBoostGraph::vertex_t node = posteriorFactor.ordered_variables()[0];
+              auto pos = model.hit_indices.find(node);
+              if (pos != model.hit_indices.end())
+              {
+                scores[pos->second] = posteriorOfPresence(posteriorFactor);
+                continue;
+              }
+              auto group_pos = model.group_indices.find(node);
+              if (group_pos != model.group_indices.end())
+              {
+                group_scores[group_pos->second] = posteriorOfPresence(posteriorFactor);
+              }
+            }
+          }
+          catch (const std::runtime_error& /*e*/)
+          {
+            // Graph builder needs to build otherwise it leaks memory.
+            if (!graph_mp_ownership_acquired) bigb.to_graph();
+            #pragma omp critical (LOG_WARN_access)
+            OPENMS_LOG_WARN << "Warning: Loopy belief propagation encountered a problem in a connected component. Skipping"
+                        " inference there." << std::endl;
+          }
+        }
+
+        // same entries as IDBoostGraph::getProteinGroupScoresAndTgtFraction
+        if (annotate_groups_)
+        {
+          for (Size hit : model.ungrouped_hits)
+          {
+            scores_labels.emplace_back(scores[hit], labels_[hit]);
+          }
+          for (Size group = 0; group < group_scores.size(); ++group)
+          {
+            scores_labels.emplace_back(group_scores[group], model.group_target_fractions[group]);
+          }
+        }
+      }
+
+      if (!annotate_groups_)
+      {
+        scores_labels.reserve(scores.size());
+        for (Size i = 0; i < scores.size(); ++i)
+        {
+          scores_labels.emplace_back(scores[i], labels_[i]);
+        }
+      }
+      std::sort(scores_labels.rbegin(), scores_labels.rend());
+
+      FalseDiscoveryRate fdr;
+      Param fdrparam = fdr.getParameters();
+      fdrparam.setValue("conservative", param_.getValue("param_optimize:conservative_fdr"));
+      fdrparam.setValue("add_decoy_proteins","true");
+      fdr.setParameters(fdrparam);
+      // same evaluation as in FalseDiscoveryRate::applyEvaluateProteinIDs, without its (unsynchronized) logging
+      double diff = fdr.diffEstimatedEmpirical(scores_labels, 1.0);
+      double auc = fdr.rocN(scores_labels, 100);
+      #pragma omp critical (LOG_INFO_access)
+      OPENMS_LOG_INFO << "Evaluated: " << alpha << " " << beta << " " << gamma
+                      << ": Difference estimated vs. T-D FDR = " << diff << " and roc100 = " << auc << std::endl;
+      return (1.0 - diff) * (1.0 - aucweight_) + auc * aucweight_;
+    }
+
+    const Param& param_;
+    bool regularize_;
+    bool user_defined_priors_;
+    double pnorm_;
+    double pep_prior_;
+    double aucweight_;
+    bool annotate_groups_;
+    vector<double> initial_scores_;
+    vector<bool> labels_;
+    vector<ComponentModel> components_;
+  };
+
+
   BayesianProteinInferenceAlgorithm::BayesianProteinInferenceAlgorithm(unsigned int debug_lvl) :
       DefaultParamHandler("BayesianProteinInferenceAlgorithm"),
       ProgressLogger(),
@@ -684,6 +1011,13 @@ namespace OpenMS
                        "Use a regularized FDR for proteins without unique peptides.");
     defaults_.setValidStrings("param_optimize:regularized_fdr", {"true","false"});
 
+    defaults_.setValue("param_optimize:parallel_grid_search",
+                       "false",
+                       "Evaluate the parameter combinations of the grid search in parallel instead of parallelizing over"
+                       " connected components. Factor structures of the components are built only once and reused for"
+                       " all combinations. Faster for many small components, but needs memory for one factor graph per thread.");
+    defaults_.setValidStrings("param_optimize:parallel_grid_search", {"true","false"});
+
 
     // write defaults into Param object param_
     defaultsToParam_();
@@ -919,7 +1253,35 @@ namespace OpenMS
     if (gs.getNrCombos() > 1)
     {
      OPENMS_LOG_INFO << "Testing " << gs.getNrCombos() << " param combinations." << std::endl;
-      /*double res =*/ gs.evaluate(GridSearchEvaluator(param_, ibg, debug_lvl_), -1.0, bestParams);
+      if (param_.getValue("param_optimize:parallel_grid_search").toBool() && !use_run_info)
+      {
+        // evaluate all points at once, then let the grid search pick the best one from the results
+        vector<std::array<double, 3>> points;
+        for (double alpha : alpha_search)
+        {
+          for (double beta : beta_search)
+          {
+            for (double gamma : gamma_search)
+            {
+              points.push_back({{alpha, beta, gamma}});
+            }
+          }
+        }
+        vector<double> results = ParallelGridSearchEvaluator(param_, ibg).evaluate(points);
+        std::map<std::array<double, 3>, double> results_by_point;
+        for (Size i = 0; i < points.size(); ++i)
+        {
+          results_by_point[points[i]] = results[i];
+        }
+        gs.evaluate([&results_by_point](double alpha, double beta, double gamma)
+                    {
+                      return results_by_point.at({{alpha, beta, gamma}});
+                    }, -1.0, bestParams);
+      }
+      else
+      {
+        /*double res =*/ gs.evaluate(GridSearchEvaluator(param_, ibg, debug_lvl_), -1.0, bestParams);
+      }
     }
     else
     {
@@ -0,0 +1,357 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/ID/MetaboliteSpectralLibraryIndex.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#define METABOLITE_SPECTRAL_LIBRARY_INDEX_IDENTIFIER 8096
+#define METABOLITE_SPECTRAL_LIBRARY_INDEX_VERSION 2
+
+using namespace std;
+
+namespace OpenMS
+{
+
+  namespace
+  {
+    /// Hash of the fragment m/z values of @p spectrum (FNV-1a over their bit patterns, independent of platform and run)
+    UInt64 fragmentFingerprint(const MSSpectrum& spectrum)
+    {
+      UInt64 hash = 14695981039346656037ULL;
+      for (const Peak1D& peak : spectrum)
+      {
+        const double mz = peak.getMZ();
+        UInt64 bits;
+        memcpy(&bits, &mz, sizeof(bits));
+        for (Size byte = 0; byte < sizeof(bits); ++byte)
+        {
+          hash ^= (bits >> (8 * byte)) & 0xff;
+          hash *= 1099511628211ULL;
+        }
+      }
+      return hash;
+    }
+
+    template <typename T>
+    void writeVector(ofstream& ofs, const vector<T>& data)
+    {
+      UInt64 size = data.size();
+      ofs.write((char*)&size, sizeof(size));
+      if (size > 0) ofs.write((char*)data.data(), size * sizeof(T));
+    }
+
+    /// Reads a vector written by writeVector(); its length is checked against the file size before allocating
+    template <typename T>
+    void readVector(ifstream& ifs, streamoff file_size, const String& filename, vector<T>& data)
+    {
+      UInt64 size = 0;
+      ifs.read((char*)&size, sizeof(size));
+      const streamoff remaining = ifs ? file_size - streamoff(ifs.tellg()) : -1;
+      if (remaining < 0 || size > UInt64(remaining) / sizeof(T))
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Spectral library index is truncated or inconsistent. Aborting!", filename);
+      }
+      data.resize(size);
+      if (size > 0) ifs.read((char*)data.data(), size * sizeof(T));
+    }
+  }
+
+  MetaboliteSpectralLibraryIndex::MetaboliteSpectralLibraryIndex() :
+    bin_size_(0.01)
+  {
+    bin_offset_.push_back(0);
+  }
+
+  void MetaboliteSpectralLibraryIndex::build(const PeakMap& library, double bin_size)
+  {
+    if (!(bin_size > 0))
+    {
+      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Bin size must be positive.");
+    }
+    bin_size_ = bin_size;
+
+    const Size n = library.size();
+    precursor_mz_.assign(n, -1.0);
+    precursor_charge_.assign(n, 0);
+    peak_count_.assign(n, 0);
+    fingerprint_.assign(n, 0);
+    bin_offset_.assign(n + 1, 0);
+
+    // fragment bins of each spectrum, computed in parallel and concatenated afterwards
+    vector<vector<UInt32> > spectrum_bins(n);
+#pragma omp parallel for schedule(dynamic, 256)
+    for (SignedSize i = 0; i < (SignedSize)n; ++i)
+    {
+      const MSSpectrum& spectrum = library[i];
+      if (!spectrum.getPrecursors().empty())
+      {
+        precursor_mz_[i] = spectrum.getPrecursors()[0].getMZ();
+        precursor_charge_[i] = spectrum.getPrecursors()[0].getCharge();
+      }
+      peak_count_[i] = (UInt32)spectrum.size();
+      fingerprint_[i] = fragmentFingerprint(spectrum);
+
+      vector<UInt32>& bins = spectrum_bins[i];
+      bins.reserve(spectrum.size());
+      for (const Peak1D& peak : spectrum)
+      {
+        bins.push_back(getBin_(peak.getMZ()));
+      }
+      sort(bins.begin(), bins.end());
+      bins.erase(unique(bins.begin(), bins.end()), bins.end());
+    }
+
+    for (Size i = 0; i < n; ++i)
+    {
+      bin_offset_[i + 1] = bin_offset_[i] + spectrum_bins[i].size();
+    }
+    bins_.clear();
+    bins_.reserve(bin_offset_[n]);
+    for (vector<UInt32>& bins : spectrum_bins)
+    {
+      bins_.insert(bins_.end(), bins.begin(), bins.end());
+      vector<UInt32>().swap(bins);
+    }
+
+    sortByPrecursor_();
+  }
+
+  Size MetaboliteSpectralLibraryIndex::size() const
+  {
+    return precursor_mz_.size();
+  }
+
+  double MetaboliteSpectralLibraryIndex::getBinSize() const
+  {
+    return bin_size_;
+  }
+
+  bool MetaboliteSpectralLibraryIndex::isIndexOf(const PeakMap& library) const
+  {
+    if (library.size() != size()) return false;
+    for (Size i = 0; i < library.size(); ++i)
+    {
+      const MSSpectrum& spectrum = library[i];
+      double precursor_mz = spectrum.getPrecursors().empty() ? -1.0 : spectrum.getPrecursors()[0].getMZ();
+      Int precursor_charge = spectrum.getPrecursors().empty() ? 0 : spectrum.getPrecursors()[0].getCharge();
+      if (precursor_mz != precursor_mz_[i] || precursor_charge != precursor_charge_[i] ||
+          spectrum.size() != peak_count_[i] || fragmentFingerprint(spectrum) != fingerprint_[i])
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void MetaboliteSpectralLibraryIndex::findCandidates(double mz_lower, double mz_upper, vector<Size>& candidates) const
+  {
+    candidates.clear();
+    vector<double>::const_iterator lower_it = lower_bound(sorted_mz_.begin(), sorted_mz_.end(), mz_lower);
+    vector<double>::const_iterator upper_it = upper_bound(sorted_mz_.begin(), sorted_mz_.end(), mz_upper);
+    if (lower_it >= upper_it) return;
+    candidates.assign(order_.begin() + (lower_it - sorted_mz_.begin()), order_.begin() + (upper_it - sorted_mz_.begin()));
+  }
+
+  double MetaboliteSpectralLibraryIndex::getPrecursorMZ(Size index) const
+  {
+    return precursor_mz_[index];
+  }
+
+  Int MetaboliteSpectralLibraryIndex::getPrecursorCharge(Size index) const
+  {
+    return precursor_charge_[index];
+  }
+
+  void MetaboliteSpectralLibraryIndex::getQueryBins(const MSSpectrum& spectrum, double fragment_mass_error, bool fragment_mass_tolerance_unit_ppm, QueryBins& query) const
+  {
+    query.clear();
+    query.reserve(spectrum.size());
+
+    vector<double> mzs;
+    mzs.reserve(spectrum.size());
+    for (const Peak1D& peak : spectrum)
+    {
+      mzs.push_back(peak.getMZ());
+    }
+    sort(mzs.begin(), mzs.end());
+
+    // with a ppm tolerance, a fragment at m/z f matches a peak at m/z p if
+    // |p - f| <= f * k, which implies |p - f| <= p * k / (1 - k)
+    const double k = fragment_mass_error * 1e-6;
+    const double ppm_factor = (k < 1.0) ? k / (1.0 - k) : numeric_limits<double>::max();
+    for (double mz : mzs)
+    {
+      double offset = fragment_mass_tolerance_unit_ppm ? mz * ppm_factor : fragment_mass_error;
+      // widen slightly, so that rounding can not exclude a matching fragment
+      offset = offset * (1.0 + 1e-9) + 1e-9;
+      query.emplace_back(getBin_(mz - offset), getBin_(mz + offset));
+    }
+  }
+
+  Size MetaboliteSpectralLibraryIndex::countMatchingPeaks(const QueryBins& query, Size index, Size max_count) const
+  {
+    vector<UInt32>::const_iterator bin_it = bins_.begin() + bin_offset_[index];
+    const vector<UInt32>::const_iterator bin_end = bins_.begin() + bin_offset_[index + 1];
+
+    // query ranges are ordered by their (non-decreasing) bounds, so the fragment bins are traversed once
+    Size count(0);
+    for (const pair<UInt32, UInt32>& range : query)
+    {
+      while (bin_it != bin_end && *bin_it < range.first) ++bin_it;
+      if (bin_it == bin_end) break;
+      if (*bin_it <= range.second && ++count >= max_count) break;
+    }
+    return count;
+  }
+
+  void MetaboliteSpectralLibraryIndex::store(const String& filename) const
+  {
+    ofstream ofs(filename.c_str(), ios::binary);
+    if (!ofs)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    int file_identifier = METABOLITE_SPECTRAL_LIBRARY_INDEX_IDENTIFIER;
+    int version = METABOLITE_SPECTRAL_LIBRARY_INDEX_VERSION;
+    ofs.write((char*)&file_identifier, sizeof(file_identifier));
+    ofs.write((char*)&version, sizeof(version));
+    ofs.write((char*)&bin_size_, sizeof(bin_size_));
+    writeVector(ofs, precursor_mz_);
+    writeVector(ofs, precursor_charge_);
+    writeVector(ofs, peak_count_);
+    writeVector(ofs, bin_offset_);
+    writeVector(ofs, bins_);
+    writeVector(ofs, fingerprint_);
+    if (!ofs)
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+  }
+
+  void MetaboliteSpectralLibraryIndex::load(const String& filename)
+  {
+    ifstream ifs(filename.c_str(), ios::binary);
+    if (!ifs)
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    int file_identifier = 0;
+    int version = 0;
+    ifs.read((char*)&file_identifier, sizeof(file_identifier));
+    if (file_identifier != METABOLITE_SPECTRAL_LIBRARY_INDEX_IDENTIFIER)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "File might not be a spectral library index (wrong file magic number). Aborting!", filename);
+    }
+    ifs.read((char*)&version, sizeof(version));
+    if (version != METABOLITE_SPECTRAL_LIBRARY_INDEX_VERSION)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Unsupported spectral library index version " + String(version) + ". Aborting!", filename);
+    }
+    // read into a new index, so this one is only replaced if the file is valid
+    MetaboliteSpectralLibraryIndex index;
+    ifs.read((char*)&index.bin_size_, sizeof(index.bin_size_));
+    if (!ifs || !(index.bin_size_ > 0) || !std::isfinite(index.bin_size_))
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Spectral library index has an invalid bin size. Aborting!", filename);
+    }
+
+    // vector lengths are checked against the file size, so a corrupt file can not request huge allocations
+    const streampos data_start = ifs.tellg();
+    ifs.seekg(0, ios::end);
+    const streamoff file_size = ifs.tellg();
+    ifs.seekg(data_start);
+    readVector(ifs, file_size, filename, index.precursor_mz_);
+    readVector(ifs, file_size, filename, index.precursor_charge_);
+    readVector(ifs, file_size, filename, index.peak_count_);
+    readVector(ifs, file_size, filename, index.bin_offset_);
+    readVector(ifs, file_size, filename, index.bins_);
+    readVector(ifs, file_size, filename, index.fingerprint_);
+
+    const Size n = index.precursor_mz_.size();
+    bool consistent = ifs && index.precursor_charge_.size() == n && index.peak_count_.size() == n && index.fingerprint_.size() == n &&
+                      index.bin_offset_.size() == n + 1 && index.bin_offset_.front() == 0 && index.bin_offset_.back() == index.bins_.size();
+    // the fragment bins of each spectrum must be a valid, sorted range of bins_
+    for (Size i = 0; consistent && i < n; ++i)
+    {
+      consistent = index.bin_offset_[i] <= index.bin_offset_[i + 1];
+      for (UInt64 j = index.bin_offset_[i] + 1; consistent && j < index.bin_offset_[i + 1]; ++j)
+      {
+        consistent = index.bins_[j - 1] < index.bins_[j];
+      }
+    }
+    if (!consistent)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Spectral library index is truncated or inconsistent. Aborting!", filename);
+    }
+    index.sortByPrecursor_();
+    *this = std::move(index);
+  }
+
+  UInt32 MetaboliteSpectralLibraryIndex::getBin_(double mz) const
+  {
+    double bin = floor(mz / bin_size_);
+    if (bin <= 0) return 0;
+    if (bin >= numeric_limits<UInt32>::max()) return numeric_limits<UInt32>::max();
+    return (UInt32)bin;
+  }
+
+  void MetaboliteSpectralLibraryIndex::sortByPrecursor_()
+  {
+    order_.clear();
+    for (Size i = 0; i < precursor_mz_.size(); ++i)
+    {
+      if (precursor_mz_[i] >= 0) order_.push_back(i);
+    }
+    stable_sort(order_.begin(), order_.end(), [this](Size a, Size b) { return precursor_mz_[a] < precursor_mz_[b]; });
+    sorted_mz_.resize(order_.size());
+    for (Size i = 0; i < order_.size(); ++i)
+    {
+      sorted_mz_[i] = precursor_mz_[order_[i]];
+    }
+  }
+
+}
@@ -439,14 +439,17 @@ namespace OpenMS
 
   void MetaboliteSpectralMatching::run(PeakMap& msexp, PeakMap& spec_db, MzTab& mztab_out)
   {
-    sort(spec_db.begin(), spec_db.end(), PrecursorMZLess);
+    MetaboliteSpectralLibraryIndex index;
+    index.build(spec_db);
+    run(msexp, spec_db, index, mztab_out);
+  }
 
-    vector<double> mz_keys;
 
-    // copy precursor m/z values to vector for searching
-    for (Size spec_idx = 0; spec_idx < spec_db.size(); ++spec_idx)
+  void MetaboliteSpectralMatching::run(PeakMap& msexp, const PeakMap& spec_db, const MetaboliteSpectralLibraryIndex& index, MzTab& mztab_out)
+  {
+    if (!index.isIndexOf(spec_db))
     {
-      mz_keys.push_back(spec_db[spec_idx].getPrecursors()[0].getMZ());
+      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "The spectral library index does not belong to the spectral library.");
     }
 
     // remove potential noise peaks by selecting the ten most intense peak per 100 Da window
@@ -466,16 +469,22 @@ namespace OpenMS
     wm.filterPeakMap(msexp);
 
 
-    // container storing results
-    vector<SpectralMatch> matching_results;
+    // container storing results (per spectrum, so they can be collected in parallel)
+    vector<vector<SpectralMatch> > spectrum_results(msexp.size());
 
     bool fragment_error_unit_ppm(true);
     if (mz_error_unit_ == "Da") { fragment_error_unit_ppm = false; }
 
-    for (Size spec_idx = 0; spec_idx < msexp.size(); ++spec_idx)
+#pragma omp parallel for schedule(dynamic)
+    for (SignedSize spec_idx = 0; spec_idx < (SignedSize)msexp.size(); ++spec_idx)
     {
       // cout << "merged spectrum no. " << spec_idx << " with #fragment ions: " << msexp[spec_idx].size() << endl;
 
+      vector<SpectralMatch>& matching_results = spectrum_results[spec_idx];
+      vector<Size> candidates;
+      MetaboliteSpectralLibraryIndex::QueryBins query_bins;
+      index.getQueryBins(msexp[spec_idx], fragment_mz_error_, fragment_error_unit_ppm, query_bins);
+
       // iterate over all precursor masses
       for (Size prec_idx = 0; prec_idx < msexp[spec_idx].getPrecursors().size(); ++prec_idx)
       {
@@ -501,23 +510,25 @@ namespace OpenMS
         // cout << "lower mz: " << prec_mz_lowerbound << " ";
         // cout << "upper mz: " << prec_mz_upperbound << endl;
 
-        vector<double>::const_iterator lower_it = lower_bound(mz_keys.begin(), mz_keys.end(), prec_mz_lowerbound);
-        vector<double>::const_iterator upper_it = upper_bound(mz_keys.begin(), mz_keys.end(), prec_mz_upperbound);
-
-        Size start_idx(lower_it - mz_keys.begin());
-        Size end_idx(upper_it - mz_keys.begin());
+        index.findCandidates(prec_mz_lowerbound, prec_mz_upperbound, candidates);
 
         //cout << "identifying " << msexp[spec_idx].getMetaValue("Massbank_Accession_ID") << endl;
 
         vector<SpectralMatch> partial_results;
 
-        for (Size search_idx = start_idx; search_idx < end_idx; ++search_idx)
+        for (Size search_idx : candidates)
         {
           // do spectral matching
           // cout << "scanning " << spec_db[search_idx].getPrecursors()[0].getMZ() << " " << spec_db[search_idx].getMetaValue("Metabolite_Name") << endl;
 
           // check for charge state of precursor ions: do they match?
-          if ( (ion_mode_ == "positive" && spec_db[search_idx].getPrecursors()[0].getCharge() < 0) || (ion_mode_ == "negative" && spec_db[search_idx].getPrecursors()[0].getCharge() > 0))
+          if ( (ion_mode_ == "positive" && index.getPrecursorCharge(search_idx) < 0) || (ion_mode_ == "negative" && index.getPrecursorCharge(search_idx) > 0))
+          {
+            continue;
+          }
+
+          // the hyperscore is zero with less than three matched peaks
+          if (index.countMatchingPeaks(query_bins, search_idx, 3) < 3)
           {
             continue;
           }
@@ -532,10 +543,10 @@ namespace OpenMS
             // score result temporarily
             SpectralMatch tmp_match;
             tmp_match.setObservedPrecursorMass(precursor_mz);
-            tmp_match.setFoundPrecursorMass(spec_db[search_idx].getPrecursors()[0].getMZ());
+            tmp_match.setFoundPrecursorMass(index.getPrecursorMZ(search_idx));
             double obs_rt = floor(msexp[spec_idx].getRT() * 10)/10.0;
             tmp_match.setObservedPrecursorRT(obs_rt);
-            tmp_match.setFoundPrecursorCharge(spec_db[search_idx].getPrecursors()[0].getCharge());
+            tmp_match.setFoundPrecursorCharge(index.getPrecursorCharge(search_idx));
             tmp_match.setMatchingScore(hyperscore);
             tmp_match.setObservedSpectrumIndex(spec_idx);
             tmp_match.setMatchingSpectrumIndex(search_idx);
@@ -553,7 +564,7 @@ namespace OpenMS
         }
 
         // sort results by decreasing store
-        sort(partial_results.begin(), partial_results.end(), SpectralMatchScoreGreater);
+        stable_sort(partial_results.begin(), partial_results.end(), SpectralMatchScoreGreater);
 
         // report mode: top3 or best?
         if (report_mode_ == "top3")
@@ -580,6 +591,12 @@ namespace OpenMS
       } // end precursor loop
     } // end spectra loop
 
+    vector<SpectralMatch> matching_results;
+    for (const vector<SpectralMatch>& results : spectrum_results)
+    {
+      matching_results.insert(matching_results.end(), results.begin(), results.end());
+    }
+
     // write final results to MzTab
     exportMzTab_(matching_results, mztab_out);
   }
@@ -31,6 +31,7 @@ IDDecoyProbability.cpp
 IDScoreGetterSetter.cpp
 IDScoreSwitcherAlgorithm.cpp
 MessagePasserFactory.cpp
+MetaboliteSpectralLibraryIndex.cpp
 MetaboliteSpectralMatching.cpp
 PeptideProteinResolution.cpp
 PrecursorPurity.cpp
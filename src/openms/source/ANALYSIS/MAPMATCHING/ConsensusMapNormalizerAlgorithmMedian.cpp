@@ -39,6 +39,10 @@
 #include <OpenMS/METADATA/ProteinIdentification.h>
 #include <boost/regex.hpp>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace std;
 
 namespace OpenMS
@@ -84,11 +88,12 @@ namespace OpenMS
     }
 
     // fill feature_int with intensities
+    const vector<char> passes = computeFilterResults_(map, acc_filter, desc_filter);
     Size pass_counter = 0;
     ConsensusMap::ConstIterator cf_it;
     for (cf_it = map.begin(); cf_it != map.end(); ++cf_it)
     {
-      if (!passesFilters_(cf_it, map, acc_filter, desc_filter))
+      if (!passes[cf_it - map.begin()])
       {
         continue;
       }
@@ -124,8 +129,9 @@ namespace OpenMS
     }
     else
     {
-      //compute medians
-      for (UInt j = 0; j < number_of_maps; j++)
+      //compute medians (independently for each map)
+#pragma omp parallel for schedule(dynamic)
+      for (SignedSize j = 0; j < (SignedSize)number_of_maps; j++)
       {
         vector<double>& ints_j = feature_int[j];
         medians[j] = Math::median(ints_j.begin(), ints_j.end());
@@ -142,7 +148,6 @@ namespace OpenMS
       OPENMS_LOG_WARN << endl << "WARNING: normalization using median shifting is not recommended for regular log-normal MS data. Use this only if you know exactly what you're doing!" << endl << endl;
     }
 
-    ConsensusMap::Iterator cf_it;
     ProgressLogger progresslogger;
     progresslogger.setLogType(ProgressLogger::CMD);
     progresslogger.startProgress(0, map.size(), "normalizing maps");
@@ -150,11 +155,25 @@ namespace OpenMS
     vector<double> medians;
     Size index_of_largest_map = computeMedians(map, medians, acc_filter, desc_filter);
 
-    for (cf_it = map.begin(); cf_it != map.end(); ++cf_it)
+    // shift to median of map with largest median in order to avoid negative intensities
+    double max_median(numeric_limits<double>::min());
+    Size max_median_index(0);
+    for (Size i = 0; i < medians.size(); ++i)
+    {
+      if (medians[i] > max_median)
+      {
+        max_median = medians[i];
+        max_median_index = i;
+      }
+    }
+
+    // consensus features are normalized independently
+#pragma omp parallel for schedule(dynamic, 1000)
+    for (SignedSize i = 0; i < (SignedSize)map.size(); ++i)
     {
-      progresslogger.setProgress(cf_it - map.begin());
+      IF_MASTERTHREAD progresslogger.setProgress(i);
       ConsensusFeature::HandleSetType::const_iterator f_it;
-      for (f_it = cf_it->getFeatures().begin(); f_it != cf_it->getFeatures().end(); ++f_it)
+      for (f_it = map[i].getFeatures().begin(); f_it != map[i].getFeatures().end(); ++f_it)
       {
         Size map_index = f_it->getMapIndex();
         if (method == NM_SCALE)
@@ -164,17 +183,6 @@ namespace OpenMS
         }
         else // method == NM_SHIFT
         {
-          // shift to median of map with largest median in order to avoid negative intensities
-          double max_median(numeric_limits<double>::min());
-          Size max_median_index(0);
-          for (Size i = 0; i < medians.size(); ++i)
-          {
-            if (medians[i] > max_median)
-            {
-              max_median = medians[i];
-              max_median_index = i;
-            }
-          }
           f_it->asMutable().setIntensity(f_it->getIntensity() + medians[max_median_index] - medians[map_index]);
         }
       }
@@ -239,4 +247,88 @@ namespace OpenMS
     return false;
   }
 
+  vector<char> ConsensusMapNormalizerAlgorithmMedian::computeFilterResults_(const ConsensusMap& map, const String& acc_filter, const String& desc_filter)
+  {
+    vector<char> result(map.size(), 1);
+
+    boost::regex acc_regexp(acc_filter);
+    boost::regex desc_regexp(desc_filter);
+    boost::cmatch m;
+    const bool all_accessions = acc_filter == "" || boost::regex_search("", m, acc_regexp);
+    const bool all_descriptions = desc_filter == "" || boost::regex_search("", m, desc_regexp);
+
+    if (all_accessions && all_descriptions)
+    {
+      // all features pass (even if they have no identification!)
+      return result;
+    }
+
+    // descriptions of the (first) protein hit with a given accession in each protein identification run
+    std::map<String, vector<String> > descriptions;
+    if (!all_descriptions)
+    {
+      for (const ProteinIdentification& prot_id : map.getProteinIdentifications())
+      {
+        set<String> run_accessions;
+        for (const ProteinHit& hit : prot_id.getHits())
+        {
+          if (run_accessions.insert(hit.getAccession()).second)
+          {
+            descriptions[hit.getAccession()].push_back(hit.getDescription());
+          }
+        }
+      }
+    }
+
+    // filter results per protein accession
+    std::map<String, bool> accession_passes;
+    auto passes = [&](const String& acc)
+    {
+      std::map<String, bool>::const_iterator pos = accession_passes.find(acc);
+      if (pos != accession_passes.end()) return pos->second;
+
+      bool pass = all_accessions || boost::regex_search(acc.c_str(), m, acc_regexp);
+      if (pass && !all_descriptions)
+      {
+        pass = false;
+        std::map<String, vector<String> >::const_iterator desc_pos = descriptions.find(acc);
+        if (desc_pos != descriptions.end())
+        {
+          for (const String& desc : desc_pos->second)
+          {
+            if (boost::regex_search(desc.c_str(), m, desc_regexp))
+            {
+              pass = true;
+              break;
+            }
+          }
+        }
+      }
+      accession_passes[acc] = pass;
+      return pass;
+    };
+
+    for (Size i = 0; i < map.size(); ++i)
+    {
+      result[i] = 0;
+      for (const PeptideIdentification& pep_id : map[i].getPeptideIdentifications())
+      {
+        for (const PeptideHit& hit : pep_id.getHits())
+        {
+          for (const String& acc : hit.extractProteinAccessionsSet())
+          {
+            if (passes(acc))
+            {
+              result[i] = 1;
+              break;
+            }
+          }
+          if (result[i]) break;
+        }
+        if (result[i]) break;
+      }
+    }
+    return result;
+  }
+
 }
@@ -66,61 +66,59 @@ namespace OpenMS
       }
     }
 
-    //resample n data points from each sorted intensity distribution (from the different maps), n = maximum number of features in any map
-    vector<vector<double> > resampled_sorted_data;
-    for (Size i = 0; i < number_of_maps; ++i)
+    //sort the intensities of each map, remembering their original positions (needed to write them back)
+    //and resample n data points from each sorted intensity distribution, n = maximum number of features in any map
+    vector<vector<Size> > sort_indices(number_of_maps);
+    vector<vector<double> > resampled_sorted_data(number_of_maps);
+#pragma omp parallel for schedule(dynamic)
+    for (SignedSize i = 0; i < (SignedSize)number_of_maps; ++i)
     {
-      vector<double> sorted = feature_ints[i];
-      std::sort(sorted.begin(), sorted.end());
-      vector<double> resampled(largest_number_of_features);
-      resample(sorted, resampled, static_cast<UInt>(largest_number_of_features));
-      resampled_sorted_data.push_back(resampled);
+      // We do not want to change the order in feature_ints[i], so we transfer the values
+      // into pairs that store the value and the index in feature_ints[i]. Sorting the pairs
+      // yields the sorted intensities and the indexes of feature_ints[i] in sorted order.
+      std::vector<std::pair<double, UInt> > sort_pairs;
+      sort_pairs.reserve(feature_ints[i].size());
+      for (Size j = 0; j < feature_ints[i].size(); ++j)
+      {
+        sort_pairs.push_back(std::make_pair(feature_ints[i][j], j));
+      }
+      std::sort(sort_pairs.begin(), sort_pairs.end());
+
+      vector<double> sorted;
+      sorted.reserve(sort_pairs.size());
+      sort_indices[i].reserve(sort_pairs.size());
+      for (Size j = 0; j < sort_pairs.size(); ++j)
+      {
+        sorted.push_back(sort_pairs[j].first);
+        sort_indices[i].push_back(sort_pairs[j].second);
+      }
+      resample(sorted, resampled_sorted_data[i], static_cast<UInt>(largest_number_of_features));
     }
 
     //compute reference distribution from all resampled distributions
     vector<double> reference_distribution(largest_number_of_features);
-    for (Size i = 0; i < number_of_maps; ++i)
+#pragma omp parallel for
+    for (SignedSize j = 0; j < (SignedSize)largest_number_of_features; ++j)
     {
-      for (Size j = 0; j < largest_number_of_features; ++j)
+      for (Size i = 0; i < number_of_maps; ++i)
       {
         reference_distribution[j] += (resampled_sorted_data[i][j] / (double)number_of_maps);
       }
     }
 
     //for each map: resample from the reference distribution down to the respective original size again
-    vector<vector<double> > normalized_sorted_ints(number_of_maps);
-    for (Size i = 0; i < number_of_maps; ++i)
+    //and set the intensities of feature_ints to the normalized intensities (normalized_sorted_ints comes sorted)
+#pragma omp parallel for schedule(dynamic)
+    for (SignedSize i = 0; i < (SignedSize)number_of_maps; ++i)
     {
-      vector<double> ints;
-      resample(reference_distribution, ints, static_cast<UInt>(feature_ints[i].size()));
-      normalized_sorted_ints[i] = ints;
-    }
+      vector<double> normalized_sorted_ints;
+      resample(reference_distribution, normalized_sorted_ints, static_cast<UInt>(feature_ints[i].size()));
 
-    //set the intensities of feature_ints to the normalized intensities
-    for (Size i = 0; i < number_of_maps; ++i)
-    {
-      // We do not want to change the order in feature_ints[i] but normalized_sorted_ints
-      // comes sorted, so we transfer the values in feature_ints[i] into pairs that store
-      // the value and the index in feature_ints[i]. Then we sort the vector of pair and as
-      // a result store the indexes of feature_ints[i] in a sorted order in sort_indices.
-      std::vector<std::pair<double, UInt> > sort_pairs;
-      sort_pairs.reserve(feature_ints[i].size());
-      for (Size j = 0; j < feature_ints[i].size(); ++j)
-      {
-        sort_pairs.push_back(std::make_pair(feature_ints[i][j], j));
-      }
-      std::sort(sort_pairs.begin(), sort_pairs.end());
-      vector<Size> sort_indices;
-      sort_indices.reserve(sort_pairs.size());
-      for (Size j = 0; j < sort_pairs.size(); ++j)
-      {
-        sort_indices.push_back(sort_pairs.at(j).second);
-      }
       Size k = 0;
-      for (Size j = 0; j < sort_indices.size(); ++j)
+      for (Size j = 0; j < sort_indices[i].size(); ++j)
       {
-        Size idx = sort_indices[j];
-        feature_ints[i][idx] = normalized_sorted_ints[i][k++];
+        Size idx = sort_indices[i][j];
+        feature_ints[i][idx] = normalized_sorted_ints[k++];
       }
     }
 
@@ -37,6 +37,10 @@
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 #include "OpenMS/MATH/STATISTICS/StatisticFunctions.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace std;
 
 namespace OpenMS
@@ -72,12 +76,13 @@ namespace OpenMS
     }
 
     //fill feature_int with intensities
+    const vector<char> passes = ConsensusMapNormalizerAlgorithmMedian::computeFilterResults_(map, acc_filter, desc_filter);
     Size pass_counter = 0;
     ConsensusMap::ConstIterator cf_it;
     UInt idx = 0;
     for (cf_it = map.begin(); cf_it != map.end(); ++cf_it, ++idx)
     {
-      if (!ConsensusMapNormalizerAlgorithmMedian::passesFilters_(cf_it, map, acc_filter, desc_filter))
+      if (!passes[idx])
       {
         continue;
       }
@@ -120,15 +125,16 @@ namespace OpenMS
 
   void ConsensusMapNormalizerAlgorithmThreshold::normalizeMaps(ConsensusMap& map, const vector<double>& ratios)
   {
-    ConsensusMap::Iterator cf_it;
     ProgressLogger progresslogger;
     progresslogger.setLogType(ProgressLogger::CMD);
     progresslogger.startProgress(0, map.size(), "normalizing maps");
-    for (cf_it = map.begin(); cf_it != map.end(); ++cf_it)
+    // consensus features are normalized independently
+#pragma omp parallel for schedule(dynamic, 1000)
+    for (SignedSize i = 0; i < (SignedSize)map.size(); ++i)
     {
-      progresslogger.setProgress(cf_it - map.begin());
+      IF_MASTERTHREAD progresslogger.setProgress(i);
       ConsensusFeature::HandleSetType::const_iterator f_it;
-      for (f_it = cf_it->getFeatures().begin(); f_it != cf_it->getFeatures().end(); ++f_it)
+      for (f_it = map[i].getFeatures().begin(); f_it != map[i].getFeatures().end(); ++f_it)
       {
         f_it->asMutable().setIntensity(f_it->getIntensity() * ratios[f_it->getMapIndex()]);
       }
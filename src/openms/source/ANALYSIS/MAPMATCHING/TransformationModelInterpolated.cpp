@@ -37,6 +37,7 @@
 // Spline2dInterpolator
 #include <OpenMS/MATH/MISC/CubicSpline2d.h>
 
+#include <algorithm>
 #include <numeric>
 
 // AkimaInterpolator
@@ -71,6 +72,11 @@ public:
       return spline_->eval(x);
     }
 
+    double evalWithHint(const double& x, Size& hint) const override
+    {
+      return spline_->eval(x, hint);
+    }
+
     ~Spline2dInterpolator() override
     {
       delete spline_;
@@ -163,6 +169,35 @@ public:
       }
     }
 
+    double evalWithHint(const double& x, Size& hint) const override
+    {
+      // hint: index of the first point > x (as found by upper_bound in eval)
+      if (hint == 0 || hint > x_.size() || x_[hint - 1] > x)
+      {
+        hint = std::upper_bound(x_.begin(), x_.end(), x) - x_.begin();
+      }
+      else if (hint < x_.size() && x_[hint] <= x)
+      {
+        // x lies further right: check the next point, then search the remainder
+        ++hint;
+        if (hint < x_.size() && x_[hint] <= x)
+        {
+          hint = std::upper_bound(x_.begin() + hint, x_.end(), x) - x_.begin();
+        }
+      }
+
+      if (hint == x_.size())
+      {
+        return y_.back();
+      }
+      const double x_0 = x_[hint - 1];
+      const double x_1 = x_[hint];
+      const double y_0 = y_[hint - 1];
+      const double y_1 = y_[hint];
+
+      return y_0 + (y_1 - y_0) * (x - x_0) / (x_1 - x_0);
+    }
+
     ~LinearInterpolator() override
     {
     }
@@ -418,6 +453,38 @@ private:
     return interp_->eval(value);
   }
 
+  void TransformationModelInterpolated::evaluate(const std::vector<double>& values, std::vector<double>& results) const
+  {
+    results.resize(values.size());
+
+    // blocks of consecutive values, each evaluated by one thread
+    const Size block_size = 4096;
+    const SignedSize n_blocks = (values.size() + block_size - 1) / block_size;
+
+#pragma omp parallel for schedule(static) if (n_blocks > 1)
+    for (SignedSize block = 0; block < n_blocks; ++block)
+    {
+      const Size end = std::min(values.size(), (block + 1) * block_size);
+      Size hint = 0;
+      for (Size i = block * block_size; i < end; ++i)
+      {
+        const double value = values[i];
+        if (value < x_.front()) // extrapolate front
+        {
+          results[i] = lm_front_->evaluate(value);
+        }
+        else if (value > x_.back()) // extrapolate back
+        {
+          results[i] = lm_back_->evaluate(value);
+        }
+        else // interpolate
+        {
+          results[i] = interp_->evalWithHint(value, hint);
+        }
+      }
+    }
+  }
+
   void TransformationModelInterpolated::getDefaultParameters(Param& params)
   {
     params.clear();
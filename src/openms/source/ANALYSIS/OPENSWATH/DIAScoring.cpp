@@ -39,6 +39,7 @@
 
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/FeatureFinderAlgorithmPickedHelperStructs.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/FeatureFinderAlgorithm.h>
+#include <OpenMS/OPENSWATHALGO/ALGO/ScoringScratch.h>
 #include <OpenMS/OPENSWATHALGO/ALGO/StatsHelpers.h>
 #include <OpenMS/OPENSWATHALGO/DATAACCESS/SpectrumHelpers.h> // integrateWindow
 #include <OpenMS/ANALYSIS/OPENSWATH/DIAHelper.h>
@@ -207,7 +208,9 @@ namespace OpenMS
     // although precursor_mz can be received from the empirical formula (if non-empty), the actual precursor could be
     // slightly different. And also for compounds, usually the neutral sum_formula without adducts is given.
     // Therefore calculate the isotopes based on the formula but place them at precursor_mz
-    std::vector<double> isotopes_int;
+    OpenSwath::ScoringScratch& scratch = OpenSwath::ScoringScratch::threadLocal();
+    OpenSwath::ScoringScratch::Frame frame(scratch);
+    std::vector<double>& isotopes_int = scratch.acquire(dia_nr_isotopes_ + 1);
     getIsotopeIntysFromExpSpec_(precursor_mz, spectrum, isotopes_int, sum_formula.getCharge());
 
     double max_ratio = 0;
@@ -240,7 +243,9 @@ namespace OpenMS
                                                     double& isotope_corr, double& isotope_overlap,
                                                     int charge_state) const
   {
-    std::vector<double> exp_isotopes_int;
+    OpenSwath::ScoringScratch& scratch = OpenSwath::ScoringScratch::threadLocal();
+    OpenSwath::ScoringScratch::Frame frame(scratch);
+    std::vector<double>& exp_isotopes_int = scratch.acquire(dia_nr_isotopes_ + 1);
     getIsotopeIntysFromExpSpec_(precursor_mz, spectrum, exp_isotopes_int, charge_state);
     CoarseIsotopePatternGenerator solver(dia_nr_isotopes_ + 1);
     // NOTE: this is a rough estimate of the neutral mz value since we would not know the charge carrier for negative ions
@@ -264,7 +269,10 @@ namespace OpenMS
     OPENMS_PRECONDITION(charge > 0, "Charge is a positive integer"); // for peptides, charge should be positive
 
     double mz, intensity, left, right;
-    std::vector<double> yseries, bseries;
+    OpenSwath::ScoringScratch& scratch = OpenSwath::ScoringScratch::threadLocal();
+    OpenSwath::ScoringScratch::Frame frame(scratch);
+    std::vector<double>& yseries = scratch.acquire();
+    std::vector<double>& bseries = scratch.acquire();
     OpenMS::DIAHelpers::getBYSeries(sequence, bseries, yseries, generator, charge);
     for (const auto& b_ion_mz : bseries)
     {
@@ -322,7 +330,9 @@ namespace OpenMS
                                         double& isotope_corr,
                                         double& isotope_overlap) const
   {
-    std::vector<double> isotopes_int;
+    OpenSwath::ScoringScratch& scratch = OpenSwath::ScoringScratch::threadLocal();
+    OpenSwath::ScoringScratch::Frame frame(scratch);
+    std::vector<double>& isotopes_int = scratch.acquire(dia_nr_isotopes_ + 1);
     double max_ratio;
     int nr_occurences;
     for (Size k = 0; k < transitions.size(); k++)
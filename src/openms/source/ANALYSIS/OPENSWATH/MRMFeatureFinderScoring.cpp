@@ -41,6 +41,7 @@
 
 // peak picking & noise estimation
 #include <OpenMS/OPENSWATHALGO/ALGO/MRMScoring.h>
+#include <OpenMS/OPENSWATHALGO/ALGO/ScoringScratch.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/MRMTransitionGroupPicker.h>
 
 // Helpers
@@ -100,6 +101,8 @@ namespace OpenMS
     defaults_.setMinInt("add_up_spectra", 1);
     defaults_.setValue("spacing_for_spectra_resampling", 0.005, "If spectra are to be added, use this spacing to add them up", ListUtils::create<String>("advanced"));
     defaults_.setMinFloat("spacing_for_spectra_resampling", 0.0);
+    defaults_.setValue("spectrum_cache_size", 16, "Number of (added up) spectra around peak apices to keep in memory for reuse by neighbouring peak groups (0 disables the cache)", ListUtils::create<String>("advanced"));
+    defaults_.setMinInt("spectrum_cache_size", 0);
     defaults_.setValue("uis_threshold_sn", -1, "S/N threshold to consider identification transition (set to -1 to consider all)");
     defaults_.setValue("uis_threshold_peak_area", 0, "Peak area threshold to consider identification transition (set to -1 to consider all)");
     defaults_.setValue("scoring_model", "default", "Scoring model to use", ListUtils::create<String>("advanced"));
@@ -257,6 +260,12 @@ namespace OpenMS
     }
     endProgress();
 
+    if (spectrum_cache_)
+    {
+      OPENMS_LOG_DEBUG << "Spectrum cache: " << spectrum_cache_->getHits() << " hits, " << spectrum_cache_->getMisses() <<
+        " misses (hit rate " << spectrum_cache_->getHitRate() << ")" << std::endl;
+    }
+
     //output.sortByPosition(); // if the exact same order is needed
     return;
   }
@@ -547,6 +556,7 @@ namespace OpenMS
                       im_extra_drift_,
                       su_,
                       spectrum_addition_method_);
+    scorer.setSpectrumCache(spectrum_cache_);
 
     ProteaseDigestion pd;
     pd.setEnzyme("Trypsin");
@@ -561,6 +571,9 @@ namespace OpenMS
     for (SignedSize feature_idx = 0; feature_idx < (SignedSize) mrmfeatures.size(); ++feature_idx)
     {
       auto& mrmfeature = mrmfeatures[feature_idx];
+      // scratch buffers of this thread are recycled for every scored peak group
+      OpenSwath::ScoringScratch& scratch = OpenSwath::ScoringScratch::threadLocal();
+      scratch.reset();
       OpenSwath::IMRMFeature* imrmfeature;
       imrmfeature = new MRMFeatureOpenMS(mrmfeature);
 
@@ -968,6 +981,9 @@ namespace OpenMS
       #pragma omp critical
       feature_list.push_back(mrmfeature);
 
+      OPENMS_LOG_DEBUG << "Scored feature " << mrmfeature.getUniqueId() << " with " << scratch.getAllocationCount() <<
+        " scratch allocations (pool of " << scratch.getPoolSize() << " buffers)" << std::endl;
+
       delete imrmfeature;
     }
 
@@ -1033,6 +1049,16 @@ namespace OpenMS
     add_up_spectra_ = param_.getValue("add_up_spectra");
     spectrum_addition_method_ = param_.getValue("spectrum_addition_method");
     spacing_for_spectra_resampling_ = param_.getValue("spacing_for_spectra_resampling");
+    // cached spectra depend on the spectrum addition settings
+    Size spectrum_cache_size = (Size)(int)param_.getValue("spectrum_cache_size");
+    if (spectrum_cache_size > 0)
+    {
+      spectrum_cache_.reset(new SwathSpectrumCache(spectrum_cache_size));
+    }
+    else
+    {
+      spectrum_cache_.reset();
+    }
     im_extra_drift_ = (double)param_.getValue("im_extra_drift");
     uis_threshold_sn_ = param_.getValue("uis_threshold_sn");
     uis_threshold_peak_area_ = param_.getValue("uis_threshold_peak_area");
@@ -53,6 +53,23 @@
 namespace OpenMS
 {
 
+  /// Reorders all (non-empty) data arrays of @p spec according to @p select_indices
+  void reorderSpectrum(OpenSwath::Spectrum& spec, const std::vector<Size>& select_indices)
+  {
+    for (auto& da : spec.getDataArrays() )
+    {
+      if (da->data.empty()) continue;
+      OpenSwath::BinaryDataArrayPtr tmp(new OpenSwath::BinaryDataArray);
+      tmp->description = da->description;
+      tmp->data.reserve(select_indices.size());
+      for (Size i = 0; i < select_indices.size(); ++i)
+      {
+        tmp->data.push_back( da->data[ select_indices[i] ] );
+      }
+      da = tmp;
+    }
+  }
+
   void sortSpectrumByMZ(OpenSwath::Spectrum& spec)
   {
     //sort index list
@@ -73,19 +90,63 @@ namespace OpenMS
     {
       select_indices.push_back(sidx.second);
     }
+    reorderSpectrum(spec, select_indices);
 
-    for (auto& da : spec.getDataArrays() )
+    OPENMS_POSTCONDITION( std::adjacent_find(spec.getMZArray()->data.begin(),
+           spec.getMZArray()->data.end(), std::greater<double>()) == spec.getMZArray()->data.end(),
+           "Postcondition violated: m/z vector needs to be sorted!" )
+  }
+
+  /**
+    @brief Sorts a spectrum that is the concatenation of m/z sorted runs by m/z
+
+    Equivalent to sortSpectrumByMZ (ties keep their order), but merges the
+    runs given by @p run_sizes pairwise instead of sorting all peaks. Falls
+    back to sortSpectrumByMZ if a run is not sorted.
+  */
+  void mergeSortedRunsByMZ(OpenSwath::Spectrum& spec, const std::vector<Size>& run_sizes)
+  {
+    const std::vector<double>& mz = spec.getMZArray()->data;
+    std::vector<Size> select_indices(mz.size());
+    std::vector<Size> run_bounds(1, 0);
+    for (Size run_size : run_sizes)
+    {
+      Size begin = run_bounds.back();
+      Size end = begin + run_size;
+      if (end > mz.size() || !std::is_sorted(mz.begin() + begin, mz.begin() + end))
+      {
+        sortSpectrumByMZ(spec);
+        return;
+      }
+      for (Size i = begin; i < end; ++i) select_indices[i] = i;
+      run_bounds.push_back(end);
+    }
+    if (run_bounds.back() != mz.size())
     {
-      if (da->data.empty()) continue;
-      OpenSwath::BinaryDataArrayPtr tmp(new OpenSwath::BinaryDataArray);
-      tmp->description = da->description;
-      tmp->data.reserve(select_indices.size());
-      for (Size i = 0; i < select_indices.size(); ++i)
+      sortSpectrumByMZ(spec);
+      return;
+    }
+
+    // bottom-up pairwise merge; std::merge takes from the first range on ties
+    auto mz_less = [&mz](Size a, Size b) { return mz[a] < mz[b]; };
+    std::vector<Size> merged(select_indices.size());
+    while (run_bounds.size() > 2)
+    {
+      std::vector<Size> new_bounds(1, 0);
+      for (Size r = 0; r + 1 < run_bounds.size(); r += 2)
       {
-        tmp->data.push_back( da->data[ select_indices[i] ] );
+        Size begin = run_bounds[r];
+        Size middle = run_bounds[r + 1];
+        Size end = (r + 2 < run_bounds.size()) ? run_bounds[r + 2] : middle;
+        std::merge(select_indices.begin() + begin, select_indices.begin() + middle,
+                   select_indices.begin() + middle, select_indices.begin() + end,
+                   merged.begin() + begin, mz_less);
+        new_bounds.push_back(end);
       }
-      da = tmp;
+      select_indices.swap(merged);
+      run_bounds.swap(new_bounds);
     }
+    reorderSpectrum(spec, select_indices);
 
     OPENMS_POSTCONDITION( std::adjacent_find(spec.getMZArray()->data.begin(),
            spec.getMZArray()->data.end(), std::greater<double>()) == spec.getMZArray()->data.end(),
@@ -126,6 +187,11 @@ namespace OpenMS
     this->su_ = su;
   }
 
+  void OpenSwathScoring::setSpectrumCache(const boost::shared_ptr<SwathSpectrumCache>& cache)
+  {
+    spectrum_cache_ = cache;
+  }
+
   void OpenSwathScoring::calculateDIAScores(OpenSwath::IMRMFeature* imrmfeature,
                                             const std::vector<TransitionType>& transitions,
                                             const std::vector<OpenSwath::SwathMap>& swath_maps,
@@ -627,6 +693,12 @@ namespace OpenMS
       closest_idx--;
     }
 
+    if (spectrum_cache_)
+    {
+      OpenSwath::SpectrumPtr cached = spectrum_cache_->get(swath_map, closest_idx, nr_spectra_to_add, drift_lower, drift_upper);
+      if (cached) return cached;
+    }
+
     if (nr_spectra_to_add == 1)
     {
       added_spec = swath_map->getSpectrumById(closest_idx);
@@ -672,9 +744,12 @@ namespace OpenMS
           }
         }
 
-        // Simply add up data and sort in the end
+        // Simply add up data and merge the (sorted) spectra in the end
+        std::vector<Size> run_sizes;
+        run_sizes.reserve(all_spectra.size());
         for (const auto& s : all_spectra)
         {
+          run_sizes.push_back(s->getMZArray()->data.size());
           for (Size k = 0; k < s->getDataArrays().size(); k++)
           {
             auto& v1 = added_spec->getDataArrays()[k]->data;
@@ -684,7 +759,7 @@ namespace OpenMS
             v1.insert( v1.end(), v2.begin(), v2.end() );
           }
         }
-        sortSpectrumByMZ(*added_spec);
+        mergeSortedRunsByMZ(*added_spec, run_sizes);
       }
       else
       {
@@ -696,6 +771,10 @@ namespace OpenMS
            added_spec->getMZArray()->data.end(), std::greater<double>()) == added_spec->getMZArray()->data.end(),
            "Postcondition violated: m/z vector needs to be sorted!" )
 
+    if (spectrum_cache_)
+    {
+      spectrum_cache_->insert(swath_map, closest_idx, nr_spectra_to_add, drift_lower, drift_upper, added_spec);
+    }
     return added_spec;
   }
 
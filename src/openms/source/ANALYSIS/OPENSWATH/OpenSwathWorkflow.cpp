@@ -986,6 +986,12 @@ namespace OpenMS
       }
     }
 
+    if (featureFinder.getSpectrumCache())
+    {
+      OPENMS_LOG_DEBUG << "Spectrum cache hit rate: " << featureFinder.getSpectrumCache()->getHitRate() <<
+        " (" << featureFinder.getSpectrumCache()->getHits() << " hits)" << std::endl;
+    }
+
     // Only write at the very end since this is a step that needs a barrier
     if (tsv_writer.isActive())
     {
@@ -83,8 +83,7 @@ namespace OpenMS
 
   void PeakPickerMRM::pickChromatogram(const MSChromatogram& chromatogram, MSChromatogram& picked_chrom)
   {
-    MSChromatogram s;
-    pickChromatogram(chromatogram, picked_chrom, s);
+    pickChromatogram(chromatogram, picked_chrom, smoothed_chrom_);
   }
   
   void PeakPickerMRM::pickChromatogram(const MSChromatogram& chromatogram, MSChromatogram& picked_chrom, MSChromatogram& smoothed_chrom)
@@ -0,0 +1,180 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/ANALYSIS/OPENSWATH/SwathSpectrumCache.h>
+
+#include <boost/functional/hash.hpp>
+
+namespace OpenMS
+{
+
+  bool SwathSpectrumCache::Key::operator==(const Key& rhs) const
+  {
+    return swath_map == rhs.swath_map &&
+           apex_index == rhs.apex_index &&
+           nr_spectra_to_add == rhs.nr_spectra_to_add &&
+           drift_lower == rhs.drift_lower &&
+           drift_upper == rhs.drift_upper;
+  }
+
+  std::size_t SwathSpectrumCache::KeyHash::operator()(const Key& key) const
+  {
+    std::size_t seed = 0;
+    boost::hash_combine(seed, key.swath_map);
+    boost::hash_combine(seed, key.apex_index);
+    boost::hash_combine(seed, key.nr_spectra_to_add);
+    boost::hash_combine(seed, key.drift_lower);
+    boost::hash_combine(seed, key.drift_upper);
+    return seed;
+  }
+
+  SwathSpectrumCache::SwathSpectrumCache(Size capacity) :
+    capacity_(capacity),
+    hits_(0),
+    misses_(0)
+  {
+  }
+
+  OpenSwath::SpectrumPtr SwathSpectrumCache::get(const OpenSwath::SpectrumAccessPtr& swath_map, int apex_index,
+                                                 int nr_spectra_to_add, double drift_lower, double drift_upper)
+  {
+    const Key key = {swath_map.get(), apex_index, nr_spectra_to_add, drift_lower, drift_upper};
+    OpenSwath::SpectrumPtr spectrum;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end())
+    {
+      // a different map may have been allocated at the address of a destroyed one
+      if (it->second->swath_map.lock() == swath_map)
+      {
+        spectrum = it->second->spectrum;
+        entries_.splice(entries_.begin(), entries_, it->second);
+      }
+      else
+      {
+        entries_.erase(it->second);
+        index_.erase(it);
+      }
+    }
+    if (spectrum) ++hits_;
+    else ++misses_;
+    return spectrum;
+  }
+
+  void SwathSpectrumCache::insert(const OpenSwath::SpectrumAccessPtr& swath_map, int apex_index,
+                                  int nr_spectra_to_add, double drift_lower, double drift_upper,
+                                  const OpenSwath::SpectrumPtr& spectrum)
+  {
+    const Key key = {swath_map.get(), apex_index, nr_spectra_to_add, drift_lower, drift_upper};
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capacity_ == 0) return;
+
+    auto it = index_.find(key);
+    if (it != index_.end())
+    {
+      // another thread computed the same spectrum in the meantime
+      it->second->swath_map = swath_map;
+      it->second->spectrum = spectrum;
+      entries_.splice(entries_.begin(), entries_, it->second);
+    }
+    else
+    {
+      entries_.push_front(Entry{key, swath_map, spectrum});
+      index_[key] = entries_.begin();
+      shrink_();
+    }
+  }
+
+  void SwathSpectrumCache::clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+  }
+
+  Size SwathSpectrumCache::size() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+  }
+
+  Size SwathSpectrumCache::getCapacity() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_;
+  }
+
+  void SwathSpectrumCache::setCapacity(Size capacity)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    shrink_();
+  }
+
+  Size SwathSpectrumCache::getHits() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+  }
+
+  Size SwathSpectrumCache::getMisses() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+  }
+
+  double SwathSpectrumCache::getHitRate() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Size lookups = hits_ + misses_;
+    return lookups == 0 ? 0.0 : double(hits_) / lookups;
+  }
+
+  void SwathSpectrumCache::resetStatistics()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    hits_ = 0;
+    misses_ = 0;
+  }
+
+  void SwathSpectrumCache::shrink_()
+  {
+    while (entries_.size() > capacity_)
+    {
+      index_.erase(entries_.back().key);
+      entries_.pop_back();
+    }
+  }
+
+}
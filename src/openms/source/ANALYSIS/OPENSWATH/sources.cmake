@@ -32,6 +32,7 @@ set(sources_list
   PeakPickerMRM.cpp
   SONARScoring.cpp
   SwathMapMassCorrection.cpp
+  SwathSpectrumCache.cpp
   SwathWindowLoader.cpp
   SwathQC.cpp
   SpectrumAddition.cpp
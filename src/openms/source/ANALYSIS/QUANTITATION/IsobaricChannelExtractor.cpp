@@ -43,6 +43,9 @@
 #include <OpenMS/KERNEL/ConsensusMap.h>
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
 
+#include <algorithm>
+#include <limits>
+
 // #define ISOBARIC_CHANNEL_EXTRACTOR_DEBUG
 // #undef ISOBARIC_CHANNEL_EXTRACTOR_DEBUG
 
@@ -54,20 +57,6 @@ namespace OpenMS
   // Also used for TMT_11PLEX
   double TMT_10AND11PLEX_CHANNEL_TOLERANCE = 0.003;
 
-  /// small quality control class, holding temporary data for reporting
-  struct ChannelQC
-  {
-    // C'tor
-    ChannelQC() :
-      mz_deltas(),
-      signal_not_unique(0)
-    {}
-
-    std::vector<double> mz_deltas; ///< m/z distance between expected and observed reporter ion closest to expected position
-    int signal_not_unique;  ///< counts if more than one peak was found within the search window of each reporter position
-  };
-
-
   IsobaricChannelExtractor::PuritySate_::PuritySate_(const PeakMap& targetExp) :
     baseExperiment(targetExp)
   {
@@ -241,28 +230,28 @@ namespace OpenMS
     return false;
   }
 
-  double IsobaricChannelExtractor::computeSingleScanPrecursorPurity_(const PeakMap::ConstIterator& ms2_spec, const PeakMap::SpectrumType& precursor_spec) const
+  double IsobaricChannelExtractor::computeSingleScanPrecursorPurity_(const PeakMap::SpectrumType& ms2_spec, const PeakMap::SpectrumType& precursor_spec) const
   {
 
     typedef PeakMap::SpectrumType::ConstIterator const_spec_iterator;
 
     // compute distance between isotopic peaks based on the precursor charge.
-    const double charge_dist = Constants::NEUTRON_MASS_U / static_cast<double>(ms2_spec->getPrecursors()[0].getCharge());
+    const double charge_dist = Constants::NEUTRON_MASS_U / static_cast<double>(ms2_spec.getPrecursors()[0].getCharge());
 
     // the actual boundary values
-    const double strict_lower_mz = ms2_spec->getPrecursors()[0].getMZ() - ms2_spec->getPrecursors()[0].getIsolationWindowLowerOffset();
-    const double strict_upper_mz = ms2_spec->getPrecursors()[0].getMZ() + ms2_spec->getPrecursors()[0].getIsolationWindowUpperOffset();
+    const double strict_lower_mz = ms2_spec.getPrecursors()[0].getMZ() - ms2_spec.getPrecursors()[0].getIsolationWindowLowerOffset();
+    const double strict_upper_mz = ms2_spec.getPrecursors()[0].getMZ() + ms2_spec.getPrecursors()[0].getIsolationWindowUpperOffset();
 
     const double fuzzy_lower_mz = strict_lower_mz - (strict_lower_mz * max_precursor_isotope_deviation_ / 1000000);
     const double fuzzy_upper_mz = strict_upper_mz + (strict_upper_mz * max_precursor_isotope_deviation_ / 1000000);
 
     // first find the actual precursor peak
-    Size precursor_peak_idx = precursor_spec.findNearest(ms2_spec->getPrecursors()[0].getMZ());
+    Size precursor_peak_idx = precursor_spec.findNearest(ms2_spec.getPrecursors()[0].getMZ());
     const Peak1D& precursor_peak = precursor_spec[precursor_peak_idx];
 
     // now we get ourselves some border iterators
     const_spec_iterator lower_bound = precursor_spec.MZBegin(fuzzy_lower_mz);
-    const_spec_iterator upper_bound = precursor_spec.MZEnd(ms2_spec->getPrecursors()[0].getMZ());
+    const_spec_iterator upper_bound = precursor_spec.MZEnd(ms2_spec.getPrecursors()[0].getMZ());
 
     Peak1D::IntensityType precursor_intensity = precursor_peak.getIntensity();
     Peak1D::IntensityType total_intensity = precursor_peak.getIntensity();
@@ -325,7 +314,7 @@ namespace OpenMS
     // try to find a match for our isotopic peak on the right
 
     // redefine bounds
-    lower_bound = precursor_spec.MZBegin(ms2_spec->getPrecursors()[0].getMZ());
+    lower_bound = precursor_spec.MZBegin(ms2_spec.getPrecursors()[0].getMZ());
     upper_bound = precursor_spec.MZEnd(fuzzy_upper_mz);
 
     expected_next_mz = precursor_peak.getMZ() + charge_dist;
@@ -416,32 +405,32 @@ namespace OpenMS
     return precursor_intensity / total_intensity;
   }
 
-  double IsobaricChannelExtractor::computePrecursorPurity_(const PeakMap::ConstIterator& ms2_spec, const PuritySate_& pState) const
+  double IsobaricChannelExtractor::computePrecursorPurity_(const PeakMap::SpectrumType& ms2_spec, const PeakMap::SpectrumType& precursor_spec, const PeakMap::SpectrumType* follow_up_spec) const
   {
     // we cannot analyze precursors without a charge
-    if (ms2_spec->getPrecursors()[0].getCharge() == 0)
+    if (ms2_spec.getPrecursors()[0].getCharge() == 0)
     {
       return 1.0;
     }
     else
     {
 #ifdef ISOBARIC_CHANNEL_EXTRACTOR_DEBUG
-      std::cerr << "------------------ analyzing " << ms2_spec->getNativeID() << std::endl;
+      std::cerr << "------------------ analyzing " << ms2_spec.getNativeID() << std::endl;
 #endif
 
       // compute purity of preceding ms1 scan
-      double early_scan_purity = computeSingleScanPrecursorPurity_(ms2_spec, *(pState.precursorScan));
+      double early_scan_purity = computeSingleScanPrecursorPurity_(ms2_spec, precursor_spec);
 
-      if (pState.hasFollowUpScan && interpolate_precursor_purity_)
+      if (follow_up_spec != nullptr && interpolate_precursor_purity_)
       {
-        double late_scan_purity = computeSingleScanPrecursorPurity_(ms2_spec, *(pState.followUpScan));
+        double late_scan_purity = computeSingleScanPrecursorPurity_(ms2_spec, *follow_up_spec);
 
         // calculating the extrapolated, S2I value as a time weighted linear combination of the two scans
         // see: Savitski MM, Sweetman G, Askenazi M, Marto JA, Lang M, Zinn N, et al. (2011).
         // Analytical chemistry 83: 8959–67. http://www.ncbi.nlm.nih.gov/pubmed/22017476
         // std::fabs is applied to compensate for potentially negative RTs
-        return std::fabs(ms2_spec->getRT() - pState.precursorScan->getRT()) *
-               ((late_scan_purity - early_scan_purity) / std::fabs(pState.followUpScan->getRT() - pState.precursorScan->getRT()))
+        return std::fabs(ms2_spec.getRT() - precursor_spec.getRT()) *
+               ((late_scan_purity - early_scan_purity) / std::fabs(follow_up_spec->getRT() - precursor_spec.getRT()))
                + early_scan_purity;
       }
       else
@@ -513,13 +502,12 @@ namespace OpenMS
     // remember the current precursor spectrum
     PuritySate_ pState(ms_exp_data);
 
-    typedef std::map<String, ChannelQC > ChannelQCSet;
-    ChannelQCSet channel_mz_delta;
-    const double qc_dist_mz = 0.5; // fixed! Do not change!
-
-    Size number_of_channels = quant_method_->getNumberOfChannels();
+    ChannelQCSet_ channel_qc;
 
-    PeakMap::ConstIterator it_last_MS2 = ms_exp_data.end(); // remember last MS2 spec, to get precursor in MS1 (also if quant is in MS3)
+    // scans are collected sequentially and quantified in parallel batches
+    const Size batch_size = 1000;
+    std::vector<QuantScan_> scans;
+    scans.reserve(batch_size);
 
     for (PeakMap::ConstIterator it = ms_exp_data.begin(); it != ms_exp_data.end(); ++it)
     {
@@ -528,8 +516,6 @@ namespace OpenMS
       {
         // remember potential precursor and continue
         pState.precursorScan = it;
-        // reset last MS2 -- we expect to see a new one soon and the old one should not be used for the following MS3 (if any)
-        it_last_MS2 = ms_exp_data.end();
         continue;
       }
 
@@ -551,109 +537,197 @@ namespace OpenMS
         continue;
       }
 
-      // check precursor purity if we have a valid precursor ..
-      double precursor_purity = -1.0;
-      if (pState.precursorScan != ms_exp_data.end())
+      QuantScan_ scan;
+      scan.spectrum = &(*it);
+      scan.precursor_scan = pState.precursorScan != ms_exp_data.end() ? &(*pState.precursorScan) : nullptr;
+      scan.follow_up_scan = pState.hasFollowUpScan ? &(*pState.followUpScan) : nullptr;
+
+      // remember MS2 spec, to get precursor in MS1 (also if quant is in MS3)
+      PeakMap::ConstIterator it_last_MS2 = it;
+      if (it->getMSLevel() == 3)
+      {
+        // we cannot save just the last MS2 but need to compare to the precursor info stored in the (potential MS3 spectrum)
+        it_last_MS2 = ms_exp_data.getPrecursorSpectrum(it);
+      }
+
+      if (it_last_MS2 == ms_exp_data.end())
+      { // this only happens if an MS3 spec does not have a preceding MS2
+        scan.error = String("No MS2 precursor information given for MS3 scan native ID ") + it->getNativeID() + " with RT " + String(it->getRT());
+      }
+      else if (it_last_MS2->getPrecursors().empty())
+      {
+        scan.error = String("No precursor information given for scan native ID ") + it->getNativeID() + " with RT " + String(it->getRT());
+      }
+      else
+      {
+        scan.ms2_rt = it_last_MS2->getRT();
+        scan.ms2_precursor_mz = it_last_MS2->getPrecursors()[0].getMZ();
+      }
+      scans.push_back(scan);
+
+      if (scans.size() >= batch_size)
+      {
+        quantifyScans_(scans, consensus_map, channel_qc, element_index);
+        scans.clear();
+      }
+    } // ! Experiment iterator
+    quantifyScans_(scans, consensus_map, channel_qc, element_index);
+
+    printCalibrationStats_(channel_qc);
+
+    /// add meta information to the map
+    registerChannelsInOutputMap_(consensus_map);
+  }
+
+  void IsobaricChannelExtractor::extractScan_(const QuantScan_& scan, ScanResult_& result) const
+  {
+    const MSSpectrum& spec = *scan.spectrum;
+
+    // check precursor purity if we have a valid precursor ..
+    result.precursor_purity = -1.0;
+    if (scan.precursor_scan != nullptr)
+    {
+      result.precursor_purity = computePrecursorPurity_(spec, *scan.precursor_scan, scan.follow_up_scan);
+      // check if purity is high enough
+      if (result.precursor_purity < min_precursor_purity_)
       {
-        precursor_purity = computePrecursorPurity_(it, pState);
-        // check if purity is high enough
-        if (precursor_purity < min_precursor_purity_)
+        result.passed_purity = false;
+        return;
+      }
+    }
+    result.passed_purity = true;
+
+    const double qc_dist_mz = 0.5; // fixed! Do not change!
+    const IsobaricQuantitationMethod::IsobaricChannelList& channels = quant_method_->getChannelInformation();
+    result.intensities.assign(channels.size(), 0);
+    result.mz_deltas.assign(channels.size(), 0.0);
+    result.has_signal.assign(channels.size(), 0);
+    result.signal_not_unique.assign(channels.size(), 0);
+
+    // for each each channel
+    for (Size i = 0; i < channels.size(); ++i)
+    {
+      const double center = channels[i].center;
+
+      // as every evaluation requires time, we cache the MZEnd iterator
+      const PeakMap::SpectrumType::ConstIterator mz_end = spec.MZEnd(center + qc_dist_mz);
+
+      // search for the non-zero signal closest to theoretical position
+      // & check for closest signal within reasonable distance (0.5 Da) -- might find neighbouring TMT channel, but that should not confuse anyone
+      int peak_count(0); // count peaks in user window -- should be only one, otherwise Window is too large
+      PeakMap::SpectrumType::ConstIterator idx_nearest(mz_end);
+      for (PeakMap::SpectrumType::ConstIterator mz_it = spec.MZBegin(center - qc_dist_mz);
+            mz_it != mz_end;
+            ++mz_it)
+      {
+        if (mz_it->getIntensity() == 0) continue; // ignore 0-intensity shoulder peaks -- could be detrimental when de-calibrated
+        double dist_mz = fabs(mz_it->getMZ() - center);
+        if (dist_mz < reporter_mass_shift_) ++peak_count;
+        if (idx_nearest == mz_end // first peak
+            || ((dist_mz < fabs(idx_nearest->getMZ() - center)))) // closer to best candidate
         {
-          OPENMS_LOG_DEBUG << "Skip spectrum " << it->getNativeID() << ": Precursor purity is below the threshold. [purity = " << precursor_purity << "]" << std::endl;
-          continue;
+          idx_nearest = mz_it;
         }
       }
-      else
+      if (idx_nearest != mz_end)
       {
-        OPENMS_LOG_INFO << "No precursor available for spectrum: " << it->getNativeID() << std::endl;
+        double mz_delta = center - idx_nearest->getMZ();
+        // stats: we don't care what shift the user specified
+        result.has_signal[i] = 1;
+        result.mz_deltas[i] = mz_delta;
+        result.signal_not_unique[i] = peak_count > 1;
+        // pass user threshold
+        if (std::fabs(mz_delta) < reporter_mass_shift_)
+        {
+          result.intensities[i] = idx_nearest->getIntensity();
+        }
       }
 
-      if (it->getMSLevel() == 3)
+      // discard contribution of this channel as it is below the required intensity threshold
+      if (result.intensities[i] < min_reporter_intensity_)
       {
-        // we cannot save just the last MS2 but need to compare to the precursor info stored in the (potential MS3 spectrum)
-        it_last_MS2 = ms_exp_data.getPrecursorSpectrum(it);
+        result.intensities[i] = 0;
+      }
+    } // ! channel_iterator
+  }
+
+  void IsobaricChannelExtractor::quantifyScans_(const std::vector<QuantScan_>& scans, ConsensusMap& consensus_map, ChannelQCSet_& channel_qc, UInt64& element_index) const
+  {
+    std::vector<ScanResult_> results(scans.size());
 
-        if (it_last_MS2 == ms_exp_data.end())
-        { // this only happens if an MS3 spec does not have a preceding MS2
-          throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("No MS2 precursor information given for MS3 scan native ID ") + it->getNativeID() + " with RT " + String(it->getRT()));
+    // purity and reporter ions are independent for each scan
+    Size error_count = 0;
+    String error_message;
+#pragma omp parallel for schedule(dynamic, 16)
+    for (SignedSize i = 0; i < (SignedSize)scans.size(); ++i)
+    {
+      try
+      {
+        extractScan_(scans[i], results[i]);
+      }
+      catch (Exception::BaseException& e)
+      {
+#pragma omp critical (IsobaricChannelExtractor_error)
+        {
+          ++error_count;
+          if (error_message.empty()) error_message = e.what();
         }
       }
-      else
+    }
+    if (error_count > 0)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Channel extraction failed for " + String(error_count) + " scan(s): " + error_message);
+    }
+
+    // assemble the features in the order of the scans
+    const IsobaricQuantitationMethod::IsobaricChannelList& channels = quant_method_->getChannelInformation();
+    for (Size i = 0; i < scans.size(); ++i)
+    {
+      const MSSpectrum& spec = *scans[i].spectrum;
+      const ScanResult_& result = results[i];
+
+      if (scans[i].precursor_scan == nullptr)
       {
-        it_last_MS2 = it;
+        OPENMS_LOG_INFO << "No precursor available for spectrum: " << spec.getNativeID() << std::endl;
+      }
+      else if (!result.passed_purity)
+      {
+        OPENMS_LOG_DEBUG << "Skip spectrum " << spec.getNativeID() << ": Precursor purity is below the threshold. [purity = " << result.precursor_purity << "]" << std::endl;
+        continue;
       }
 
       // check if MS1 precursor info is available
-      if (it_last_MS2->getPrecursors().empty())
+      if (!scans[i].error.empty())
       {
-        throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("No precursor information given for scan native ID ") + it->getNativeID() + " with RT " + String(it->getRT()));
+        throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, scans[i].error);
       }
 
       // store RT of MS2 scan and MZ of MS1 precursor ion as centroid of ConsensusFeature
       ConsensusFeature cf;
       cf.setUniqueId();
-      cf.setRT(it_last_MS2->getRT());
-      cf.setMZ(it_last_MS2->getPrecursors()[0].getMZ());
+      cf.setRT(scans[i].ms2_rt);
+      cf.setMZ(scans[i].ms2_precursor_mz);
 
       Peak2D channel_value;
-      channel_value.setRT(it->getRT());
-      // for each each channel
-      UInt64 map_index = 0;
+      channel_value.setRT(spec.getRT());
       Peak2D::IntensityType overall_intensity = 0;
 
-      for (IsobaricQuantitationMethod::IsobaricChannelList::const_iterator cl_it = quant_method_->getChannelInformation().begin();
-            cl_it != quant_method_->getChannelInformation().end();
-            ++cl_it)
-      {
-        // set mz-position of channel
-        channel_value.setMZ(cl_it->center);
-        // reset intensity
-        channel_value.setIntensity(0);
-
-        // as every evaluation requires time, we cache the MZEnd iterator
-        const PeakMap::SpectrumType::ConstIterator mz_end = it->MZEnd(cl_it->center + qc_dist_mz);
-
-        // search for the non-zero signal closest to theoretical position
-        // & check for closest signal within reasonable distance (0.5 Da) -- might find neighbouring TMT channel, but that should not confuse anyone
-        int peak_count(0); // count peaks in user window -- should be only one, otherwise Window is too large
-        PeakMap::SpectrumType::ConstIterator idx_nearest(mz_end);
-        for (PeakMap::SpectrumType::ConstIterator mz_it = it->MZBegin(cl_it->center - qc_dist_mz);
-              mz_it != mz_end;
-              ++mz_it)
-        {
-          if (mz_it->getIntensity() == 0) continue; // ignore 0-intensity shoulder peaks -- could be detrimental when de-calibrated
-          double dist_mz = fabs(mz_it->getMZ() - cl_it->center);
-          if (dist_mz < reporter_mass_shift_) ++peak_count;
-          if (idx_nearest == mz_end // first peak
-              || ((dist_mz < fabs(idx_nearest->getMZ() - cl_it->center)))) // closer to best candidate
-          {
-            idx_nearest = mz_it;
-          }
-        }
-        if (idx_nearest != mz_end)
-        {
-          double mz_delta = cl_it->center - idx_nearest->getMZ();
-          // stats: we don't care what shift the user specified
-          channel_mz_delta[cl_it->name].mz_deltas.push_back(mz_delta);
-          if (peak_count > 1) ++channel_mz_delta[cl_it->name].signal_not_unique;
-          // pass user threshold
-          if (std::fabs(mz_delta) < reporter_mass_shift_)
-          {
-            channel_value.setIntensity(idx_nearest->getIntensity());
-          }
-        }
-
-        // discard contribution of this channel as it is below the required intensity threshold
-        if (channel_value.getIntensity() < min_reporter_intensity_)
+      for (Size c = 0; c < channels.size(); ++c)
+      {
+        if (result.has_signal[c])
         {
-          channel_value.setIntensity(0);
+          ChannelQC_& qc = channel_qc[channels[c].name];
+          qc.mz_deltas.push_back(result.mz_deltas[c]);
+          if (result.signal_not_unique[c]) ++qc.signal_not_unique;
         }
 
+        channel_value.setMZ(channels[c].center);
+        channel_value.setIntensity(result.intensities[c]);
         overall_intensity += channel_value.getIntensity();
         // add channel to ConsensusFeature
-        cf.insert(map_index, channel_value, element_index);
-        ++map_index;
-      } // ! channel_iterator
+        cf.insert(c, channel_value, element_index);
+      }
 
       // check if we keep this feature or if it contains low-intensity quantifications
       if (remove_low_intensity_quantifications_ && hasLowIntensityReporter_(cf))
@@ -667,23 +741,29 @@ namespace OpenMS
         cf.setMetaValue("all_empty", String("true"));
       }
       // add purity information if we could compute it
-      if (precursor_purity > 0.0)
+      if (result.precursor_purity > 0.0)
       {
-        cf.setMetaValue("precursor_purity", precursor_purity);
+        cf.setMetaValue("precursor_purity", result.precursor_purity);
       }
 
       // embed the id of the scan from which the quantitative information was extracted
-      cf.setMetaValue("scan_id", it->getNativeID());
+      cf.setMetaValue("scan_id", spec.getNativeID());
       // ...as well as additional meta information
-      cf.setMetaValue("precursor_intensity", it->getPrecursors()[0].getIntensity());
+      cf.setMetaValue("precursor_intensity", spec.getPrecursors()[0].getIntensity());
 
-      cf.setCharge(it->getPrecursors()[0].getCharge());
+      cf.setCharge(spec.getPrecursors()[0].getCharge());
       cf.setIntensity(overall_intensity);
       consensus_map.push_back(cf);
 
       // the tandem-scan in the order they appear in the experiment
       ++element_index;
-    } // ! Experiment iterator
+    }
+  }
+
+  void IsobaricChannelExtractor::printCalibrationStats_(const ChannelQCSet_& channel_qc) const
+  {
+    const double qc_dist_mz = 0.5; // fixed! Do not change!
+    Size number_of_channels = quant_method_->getNumberOfChannels();
 
     // print stats about m/z calibration / presence of signal
     OPENMS_LOG_INFO << "Calibration stats: Median distance of observed reporter ions m/z to expected position (up to " << qc_dist_mz << " Th):\n";
@@ -693,10 +773,12 @@ namespace OpenMS
       ++cl_it)
     {
       OPENMS_LOG_INFO << "  ch " << String(cl_it->name).fillRight(' ', 4) << " (~" << String(cl_it->center).substr(0, 7).fillRight(' ', 7) << "): ";
-      if (channel_mz_delta.find(cl_it->name) != channel_mz_delta.end())
+      ChannelQCSet_::const_iterator qc_it = channel_qc.find(cl_it->name);
+      if (qc_it != channel_qc.end())
       {
         // sort
-        double median = Math::median(channel_mz_delta[cl_it->name].mz_deltas.begin(), channel_mz_delta[cl_it->name].mz_deltas.end(), false);
+        std::vector<double> mz_deltas = qc_it->second.mz_deltas;
+        double median = Math::median(mz_deltas.begin(), mz_deltas.end(), false);
         if (((number_of_channels == 10) || (number_of_channels == 11)) &&
             (fabs(median) > TMT_10AND11PLEX_CHANNEL_TOLERANCE) &&
             (int(cl_it->center) != 126 && int(cl_it->center) != 131)) // these two channels have ~1 Th spacing.. so they do not suffer from the tolerance problem
@@ -706,9 +788,9 @@ namespace OpenMS
         else
         {
           OPENMS_LOG_INFO << median << " Th";
-          if (channel_mz_delta[cl_it->name].signal_not_unique > 0) 
+          if (qc_it->second.signal_not_unique > 0) 
           {
-            OPENMS_LOG_INFO << " [MSn impurity (within " << reporter_mass_shift_ << " Th): " << channel_mz_delta[cl_it->name].signal_not_unique << " windows|spectra]";
+            OPENMS_LOG_INFO << " [MSn impurity (within " << reporter_mass_shift_ << " Th): " << qc_it->second.signal_not_unique << " windows|spectra]";
             impurities_found = true;
           }
           OPENMS_LOG_INFO << "\n";
@@ -722,13 +804,9 @@ namespace OpenMS
     if (impurities_found) OPENMS_LOG_INFO << "\nImpurities within the allowed reporter mass shift " << reporter_mass_shift_ << " Th have been found." 
                                    << "They can be ignored if the spectra are m/z calibrated (see above), since only the peak closest to the theoretical position is used for quantification!";
     OPENMS_LOG_INFO << std::endl;
-
-
-    /// add meta information to the map
-    registerChannelsInOutputMap_(consensus_map);
   }
 
-  void IsobaricChannelExtractor::registerChannelsInOutputMap_(ConsensusMap& consensus_map)
+  void IsobaricChannelExtractor::registerChannelsInOutputMap_(ConsensusMap& consensus_map) const
   {
     // register the individual channels in the output consensus map
     Int index = 0;
@@ -753,4 +831,205 @@ namespace OpenMS
     }
   }
 
+  IsobaricChannelExtractor::ChannelExtractingConsumer::ChannelExtractingConsumer(const IsobaricChannelExtractor& extractor, ConsensusMap& consensus_map, Size batch_size) :
+    extractor_(extractor),
+    consensus_map_(consensus_map),
+    batch_size_(std::max(batch_size, Size(1))),
+    is_valid_activation_(ListUtils::create<String>(extractor.selected_activation_)),
+    quant_ms_level_(0),
+    nr_spectra_(0),
+    last_rt_(-std::numeric_limits<double>::max()),
+    finished_(false),
+    element_index_(0)
+  {
+    // clear the output map
+    consensus_map_.clear(false);
+    consensus_map_.setExperimentType("labeled_MS2");
+
+    OPENMS_LOG_INFO << "Selecting scans with activation mode: " << (extractor_.selected_activation_ == "" ? "any" : extractor_.selected_activation_) << std::endl;
+  }
+
+  IsobaricChannelExtractor::ChannelExtractingConsumer::~ChannelExtractingConsumer()
+  {
+  }
+
+  void IsobaricChannelExtractor::ChannelExtractingConsumer::consumeSpectrum(SpectrumType& s)
+  {
+    if (finished_)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Cannot consume spectra after finish() was called.");
+    }
+    // check if RT is sorted (we rely on it)
+    if (s.getRT() < last_rt_)
+    {
+      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Spectra are not sorted in RT! Please sort them first!");
+    }
+    last_rt_ = s.getRT();
+    ++nr_spectra_;
+
+    if (s.getMSLevel() == 1)
+    {
+      std::shared_ptr<const MSSpectrum> ms1 = std::make_shared<const MSSpectrum>(s);
+
+      // this is the follow-up scan of all pending scans with a smaller RT
+      while (!pending_.empty() && pending_.front().spectrum->getRT() < ms1->getRT())
+      {
+        pending_.front().follow_up_scan = ms1;
+        ready_.push_back(std::move(pending_.front()));
+        pending_.pop_front();
+      }
+
+      // remember potential precursor (the previous one is only kept alive by pending scans referring to it)
+      last_ms1_ = ms1;
+      parents_previous_cycle_.swap(parents_current_cycle_);
+      parents_current_cycle_.clear();
+
+      if (ready_.size() >= batch_size_) flush_();
+      return;
+    }
+
+    // every MSn scan might be the parent of a following scan (independent of its activation method)
+    ParentScan_ parent;
+    parent.native_id = s.getNativeID();
+    parent.ms_level = s.getMSLevel();
+    parent.rt = s.getRT();
+    parent.has_precursor = !s.getPrecursors().empty();
+    parent.precursor_mz = parent.has_precursor ? s.getPrecursors()[0].getMZ() : 0.0;
+    parents_current_cycle_.push_back(parent);
+    last_parent_[parent.ms_level] = parent;
+
+    ++activation_modes_[extractor_.getActivationMethod_(s)]; // count HCD, CID, ...
+    if (!(extractor_.selected_activation_.empty() || is_valid_activation_(s))) return;
+    ++ms_level_counts_[s.getMSLevel()];
+
+    // only the highest level will be used for quantification (e.g. MS3, if present)
+    if (s.getMSLevel() > quant_ms_level_)
+    {
+      quant_ms_level_ = s.getMSLevel();
+      consensus_map_.clear(false);
+      consensus_map_.setExperimentType("labeled_MS2");
+      channel_qc_.clear();
+      element_index_ = 0;
+      pending_.clear();
+      ready_.clear();
+    }
+    else if (s.getMSLevel() < quant_ms_level_)
+    {
+      return;
+    }
+
+    if (s.empty()) return; // skip empty spectra
+
+    // check precursor constraints
+    if (!extractor_.isValidPrecursor_(s.getPrecursors()[0]))
+    {
+      OPENMS_LOG_DEBUG << "Skip spectrum " << s.getNativeID() << ": Precursor doesn't fulfill all constraints." << std::endl;
+      return;
+    }
+
+    PendingScan_ scan;
+    scan.spectrum = std::make_shared<const MSSpectrum>(s);
+    scan.precursor_scan = last_ms1_;
+
+    const ParentScan_* ms2 = (s.getMSLevel() == 3) ? findParentScan_(s) : &parent;
+    if (ms2 == nullptr)
+    { // this only happens if an MS3 spec does not have a preceding MS2
+      scan.error = String("No MS2 precursor information given for MS3 scan native ID ") + s.getNativeID() + " with RT " + String(s.getRT());
+    }
+    else if (!ms2->has_precursor)
+    {
+      scan.error = String("No precursor information given for scan native ID ") + s.getNativeID() + " with RT " + String(s.getRT());
+    }
+    else
+    {
+      scan.ms2_rt = ms2->rt;
+      scan.ms2_precursor_mz = ms2->precursor_mz;
+    }
+    pending_.push_back(std::move(scan));
+  }
+
+  const IsobaricChannelExtractor::ChannelExtractingConsumer::ParentScan_* IsobaricChannelExtractor::ChannelExtractingConsumer::findParentScan_(const MSSpectrum& s) const
+  {
+    const UInt parent_level = s.getMSLevel() - 1;
+
+    if (!s.getPrecursors().empty() && s.getPrecursors()[0].metaValueExists("spectrum_ref"))
+    {
+      const String ref = s.getPrecursors()[0].getMetaValue("spectrum_ref");
+      for (const std::vector<ParentScan_>* cycle : {&parents_current_cycle_, &parents_previous_cycle_})
+      {
+        for (std::vector<ParentScan_>::const_reverse_iterator it = cycle->rbegin(); it != cycle->rend(); ++it)
+        {
+          if (it->ms_level == parent_level && it->native_id == ref) return &(*it);
+        }
+      }
+    }
+
+    // no (known) reference: use the closest preceding scan of the parent level
+    std::map<UInt, ParentScan_>::const_iterator it = last_parent_.find(parent_level);
+    return it != last_parent_.end() ? &(it->second) : nullptr;
+  }
+
+  void IsobaricChannelExtractor::ChannelExtractingConsumer::flush_()
+  {
+    if (ready_.empty()) return;
+
+    std::vector<QuantScan_> scans(ready_.size());
+    for (Size i = 0; i < ready_.size(); ++i)
+    {
+      scans[i].spectrum = ready_[i].spectrum.get();
+      scans[i].precursor_scan = ready_[i].precursor_scan.get();
+      scans[i].follow_up_scan = ready_[i].follow_up_scan.get();
+      scans[i].ms2_rt = ready_[i].ms2_rt;
+      scans[i].ms2_precursor_mz = ready_[i].ms2_precursor_mz;
+      scans[i].error = ready_[i].error;
+    }
+    extractor_.quantifyScans_(scans, consensus_map_, channel_qc_, element_index_);
+    ready_.clear();
+  }
+
+  void IsobaricChannelExtractor::ChannelExtractingConsumer::finish()
+  {
+    if (finished_) return;
+    finished_ = true;
+
+    if (nr_spectra_ == 0)
+    {
+      OPENMS_LOG_WARN << "The given file does not contain any conventional peak data, but might"
+                  " contain chromatograms. This tool currently cannot handle them, sorry.\n";
+      throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Experiment has no scans!");
+    }
+
+    // the remaining scans do not have a follow-up scan
+    while (!pending_.empty())
+    {
+      ready_.push_back(std::move(pending_.front()));
+      pending_.pop_front();
+    }
+    flush_();
+    last_ms1_.reset();
+
+    if (ms_level_counts_.empty())
+    {
+      OPENMS_LOG_WARN << "Filtering by MS/MS(/MS) and activation mode: no spectra pass activation mode filter!\n"
+               << "Activation modes found:\n";
+      for (std::map<String, int>::const_iterator it = activation_modes_.begin(); it != activation_modes_.end(); ++it)
+      {
+        OPENMS_LOG_WARN << "  mode " << (it->first.empty() ? "<none>" : it->first) << ": " << it->second << " scans\n";
+      }
+      OPENMS_LOG_WARN << "Result will be empty!" << std::endl;
+      return;
+    }
+    OPENMS_LOG_INFO << "Filtering by MS/MS(/MS) and activation mode:\n";
+    for (std::map<UInt, UInt>::const_iterator it = ms_level_counts_.begin(); it != ms_level_counts_.end(); ++it)
+    {
+      OPENMS_LOG_INFO << "  level " << it->first << ": " << it->second << " scans\n";
+    }
+    OPENMS_LOG_INFO << "Using MS-level " << quant_ms_level_ << " for quantification." << std::endl;
+
+    extractor_.printCalibrationStats_(channel_qc_);
+
+    /// add meta information to the map
+    extractor_.registerChannelsInOutputMap_(consensus_map_);
+  }
+
 } // namespace
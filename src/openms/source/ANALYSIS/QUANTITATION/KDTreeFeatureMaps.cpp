@@ -35,6 +35,8 @@
 #include <OpenMS/ANALYSIS/QUANTITATION/KDTreeFeatureMaps.h>
 #include <OpenMS/MATH/MISC/MathFunctions.h>
 
+#include <algorithm>
+
 using namespace std;
 
 namespace OpenMS
@@ -168,9 +170,33 @@ void KDTreeFeatureMaps::queryRegion(double rt_low, double rt_high, double mz_low
 
 void KDTreeFeatureMaps::applyTransformations(const vector<TransformationModelLowess*>& trafos)
 {
+  // collect (RT, feature index) per map and evaluate each map's transformation
+  // once on all of its RTs in ascending order (fast batch evaluation)
+  vector<vector<pair<double, Size> > > rts_per_map(trafos.size());
   for (Size i = 0; i < size(); ++i)
   {
-    rt_[i] = trafos[map_index_[i]]->evaluate(features_[i]->getRT());
+    rts_per_map[map_index_[i]].push_back(make_pair(features_[i]->getRT(), i));
+  }
+
+  vector<double> rts, transformed_rts;
+  for (Size map_index = 0; map_index < rts_per_map.size(); ++map_index)
+  {
+    vector<pair<double, Size> >& map_rts = rts_per_map[map_index];
+    if (map_rts.empty()) continue;
+
+    sort(map_rts.begin(), map_rts.end());
+    rts.resize(map_rts.size());
+    for (Size j = 0; j < map_rts.size(); ++j)
+    {
+      rts[j] = map_rts[j].first;
+    }
+
+    trafos[map_index]->evaluate(rts, transformed_rts);
+
+    for (Size j = 0; j < map_rts.size(); ++j)
+    {
+      rt_[map_rts[j].second] = transformed_rts[j];
+    }
   }
 }
 
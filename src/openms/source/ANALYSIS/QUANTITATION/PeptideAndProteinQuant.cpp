@@ -36,6 +36,8 @@
 #include <OpenMS/ANALYSIS/QUANTITATION/PeptideAndProteinQuant.h>
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
 
+#include <boost/functional/hash.hpp>
+
 using namespace std;
 
 namespace OpenMS
@@ -120,18 +122,79 @@ namespace OpenMS
   }
 
 
+  std::size_t PeptideAndProteinQuant::AASequenceHash_::operator()(const AASequence& seq) const
+  {
+    std::size_t hash = 0;
+    boost::hash_combine(hash, seq.getNTerminalModification());
+    boost::hash_combine(hash, seq.getCTerminalModification());
+    for (Size i = 0; i < seq.size(); ++i)
+    {
+      boost::hash_combine(hash, &seq[i]);
+    }
+    return hash;
+  }
+
+
+  Size PeptideAndProteinQuant::internPeptide_(const AASequence& seq)
+  {
+    auto pos = peptide_ids_.find(seq);
+    if (pos != peptide_ids_.end()) return pos->second;
+
+    DenseAbundances_ dense;
+    dense.data = &pep_quant_[seq];
+    dense_abundances_.push_back(dense);
+    peptide_ids_.emplace(seq, dense_abundances_.size() - 1);
+    return dense_abundances_.size() - 1;
+  }
+
+
   void PeptideAndProteinQuant::quantifyFeature_(const FeatureHandle& feature,
                                                 const size_t fraction,
                                                 const size_t sample,
-                                                const PeptideHit& hit)
+                                                const Size peptide_id,
+                                                const Int charge)
   {
-    // return if annotation for the feature is ambiguous or missing
-    if (hit == PeptideHit()) { return; }
-
     stats_.quant_features++;
-    const AASequence& seq = hit.getSequence();
-    pep_quant_[seq].abundances[fraction][hit.getCharge()][sample] +=
-      feature.getIntensity(); // new map element is initialized with 0
+    DenseAbundances_& dense = dense_abundances_[peptide_id];
+
+    // there are only few fraction/charge combinations per peptide:
+    const std::pair<Int, Int> key(fraction, charge);
+    Size row = std::find(dense.rows.begin(), dense.rows.end(), key) - dense.rows.begin();
+    if (row == dense.rows.size())
+    {
+      dense.rows.push_back(key);
+      dense.values.resize(dense.rows.size() * dense_columns_, 0.0);
+      dense.observed.resize(dense.rows.size() * dense_columns_, 0);
+    }
+    const Size index = row * dense_columns_ + sample;
+    dense.values[index] += feature.getIntensity();
+    dense.observed[index] = 1;
+  }
+
+
+  void PeptideAndProteinQuant::transferDenseAbundances_()
+  {
+    // every peptide owns its nested maps, so they can be filled independently
+#pragma omp parallel for schedule(dynamic, 64)
+    for (SignedSize i = 0; i < (SignedSize)dense_abundances_.size(); ++i)
+    {
+      DenseAbundances_& dense = dense_abundances_[i];
+      for (Size row = 0; row < dense.rows.size(); ++row)
+      {
+        SampleAbundances& abundances = dense.data->abundances[dense.rows[row].first][dense.rows[row].second];
+        for (Size sample = 0; sample < dense_columns_; ++sample)
+        {
+          const Size index = row * dense_columns_ + sample;
+          if (dense.observed[index])
+          {
+            abundances.emplace_hint(abundances.end(), sample, 0.0)->second += dense.values[index];
+          }
+        }
+      }
+      dense = DenseAbundances_(); // release memory early
+    }
+    dense_abundances_.clear();
+    peptide_ids_.clear();
   }
 
 
@@ -196,10 +259,19 @@ namespace OpenMS
     }
 
     //////////////////////////////////////////////////////
-    // second, perform the actual peptide quantification:
-    for (auto & pep_q : pep_quant_)
+    // second, perform the actual peptide quantification
+    // (independently for each peptide, so in parallel):
+    const bool best_charge_and_fraction = param_.getValue("best_charge_and_fraction") == "true";
+    vector<PeptideQuant::value_type*> pep_entries;
+    pep_entries.reserve(pep_quant_.size());
+    for (auto & pep_q : pep_quant_) pep_entries.push_back(&pep_q);
+
+    Size quant_peptides = 0;
+#pragma omp parallel for schedule(dynamic, 64) reduction(+: quant_peptides)
+    for (SignedSize i = 0; i < (SignedSize)pep_entries.size(); ++i)
     {
-      if (param_.getValue("best_charge_and_fraction") == "true")
+      PeptideQuant::value_type& pep_q = *pep_entries[i];
+      if (best_charge_and_fraction)
       { // quantify according to the best charge state only:
 
         // determine which fraction and charge state yields the maximum number of abundances 
@@ -249,8 +321,9 @@ namespace OpenMS
       }
 
       // count quantified peptide
-      if (!pep_q.second.total_abundances.empty()) { stats_.quant_peptides++; }
+      if (!pep_q.second.total_abundances.empty()) { quant_peptides++; }
     }
+    stats_.quant_peptides += quant_peptides;
 
     //////////////////////////////////////////////////////
     // normalize (optional):
@@ -398,18 +471,21 @@ namespace OpenMS
       // proteotypic peptide
       const String peptide = pep_q.first.toUnmodifiedString();
 
-      prot_quant_[accession].psm_count += pep_q.second.psm_count;
+      ProteinData& prot_data = prot_quant_[accession];
+      prot_data.psm_count += pep_q.second.psm_count;
 
       // transfer abundances and counts from peptides->protein
       // summarize abundances and counts between different peptidoforms       
+      SampleAbundances& pep_abundances = prot_data.abundances[peptide];
       for (auto const & sta : pep_q.second.total_abundances)
       {
-        prot_quant_[accession].abundances[peptide][sta.first] += sta.second;
+        pep_abundances[sta.first] += sta.second;
       }
 
+      SampleAbundances& pep_psm_counts = prot_data.psm_counts[peptide];
       for (auto const & sta : pep_q.second.total_psm_counts)
       {
-        prot_quant_[accession].psm_counts[peptide][sta.first] += sta.second;
+        pep_psm_counts[sta.first] += sta.second;
       }
     }
 
@@ -418,8 +494,16 @@ namespace OpenMS
     bool include_all = param_.getValue("include_all") == "true";
     bool fix_peptides = param_.getValue("consensus:fix_peptides") == "true";
 
-    for (auto & prot_q : prot_quant_)
+    // proteins are aggregated independently of each other, so in parallel:
+    vector<ProteinQuant::value_type*> prot_entries;
+    prot_entries.reserve(prot_quant_.size());
+    for (auto & prot_q : prot_quant_) prot_entries.push_back(&prot_q);
+
+    Size too_few_peptides = 0, quant_proteins = 0;
+#pragma omp parallel for schedule(dynamic, 16) reduction(+: too_few_peptides, quant_proteins)
+    for (SignedSize i = 0; i < (SignedSize)prot_entries.size(); ++i)
     {
+      ProteinQuant::value_type& prot_q = *prot_entries[i];
       const ProteinData& pd = prot_q.second;
 
       // calculate PSM counts based on all (!) peptides of a protein (group)
@@ -438,7 +522,7 @@ namespace OpenMS
       // select which peptides of the current protein (group) are quantified 
       if ((top > 0) && (prot_q.second.abundances.size() < top))
       { // not enough proteotypic peptides? skip protein (except if user chose to include the nevertheless)
-        stats_.too_few_peptides++;
+        too_few_peptides++;
         if (!include_all) { continue; }
       }
 
@@ -491,8 +575,8 @@ namespace OpenMS
         // if we have more than "top", reduce to the top ones
         if ((top > 0) && (ab.second.size() > top))
         {
-          // sort descending:
-          sort(ab.second.begin(), ab.second.end(), greater<double>());
+          // sort the best "top" values descending:
+          partial_sort(ab.second.begin(), ab.second.begin() + top, ab.second.end(), greater<double>());
           ab.second.resize(top); // remove all but best "top" values
         }
 
@@ -527,13 +611,15 @@ namespace OpenMS
       // update statistics:
       if (prot_q.second.total_abundances.empty()) 
       { 
-        stats_.too_few_peptides++; 
+        too_few_peptides++; 
       }
       else 
       {
-        stats_.quant_proteins++;
+        quant_proteins++;
       }
     }
+    stats_.too_few_peptides += too_few_peptides;
+    stats_.quant_proteins += quant_proteins;
   }
 
 
@@ -549,6 +635,10 @@ namespace OpenMS
 
     stats_.total_features = features.size();
 
+    const size_t fraction(1), sample(1);
+    dense_columns_ = sample + 1;
+    const PeptideHit no_hit;
+
     for (auto & f : features)
     {
       if (f.getPeptideIdentifications().empty())
@@ -559,10 +649,13 @@ namespace OpenMS
        
       countPeptides_(f.getPeptideIdentifications(), 1);
       PeptideHit hit = getAnnotation_(f.getPeptideIdentifications());
+      // skip if annotation for the feature is ambiguous or missing
+      if (hit == no_hit) { continue; }
+
       FeatureHandle handle(0, f);
-      const size_t fraction(1), sample(1);
-      quantifyFeature_(handle, fraction, sample, hit); // updates "stats_.quant_features"
+      quantifyFeature_(handle, fraction, sample, internPeptide_(hit.getSequence()), hit.getCharge()); // updates "stats_.quant_features"
     }
+    transferDenseAbundances_();
     countPeptides_(features.getUnassignedPeptideIdentifications(), 1);
     stats_.total_peptides = pep_quant_.size();
     stats_.ambig_features = stats_.total_features - stats_.blank_features -
@@ -591,6 +684,14 @@ namespace OpenMS
     OPENMS_LOG_DEBUG << "  Fractions       : " << stats_.n_fractions << endl;
     OPENMS_LOG_DEBUG << "  Samples (Assays): " << stats_.n_samples << endl;
 
+    // abundances are accumulated in dense (fraction/charge x sample) matrices per peptide
+    dense_columns_ = 1;
+    for (const auto& row : ed.getMSFileSection())
+    {
+      dense_columns_ = std::max(dense_columns_, Size(row.sample + 1));
+    }
+    const PeptideHit no_hit;
+
     for (auto & c : consensus)
     {
       stats_.total_features += c.getFeatures().size();
@@ -604,6 +705,11 @@ namespace OpenMS
 
       countPeptides_(c.getPeptideIdentifications(), stats_.n_fractions);
       PeptideHit hit = getAnnotation_(c.getPeptideIdentifications());
+      // skip if annotation for the feature is ambiguous or missing
+      if (hit == no_hit) { continue; }
+
+      // look up the peptide only once for all features
+      const Size peptide_id = internPeptide_(hit.getSequence());
       for (auto const & f : c.getFeatures())
       {
         // indices in experimental design are 1-based (as in text file)
@@ -612,9 +718,10 @@ namespace OpenMS
         size_t row = f.getMapIndex();
         size_t fraction = ed.getMSFileSection()[row].fraction;
         size_t sample = ed.getMSFileSection()[row].sample;
-        quantifyFeature_(f, fraction, sample, hit); // updates "stats_.quant_features"
+        quantifyFeature_(f, fraction, sample, peptide_id, hit.getCharge()); // updates "stats_.quant_features"
       }
     }
+    transferDenseAbundances_();
     countPeptides_(consensus.getUnassignedPeptideIdentifications(), stats_.n_fractions);
     stats_.total_peptides = pep_quant_.size();
     stats_.ambig_features = stats_.total_features - stats_.blank_features -
@@ -715,6 +822,9 @@ namespace OpenMS
     stats_ = Statistics();
     pep_quant_.clear();
     prot_quant_.clear();
+    peptide_ids_.clear();
+    dense_abundances_.clear();
+    dense_columns_ = 0;
   }
 
 
@@ -37,12 +37,131 @@
 #include <OpenMS/CONCEPT/ProgressLogger.h>
 #include <OpenMS/FORMAT/SVOutStream.h>
 
+#include <algorithm>
+#include <limits>
+#include <random>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace OpenMS;
 using namespace std;
 
+namespace
+{
+  /**
+     @brief Fit a sigmoid function to decision values (Platt scaling)
+
+     Implementation following LIBSVM (Lin, Lin & Weng: "A note on Platt's probabilistic outputs for support vector machines", 2007).
+
+     @param dec_values Decision values
+     @param targets Class labels (+1/-1) corresponding to @p dec_values
+
+     @return Parameters A and B of the sigmoid 1 / (1 + exp(A * f + B))
+  */
+  pair<double, double> fitSigmoid(const vector<double>& dec_values, const vector<double>& targets)
+  {
+    double prior1 = 0.0, prior0 = 0.0;
+    for (double target : targets)
+    {
+      if (target > 0) prior1 += 1.0;
+      else prior0 += 1.0;
+    }
+    const Size max_iter = 100;
+    const double min_step = 1e-10, sigma = 1e-12, eps = 1e-5;
+    const double hi_target = (prior1 + 1.0) / (prior1 + 2.0);
+    const double lo_target = 1.0 / (prior0 + 2.0);
+
+    // objective function for given sigmoid parameters:
+    vector<double> t(targets.size());
+    for (Size i = 0; i < targets.size(); ++i)
+    {
+      t[i] = (targets[i] > 0) ? hi_target : lo_target;
+    }
+    auto objective = [&](double a, double b)
+    {
+      double fval = 0.0;
+      for (Size i = 0; i < dec_values.size(); ++i)
+      {
+        double f_apb = dec_values[i] * a + b;
+        if (f_apb >= 0) fval += t[i] * f_apb + log(1 + exp(-f_apb));
+        else fval += (t[i] - 1) * f_apb + log(1 + exp(f_apb));
+      }
+      return fval;
+    };
+
+    double a = 0.0, b = log((prior0 + 1.0) / (prior1 + 1.0));
+    double fval = objective(a, b);
+    for (Size iter = 0; iter < max_iter; ++iter)
+    {
+      // gradient and Hessian (use H' = H + sigma * I):
+      double h11 = sigma, h22 = sigma, h21 = 0.0, g1 = 0.0, g2 = 0.0;
+      for (Size i = 0; i < dec_values.size(); ++i)
+      {
+        double f_apb = dec_values[i] * a + b, p, q;
+        if (f_apb >= 0)
+        {
+          p = exp(-f_apb) / (1.0 + exp(-f_apb));
+          q = 1.0 / (1.0 + exp(-f_apb));
+        }
+        else
+        {
+          p = 1.0 / (1.0 + exp(f_apb));
+          q = exp(f_apb) / (1.0 + exp(f_apb));
+        }
+        double d2 = p * q;
+        h11 += dec_values[i] * dec_values[i] * d2;
+        h22 += d2;
+        h21 += dec_values[i] * d2;
+        double d1 = t[i] - p;
+        g1 += dec_values[i] * d1;
+        g2 += d1;
+      }
+      if ((fabs(g1) < eps) && (fabs(g2) < eps)) break; // stopping criterion
+
+      // Newton direction, followed by line search:
+      double det = h11 * h22 - h21 * h21;
+      double d_a = -(h22 * g1 - h21 * g2) / det;
+      double d_b = -(-h21 * g1 + h11 * g2) / det;
+      double gd = g1 * d_a + g2 * d_b;
+      double stepsize = 1.0;
+      while (stepsize >= min_step)
+      {
+        double new_a = a + stepsize * d_a, new_b = b + stepsize * d_b;
+        double new_f = objective(new_a, new_b);
+        if (new_f < fval + 0.0001 * stepsize * gd) // sufficient decrease
+        {
+          a = new_a;
+          b = new_b;
+          fval = new_f;
+          break;
+        }
+        stepsize /= 2.0;
+      }
+      if (stepsize < min_step)
+      {
+        OPENMS_LOG_DEBUG << "Line search fails in two-class probability estimates" << endl;
+        break;
+      }
+    }
+    return make_pair(a, b);
+  }
+
+  /// Probability (of the positive class) for a decision value, given sigmoid parameters
+  double predictSigmoid(double dec_value, const pair<double, double>& params)
+  {
+    double f_apb = dec_value * params.first + params.second;
+    // 1 - p if dec_value is replaced by -dec_value:
+    if (f_apb >= 0) return exp(-f_apb) / (1.0 + exp(-f_apb));
+    return 1.0 / (1.0 + exp(f_apb));
+  }
+}
+
 
 SimpleSVM::SimpleSVM():
-  DefaultParamHandler("SimpleSVM"), data_(), model_(nullptr)
+  DefaultParamHandler("SimpleSVM"), data_(), model_(nullptr),
+  use_linear_solver_(false), linear_labels_(0, 0), sigmoid_params_(0.0, 0.0)
 {
   defaults_.setValue("kernel", "RBF", "SVM kernel");
   defaults_.setValidStrings("kernel", ListUtils::create<String>("RBF,linear"));
@@ -69,6 +188,10 @@ SimpleSVM::SimpleSVM():
   defaults_.setValidStrings("no_shrinking",
                             ListUtils::create<String>("true,false"));
 
+  defaults_.setValue("linear_solver", "coordinate_descent", "Solver for two-class classification with a linear kernel: dual coordinate descent on dense data (fast, bias term is regularized as in LIBLINEAR) or LIBSVM", advanced);
+  defaults_.setValidStrings("linear_solver",
+                            ListUtils::create<String>("coordinate_descent,libsvm"));
+
   defaultsToParam_();
 
   svm_set_print_string_function(&printNull_); // suppress output of LIBSVM
@@ -77,7 +200,7 @@ SimpleSVM::SimpleSVM():
 
 SimpleSVM::~SimpleSVM()
 {
-  if (model_ != nullptr) svm_free_model_content(model_);
+  if (model_ != nullptr) svm_free_and_destroy_model(&model_);
   delete[] data_.x;
   delete[] data_.y;
 }
@@ -99,6 +222,7 @@ void SimpleSVM::setup(PredictorMap& predictors, const map<Size, Int>& labels)
   data_.l = labels.size();
   data_.x = new svm_node*[data_.l];
   data_.y = new double[data_.l];
+  training_obs_.resize(data_.l);
   map<Int, Size> label_table;
   Size index = 0;
   for (map<Size, Int>::const_iterator it = labels.begin(); it != labels.end();
@@ -113,6 +237,7 @@ void SimpleSVM::setup(PredictorMap& predictors, const map<Size, Int>& labels)
     }
     data_.x[index] = &(nodes_[it->first][0]);
     data_.y[index] = double(it->second);
+    training_obs_[index] = it->first;
     label_table[it->second]++;
   }
   if (label_table.size() < 2)
@@ -146,10 +271,51 @@ void SimpleSVM::setup(PredictorMap& predictors, const map<Size, Int>& labels)
   svm_params_.nr_weight = 0; // weighting not supported for now
   svm_params_.probability = 0; // no prob. estimation during cross-validation
 
+  // in case "setup" was called before:
+  if (model_ != nullptr) svm_free_and_destroy_model(&model_);
+  linear_weights_.clear();
+  dense_data_.clear();
+
+  use_linear_solver_ = (svm_params_.kernel_type == LINEAR) &&
+    (param_.getValue("linear_solver") == "coordinate_descent");
+  if (use_linear_solver_ && (label_table.size() > 2))
+  {
+    OPENMS_LOG_INFO << "Linear solver supports only two classes - using LIBSVM."
+                    << endl;
+    use_linear_solver_ = false;
+  }
+  if (use_linear_solver_)
+  {
+    // dense copy of the (informative) predictors:
+    Size n_pred = predictor_names_.size();
+    dense_data_.resize(n_obs * n_pred);
+    for (Size pred_index = 0; pred_index < n_pred; ++pred_index)
+    {
+      const vector<double>& values = predictors[predictor_names_[pred_index]];
+      for (Size obs_index = 0; obs_index < n_obs; ++obs_index)
+      {
+        dense_data_[obs_index * n_pred + pred_index] = values[obs_index];
+      }
+    }
+    // same orientation as LIBSVM: positive decision values for the first label
+    linear_labels_.first = Int(data_.y[0]);
+    linear_labels_.second = (label_table.begin()->first == linear_labels_.first) ?
+      label_table.rbegin()->first : label_table.begin()->first;
+  }
+
   optimizeParameters_();
+
+  if (use_linear_solver_)
+  {
+    vector<Size> training(data_.l);
+    for (Size i = 0; i < training.size(); ++i) training[i] = i;
+    trainLinear_(training, svm_params_.C, linear_weights_);
+    OPENMS_LOG_INFO << "Trained linear SVM model (dual coordinate descent)."
+                    << endl;
+    return;
+  }
+
   svm_params_.probability = 1;
-  // in case "setup" was called before:
-  if (model_ != nullptr) svm_free_model_content(model_);
   model_ = svm_train(&data_, &svm_params_);
   OPENMS_LOG_INFO << "Number of support vectors in the final model: " << model_->l
            << endl;
@@ -158,7 +324,7 @@ void SimpleSVM::setup(PredictorMap& predictors, const map<Size, Int>& labels)
 
 void SimpleSVM::predict(vector<Prediction>& predictions, vector<Size> indexes) const
 {
-  if (model_ == nullptr)
+  if ((model_ == nullptr) && linear_weights_.empty())
   {
     throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
                                   "SVM model has not been trained (use the "
@@ -171,6 +337,33 @@ void SimpleSVM::predict(vector<Prediction>& predictions, vector<Size> indexes) c
     indexes.reserve(n_obs);
     for (Size i = 0; i < n_obs; indexes.push_back(i++)){};
   }
+
+  if (model_ == nullptr) // linear model
+  {
+    const double min_prob = 1e-7; // as in LIBSVM
+    predictions.clear();
+    predictions.reserve(indexes.size());
+    for (vector<Size>::iterator it = indexes.begin(); it != indexes.end(); ++it)
+    {
+      if (*it >= n_obs)
+      {
+        String msg = "Invalid index for prediction; there are only " + 
+          String(n_obs) + " observations.";
+        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+                                      msg, String(*it));
+      }
+      double dec_value = linearDecisionValue_(linear_weights_, *it);
+      double prob = predictSigmoid(dec_value, sigmoid_params_);
+      prob = min(max(prob, min_prob), 1 - min_prob);
+      Prediction pred;
+      pred.label = (prob >= 0.5) ? linear_labels_.first : linear_labels_.second;
+      pred.probabilities[linear_labels_.first] = prob;
+      pred.probabilities[linear_labels_.second] = 1 - prob;
+      predictions.push_back(pred);
+    }
+    return;
+  }
+
   Size n_classes = svm_get_nr_class(model_);
   vector<Int> labels(n_classes);
   svm_get_labels(model_, &(labels[0]));
@@ -200,12 +393,21 @@ void SimpleSVM::predict(vector<Prediction>& predictions, vector<Size> indexes) c
 
 void SimpleSVM::getFeatureWeights(map<String, double>& feature_weights) const
 {
-  if (model_ == nullptr)
+  if ((model_ == nullptr) && linear_weights_.empty())
   {
     throw Exception::Precondition(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
                                   "SVM model has not been trained (use the "
                                   "'setup' method)");
   }
+  if (model_ == nullptr) // linear model (always two classes)
+  {
+    feature_weights.clear();
+    for (Size pred_index = 0; pred_index < predictor_names_.size(); ++pred_index)
+    {
+      feature_weights[predictor_names_[pred_index]] = linear_weights_[pred_index];
+    }
+    return;
+  }
   Size k = model_->nr_class;
   if (k > 2)
   {
@@ -390,37 +592,116 @@ void SimpleSVM::optimizeParameters_()
 
   OPENMS_LOG_INFO << "Running cross-validation to find optimal SVM parameters..." 
            << endl;
+  vector<Size> partitions = assignPartitions_();
+  Size n_grid = log2_gamma_.size() * log2_C_.size();
+  Size n_tasks = n_grid * n_parts_;
+  // numbers of correct predictions per task (parameter combination and partition):
+  vector<Size> n_correct(n_tasks, 0);
+  // cross-validation decision values of the linear solver for every "C" (for probability estimates):
+  vector<vector<double> > dec_values;
+  if (use_linear_solver_)
+  {
+    dec_values.assign(log2_C_.size(), vector<double>(data_.l));
+  }
+
+  // every concurrent training run allocates its own kernel cache, so the
+  // configured cache size is shared between the threads:
+  double task_cache_size = svm_params_.cache_size;
+#ifdef _OPENMP
+  Size n_threads = min(Size(omp_get_max_threads()), n_tasks);
+  if (n_threads > 1)
+  {
+    task_cache_size = max(1.0, task_cache_size / n_threads);
+  }
+#endif
+
   Size prog_counter = 0;
   ProgressLogger prog_log;
-  prog_log.startProgress(1, log2_gamma_.size() * log2_C_.size(),
-                         "testing SVM parameters");
+  prog_log.startProgress(0, n_tasks, "testing SVM parameters");
+#pragma omp parallel for schedule(dynamic, 1)
+  for (SignedSize task = 0; task < (SignedSize)n_tasks; ++task)
+  {
+    // vary "C"s faster than "gamma"s, partitions fastest:
+    Size part = task % n_parts_;
+    Size c_index = (task / n_parts_) % log2_C_.size();
+    Size g_index = task / (n_parts_ * log2_C_.size());
+
+    // with only one partition, training and test set are the same:
+    vector<Size> training, test;
+    for (Size i = 0; i < Size(data_.l); ++i)
+    {
+      if ((n_parts_ == 1) || (partitions[i] != part)) training.push_back(i);
+      if ((n_parts_ == 1) || (partitions[i] == part)) test.push_back(i);
+    }
+
+    Size correct = 0;
+    if (use_linear_solver_)
+    {
+      vector<double> weights;
+      trainLinear_(training, pow(2.0, log2_C_[c_index]), weights);
+      for (Size i : test)
+      {
+        double dec_value = linearDecisionValue_(weights, training_obs_[i]);
+        dec_values[c_index][i] = dec_value;
+        Int label = (dec_value > 0) ? linear_labels_.first : linear_labels_.second;
+        if (label == data_.y[i]) correct++;
+      }
+    }
+    else
+    {
+      struct svm_parameter params = svm_params_;
+      params.C = pow(2.0, log2_C_[c_index]);
+      params.gamma = pow(2.0, log2_gamma_[g_index]);
+      params.cache_size = task_cache_size;
+      vector<struct svm_node*> x;
+      vector<double> y;
+      x.reserve(training.size());
+      y.reserve(training.size());
+      for (Size i : training)
+      {
+        x.push_back(data_.x[i]);
+        y.push_back(data_.y[i]);
+      }
+      struct svm_problem subset;
+      subset.l = int(training.size());
+      subset.x = &(x[0]);
+      subset.y = &(y[0]);
+      struct svm_model* model = svm_train(&subset, &params);
+      for (Size i : test)
+      {
+        if (svm_predict(model, data_.x[i]) == data_.y[i]) correct++;
+      }
+      svm_free_and_destroy_model(&model);
+    }
+    n_correct[task] = correct;
+
+#pragma omp critical (SimpleSVM_progress)
+    prog_log.setProgress(++prog_counter);
+  }
+  prog_log.endProgress();
+
   // classification performance for different parameter pairs:
   performance_.resize(log2_gamma_.size());
   // vary "C"s in inner loop to keep results for all "C"s in one vector:
   for (Size g_index = 0; g_index < log2_gamma_.size(); ++g_index)
   {
-    svm_params_.gamma = pow(2.0, log2_gamma_[g_index]);
     performance_[g_index].resize(log2_C_.size());
     for (Size c_index = 0; c_index < log2_C_.size(); ++c_index)
     {
-      svm_params_.C = pow(2.0, log2_C_[c_index]);
-      vector<double> targets(data_.l);
-      svm_cross_validation(&data_, &svm_params_, n_parts_, &(targets[0]));
-      Size n_correct = 0;
-      for (Size i = 0; i < Size(data_.l); ++i)
+      Size offset = (g_index * log2_C_.size() + c_index) * n_parts_;
+      Size correct = 0;
+      for (Size part = 0; part < n_parts_; ++part)
       {
-        if (targets[i] == data_.y[i]) n_correct++;
+        correct += n_correct[offset + part];
       }
-      double ratio = n_correct / double(data_.l);
+      double ratio = correct / double(data_.l);
       performance_[g_index][c_index] = ratio;
-      prog_log.setProgress(++prog_counter);
       OPENMS_LOG_DEBUG << "Performance (log2_C = " << log2_C_[c_index] 
                 << ", log2_gamma = " << log2_gamma_[g_index] << "): " 
-                << n_correct << " correct (" << float(ratio * 100.0) << "%)"
+                << correct << " correct (" << float(ratio * 100.0) << "%)"
                 << endl;
     }
   }
-  prog_log.endProgress();
 
   pair<double, double> best_params = chooseBestParameters_();
   OPENMS_LOG_INFO << "Best SVM parameters: log2_C = " << best_params.first
@@ -428,5 +709,149 @@ void SimpleSVM::optimizeParameters_()
 
   svm_params_.C = pow(2.0, best_params.first);
   svm_params_.gamma = pow(2.0, best_params.second);
+
+  if (use_linear_solver_)
+  {
+    // probability estimates (Platt scaling) based on cross-validation results:
+    Size c_index = find(log2_C_.begin(), log2_C_.end(), best_params.first) -
+      log2_C_.begin();
+    vector<double> targets(data_.l);
+    for (Size i = 0; i < targets.size(); ++i)
+    {
+      targets[i] = (Int(data_.y[i]) == linear_labels_.first) ? 1.0 : -1.0;
+    }
+    sigmoid_params_ = fitSigmoid(dec_values[c_index], targets);
+  }
+}
+
+
+vector<Size> SimpleSVM::assignPartitions_() const
+{
+  // shuffle observations (deterministically), then distribute the observations
+  // of each class evenly over the partitions:
+  vector<Size> order(data_.l);
+  for (Size i = 0; i < order.size(); ++i) order[i] = i;
+  mt19937 rng(42);
+  for (Size i = order.size(); i > 1; --i)
+  {
+    swap(order[i - 1], order[rng() % i]);
+  }
+  map<double, Size> class_counts;
+  vector<Size> partitions(data_.l);
+  for (Size i : order)
+  {
+    partitions[i] = class_counts[data_.y[i]]++ % n_parts_;
+  }
+  return partitions;
+}
+
+
+void SimpleSVM::trainLinear_(const vector<Size>& training, double C,
+                             vector<double>& weights) const
+{
+  // dual coordinate descent for the L1-loss SVM, following LIBLINEAR
+  // (Hsieh et al.: "A dual coordinate descent method for large-scale linear SVM", 2008)
+  Size n_pred = predictor_names_.size();
+  Size n_train = training.size();
+  weights.assign(n_pred + 1, 0.0); // last element: bias
+  vector<double> alpha(n_train, 0.0), y(n_train), q_diag(n_train);
+  for (Size j = 0; j < n_train; ++j)
+  {
+    Size i = training[j];
+    y[j] = (Int(data_.y[i]) == linear_labels_.first) ? 1.0 : -1.0;
+    const double* row = dense_data_.data() + training_obs_[i] * n_pred;
+    double sq_norm = 1.0; // bias term
+    for (Size k = 0; k < n_pred; ++k) sq_norm += row[k] * row[k];
+    q_diag[j] = sq_norm;
+  }
+
+  vector<Size> index(n_train);
+  for (Size j = 0; j < n_train; ++j) index[j] = j;
+  mt19937 rng(1);
+  const Size max_iter = 1000;
+  const double eps = svm_params_.eps;
+  const double inf = numeric_limits<double>::infinity();
+  double pg_max_old = inf, pg_min_old = -inf;
+  Size active_size = n_train;
+  Size iter = 0;
+  for (; iter < max_iter; ++iter)
+  {
+    double pg_max_new = -inf, pg_min_new = inf;
+    for (Size s = active_size; s > 1; --s)
+    {
+      swap(index[s - 1], index[rng() % s]);
+    }
+    for (Size s = 0; s < active_size; ++s)
+    {
+      Size j = index[s];
+      const double* row = dense_data_.data() + training_obs_[training[j]] * n_pred;
+      double g = weights[n_pred];
+      for (Size k = 0; k < n_pred; ++k) g += weights[k] * row[k];
+      g = g * y[j] - 1;
+
+      // projected gradient (and shrinking of the active set):
+      double pg = 0.0;
+      if (alpha[j] == 0)
+      {
+        if (g > pg_max_old)
+        {
+          --active_size;
+          swap(index[s], index[active_size]);
+          --s;
+          continue;
+        }
+        else if (g < 0) pg = g;
+      }
+      else if (alpha[j] == C)
+      {
+        if (g < pg_min_old)
+        {
+          --active_size;
+          swap(index[s], index[active_size]);
+          --s;
+          continue;
+        }
+        else if (g > 0) pg = g;
+      }
+      else pg = g;
+      pg_max_new = max(pg_max_new, pg);
+      pg_min_new = min(pg_min_new, pg);
+
+      if (fabs(pg) > 1.0e-12)
+      {
+        double alpha_old = alpha[j];
+        alpha[j] = min(max(alpha[j] - g / q_diag[j], 0.0), C);
+        double d = (alpha[j] - alpha_old) * y[j];
+        for (Size k = 0; k < n_pred; ++k) weights[k] += d * row[k];
+        weights[n_pred] += d;
+      }
+    }
+
+    if (pg_max_new - pg_min_new <= eps)
+    {
+      if (active_size == n_train) break;
+      // check convergence on all observations:
+      active_size = n_train;
+      pg_max_old = inf;
+      pg_min_old = -inf;
+      continue;
+    }
+    pg_max_old = (pg_max_new <= 0) ? inf : pg_max_new;
+    pg_min_old = (pg_min_new >= 0) ? -inf : pg_min_new;
+  }
+  if (iter >= max_iter)
+  {
+    OPENMS_LOG_DEBUG << "Linear SVM solver reached the maximum number of iterations." << endl;
+  }
+}
+
+
+double SimpleSVM::linearDecisionValue_(const vector<double>& weights, Size obs_index) const
+{
+  Size n_pred = predictor_names_.size();
+  const double* row = dense_data_.data() + obs_index * n_pred;
+  double dec_value = weights[n_pred];
+  for (Size k = 0; k < n_pred; ++k) dec_value += weights[k] * row[k];
+  return dec_value;
 }
 
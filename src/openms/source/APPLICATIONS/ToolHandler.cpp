@@ -247,6 +247,8 @@ namespace OpenMS
     util_map["SequenceCoverageCalculator"] = Internal::ToolDescription("SequenceCoverageCalculator", util_category);
     util_map["SpecLibCreator"] = Internal::ToolDescription("SpecLibCreator", util_category);
     util_map["SpectraSTSearchAdapter"] = Internal::ToolDescription("SpectraSTSearchAdapter", util_category);
+    util_map["MassDecompositionBenchmark"] = Internal::ToolDescription("MassDecompositionBenchmark", util_category);
+    util_map["SpectrumGeneratorBenchmark"] = Internal::ToolDescription("SpectrumGeneratorBenchmark", util_category);
     util_map["SimpleSearchEngine"] = Internal::ToolDescription("SimpleSearchEngine", util_category);
     util_map["SiriusAdapter"] = Internal::ToolDescription("SiriusAdapter", util_category);
     util_map["StaticModification"] = Internal::ToolDescription("StaticModification", util_category);
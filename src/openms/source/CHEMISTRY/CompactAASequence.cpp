@@ -0,0 +1,503 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CHEMISTRY/CompactAASequence.h>
+
+#include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/CHEMISTRY/ResidueDB.h>
+#include <OpenMS/CHEMISTRY/ResidueModification.h>
+#include <OpenMS/CONCEPT/Constants.h>
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/CONCEPT/LogStream.h>
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+
+using namespace std;
+
+namespace OpenMS
+{
+  namespace
+  {
+    /// entry of the interned residue table
+    struct InternedResidue
+    {
+      const Residue* residue;
+      double mono_weight;
+      double average_weight;
+    };
+
+    /**
+      @brief Process-wide table of all residues used by CompactAASequence
+
+      Entries are stored in fixed-size chunks that are never reallocated, so
+      an index obtained from internResidue() can be dereferenced without
+      taking the lock. Only adding residues is synchronized.
+    */
+    class InternedResidueTable
+    {
+    public:
+      static const Size CHUNK_SIZE = 256;
+      static const Size MAX_CHUNKS = 256; // 256 * 256 = range of CompactAASequence::ResidueIndex
+
+      /// returns the index of @p residue (caller has to hold the lock); returns false if the table is full
+      bool intern(const Residue* residue, CompactAASequence::ResidueIndex& index)
+      {
+        auto it = index_.find(residue);
+        if (it != index_.end())
+        {
+          index = it->second;
+          return true;
+        }
+        if (size_ == CHUNK_SIZE * MAX_CHUNKS) return false;
+
+        Size chunk = size_ / CHUNK_SIZE;
+        if (!chunks_[chunk]) chunks_[chunk].reset(new InternedResidue[CHUNK_SIZE]);
+        chunks_[chunk][size_ % CHUNK_SIZE] = InternedResidue{residue,
+          residue->getMonoWeight(Residue::Internal),
+          residue->getAverageWeight(Residue::Internal)};
+
+        index = static_cast<CompactAASequence::ResidueIndex>(size_);
+        index_.emplace(residue, index);
+        ++size_;
+        return true;
+      }
+
+      const InternedResidue& operator[](CompactAASequence::ResidueIndex index) const
+      {
+        return chunks_[index / CHUNK_SIZE][index % CHUNK_SIZE];
+      }
+
+      Size size() const
+      {
+        return size_;
+      }
+
+    private:
+      std::unordered_map<const Residue*, CompactAASequence::ResidueIndex> index_;
+      std::unique_ptr<InternedResidue[]> chunks_[MAX_CHUNKS];
+      Size size_ = 0;
+    };
+
+    InternedResidueTable& getTable()
+    {
+      static InternedResidueTable table;
+      return table;
+    }
+
+    bool isNTerminalType(Residue::ResidueType type)
+    {
+      return type == Residue::Full || type == Residue::AIon || type == Residue::BIon ||
+             type == Residue::CIon || type == Residue::NTerminal;
+    }
+
+    bool isCTerminalType(Residue::ResidueType type)
+    {
+      return type == Residue::Full || type == Residue::XIon || type == Residue::YIon ||
+             type == Residue::ZIon || type == Residue::CTerminal;
+    }
+
+    double getTerminalAverageWeight(Residue::ResidueType type)
+    {
+      static const double full = Residue::getInternalToFull().getAverageWeight();
+      static const double n_term = Residue::getInternalToNTerm().getAverageWeight();
+      static const double c_term = Residue::getInternalToCTerm().getAverageWeight();
+      static const double a_ion = Residue::getInternalToAIon().getAverageWeight();
+      static const double b_ion = Residue::getInternalToBIon().getAverageWeight();
+      static const double c_ion = Residue::getInternalToCIon().getAverageWeight();
+      static const double x_ion = Residue::getInternalToXIon().getAverageWeight();
+      static const double y_ion = Residue::getInternalToYIon().getAverageWeight();
+      static const double z_ion = Residue::getInternalToZIon().getAverageWeight();
+      switch (type)
+      {
+        case Residue::Full: return full;
+        case Residue::Internal: return 0.0;
+        case Residue::NTerminal: return n_term;
+        case Residue::CTerminal: return c_term;
+        case Residue::AIon: return a_ion;
+        case Residue::BIon: return b_ion;
+        case Residue::CIon: return c_ion;
+        case Residue::XIon: return x_ion;
+        case Residue::YIon: return y_ion;
+        case Residue::ZIon: return z_ion;
+        default:
+          OPENMS_LOG_ERROR << "CompactAASequence::getAverageWeight: unknown ResidueType" << std::endl;
+      }
+      return 0.0;
+    }
+  }
+
+  CompactAASequence::CompactAASequence() :
+    residues_(),
+    n_term_mod_(nullptr),
+    c_term_mod_(nullptr),
+    internal_mono_(0.0),
+    internal_average_(0.0),
+    has_unknown_(false),
+    prefix_ready_(false)
+  {
+  }
+
+  CompactAASequence::CompactAASequence(const AASequence& seq) :
+    residues_(),
+    n_term_mod_(seq.getNTerminalModification()),
+    c_term_mod_(seq.getCTerminalModification()),
+    internal_mono_(0.0),
+    internal_average_(0.0),
+    has_unknown_(false),
+    prefix_ready_(false)
+  {
+    static const Residue* const rx = ResidueDB::getInstance()->getResidue("X");
+
+    residues_.resize(seq.size());
+    bool table_full(false);
+    // a single lock for the whole sequence instead of one per residue
+    #pragma omp critical (OpenMS_CompactAASequence)
+    {
+      InternedResidueTable& table = getTable();
+      for (Size i = 0; i != seq.size(); ++i)
+      {
+        if (!table.intern(&seq[i], residues_[i]))
+        {
+          table_full = true;
+          break;
+        }
+      }
+    }
+    if (table_full)
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, InternedResidueTable::CHUNK_SIZE * InternedResidueTable::MAX_CHUNKS, InternedResidueTable::CHUNK_SIZE * InternedResidueTable::MAX_CHUNKS);
+    }
+
+    const InternedResidueTable& table = getTable();
+    for (ResidueIndex r : residues_)
+    {
+      const InternedResidue& entry = table[r];
+      if (entry.residue == rx) has_unknown_ = true;
+      internal_mono_ += entry.mono_weight;
+      internal_average_ += entry.average_weight;
+    }
+  }
+
+  CompactAASequence::CompactAASequence(const CompactAASequence& rhs) :
+    residues_(rhs.residues_),
+    n_term_mod_(rhs.n_term_mod_),
+    c_term_mod_(rhs.c_term_mod_),
+    internal_mono_(rhs.internal_mono_),
+    internal_average_(rhs.internal_average_),
+    has_unknown_(rhs.has_unknown_),
+    prefix_ready_(false)
+  {
+  }
+
+  CompactAASequence::CompactAASequence(CompactAASequence&& rhs) noexcept :
+    residues_(std::move(rhs.residues_)),
+    n_term_mod_(rhs.n_term_mod_),
+    c_term_mod_(rhs.c_term_mod_),
+    internal_mono_(rhs.internal_mono_),
+    internal_average_(rhs.internal_average_),
+    has_unknown_(rhs.has_unknown_),
+    prefix_ready_(false)
+  {
+  }
+
+  CompactAASequence::~CompactAASequence()
+  {
+  }
+
+  CompactAASequence& CompactAASequence::operator=(const CompactAASequence& rhs)
+  {
+    if (this != &rhs)
+    {
+      residues_ = rhs.residues_;
+      n_term_mod_ = rhs.n_term_mod_;
+      c_term_mod_ = rhs.c_term_mod_;
+      internal_mono_ = rhs.internal_mono_;
+      internal_average_ = rhs.internal_average_;
+      has_unknown_ = rhs.has_unknown_;
+      prefix_mono_.clear();
+      prefix_ready_ = false;
+    }
+    return *this;
+  }
+
+  CompactAASequence& CompactAASequence::operator=(CompactAASequence&& rhs) noexcept
+  {
+    if (this != &rhs)
+    {
+      residues_ = std::move(rhs.residues_);
+      n_term_mod_ = rhs.n_term_mod_;
+      c_term_mod_ = rhs.c_term_mod_;
+      internal_mono_ = rhs.internal_mono_;
+      internal_average_ = rhs.internal_average_;
+      has_unknown_ = rhs.has_unknown_;
+      prefix_mono_.clear();
+      prefix_ready_ = false;
+    }
+    return *this;
+  }
+
+  CompactAASequence CompactAASequence::fromString(const String& s, bool permissive)
+  {
+    return CompactAASequence(AASequence::fromString(s, permissive));
+  }
+
+  AASequence CompactAASequence::toAASequence() const
+  {
+    AASequence seq;
+    const InternedResidueTable& table = getTable();
+    for (ResidueIndex r : residues_)
+    {
+      seq += table[r].residue;
+    }
+    seq.setNTerminalModification(n_term_mod_);
+    seq.setCTerminalModification(c_term_mod_);
+    return seq;
+  }
+
+  String CompactAASequence::toString() const
+  {
+    return toAASequence().toString();
+  }
+
+  const Residue& CompactAASequence::getResidue(Size index) const
+  {
+    if (index >= residues_.size())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, index, residues_.size());
+    }
+    return *getTable()[residues_[index]].residue;
+  }
+
+  bool CompactAASequence::has(const Residue& residue) const
+  {
+    const InternedResidueTable& table = getTable();
+    for (ResidueIndex r : residues_)
+    {
+      if (*table[r].residue == residue) return true;
+    }
+    return false;
+  }
+
+  double CompactAASequence::getTerminalMonoWeight_(Residue::ResidueType type)
+  {
+    static const double full = Residue::getInternalToFull().getMonoWeight();
+    static const double n_term = Residue::getInternalToNTerm().getMonoWeight();
+    static const double c_term = Residue::getInternalToCTerm().getMonoWeight();
+    static const double a_ion = Residue::getInternalToAIon().getMonoWeight();
+    static const double b_ion = Residue::getInternalToBIon().getMonoWeight();
+    static const double c_ion = Residue::getInternalToCIon().getMonoWeight();
+    static const double x_ion = Residue::getInternalToXIon().getMonoWeight();
+    static const double y_ion = Residue::getInternalToYIon().getMonoWeight();
+    static const double z_ion = Residue::getInternalToZIon().getMonoWeight();
+    switch (type)
+    {
+      case Residue::Full: return full;
+      case Residue::Internal: return 0.0;
+      case Residue::NTerminal: return n_term;
+      case Residue::CTerminal: return c_term;
+      case Residue::AIon: return a_ion;
+      case Residue::BIon: return b_ion;
+      case Residue::CIon: return c_ion;
+      case Residue::XIon: return x_ion;
+      case Residue::YIon: return y_ion;
+      case Residue::ZIon: return z_ion;
+      default:
+        OPENMS_LOG_ERROR << "CompactAASequence::getMonoWeight: unknown ResidueType" << std::endl;
+    }
+    return 0.0;
+  }
+
+  double CompactAASequence::getMonoWeight(Residue::ResidueType type, Int charge) const
+  {
+    if (residues_.empty())
+    {
+      OPENMS_LOG_ERROR << "CompactAASequence::getMonoWeight: Mass for ResidueType " << type << " not defined for sequences of length 0." << std::endl;
+      return 0.0;
+    }
+    if (has_unknown_)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Cannot get weight of sequence with unknown AA 'X' with unknown mass.", toString());
+    }
+
+    double mono_weight = internal_mono_ + Constants::PROTON_MASS_U * charge + getTerminalMonoWeight_(type);
+    if (n_term_mod_ != nullptr && isNTerminalType(type)) mono_weight += n_term_mod_->getDiffMonoMass();
+    if (c_term_mod_ != nullptr && isCTerminalType(type)) mono_weight += c_term_mod_->getDiffMonoMass();
+    return mono_weight;
+  }
+
+  double CompactAASequence::getAverageWeight(Residue::ResidueType type, Int charge) const
+  {
+    if (residues_.empty())
+    {
+      OPENMS_LOG_ERROR << "CompactAASequence::getAverageWeight: Mass for ResidueType " << type << " not defined for sequences of length 0." << std::endl;
+      return 0.0;
+    }
+    if (has_unknown_)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Cannot get weight of sequence with unknown AA 'X' with unknown mass.", toString());
+    }
+
+    double average_weight = internal_average_ + Constants::PROTON_MASS_U * charge + getTerminalAverageWeight(type);
+    if (n_term_mod_ != nullptr && isNTerminalType(type)) average_weight += n_term_mod_->getDiffAverageMass();
+    if (c_term_mod_ != nullptr && isCTerminalType(type)) average_weight += c_term_mod_->getDiffAverageMass();
+    return average_weight;
+  }
+
+  double CompactAASequence::getMZ(Int charge, Residue::ResidueType type) const
+  {
+    if (charge == 0) throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Can't calculate mass-to-charge ratio for charge=0.", toString());
+    return getMonoWeight(type, charge) / charge;
+  }
+
+  void CompactAASequence::computePrefixMasses_() const
+  {
+    const InternedResidueTable& table = getTable();
+    prefix_mono_.resize(residues_.size());
+    double sum(0.0);
+    for (Size i = 0; i != residues_.size(); ++i)
+    {
+      sum += table[residues_[i]].mono_weight;
+      prefix_mono_[i] = sum;
+    }
+  }
+
+  const std::vector<double>& CompactAASequence::getPrefixMonoMasses() const
+  {
+    if (!prefix_ready_.load(std::memory_order_acquire))
+    {
+      #pragma omp critical (OpenMS_CompactAASequence_prefix)
+      {
+        if (!prefix_ready_.load(std::memory_order_relaxed))
+        {
+          computePrefixMasses_();
+          prefix_ready_.store(true, std::memory_order_release);
+        }
+      }
+    }
+    return prefix_mono_;
+  }
+
+  double CompactAASequence::getPrefixMonoWeight(Size length, Residue::ResidueType type, Int charge) const
+  {
+    if (length == 0 || length > residues_.size())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, length, residues_.size());
+    }
+    double mono_weight = getPrefixMonoMasses()[length - 1] + Constants::PROTON_MASS_U * charge + getTerminalMonoWeight_(type);
+    if (n_term_mod_ != nullptr) mono_weight += n_term_mod_->getDiffMonoMass();
+    return mono_weight;
+  }
+
+  double CompactAASequence::getSuffixMonoWeight(Size length, Residue::ResidueType type, Int charge) const
+  {
+    if (length == 0 || length > residues_.size())
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, length, residues_.size());
+    }
+    const std::vector<double>& prefix = getPrefixMonoMasses();
+    const Size n = residues_.size();
+    double internal = prefix[n - 1];
+    if (length < n) internal -= prefix[n - length - 1];
+    double mono_weight = internal + Constants::PROTON_MASS_U * charge + getTerminalMonoWeight_(type);
+    if (c_term_mod_ != nullptr) mono_weight += c_term_mod_->getDiffMonoMass();
+    return mono_weight;
+  }
+
+  bool CompactAASequence::operator==(const CompactAASequence& rhs) const
+  {
+    return residues_ == rhs.residues_ &&
+           n_term_mod_ == rhs.n_term_mod_ &&
+           c_term_mod_ == rhs.c_term_mod_;
+  }
+
+  bool CompactAASequence::operator!=(const CompactAASequence& rhs) const
+  {
+    return !(*this == rhs);
+  }
+
+  bool CompactAASequence::operator<(const CompactAASequence& rhs) const
+  {
+    if (residues_.size() != rhs.residues_.size())
+    {
+      return residues_.size() < rhs.residues_.size();
+    }
+    if (residues_ != rhs.residues_)
+    {
+      return std::lexicographical_compare(residues_.begin(), residues_.end(), rhs.residues_.begin(), rhs.residues_.end());
+    }
+    if (n_term_mod_ != rhs.n_term_mod_)
+    {
+      return std::less<const ResidueModification*>()(n_term_mod_, rhs.n_term_mod_);
+    }
+    return std::less<const ResidueModification*>()(c_term_mod_, rhs.c_term_mod_);
+  }
+
+  CompactAASequence::ResidueIndex CompactAASequence::internResidue(const Residue* residue)
+  {
+    ResidueIndex index(0);
+    bool success(false);
+    #pragma omp critical (OpenMS_CompactAASequence)
+    {
+      success = getTable().intern(residue, index);
+    }
+    if (!success)
+    {
+      throw Exception::IndexOverflow(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, InternedResidueTable::CHUNK_SIZE * InternedResidueTable::MAX_CHUNKS, InternedResidueTable::CHUNK_SIZE * InternedResidueTable::MAX_CHUNKS);
+    }
+    return index;
+  }
+
+  const Residue* CompactAASequence::getResidueByIndex(ResidueIndex index)
+  {
+    return getTable()[index].residue;
+  }
+
+  double CompactAASequence::getInternalMonoWeight(ResidueIndex index)
+  {
+    return getTable()[index].mono_weight;
+  }
+
+  Size CompactAASequence::getNumberOfInternedResidues()
+  {
+    Size s;
+    #pragma omp critical (OpenMS_CompactAASequence)
+    {
+      s = getTable().size();
+    }
+    return s;
+  }
+
+} // namespace OpenMS
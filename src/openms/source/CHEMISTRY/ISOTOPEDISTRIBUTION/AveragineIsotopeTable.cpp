@@ -0,0 +1,340 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/AveragineIsotopeTable.h>
+
+#include <OpenMS/CHEMISTRY/ElementDB.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+#include <OpenMS/CONCEPT/Exception.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <memory>
+
+#define AVERAGINE_ISOTOPE_TABLE_FILE_IDENTIFIER 8095
+
+namespace OpenMS
+{
+  const std::string AveragineIsotopeTable::NamesOfAveragineModel[] = {"peptide", "RNA", "DNA"};
+
+  namespace
+  {
+    /// all tables handed out by getTable() / registerTable()
+    std::vector<std::unique_ptr<AveragineIsotopeTable> >& registry()
+    {
+      static std::vector<std::unique_ptr<AveragineIsotopeTable> > tables;
+      return tables;
+    }
+  }
+
+  AveragineIsotopeTable::AveragineIsotopeTable(AveragineModel model, double mass_resolution, double max_mass, Size max_isotopes) :
+    model_(model),
+    mass_resolution_(mass_resolution),
+    n_masses_(0),
+    max_isotopes_(max_isotopes)
+  {
+    checkParameters_(model, mass_resolution, max_mass, max_isotopes);
+
+    n_masses_ = static_cast<Size>(std::ceil(max_mass / mass_resolution)) + 1;
+    sizes_.resize(n_masses_);
+    intensities_.resize(n_masses_ * max_isotopes_, 0.0);
+
+    // initialize the element database before the threads use it
+    ElementDB::getInstance();
+
+#pragma omp parallel
+    {
+      std::vector<double> pattern;
+#pragma omp for schedule(dynamic, 64)
+      for (SignedSize i = 0; i < (SignedSize)n_masses_; ++i)
+      {
+        computeIntensities_(model_, i * mass_resolution_, max_isotopes_, pattern);
+        sizes_[i] = pattern.size();
+        std::copy(pattern.begin(), pattern.end(), intensities_.begin() + i * max_isotopes_);
+      }
+    }
+  }
+
+  AveragineIsotopeTable::AveragineIsotopeTable(const String& filename) :
+    model_(PEPTIDE),
+    mass_resolution_(1.0),
+    n_masses_(0),
+    max_isotopes_(0)
+  {
+    std::ifstream ifs(filename.c_str(), std::ios::binary);
+    if (ifs.fail())
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    int file_identifier = 0;
+    int model = 0;
+    ifs.read((char*)&file_identifier, sizeof(file_identifier));
+    ifs.read((char*)&model, sizeof(model));
+    ifs.read((char*)&mass_resolution_, sizeof(mass_resolution_));
+    ifs.read((char*)&n_masses_, sizeof(n_masses_));
+    ifs.read((char*)&max_isotopes_, sizeof(max_isotopes_));
+    if (!ifs || file_identifier != AVERAGINE_ISOTOPE_TABLE_FILE_IDENTIFIER ||
+        model < 0 || model >= SIZE_OF_AVERAGINEMODEL || !(mass_resolution_ > 0.0) ||
+        n_masses_ < 2 || max_isotopes_ == 0)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "File might not be an averagine isotope table (wrong file magic number or header). Aborting!", filename);
+    }
+    model_ = static_cast<AveragineModel>(model);
+
+    // the table dimensions must match the file size before we allocate anything
+    const std::streampos data_start = ifs.tellg();
+    ifs.seekg(0, std::ios::end);
+    const std::streamoff data_size = ifs.tellg() - data_start;
+    ifs.seekg(data_start);
+    const Size bytes_per_mass = sizeof(Size) + sizeof(double) * max_isotopes_;
+    if (!ifs || data_size < 0 ||
+        max_isotopes_ > Size(data_size) / sizeof(double) ||
+        n_masses_ > Size(data_size) / bytes_per_mass ||
+        n_masses_ * bytes_per_mass != Size(data_size))
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Averagine isotope table size does not match its header (" + String(n_masses_) + " masses, " +
+        String(max_isotopes_) + " isotopes). Aborting!", filename);
+    }
+
+    sizes_.resize(n_masses_);
+    intensities_.resize(n_masses_ * max_isotopes_);
+    ifs.read((char*)&sizes_[0], n_masses_ * sizeof(Size));
+    ifs.read((char*)&intensities_[0], intensities_.size() * sizeof(double));
+    if (!ifs)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Averagine isotope table is truncated. Aborting!", filename);
+    }
+    for (Size i = 0; i < n_masses_; ++i)
+    {
+      if (sizes_[i] > max_isotopes_)
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Averagine isotope table contains an invalid pattern size. Aborting!", filename);
+      }
+    }
+  }
+
+  void AveragineIsotopeTable::checkParameters_(AveragineModel model, double mass_resolution, double max_mass, Size max_isotopes)
+  {
+    if (model < PEPTIDE || model >= SIZE_OF_AVERAGINEMODEL)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Unknown averagine model.", String(int(model)));
+    }
+    if (!(mass_resolution > 0.0))
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Mass resolution must be positive.", String(mass_resolution));
+    }
+    if (!(max_mass >= mass_resolution))
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Maximum mass must not be smaller than the mass resolution.", String(max_mass));
+    }
+    if (max_isotopes == 0)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Number of isotopes must be positive.", String(max_isotopes));
+    }
+  }
+
+  void AveragineIsotopeTable::computeIntensities_(AveragineModel model, double mass, Size n_isotopes, std::vector<double>& intensities)
+  {
+    CoarseIsotopePatternGenerator solver(n_isotopes);
+    IsotopeDistribution distribution;
+    if (model == PEPTIDE)
+    {
+      distribution = solver.estimateFromPeptideWeight(mass);
+    }
+    else if (model == RNA)
+    {
+      distribution = solver.estimateFromRNAWeight(mass);
+    }
+    else
+    {
+      distribution = solver.estimateFromDNAWeight(mass);
+    }
+
+    intensities.clear();
+    for (IsotopeDistribution::ConstIterator it = distribution.begin(); it != distribution.end() && intensities.size() < n_isotopes; ++it)
+    {
+      intensities.push_back(it->getIntensity());
+    }
+  }
+
+  void AveragineIsotopeTable::getIntensities(double mass, Size n_isotopes, std::vector<double>& intensities) const
+  {
+    if (n_isotopes > max_isotopes_)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Averagine isotope table only contains " + String(max_isotopes_) + " isotopes.", String(n_isotopes));
+    }
+
+    const double position = mass / mass_resolution_;
+    if (!(position >= 0.0) || position > double(n_masses_ - 1))
+    {
+      // outside of the table
+      computeIntensities_(model_, mass, n_isotopes, intensities);
+      return;
+    }
+
+    // linear interpolation between the patterns left and right of the mass
+    const Size left = std::min(static_cast<Size>(position), n_masses_ - 2);
+    const double alpha = position - left;
+    const double* left_pattern = &intensities_[left * max_isotopes_];
+    const double* right_pattern = left_pattern + max_isotopes_;
+
+    Size size = sizes_[left];
+    if (alpha == 1.0)
+    {
+      size = sizes_[left + 1];
+    }
+    else if (alpha > 0.0)
+    {
+      size = std::max(size, sizes_[left + 1]);
+    }
+    size = std::min(size, n_isotopes);
+
+    intensities.resize(size);
+    double sum = 0.0;
+    for (Size i = 0; i < size; ++i)
+    {
+      intensities[i] = (1.0 - alpha) * left_pattern[i] + alpha * right_pattern[i];
+    }
+    // renormalize (the first n isotopes of a pattern sum up to less than 1)
+    for (SignedSize i = size - 1; i >= 0; --i)
+    {
+      sum += intensities[i];
+    }
+    if (sum > 0.0)
+    {
+      for (Size i = 0; i < size; ++i)
+      {
+        intensities[i] /= sum;
+      }
+    }
+  }
+
+  void AveragineIsotopeTable::store(const String& filename) const
+  {
+    std::ofstream ofs(filename.c_str(), std::ios::binary);
+    if (ofs.fail())
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+
+    int file_identifier = AVERAGINE_ISOTOPE_TABLE_FILE_IDENTIFIER;
+    int model = model_;
+    ofs.write((char*)&file_identifier, sizeof(file_identifier));
+    ofs.write((char*)&model, sizeof(model));
+    ofs.write((char*)&mass_resolution_, sizeof(mass_resolution_));
+    ofs.write((char*)&n_masses_, sizeof(n_masses_));
+    ofs.write((char*)&max_isotopes_, sizeof(max_isotopes_));
+    ofs.write((char*)&sizes_[0], n_masses_ * sizeof(Size));
+    ofs.write((char*)&intensities_[0], intensities_.size() * sizeof(double));
+    ofs.close();
+  }
+
+  AveragineIsotopeTable::AveragineModel AveragineIsotopeTable::getModel() const
+  {
+    return model_;
+  }
+
+  double AveragineIsotopeTable::getMassResolution() const
+  {
+    return mass_resolution_;
+  }
+
+  double AveragineIsotopeTable::getMaxMass() const
+  {
+    return (n_masses_ - 1) * mass_resolution_;
+  }
+
+  Size AveragineIsotopeTable::getMaxIsotopes() const
+  {
+    return max_isotopes_;
+  }
+
+  const AveragineIsotopeTable& AveragineIsotopeTable::getTable(AveragineModel model, double mass_resolution, double max_mass, Size max_isotopes)
+  {
+    checkParameters_(model, mass_resolution, max_mass, max_isotopes);
+
+    auto find_table = [&]() -> const AveragineIsotopeTable*
+    {
+      for (const auto& registered : registry())
+      {
+        if (registered->model_ == model && registered->mass_resolution_ == mass_resolution &&
+            registered->getMaxMass() >= max_mass && registered->max_isotopes_ >= max_isotopes)
+        {
+          return registered.get();
+        }
+      }
+      return nullptr;
+    };
+
+    const AveragineIsotopeTable* table = nullptr;
+#pragma omp critical (AveragineIsotopeTable_registry)
+    table = find_table();
+    if (table != nullptr) return *table;
+
+    // compute outside of the critical section (may throw, and is parallelized itself)
+    std::unique_ptr<AveragineIsotopeTable> computed(new AveragineIsotopeTable(model, mass_resolution, max_mass, max_isotopes));
+#pragma omp critical (AveragineIsotopeTable_registry)
+    {
+      // another thread may have registered a suitable table in the meantime
+      table = find_table();
+      if (table == nullptr)
+      {
+        table = computed.get();
+        registry().push_back(std::move(computed));
+      }
+    }
+    return *table;
+  }
+
+  const AveragineIsotopeTable& AveragineIsotopeTable::registerTable(const String& filename)
+  {
+    // load outside of the critical section (may throw)
+    std::unique_ptr<AveragineIsotopeTable> loaded(new AveragineIsotopeTable(filename));
+    const AveragineIsotopeTable* table = loaded.get();
+#pragma omp critical (AveragineIsotopeTable_registry)
+    {
+      // prefer the loaded table over previously registered ones
+      registry().insert(registry().begin(), std::move(loaded));
+    }
+    return *table;
+  }
+
+} // namespace OpenMS
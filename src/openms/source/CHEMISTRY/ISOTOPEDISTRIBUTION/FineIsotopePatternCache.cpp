@@ -0,0 +1,202 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/FineIsotopePatternCache.h>
+
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/FineIsotopePatternGenerator.h>
+#include <OpenMS/CHEMISTRY/EmpiricalFormula.h>
+
+#include <boost/functional/hash.hpp>
+
+#include <algorithm>
+
+namespace OpenMS
+{
+
+  bool FineIsotopePatternCache::Key::operator==(const Key& rhs) const
+  {
+    return charge == rhs.charge &&
+           stop_condition == rhs.stop_condition &&
+           use_total_prob == rhs.use_total_prob &&
+           absolute == rhs.absolute &&
+           max_isotopes == rhs.max_isotopes &&
+           elements == rhs.elements;
+  }
+
+  std::size_t FineIsotopePatternCache::KeyHash::operator()(const Key& key) const
+  {
+    std::size_t seed = 0;
+    for (const auto& element : key.elements)
+    {
+      boost::hash_combine(seed, element.first);
+      boost::hash_combine(seed, element.second);
+    }
+    boost::hash_combine(seed, key.charge);
+    boost::hash_combine(seed, key.stop_condition);
+    boost::hash_combine(seed, key.use_total_prob);
+    boost::hash_combine(seed, key.absolute);
+    boost::hash_combine(seed, key.max_isotopes);
+    return seed;
+  }
+
+  FineIsotopePatternCache::FineIsotopePatternCache(Size capacity, Size shards) :
+    capacity_(capacity)
+  {
+    shards = std::max(shards, Size(1));
+    shard_capacity_ = (capacity + shards - 1) / shards;
+    for (Size i = 0; i < shards; ++i)
+    {
+      shards_.emplace_back(new Shard());
+    }
+  }
+
+  FineIsotopePatternCache::Key FineIsotopePatternCache::makeKey_(const FineIsotopePatternGenerator& generator, const EmpiricalFormula& formula)
+  {
+    Key key;
+    key.elements.assign(formula.begin(), formula.end());
+    key.charge = formula.getCharge();
+    key.stop_condition = generator.getThreshold();
+    key.use_total_prob = generator.getTotalProbability();
+    // the absolute flag is ignored in total probability mode
+    key.absolute = !key.use_total_prob && generator.getAbsolute();
+    key.max_isotopes = generator.getMaxIsotopes();
+    return key;
+  }
+
+  bool FineIsotopePatternCache::get(const FineIsotopePatternGenerator& generator, const EmpiricalFormula& formula, IsotopeDistribution& pattern)
+  {
+    const Key key = makeKey_(generator, formula);
+    Shard& shard = *shards_[KeyHash()(key) % shards_.size()];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it == shard.index.end())
+    {
+      ++shard.misses;
+      return false;
+    }
+    ++shard.hits;
+    shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+    pattern = it->second->pattern;
+    return true;
+  }
+
+  void FineIsotopePatternCache::insert(const FineIsotopePatternGenerator& generator, const EmpiricalFormula& formula, const IsotopeDistribution& pattern)
+  {
+    if (shard_capacity_ == 0) return;
+
+    Key key = makeKey_(generator, formula);
+    Shard& shard = *shards_[KeyHash()(key) % shards_.size()];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end())
+    {
+      // another thread computed the same pattern in the meantime
+      shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+      return;
+    }
+    shard.entries.push_front(Entry{std::move(key), pattern});
+    shard.index[shard.entries.front().key] = shard.entries.begin();
+    while (shard.entries.size() > shard_capacity_)
+    {
+      shard.index.erase(shard.entries.back().key);
+      shard.entries.pop_back();
+    }
+  }
+
+  void FineIsotopePatternCache::clear()
+  {
+    for (auto& shard : shards_)
+    {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      shard->index.clear();
+      shard->entries.clear();
+    }
+  }
+
+  Size FineIsotopePatternCache::size() const
+  {
+    Size size(0);
+    for (const auto& shard : shards_)
+    {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      size += shard->entries.size();
+    }
+    return size;
+  }
+
+  Size FineIsotopePatternCache::getCapacity() const
+  {
+    return capacity_;
+  }
+
+  Size FineIsotopePatternCache::getHits() const
+  {
+    Size hits(0);
+    for (const auto& shard : shards_)
+    {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      hits += shard->hits;
+    }
+    return hits;
+  }
+
+  Size FineIsotopePatternCache::getMisses() const
+  {
+    Size misses(0);
+    for (const auto& shard : shards_)
+    {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      misses += shard->misses;
+    }
+    return misses;
+  }
+
+  double FineIsotopePatternCache::getHitRate() const
+  {
+    Size hits = getHits();
+    Size lookups = hits + getMisses();
+    return lookups == 0 ? 0.0 : double(hits) / lookups;
+  }
+
+  void FineIsotopePatternCache::resetStatistics()
+  {
+    for (auto& shard : shards_)
+    {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      shard->hits = 0;
+      shard->misses = 0;
+    }
+  }
+
+}
@@ -36,12 +36,93 @@
 
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopeDistribution.h>
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsoSpecWrapper.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/FineIsotopePatternCache.h>
+#include <OpenMS/CHEMISTRY/EmpiricalFormula.h>
+
+#include <algorithm>
 
 namespace OpenMS
 {
 
   IsotopeDistribution FineIsotopePatternGenerator::run(const EmpiricalFormula& formula) const
   {
+    if (!cache_)
+    {
+      return generate_(formula);
+    }
+    IsotopeDistribution result;
+    if (!cache_->get(*this, formula, result))
+    {
+      result = generate_(formula);
+      cache_->insert(*this, formula, result);
+    }
+    return result;
+  }
+
+  std::vector<IsotopeDistribution> FineIsotopePatternGenerator::run(const std::vector<EmpiricalFormula>& formulas) const
+  {
+    // group identical formulas, so each is computed once
+    std::vector<Size> order(formulas.size());
+    for (Size i = 0; i < order.size(); ++i)
+    {
+      order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&formulas](Size a, Size b) { return formulas[a] < formulas[b]; });
+
+    std::vector<Size> unique; // index of the first occurrence of each formula
+    for (Size i = 0; i < order.size(); ++i)
+    {
+      if (i == 0 || !(formulas[order[i]] == formulas[order[i - 1]]))
+      {
+        unique.push_back(i);
+      }
+    }
+
+    std::vector<IsotopeDistribution> result(formulas.size());
+    // patterns of large formulas take much longer than those of small ones
+#pragma omp parallel for schedule(dynamic, 1)
+    for (SignedSize u = 0; u < (SignedSize)unique.size(); ++u)
+    {
+      Size first = unique[u];
+      Size last = (u + 1 < (SignedSize)unique.size()) ? unique[u + 1] : order.size();
+      IsotopeDistribution pattern = run(formulas[order[first]]);
+      for (Size i = first + 1; i < last; ++i)
+      {
+        result[order[i]] = pattern;
+      }
+      result[order[first]] = std::move(pattern);
+    }
+    return result;
+  }
+
+  IsotopeDistribution FineIsotopePatternGenerator::generate_(const EmpiricalFormula& formula) const
+  {
+    if (max_isotopes_ > 0)
+    {
+      // memory-bounded mode: walk the configurations from the most to the least
+      // probable one and stop at the stop condition or after max_isotopes_
+      IsoSpecOrderedGeneratorWrapper generator(formula);
+      std::vector<Peak1D> distribution;
+      double acc_prob = 0.0;
+      double limit = -1.0;
+      while (distribution.size() < max_isotopes_ && generator.nextConf())
+      {
+        double p = generator.getIntensity();
+        if (!use_total_prob_)
+        {
+          // relative thresholds refer to the most probable (i.e. first) configuration
+          if (limit < 0.0) limit = absolute_ ? stop_condition_ : stop_condition_ * p;
+          if (p < limit) break;
+        }
+        distribution.emplace_back(generator.getMass(), p);
+        acc_prob += p;
+        if (use_total_prob_ && acc_prob >= 1.0 - stop_condition_) break;
+      }
+      IsotopeDistribution result;
+      result.set(std::move(distribution));
+      result.sortByMass();
+      return result;
+    }
 
     if (use_total_prob_)
     {
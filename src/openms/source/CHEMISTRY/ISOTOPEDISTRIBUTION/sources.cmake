@@ -4,7 +4,9 @@ set(directory source/CHEMISTRY/ISOTOPEDISTRIBUTION)
 
 ### list all filenames of the directory here
 set(sources_list
+  AveragineIsotopeTable.cpp
   CoarseIsotopePatternGenerator.cpp
+  FineIsotopePatternCache.cpp
   FineIsotopePatternGenerator.cpp
   IsotopeDistribution.cpp
   IsoSpecWrapper.cpp
@@ -51,21 +51,38 @@ namespace OpenMS
         new integer_decomposer_type(weights));
     }
 
-    RealMassDecomposer::decompositions_type RealMassDecomposer::getDecompositions(double mass, double error)
+    std::pair<RealMassDecomposer::integer_value_type, RealMassDecomposer::integer_value_type>
+    RealMassDecomposer::getIntegerMassRange(double mass, double error) const
     {
       // defines the range of integers to be decomposed
       integer_value_type start_integer_mass = static_cast<integer_value_type>(
         ceil((1 + rounding_errors_.first) * (mass - error) / precision_));
       integer_value_type end_integer_mass = static_cast<integer_value_type>(
         floor((1 + rounding_errors_.second) * (mass + error) / precision_));
+      return std::make_pair(start_integer_mass, end_integer_mass);
+    }
+
+    RealMassDecomposer::decompositions_type RealMassDecomposer::getIntegerMassDecompositions(integer_value_type integer_mass) const
+    {
+      return decomposer_->getAllDecompositions(integer_mass);
+    }
+
+    double RealMassDecomposer::getParentMass(const decomposition_type & decomposition) const
+    {
+      return weights_.getParentMass(decomposition);
+    }
+
+    RealMassDecomposer::decompositions_type RealMassDecomposer::getDecompositions(double mass, double error) const
+    {
+      std::pair<integer_value_type, integer_value_type> range = getIntegerMassRange(mass, error);
 
       decompositions_type all_decompositions_from_range;
 
       // loops and finds decompositions for every integer mass,
       // then checks if real mass of decomposition lays in the allowed
       // error interval [mass-error; mass+error]
-      for (integer_value_type integer_mass = start_integer_mass;
-           integer_mass < end_integer_mass; ++integer_mass)
+      for (integer_value_type integer_mass = range.first;
+           integer_mass < range.second; ++integer_mass)
       {
         decompositions_type decompositions =
           decomposer_->getAllDecompositions(integer_mass);
@@ -89,22 +106,17 @@ namespace OpenMS
     }
 
     RealMassDecomposer::decompositions_type RealMassDecomposer::getDecompositions(double mass, double error,
-                                                                                  const constraints_type & constraints)
+                                                                                  const constraints_type & constraints) const
     {
-
-      // defines the range of integers to be decomposed
-      integer_value_type start_integer_mass = static_cast<integer_value_type>(
-        ceil((1 + rounding_errors_.first) * (mass - error) / precision_));
-      integer_value_type end_integer_mass = static_cast<integer_value_type>(
-        floor((1 + rounding_errors_.second) * (mass + error) / precision_));
+      std::pair<integer_value_type, integer_value_type> range = getIntegerMassRange(mass, error);
 
       decompositions_type all_decompositions_from_range;
 
       // loops and finds decompositions for every integer mass,
       // then checks if real mass of decomposition lays in the allowed
       // error interval [mass-error; mass+error]
-      for (integer_value_type integer_mass = start_integer_mass;
-           integer_mass < end_integer_mass; ++integer_mass)
+      for (integer_value_type integer_mass = range.first;
+           integer_mass < range.second; ++integer_mass)
       {
         decompositions_type decompositions =
           decomposer_->getAllDecompositions(integer_mass);
@@ -148,7 +160,7 @@ namespace OpenMS
       return all_decompositions_from_range;
     }
 
-    RealMassDecomposer::number_of_decompositions_type RealMassDecomposer::getNumberOfDecompositions(double mass, double error)
+    RealMassDecomposer::number_of_decompositions_type RealMassDecomposer::getNumberOfDecompositions(double mass, double error) const
     {
       // defines the range of integers to be decomposed
       integer_value_type start_integer_mass = static_cast<integer_value_type>(1);
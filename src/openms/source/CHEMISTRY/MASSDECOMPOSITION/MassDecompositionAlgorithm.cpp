@@ -38,18 +38,30 @@
 #include <OpenMS/CHEMISTRY/ModificationDefinition.h>
 #include <OpenMS/CHEMISTRY/ModificationDefinitionsSet.h>
 
+#include <algorithm>
 #include <iostream>
 using namespace std;
 
 namespace OpenMS
 {
+  namespace
+  {
+    /// decomposers (and their extended residue tables) already built, keyed by alphabet and precision
+    map<String, shared_ptr<const ims::RealMassDecomposer> > decomposer_registry;
+  }
+
   MassDecompositionAlgorithm::MassDecompositionAlgorithm() :
     DefaultParamHandler("MassDecompositionAlgorithm"),
     alphabet_(nullptr),
-    decomposer_(nullptr)
+    decomposer_(),
+    cache_(),
+    cache_size_(0),
+    tolerance_(0.0)
   {
     defaults_.setValue("decomp_weights_precision", 0.01, "precision used to calculate the decompositions, this only affects cache usage!", ListUtils::create<String>("advanced"));
     defaults_.setValue("tolerance", 0.3, "tolerance which is allowed for the decompositions");
+    defaults_.setValue("cache_size", 10000, "maximal number of (discretized) masses whose decompositions are memoized, 0 disables the memo", ListUtils::create<String>("advanced"));
+    defaults_.setMinInt("cache_size", 0);
 
     vector<String> all_mods;
     ModificationsDB::getInstance()->getAllSearchModifications(all_mods);
@@ -71,35 +83,94 @@ namespace OpenMS
   MassDecompositionAlgorithm::~MassDecompositionAlgorithm()
   {
     delete alphabet_;
-    delete decomposer_;
   }
 
   void MassDecompositionAlgorithm::getDecompositions(vector<MassDecomposition> & decomps, double mass)
   {
-    double tolerance((double) param_.getValue("tolerance"));
-    ims::RealMassDecomposer::decompositions_type decompositions = decomposer_->getDecompositions(mass, tolerance);
+    if (cache_size_ == 0)
+    {
+      DecompositionCache cache;
+      decompose_(decomps, mass, cache);
+      return;
+    }
+    if (cache_.size() >= cache_size_)
+    {
+      cache_.clear();
+    }
+    decompose_(decomps, mass, cache_);
+  }
+
+  void MassDecompositionAlgorithm::getDecompositions(vector<vector<MassDecomposition> > & decomps, const vector<double> & masses)
+  {
+    decomps.clear();
+    decomps.resize(masses.size());
 
-    for (ims::RealMassDecomposer::decompositions_type::const_iterator pos = decompositions.begin(); pos != decompositions.end(); ++pos)
+    vector<Size> order(masses.size());
+    for (Size i = 0; i < order.size(); ++i)
     {
-      String d;
-      for (ims::IMSAlphabet::size_type i = 0; i < alphabet_->size(); ++i)
+      order[i] = i;
+    }
+    stable_sort(order.begin(), order.end(), [&masses](Size a, Size b) { return masses[a] < masses[b]; });
+
+    // without memo, only the integer masses of the current window are kept
+    DecompositionCache window;
+    DecompositionCache & cache = cache_size_ == 0 ? window : cache_;
+    for (Size i : order)
+    {
+      // masses are sorted, so integer masses below the current range will not be needed again
+      if (&cache == &window || cache.size() >= cache_size_)
       {
-        if ((*pos)[i] > 0)
+        cache.erase(cache.begin(), cache.lower_bound(decomposer_->getIntegerMassRange(masses[i], tolerance_).first));
+      }
+      decompose_(decomps[i], masses[i], cache);
+    }
+  }
+
+  void MassDecompositionAlgorithm::decompose_(vector<MassDecomposition> & decomps, double mass, DecompositionCache & cache) const
+  {
+    pair<ims::RealMassDecomposer::integer_value_type, ims::RealMassDecomposer::integer_value_type> range = decomposer_->getIntegerMassRange(mass, tolerance_);
+
+    // checks for every integer mass of the range whether the real mass of its
+    // decompositions lays in the allowed interval [mass - tolerance, mass + tolerance]
+    for (ims::RealMassDecomposer::integer_value_type integer_mass = range.first; integer_mass < range.second; ++integer_mass)
+    {
+      DecompositionCache::iterator it = cache.lower_bound(integer_mass);
+      if (it == cache.end() || it->first != integer_mass)
+      {
+        DecompositionList list;
+        ims::RealMassDecomposer::decompositions_type decompositions = decomposer_->getIntegerMassDecompositions(integer_mass);
+        list.reserve(decompositions.size());
+        for (ims::RealMassDecomposer::decompositions_type::const_iterator pos = decompositions.begin(); pos != decompositions.end(); ++pos)
         {
-          d += alphabet_->getName(i) + String((*pos)[i]) + " ";
+          String d;
+          for (ims::IMSAlphabet::size_type i = 0; i < alphabet_->size(); ++i)
+          {
+            if ((*pos)[i] > 0)
+            {
+              d += alphabet_->getName(i) + String((*pos)[i]) + " ";
+            }
+          }
+          d.trim();
+          list.emplace_back(decomposer_->getParentMass(*pos), MassDecomposition(d));
         }
+        it = cache.emplace_hint(it, integer_mass, std::move(list));
       }
-      d.trim();
-      MassDecomposition decomp(d);
-      decomps.push_back(decomp);
-    }
 
-    return;
+      for (const pair<double, MassDecomposition> & entry : it->second)
+      {
+        if (fabs(entry.first - mass) <= tolerance_)
+        {
+          decomps.push_back(entry.second);
+        }
+      }
+    }
   }
 
   void MassDecompositionAlgorithm::updateMembers_()
   {
-    // todo add accessor to tolerance, it is called very often in CID mode
+    tolerance_ = (double) param_.getValue("tolerance");
+    cache_size_ = (Int) param_.getValue("cache_size");
+    cache_.clear();
 
     Map<char, double> aa_to_weight;
 
@@ -188,10 +259,6 @@ namespace OpenMS
     {
       delete alphabet_;
     }
-    if (decomposer_ != nullptr)
-    {
-      delete decomposer_;
-    }
 
     // init mass decomposer
     alphabet_ = new ims::IMSAlphabet();
@@ -200,14 +267,29 @@ namespace OpenMS
       alphabet_->push_back(String(it->first), it->second);
     }
 
-    // initializes weights
-    ims::Weights weights(alphabet_->getMasses(), (double) param_.getValue("decomp_weights_precision"));
+    double precision = (double) param_.getValue("decomp_weights_precision");
+    String key(precision);
+    for (ims::IMSAlphabet::size_type i = 0; i < alphabet_->size(); ++i)
+    {
+      key += " " + alphabet_->getName(i) + "=" + String(alphabet_->getMass(i));
+    }
 
-    // optimize alphabet by dividing by gcd
-    weights.divideByGCD();
+#pragma omp critical (MassDecompositionAlgorithm_decomposers)
+    {
+      shared_ptr<const ims::RealMassDecomposer> & decomposer = decomposer_registry[key];
+      if (!decomposer)
+      {
+        // initializes weights
+        ims::Weights weights(alphabet_->getMasses(), precision);
+
+        // optimize alphabet by dividing by gcd
+        weights.divideByGCD();
 
-    // decomposes real values
-    decomposer_ = new ims::RealMassDecomposer(weights);
+        // decomposes real values
+        decomposer = make_shared<const ims::RealMassDecomposer>(weights);
+      }
+      decomposer_ = decomposer;
+    }
 
     return;
   }
@@ -35,13 +35,16 @@
 #include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
 
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/FineIsotopePatternCache.h>
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/FineIsotopePatternGenerator.h>
 #include <OpenMS/CONCEPT/Constants.h>
 #include <OpenMS/CONCEPT/LogStream.h>
 #include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/CHEMISTRY/CompactAASequence.h>
 #include <OpenMS/CHEMISTRY/ResidueDB.h>
 #include <OpenMS/KERNEL/MSSpectrum.h>
 
+#include <limits>
 #include <unordered_set>
 
 using namespace std;
@@ -119,12 +122,14 @@ namespace OpenMS
   TheoreticalSpectrumGenerator::TheoreticalSpectrumGenerator(const TheoreticalSpectrumGenerator& rhs) :
     DefaultParamHandler(rhs)
   {
+    updateMembers_();
   }
 
 
   TheoreticalSpectrumGenerator& TheoreticalSpectrumGenerator::operator=(const TheoreticalSpectrumGenerator& rhs)
   {
     DefaultParamHandler::operator=(rhs);
+    updateMembers_();
     return *this;
   }
 
@@ -134,6 +139,23 @@ namespace OpenMS
   }
 
   void TheoreticalSpectrumGenerator::getSpectrum(PeakSpectrum& spectrum, const AASequence& peptide, Int min_charge, Int max_charge, Int precursor_charge) const
+  {
+    getSpectrum_(spectrum, peptide, min_charge, max_charge, precursor_charge);
+  }
+
+  void TheoreticalSpectrumGenerator::getSpectrum(PeakSpectrum& spectrum, const CompactAASequence& peptide, Int min_charge, Int max_charge, Int precursor_charge) const
+  {
+    if (add_isotopes_ || add_losses_)
+    {
+      // isotope clusters and losses are computed from the residue formulas
+      getSpectrum_(spectrum, peptide.toAASequence(), min_charge, max_charge, precursor_charge);
+      return;
+    }
+    getSpectrum_(spectrum, peptide, min_charge, max_charge, precursor_charge);
+  }
+
+  template <typename SequenceType>
+  void TheoreticalSpectrumGenerator::getSpectrum_(PeakSpectrum& spectrum, const SequenceType& peptide, Int min_charge, Int max_charge, Int precursor_charge) const
   {
     if (peptide.empty())
     {
@@ -242,7 +264,191 @@ namespace OpenMS
   }
 
 
-  void TheoreticalSpectrumGenerator::addAbundantImmoniumIons_(PeakSpectrum& spectrum, const AASequence& peptide, DataArrays::StringDataArray& ion_names, DataArrays::IntegerDataArray& charges) const
+  void TheoreticalSpectrumGenerator::FragmentBuffer::clear()
+  {
+    mz.clear();
+    intensity.clear();
+    ion_type.clear();
+    charge.clear();
+  }
+
+  void TheoreticalSpectrumGenerator::getFragments(FragmentBuffer& buffer, const AASequence& peptide, Int min_charge, Int max_charge, bool add_intensities, bool add_ion_types) const
+  {
+    // running sums of the internal residue weights (reuses the buffer memory)
+    buffer.prefix_masses.resize(peptide.size());
+    double sum(0.0);
+    for (Size i = 0; i != peptide.size(); ++i)
+    {
+      sum += peptide[i].getMonoWeight(Residue::Internal);
+      buffer.prefix_masses[i] = sum;
+    }
+    getFragments_(buffer, peptide, buffer.prefix_masses, min_charge, max_charge, add_intensities, add_ion_types);
+  }
+
+  void TheoreticalSpectrumGenerator::getFragments(FragmentBuffer& buffer, const CompactAASequence& peptide, Int min_charge, Int max_charge, bool add_intensities, bool add_ion_types) const
+  {
+    getFragments_(buffer, peptide, peptide.getPrefixMonoMasses(), min_charge, max_charge, add_intensities, add_ion_types);
+  }
+
+  template <typename SequenceType>
+  void TheoreticalSpectrumGenerator::getFragments_(FragmentBuffer& buffer,
+                                                   const SequenceType& peptide,
+                                                   const std::vector<double>& prefix_masses,
+                                                   Int min_charge,
+                                                   Int max_charge,
+                                                   bool add_intensities,
+                                                   bool add_ion_types) const
+  {
+    buffer.clear();
+    buffer.run_mz.clear();
+    buffer.run_intensity.clear();
+    buffer.run_ion_type.clear();
+    buffer.run_charge.clear();
+    buffer.run_begin.clear();
+
+    if (peptide.empty())
+    {
+      return;
+    }
+
+    static const double stat_a = Residue::getInternalToAIon().getMonoWeight();
+    static const double stat_b = Residue::getInternalToBIon().getMonoWeight();
+    static const double stat_c = Residue::getInternalToCIon().getMonoWeight();
+    static const double stat_x = Residue::getInternalToXIon().getMonoWeight();
+    static const double stat_y = Residue::getInternalToYIon().getMonoWeight();
+    static const double stat_z = Residue::getInternalToZIon().getMonoWeight();
+    static const double stat_full = Residue::getInternalToFull().getMonoWeight();
+    static const double h2o_mono = EmpiricalFormula("H2O").getMonoWeight();
+    static const double nh3_mono = EmpiricalFormula("NH3").getMonoWeight();
+
+    const Size n = peptide.size();
+    const double n_term_mod = peptide.getNTerminalModification() ? peptide.getNTerminalModification()->getDiffMonoMass() : 0.0;
+    const double c_term_mod = peptide.getCTerminalModification() ? peptide.getCTerminalModification()->getDiffMonoMass() : 0.0;
+    const double total = prefix_masses[n - 1];
+
+    // appends a single fragment to the current run
+    auto add = [&buffer, add_intensities, add_ion_types](double mz, double intensity, Residue::ResidueType type, Int charge)
+    {
+      buffer.run_mz.push_back(mz);
+      if (add_intensities) buffer.run_intensity.push_back(static_cast<float>(intensity));
+      if (add_ion_types)
+      {
+        buffer.run_ion_type.push_back(static_cast<uint8_t>(type));
+        buffer.run_charge.push_back(static_cast<uint8_t>(charge));
+      }
+    };
+
+    // every ladder is sorted by construction (increasing fragment length)
+    auto add_prefix_ladder = [&](Residue::ResidueType type, double offset, double intensity, Int charge)
+    {
+      buffer.run_begin.push_back(buffer.run_mz.size());
+      const double shift = n_term_mod + offset + Constants::PROTON_MASS_U * charge;
+      for (Size length = add_first_prefix_ion_ ? 1 : 2; length < n; ++length)
+      {
+        add((prefix_masses[length - 1] + shift) / charge, intensity, type, charge);
+      }
+    };
+
+    auto add_suffix_ladder = [&](Residue::ResidueType type, double offset, double intensity, Int charge)
+    {
+      buffer.run_begin.push_back(buffer.run_mz.size());
+      const double shift = c_term_mod + offset + Constants::PROTON_MASS_U * charge;
+      for (Size length = 1; length < n; ++length)
+      {
+        add((total - prefix_masses[n - length - 1] + shift) / charge, intensity, type, charge);
+      }
+    };
+
+    // c and x ions are not defined for a single residue (addPeaks_ throws as well)
+    if ((add_c_ions_ || add_x_ions_) && n < 2 && min_charge <= max_charge)
+    {
+      throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 1);
+    }
+
+    for (Int z = min_charge; z <= max_charge; ++z)
+    {
+      if (add_b_ions_) add_prefix_ladder(Residue::BIon, stat_b, b_intensity_, z);
+      if (add_y_ions_) add_suffix_ladder(Residue::YIon, stat_y, y_intensity_, z);
+      if (add_a_ions_) add_prefix_ladder(Residue::AIon, stat_a, a_intensity_, z);
+      if (add_c_ions_) add_prefix_ladder(Residue::CIon, stat_c, c_intensity_, z);
+      if (add_x_ions_) add_suffix_ladder(Residue::XIon, stat_x, x_intensity_, z);
+      if (add_z_ions_) add_suffix_ladder(Residue::ZIon, stat_z, z_intensity_, z);
+    }
+
+    if (add_precursor_peaks_)
+    {
+      const double full = total + n_term_mod + c_term_mod + stat_full;
+      for (Int z = add_all_precursor_charges_ ? min_charge : max_charge; z <= max_charge; ++z)
+      {
+        // [M+H]-H2O < [M+H]-NH3 < [M+H]
+        buffer.run_begin.push_back(buffer.run_mz.size());
+        const double mono = full + Constants::PROTON_MASS_U * z;
+        add((mono - h2o_mono) / z, pre_int_H2O_, Residue::Full, z);
+        add((mono - nh3_mono) / z, pre_int_NH3_, Residue::Full, z);
+        add(mono / z, pre_int_, Residue::Full, z);
+      }
+    }
+
+    if (add_abundant_immonium_ions_)
+    {
+      static const ResidueDB* const db = ResidueDB::getInstance();
+      static const std::pair<const Residue*, double> immonium[] =
+      {
+        {db->getResidue('P'), 70.0656},
+        {db->getResidue('C'), 76.0221},
+        {db->getResidue('L'), 86.09698},
+        {db->getResidue('H'), 110.0718},
+        {db->getResidue('F'), 120.0813},
+        {db->getResidue('Y'), 136.0762},
+        {db->getResidue('W'), 159.0922}
+      };
+      buffer.run_begin.push_back(buffer.run_mz.size());
+      for (const auto& ion : immonium)
+      {
+        if (peptide.has(*ion.first)) add(ion.second, 1.0, Residue::Internal, 1);
+      }
+    }
+
+    // k-way merge of the sorted runs into the output arrays
+    const Size total_size = buffer.run_mz.size();
+    const Size runs = buffer.run_begin.size();
+    buffer.run_begin.push_back(total_size); // sentinel: end of last run
+    buffer.cursor.assign(buffer.run_begin.begin(), buffer.run_begin.end() - 1);
+
+    buffer.mz.resize(total_size);
+    if (add_intensities) buffer.intensity.resize(total_size);
+    if (add_ion_types)
+    {
+      buffer.ion_type.resize(total_size);
+      buffer.charge.resize(total_size);
+    }
+
+    for (Size out = 0; out != total_size; ++out)
+    {
+      Size best_run = runs;
+      double best_mz = std::numeric_limits<double>::max();
+      for (Size r = 0; r != runs; ++r)
+      {
+        const Size c = buffer.cursor[r];
+        if (c != buffer.run_begin[r + 1] && buffer.run_mz[c] < best_mz)
+        {
+          best_mz = buffer.run_mz[c];
+          best_run = r;
+        }
+      }
+      const Size from = buffer.cursor[best_run]++;
+      buffer.mz[out] = best_mz;
+      if (add_intensities) buffer.intensity[out] = buffer.run_intensity[from];
+      if (add_ion_types)
+      {
+        buffer.ion_type[out] = buffer.run_ion_type[from];
+        buffer.charge[out] = buffer.run_charge[from];
+      }
+    }
+  }
+
+  template <typename SequenceType>
+  void TheoreticalSpectrumGenerator::addAbundantImmoniumIons_(PeakSpectrum& spectrum, const SequenceType& peptide, DataArrays::StringDataArray& ion_names, DataArrays::IntegerDataArray& charges) const
   {
     // Proline immonium ion (C4H8N)
     if (peptide.has(*ResidueDB::getInstance()->getResidue('P')))
@@ -361,7 +567,7 @@ namespace OpenMS
     }
     else if (isotope_model_ == 2)
     {
-      dist = f.getIsotopeDistribution(FineIsotopePatternGenerator(max_isotope_probability_));
+      dist = f.getIsotopeDistribution(fine_isotope_generator_);
     }
 
     for (const auto& it : dist)
@@ -471,7 +677,7 @@ namespace OpenMS
         }
         else if (isotope_model_ == 2)
         {
-          dist = loss_ion.getIsotopeDistribution(FineIsotopePatternGenerator(max_isotope_probability_));
+          dist = loss_ion.getIsotopeDistribution(fine_isotope_generator_);
         }
 
         for (const auto& iso : dist)
@@ -740,6 +946,79 @@ namespace OpenMS
   }
 
 
+  void TheoreticalSpectrumGenerator::addPeaks_(PeakSpectrum& spectrum,
+                                               const CompactAASequence& peptide,
+                                               DataArrays::StringDataArray& ion_names,
+                                               DataArrays::IntegerDataArray& charges,
+                                               MSSpectrum::Chunks& chunks,
+                                               const Residue::ResidueType res_type,
+                                               Int charge) const
+  {
+    const String charge_str((Size)abs(charge), '+');
+    const String residue_str(Residue::residueTypeToIonLetter(res_type));
+
+    spectrum.reserve(spectrum.size() + peptide.size());
+
+    double intensity(1);
+
+    switch (res_type)
+    {
+      case Residue::AIon: intensity = a_intensity_; break;
+      case Residue::BIon: intensity = b_intensity_; break;
+      case Residue::CIon: if (peptide.size() < 2) throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 1); intensity = c_intensity_; break;
+      case Residue::XIon: if (peptide.size() < 2) throw Exception::InvalidSize(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 1); intensity = x_intensity_; break;
+      case Residue::YIon: intensity = y_intensity_; break;
+      case Residue::ZIon: intensity = z_intensity_; break;
+      default: break;
+    }
+
+    // As for AASequence, no peaks of the full peptide are generated (therefore "<").
+    // Ions are added with increasing length, i.e. in ascending m/z order.
+    const bool prefix_ion = (res_type == Residue::AIon || res_type == Residue::BIon || res_type == Residue::CIon);
+    Size length = (prefix_ion && !add_first_prefix_ion_) ? 2 : 1;
+    for (; length < peptide.size(); ++length)
+    {
+      double mono_weight = prefix_ion ? peptide.getPrefixMonoWeight(length, res_type, charge) : peptide.getSuffixMonoWeight(length, res_type, charge);
+      spectrum.emplace_back(mono_weight / charge, intensity);
+      if (add_metainfo_)
+      {
+        ion_names.emplace_back(residue_str);
+        ion_names.back().reserve(1 + 3 + charge_str.size());
+        (ion_names.back() += length) += charge_str;
+        charges.push_back(charge);
+      }
+    }
+    chunks.add(true);
+  }
+
+
+  void TheoreticalSpectrumGenerator::addPrecursorPeaks_(PeakSpectrum& spectrum,
+                                                        const CompactAASequence& peptide,
+                                                        DataArrays::StringDataArray& ion_names,
+                                                        DataArrays::IntegerDataArray& charges,
+                                                        Int charge) const
+  {
+    static const double h2o_mono = EmpiricalFormula("H2O").getMonoWeight();
+    static const double nh3_mono = EmpiricalFormula("NH3").getMonoWeight();
+
+    const String charge_str((Size)abs(charge), '+');
+    const double mono_pos = peptide.getMonoWeight(Residue::Full, charge);
+
+    if (add_metainfo_)
+    {
+      ion_names.push_back("[M+H]" + charge_str);
+      ion_names.push_back("[M+H]-H2O" + charge_str);
+      ion_names.push_back("[M+H]-NH3" + charge_str);
+      charges.push_back(charge);
+      charges.push_back(charge);
+      charges.push_back(charge);
+    }
+    spectrum.emplace_back(mono_pos / (double)charge, pre_int_);
+    spectrum.emplace_back((mono_pos - h2o_mono) / (double)charge, pre_int_H2O_);
+    spectrum.emplace_back((mono_pos - nh3_mono) / (double)charge, pre_int_NH3_);
+  }
+
+
   void TheoreticalSpectrumGenerator::addPrecursorPeaks_(PeakSpectrum& spectrum,
                                                         const AASequence& peptide,
                                                         DataArrays::StringDataArray& ion_names,
@@ -765,7 +1044,7 @@ namespace OpenMS
       }
       else if (isotope_model_ == 2)
       {
-        dist = formula.getIsotopeDistribution(FineIsotopePatternGenerator(max_isotope_probability_));
+        dist = formula.getIsotopeDistribution(fine_isotope_generator_);
       }
 
       for (IsotopeDistribution::ConstIterator it = dist.begin(); it != dist.end(); ++it)
@@ -805,7 +1084,7 @@ namespace OpenMS
       }
       else if (isotope_model_ == 2)
       {
-        dist = ion.getIsotopeDistribution(FineIsotopePatternGenerator(max_isotope_probability_));
+        dist = ion.getIsotopeDistribution(fine_isotope_generator_);
       }
 
       for (IsotopeDistribution::ConstIterator it = dist.begin(); it != dist.end(); ++it)
@@ -845,7 +1124,7 @@ namespace OpenMS
       }
       else if (isotope_model_ == 2)
       {
-        dist = ion.getIsotopeDistribution(FineIsotopePatternGenerator(max_isotope_probability_));
+        dist = ion.getIsotopeDistribution(fine_isotope_generator_);
       }
 
       for (IsotopeDistribution::ConstIterator it = dist.begin(); it != dist.end(); ++it)
@@ -895,6 +1174,12 @@ namespace OpenMS
     z_intensity_ = (double)param_.getValue("z_intensity");
     max_isotope_ = (Int)param_.getValue("max_isotope");
     max_isotope_probability_ = param_.getValue("max_isotope_probability");
+    fine_isotope_generator_ = FineIsotopePatternGenerator(max_isotope_probability_);
+    if (param_.getValue("isotope_model") == "fine")
+    {
+      // fragments of different peptides often share their sum formula
+      fine_isotope_generator_.setCache(std::make_shared<FineIsotopePatternCache>());
+    }
     rel_loss_intensity_ = (double)param_.getValue("relative_loss_intensity");
     pre_int_ = (double)param_.getValue("precursor_intensity");
     pre_int_H2O_ = (double)param_.getValue("precursor_H2O_intensity");
@@ -58,28 +58,20 @@ std::vector<double> ClusteringGrid::getGridSpacingY() const
 
 void ClusteringGrid::addCluster(const CellIndex &cell_index, const int &cluster_index)
 {
-    if (cells_.find(cell_index) == cells_.end())
-    {
-        // If hash grid cell does not yet exist, create a new one.
-        std::list<int> clusters;
-        clusters.push_back(cluster_index);
-        cells_.insert(std::make_pair(cell_index, clusters));
-    }
-    else
-    {
-        // If hash grid cell already exists, add the new cluster index to the existing list of clusters.
-        cells_.find(cell_index)->second.push_back(cluster_index);
-    }
+    // If hash grid cell does not yet exist, a new one is created.
+    // Otherwise the new cluster index is added to the existing list of clusters.
+    cells_[cell_index].push_back(cluster_index);
 }
 
 void ClusteringGrid::removeCluster(const CellIndex &cell_index, const int &cluster_index)
 {
-    if (cells_.find(cell_index) != cells_.end())
+    boost::unordered_map<CellIndex, std::list<int> >::iterator cell = cells_.find(cell_index);
+    if (cell != cells_.end())
     {
-        cells_.find(cell_index)->second.remove(cluster_index);
-        if (cells_.find(cell_index)->second.empty())
+        cell->second.remove(cluster_index);
+        if (cell->second.empty())
         {
-            cells_.erase(cell_index);
+            cells_.erase(cell);
         }
     }
 }
@@ -89,7 +81,7 @@ void ClusteringGrid::removeAllClusters()
     cells_.clear();
 }
 
-std::list<int> ClusteringGrid::getClusters(const CellIndex &cell_index) const
+const std::list<int>& ClusteringGrid::getClusters(const CellIndex &cell_index) const
 {
     return cells_.find(cell_index)->second;
 }
@@ -33,7 +33,36 @@
 // --------------------------------------------------------------------------
 //
 
+#include <OpenMS/FILTERING/BASELINE/MorphologicalFilter.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
 
+  void MorphologicalFilter::filterExperiment(PeakMap & exp)
+  {
+    startProgress(0, exp.size(), "filtering baseline");
+    Size progress = 0;
+
+#pragma omp parallel
+    {
+      // filter() stores the structuring element size in a member, so each thread uses its own filter
+      MorphologicalFilter thread_filter;
+      thread_filter.setParameters(param_);
+
+#pragma omp for schedule(dynamic)
+      for (SignedSize i = 0; i < (SignedSize)exp.size(); ++i)
+      {
+        thread_filter.filter(exp[i]);
+        IF_MASTERTHREAD setProgress(progress);
+#pragma omp atomic
+        ++progress;
+      }
+    }
+    endProgress();
+  }
+
 }
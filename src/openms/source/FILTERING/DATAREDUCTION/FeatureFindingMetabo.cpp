@@ -33,6 +33,7 @@
 // --------------------------------------------------------------------------
 
 #include <OpenMS/FILTERING/DATAREDUCTION/FeatureFindingMetabo.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/AveragineIsotopeTable.h>
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
 #include <OpenMS/SYSTEM/File.h>
 #include <OpenMS/ANALYSIS/OPENSWATH/OpenSwathHelper.h>
@@ -287,7 +288,7 @@ namespace OpenMS
   }
 
   FeatureFindingMetabo::FeatureFindingMetabo() :
-    DefaultParamHandler("FeatureFindingMetabo"), ProgressLogger()
+    DefaultParamHandler("FeatureFindingMetabo"), ProgressLogger(), averagine_table_(nullptr)
   {
     defaults_.setValue("local_rt_range", 10.0, "RT range where to look for coeluting mass traces", ListUtils::create<String>("advanced")); // 5.0
     defaults_.setValue("local_mz_range", 6.5, "MZ range where to look for isotopic mass traces", ListUtils::create<String>("advanced")); // 6.5
@@ -345,6 +346,12 @@ namespace OpenMS
     enable_RT_filtering_ = param_.getValue("enable_RT_filtering").toBool();
     
     isotope_filtering_model_ = param_.getValue("isotope_filtering_model");
+    // shared, precomputed averagine patterns for the peptide isotope scoring
+    averagine_table_ = nullptr;
+    if (isotope_filtering_model_ == "peptides")
+    {
+      averagine_table_ = &AveragineIsotopeTable::getTable(AveragineIsotopeTable::PEPTIDE);
+    }
     use_smoothed_intensities_ = param_.getValue("use_smoothed_intensities").toBool();
 
     use_mz_scoring_C13_ = param_.getValue("mz_scoring_13C").toBool();
@@ -371,11 +378,21 @@ namespace OpenMS
 
   double FeatureFindingMetabo::computeAveragineSimScore_(const std::vector<double>& hypo_ints, const double& mol_weight) const
   {
-    CoarseIsotopePatternGenerator solver(hypo_ints.size());
-    auto isodist = solver.estimateFromPeptideWeight(mol_weight);
-    // isodist.renormalize();
+    std::vector<double> averagine_dist;
+    if (averagine_table_ != nullptr && hypo_ints.size() <= averagine_table_->getMaxIsotopes())
+    {
+      averagine_table_->getIntensities(mol_weight, hypo_ints.size(), averagine_dist);
+    }
+    else
+    {
+      CoarseIsotopePatternGenerator solver(hypo_ints.size());
+      for (const auto& peak : solver.estimateFromPeptideWeight(mol_weight))
+      {
+        averagine_dist.push_back(peak.getIntensity());
+      }
+    }
+    averagine_dist.resize(hypo_ints.size(), 0.0);
 
-    IsotopeDistribution::ContainerType averagine_dist = isodist.getContainer();
     double max_int(0.0), theo_max_int(0.0);
     for (Size i = 0; i < hypo_ints.size(); ++i)
     {
@@ -384,9 +401,9 @@ namespace OpenMS
         max_int = hypo_ints[i];
       }
 
-      if (averagine_dist[i].getIntensity() > theo_max_int)
+      if (averagine_dist[i] > theo_max_int)
       {
-        theo_max_int = averagine_dist[i].getIntensity();
+        theo_max_int = averagine_dist[i];
       }
     }
 
@@ -394,7 +411,7 @@ namespace OpenMS
     std::vector<double> averagine_ratios, hypo_isos;
     for (Size i = 0; i < hypo_ints.size(); ++i)
     {
-      averagine_ratios.push_back(averagine_dist[i].getIntensity() / theo_max_int);
+      averagine_ratios.push_back(averagine_dist[i] / theo_max_int);
       hypo_isos.push_back(hypo_ints[i] / max_int);
     }
 
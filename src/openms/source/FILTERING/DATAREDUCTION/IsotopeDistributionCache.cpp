@@ -34,7 +34,7 @@
 
 #include <OpenMS/FILTERING/DATAREDUCTION/IsotopeDistributionCache.h>
 
-#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/AveragineIsotopeTable.h>
 #include <OpenMS/DATASTRUCTURES/String.h>
 
 namespace OpenMS
@@ -48,24 +48,26 @@ namespace OpenMS
     //reserve enough space
     isotope_distributions_.resize(num_isotopes);
 
+    //the window centers are grid masses of a shared table with half the window width as resolution
+    const AveragineIsotopeTable& table = AveragineIsotopeTable::getTable(AveragineIsotopeTable::PEPTIDE,
+      0.5 * mass_window_width, 0.5 * mass_window_width + (num_isotopes - 1) * mass_window_width, 20);
+    std::vector<double> d;
+
     //calculate distribution if necessary
     for (Size index = 0; index < num_isotopes; ++index)
     {
       //log_ << "Calculating iso dist for mass: " << 0.5*mass_window_width_ + index * mass_window_width_ << std::endl;
-      CoarseIsotopePatternGenerator solver(20);
-      auto d = solver.estimateFromPeptideWeight(0.5 * mass_window_width + index * mass_window_width);
+      table.getIntensities(0.5 * mass_window_width + index * mass_window_width, 20, d);
 
       //trim left and right. And store the number of isotopes on the left, to reconstruct the monoisotopic peak
-      Size size_before = d.size();
-      d.trimLeft(intensity_percentage_optional);
-      isotope_distributions_[index].trimmed_left = size_before - d.size();
-      d.trimRight(intensity_percentage_optional);
-
-      for (IsotopeDistribution::Iterator it = d.begin(); it != d.end(); ++it)
-      {
-        isotope_distributions_[index].intensity.push_back(it->getIntensity());
-        //log_ << " - " << it->second << std::endl;
-      }
+      Size left = 0;
+      while (left < d.size() && d[left] < intensity_percentage_optional) ++left;
+      if (left == d.size()) left = 0; // nothing above the cutoff: nothing is trimmed on the left
+      Size right = d.size();
+      while (right > left && d[right - 1] < intensity_percentage_optional) --right;
+      isotope_distributions_[index].trimmed_left = left;
+
+      isotope_distributions_[index].intensity.assign(d.begin() + left, d.begin() + right);
 
       //determine the number of optional peaks at the beginning/end
       Size begin = 0;
@@ -49,6 +49,7 @@
 
 #include <cmath>
 #include <algorithm>    // std::min, std::max
+#include <cstddef>
 #include <cstdlib>
 #include <vector>
 
@@ -384,64 +385,83 @@ namespace c_lowess
       }
     }
 
-    /// Update the counters of the local regression.
-    void update_indices(const ContainerType& x,
-                        const size_t n,
-                        const ValueType delta,
-                        size_t& i,
-                        size_t& last,
-                        ContainerType& ys)
+    /// A local regression that is performed in every robustness iteration.
+    struct FitPoint
     {
-      // For most points within delta of the current point, we skip the
-      // weighted linear regression (which save much computation of
-      // weights and fitted points). Instead, we'll jump to the last
-      // point within delta, fit the weighted regression at that point,
-      // and linearly interpolate in between.
-
-      // the last point actually estimated
-      last = i;
-
-      // This loop increments until we fall just outside of delta distance,
-      // copying the results for any repeated x's along the way.
-      ValueType cut = x[last] + delta;
-      for (i = last + 1; i < n; i++)
+      size_t i; ///< index of the point at which the regression is computed
+      size_t nleft; ///< left end of its neighborhood
+      size_t nright; ///< right end of its neighborhood
+      size_t last; ///< last point that takes over the fit (exact ties in x)
+    };
+
+    /// Determine at which points a regression is computed and find their
+    /// neighborhoods (these only depend on x, not on the robustness weights).
+    void plan_fits(const ContainerType& x,
+                   const size_t n,
+                   const size_t ns,
+                   const ValueType delta,
+                   std::vector<FitPoint>& fits)
+    {
+      // start of array in C++ at 0 / in FORTRAN at 1
+      // last: index of prev estimated point
+      // i: index of current point
+      size_t i(0), last(-1), nleft(0), nright(ns - 1);
+      fits.clear();
+      do
       {
-        // find close points
-        if (x[i] > cut) break;
-
-        // i one beyond last pt within cut
-        if (x[i] == x[last])
+        // Identify the neighborhood around the current x[i]
+        // -> get the nearest ns points
+        update_neighborhood(x, n, i, nleft, nright);
+
+        // For most points within delta of the current point, we skip the
+        // weighted linear regression (which save much computation of
+        // weights and fitted points). Instead, we'll jump to the last
+        // point within delta, fit the weighted regression at that point,
+        // and linearly interpolate in between.
+        FitPoint fit = {i, nleft, nright, i};
+
+        // This loop increments until we fall just outside of delta distance,
+        // recording repeated x's (which take over the fit) along the way.
+        last = i;
+        ValueType cut = x[last] + delta;
+        for (i = last + 1; i < n; i++)
         {
-          // exact match in x
-          // if tied with previous x-value, just use the already
-          // fitted y, and update the last-fit counter.
-          ys[i] = ys[last];
-          last = i;
+          // find close points
+          if (x[i] > cut) break;
+
+          // i one beyond last pt within cut
+          if (x[i] == x[last])
+          {
+            // exact match in x
+            last = i;
+          }
         }
-      }
+        fit.last = last;
+        fits.push_back(fit);
 
+        // the next point to fit the regression at is either one prior to i (since
+        // i should be the first point outside of delta) or it is "last + 1" in the
+        // case that i never got incremented. This insures we always step forward.
+        // -> back 1 point so interpolation within delta, but always go forward
+        i = std::max(last + 1, i - 1);
 
-      // the next point to fit the regression at is either one prior to i (since
-      // i should be the first point outside of delta) or it is "last + 1" in the
-      // case that i never got incremented. This insures we always step forward.
-      // -> back 1 point so interpolation within delta, but always go forward
-      i = std::max(last + 1, i - 1);
+      } while (last < n - 1);
     }
 
     /// Calculate smoothed/fitted y by linear interpolation between the current
     /// and previous y fitted by weighted regression.
     void interpolate_skipped_fits(const ContainerType& x,
-                                  const size_t i,
-                                  const size_t last,
+                                  const FitPoint& previous,
+                                  const FitPoint& current,
                                   ContainerType& ys)
     {
-      // skipped points -- interpolate
+      // skipped points -- interpolate (x[previous.last] == x[previous.i])
       ValueType alpha;
-      ValueType denom = x[i] - x[last]; // non-zero - proof?
-      for (size_t j = last + 1; j < i; j = j + 1)
+      ValueType denom = x[current.i] - x[previous.i]; // non-zero - proof?
+      for (size_t j = previous.last + 1; j < current.i; j = j + 1)
       {
-        alpha = (x[j] - x[last]) / denom;
-        ys[j] = alpha * ys[i] + (1.0 - alpha) * ys[last];
+        alpha = (x[j] - x[previous.i]) / denom;
+        ys[j] = alpha * ys[current.i] + (1.0 - alpha) * ys[previous.i];
       }
     }
 
@@ -511,8 +531,6 @@ public:
                ContainerType& weights   // vector res
                )
     {
-      bool fit_ok;
-
       size_t ns, n(x.size());
       if (n < 2)
       {
@@ -525,46 +543,60 @@ public:
       size_t tmp = (size_t)(frac * (double)n);
       ns = std::max(std::min(tmp, n), (size_t)2);
 
+      // The points at which a regression is computed and their neighborhoods
+      // are the same in every robustness iteration, so we determine them once.
+      std::vector<FitPoint> fits;
+      plan_fits(x, n, ns, delta, fits);
+      const std::ptrdiff_t n_fits = (std::ptrdiff_t)fits.size();
+      const std::ptrdiff_t n_points = (std::ptrdiff_t)n;
+
+      // only spawn threads if there is enough work to share
+      const bool run_parallel = fits.size() * ns > 100000;
+
       // robustness iterations
       for (int iter = 1; iter <= nsteps + 1; iter++)
       {
-        // start of array in C++ at 0 / in FORTRAN at 1
-        // last: index of prev estimated point
-        // i: index of current point
-        size_t i(0), last(-1), nleft(0), nright(ns -1);
-
-        // Fit all data points y[i] until the end of the array
-        do
+#pragma omp parallel if (run_parallel)
         {
-          // Identify the neighborhood around the current x[i]
-          // -> get the nearest ns points
-          update_neighborhood(x, n, i, nleft, nright);
+          // the fit of each point uses the weight vector as scratch space, so
+          // every thread needs its own
+          ContainerType fit_weights(n);
 
-          // Calculate weights and apply fit (original lowest function)
-          fit_ok = lowest(x, y, n, x[i], ys[i], nleft, nright,
-                          weights, (iter > 1), resid_weights);
+          // Fit all selected data points y[i] (independent of each other)
+#pragma omp for schedule(static)
+          for (std::ptrdiff_t k = 0; k < n_fits; ++k)
+          {
+            const FitPoint& fit = fits[k];
+
+            // Calculate weights and apply fit (original lowest function)
+            bool fit_ok = lowest(x, y, n, x[fit.i], ys[fit.i], fit.nleft, fit.nright,
+                                 fit_weights, (iter > 1), resid_weights);
 
-          // if something went wrong during the fit, use y[i] as the
-          // fitted value at x[i]
-          if (!fit_ok) ys[i] = y[i];
+            // if something went wrong during the fit, use y[i] as the
+            // fitted value at x[i]
+            if (!fit_ok) ys[fit.i] = y[fit.i];
+
+            // if tied with the fitted x-value, just use the already fitted y
+            for (size_t j = fit.i + 1; j <= fit.last; j++)
+            {
+              ys[j] = ys[fit.i];
+            }
+          }
 
           // If we skipped some points (because of how delta was set), go back
           // and fit them by linear interpolation.
-          if (last < i - 1)
+#pragma omp for schedule(static)
+          for (std::ptrdiff_t k = 1; k < n_fits; ++k)
           {
-            interpolate_skipped_fits(x, i, last, ys);
+            interpolate_skipped_fits(x, fits[k - 1], fits[k], ys);
           }
 
-          // Update the last fit counter to indicate we've now fit this point.
-          // Find the next i for which we'll run a regression.
-          update_indices(x, n, delta, i, last, ys);
-
-        } while (last < n - 1);
-
-        // compute current residuals
-        for (i = 0; i < n; i++)
-        {
-          weights[i] = y[i] - ys[i];
+          // compute current residuals
+#pragma omp for schedule(static)
+          for (std::ptrdiff_t i = 0; i < n_points; ++i)
+          {
+            weights[i] = y[i] - ys[i];
+          }
         }
 
         // compute robustness weights except last time
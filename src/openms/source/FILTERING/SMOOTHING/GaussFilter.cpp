@@ -34,6 +34,10 @@
 
 #include <OpenMS/FILTERING/SMOOTHING/GaussFilter.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
 
@@ -54,6 +58,38 @@ namespace OpenMS
   {
   }
 
+  void GaussFilter::filterExperiment(PeakMap & map)
+  {
+    if (!map.getChromatograms().empty() && param_.getValue("use_ppm_tolerance").toBool())
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, 
+        "GaussFilter: Cannot use ppm tolerance on chromatograms");
+    }
+
+    Size progress = 0;
+    startProgress(0, map.size() + map.getChromatograms().size(), "smoothing data");
+
+    // filter() does not change the state of the filter, so all threads can share it
+#pragma omp parallel for schedule(dynamic)
+    for (SignedSize i = 0; i < (SignedSize)map.size(); ++i)
+    {
+      IF_MASTERTHREAD setProgress(progress);
+      filter(map[i]);
+#pragma omp atomic
+      ++progress;
+    }
+
+#pragma omp parallel for schedule(dynamic)
+    for (SignedSize i = 0; i < (SignedSize)map.getChromatograms().size(); ++i)
+    {
+      IF_MASTERTHREAD setProgress(progress);
+      filter(map.getChromatogram(i));
+#pragma omp atomic
+      ++progress;
+    }
+    endProgress();
+  }
+
   void GaussFilter::updateMembers_()
   {
     gauss_algo_.initialize((double)param_.getValue("gaussian_width"), spacing_,
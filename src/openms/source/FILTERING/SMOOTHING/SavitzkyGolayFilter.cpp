@@ -38,6 +38,10 @@
 #include <Eigen/Core>
 #include <Eigen/SVD>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
   SavitzkyGolayFilter::SavitzkyGolayFilter() :
@@ -55,6 +59,90 @@ namespace OpenMS
   {
   }
 
+  bool SavitzkyGolayFilter::filterIntensities_(const std::vector<double>& in, std::vector<double>& out) const
+  {
+    const Size n = in.size();
+    if (frame_size_ > n) return false;
+
+    const Size frame = frame_size_;
+    const Size mid = frame / 2;
+    out.assign(n, 0.0);
+
+    // compute the transient on
+    for (Size i = 0; i <= mid; ++i)
+    {
+      double help = 0;
+      for (Size j = 0; j < frame; ++j)
+      {
+        help += in[j] * coeffs_[(i + 1) * frame - 1 - j];
+      }
+      out[i] = help;
+    }
+
+    // compute the steady state output (indices mid + 1 ... n - mid - 1): one coefficient at a time
+    // for all data points, the sums are accumulated in the same order as in the iterator version
+    if (n > 2 * mid + 1)
+    {
+      const Size begin = mid + 1;
+      const Size count = n - 2 * mid - 1;
+      double* target = out.data() + begin;
+      for (Size j = 0; j < frame; ++j)
+      {
+        const double c = coeffs_[mid * frame + j];
+        const double* source = in.data() + begin - mid + j;
+        for (Size k = 0; k < count; ++k)
+        {
+          target[k] += source[k] * c;
+        }
+      }
+    }
+
+    // compute the transient off
+    for (Size i = 0; i < mid; ++i)
+    {
+      const Size row = mid - 1 - i;
+      const Size k = n - mid + i;
+      const Size offset = k + row + 1 - frame;
+      double help = 0;
+      for (Size j = 0; j < frame; ++j)
+      {
+        help += in[offset + j] * coeffs_[row * frame + j];
+      }
+      out[k] = help;
+    }
+
+    for (double& value : out)
+    {
+      value = std::max(0.0, value);
+    }
+    return true;
+  }
+
+  void SavitzkyGolayFilter::filterExperiment(PeakMap & map)
+  {
+    Size progress = 0;
+    startProgress(0, map.size() + map.getChromatograms().size(), "smoothing data");
+
+#pragma omp parallel for schedule(dynamic)
+    for (SignedSize i = 0; i < (SignedSize)map.size(); ++i)
+    {
+      IF_MASTERTHREAD setProgress(progress);
+      filter(map[i]);
+#pragma omp atomic
+      ++progress;
+    }
+
+#pragma omp parallel for schedule(dynamic)
+    for (SignedSize i = 0; i < (SignedSize)map.getChromatograms().size(); ++i)
+    {
+      IF_MASTERTHREAD setProgress(progress);
+      filter(map.getChromatogram(i));
+#pragma omp atomic
+      ++progress;
+    }
+    endProgress();
+  }
+
   void SavitzkyGolayFilter::updateMembers_()
   {
     frame_size_ = (UInt)param_.getValue("frame_length");
@@ -35,6 +35,8 @@
 
 #include <OpenMS/FILTERING/TRANSFORMERS/SpectraMerger.h>
 
+#include <numeric>
+
 using namespace std;
 namespace OpenMS
 {
@@ -112,4 +114,73 @@ namespace OpenMS
     return *this;
   }
 
+  void SpectraMerger::clusterPrecursors_(const std::vector<BaseFeature>& data, std::vector<std::vector<Size> >& clusters) const
+  {
+    clusters.clear();
+
+    SpectraDistance_ llc;
+    llc.setParameters(param_.copy("precursor_method:", true));
+    double mz_tolerance = param_.getValue("precursor_method:mz_tolerance");
+
+    // sort by m/z, such that only neighbours within the m/z tolerance need to be compared
+    std::vector<Size> order(data.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&data](Size a, Size b) { return data[a].getMZ() < data[b].getMZ(); });
+
+    // find all links (in parallel, the union-find below is cheap)
+    std::vector<std::pair<Size, Size> > links;
+#pragma omp parallel
+    {
+      std::vector<std::pair<Size, Size> > links_local;
+#pragma omp for schedule(dynamic, 64) nowait
+      for (SignedSize i = 0; i < (SignedSize)order.size(); ++i)
+      {
+        const BaseFeature& first = data[order[i]];
+        for (Size j = i + 1; j < order.size() && data[order[j]].getMZ() - first.getMZ() <= mz_tolerance; ++j)
+        {
+          // same criterion as hierarchical clustering on the (float) distance matrix with threshold 1:
+          // distance is 1 - similarity, and only distances below 1 are linked
+          if (static_cast<float>(1 - llc(first, data[order[j]])) < 1)
+          {
+            links_local.emplace_back(order[i], order[j]);
+          }
+        }
+      }
+#pragma omp critical (OpenMS_SpectraMerger_clusterPrecursors)
+      links.insert(links.end(), links_local.begin(), links_local.end());
+    }
+
+    // union-find; the root of each component is its smallest index
+    std::vector<Size> root(data.size());
+    std::iota(root.begin(), root.end(), 0);
+    auto find_root = [&root](Size i)
+    {
+      while (root[i] != i)
+      {
+        root[i] = root[root[i]]; // path halving
+        i = root[i];
+      }
+      return i;
+    };
+    for (const std::pair<Size, Size>& link : links)
+    {
+      Size a = find_root(link.first), b = find_root(link.second);
+      if (a < b) root[b] = a;
+      else if (b < a) root[a] = b;
+    }
+
+    // collect clusters: ascending indices within each cluster, clusters ordered by their smallest index
+    std::vector<Size> cluster_index(data.size());
+    for (Size i = 0; i < data.size(); ++i)
+    {
+      Size r = find_root(i);
+      if (r == i)
+      {
+        cluster_index[i] = clusters.size();
+        clusters.push_back(std::vector<Size>());
+      }
+      clusters[cluster_index[r]].push_back(i);
+    }
+  }
+
 }
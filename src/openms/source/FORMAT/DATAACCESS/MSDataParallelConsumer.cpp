@@ -0,0 +1,189 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataParallelConsumer.h>
+
+#include <OpenMS/CONCEPT/Exception.h>
+#include <OpenMS/CONCEPT/LogStream.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace OpenMS
+{
+
+  namespace
+  {
+    /// Apply @p func to all elements of @p data in parallel; rethrow the first error afterwards
+    template <typename DataType>
+    void processInParallel(std::vector<DataType>& data, const std::function<void (DataType&)>& func)
+    {
+      if (!func) return;
+
+      Size error_count = 0;
+      String error_message;
+#pragma omp parallel for schedule(dynamic)
+      for (SignedSize i = 0; i < (SignedSize)data.size(); ++i)
+      {
+        try
+        {
+          func(data[i]);
+        }
+        catch (Exception::BaseException& e)
+        {
+#pragma omp critical (OpenMS_MSDataParallelConsumer)
+          {
+            if (error_message.empty()) error_message = e.what();
+            ++error_count;
+          }
+        }
+        catch (...)
+        {
+#pragma omp atomic
+          ++error_count;
+        }
+      }
+
+      if (error_count > 0)
+      {
+        if (error_message.empty()) error_message = "unknown error";
+        throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+          "Processing of " + String(error_count) + " element(s) failed, first error: ", error_message);
+      }
+    }
+  }
+
+  MSDataParallelConsumer::MSDataParallelConsumer(Interfaces::IMSDataConsumer* next_consumer, Size batch_size) :
+    next_consumer_(next_consumer),
+    batch_size_(batch_size),
+    lambda_spec_(nullptr),
+    lambda_chrom_(nullptr)
+  {
+    if (batch_size_ == 0)
+    {
+      Size threads = 1;
+#ifdef _OPENMP
+      threads = omp_get_max_threads();
+#endif
+      batch_size_ = 32 * threads;
+    }
+    spectra_.reserve(batch_size_);
+  }
+
+  MSDataParallelConsumer::~MSDataParallelConsumer()
+  {
+    try
+    {
+      flush();
+    }
+    catch (Exception::BaseException& e)
+    {
+      OPENMS_LOG_ERROR << "Error while processing the remaining data: " << e.what() << std::endl;
+    }
+  }
+
+  void MSDataParallelConsumer::setExperimentalSettings(const ExperimentalSettings& settings)
+  {
+    next_consumer_->setExperimentalSettings(settings);
+  }
+
+  void MSDataParallelConsumer::setExpectedSize(Size s_size, Size c_size)
+  {
+    next_consumer_->setExpectedSize(s_size, c_size);
+  }
+
+  void MSDataParallelConsumer::consumeSpectrum(SpectrumType& s)
+  {
+    // keep the overall order: chromatograms consumed earlier go first
+    if (!chromatograms_.empty()) flushChromatograms_();
+    spectra_.push_back(s);
+    if (spectra_.size() >= batch_size_) flushSpectra_();
+  }
+
+  void MSDataParallelConsumer::consumeChromatogram(ChromatogramType& c)
+  {
+    if (!spectra_.empty()) flushSpectra_();
+    chromatograms_.push_back(c);
+    if (chromatograms_.size() >= batch_size_) flushChromatograms_();
+  }
+
+  void MSDataParallelConsumer::setSpectraProcessingFunc(std::function<void (SpectrumType&)> f_spec)
+  {
+    lambda_spec_ = f_spec;
+  }
+
+  void MSDataParallelConsumer::setChromatogramProcessingFunc(std::function<void (ChromatogramType&)> f_chrom)
+  {
+    lambda_chrom_ = f_chrom;
+  }
+
+  void MSDataParallelConsumer::flush()
+  {
+    // at most one of the buffers is non-empty (see consume functions)
+    flushSpectra_();
+    flushChromatograms_();
+  }
+
+  Size MSDataParallelConsumer::getBatchSize() const
+  {
+    return batch_size_;
+  }
+
+  void MSDataParallelConsumer::flushSpectra_()
+  {
+    if (spectra_.empty()) return;
+    std::vector<SpectrumType> batch;
+    batch.reserve(batch_size_);
+    batch.swap(spectra_); // buffer is empty even if processing fails
+    processInParallel(batch, lambda_spec_);
+    for (SpectrumType& s : batch)
+    {
+      next_consumer_->consumeSpectrum(s);
+    }
+  }
+
+  void MSDataParallelConsumer::flushChromatograms_()
+  {
+    if (chromatograms_.empty()) return;
+    std::vector<ChromatogramType> batch;
+    batch.swap(chromatograms_);
+    processInParallel(batch, lambda_chrom_);
+    for (ChromatogramType& c : batch)
+    {
+      next_consumer_->consumeChromatogram(c);
+    }
+  }
+
+} //end namespace OpenMS
+
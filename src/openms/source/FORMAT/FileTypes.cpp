@@ -105,6 +105,7 @@ namespace OpenMS
     TypeNameBinding(FileTypes::PQP, "pqp", "pqp file"),
     TypeNameBinding(FileTypes::MS, "ms", "SIRIUS file"),
     TypeNameBinding(FileTypes::OSW, "osw", "OpenSwath output files"),
+    TypeNameBinding(FileTypes::OMS, "oms", "OpenMS SQLite file for identification data"),
     TypeNameBinding(FileTypes::PSMS, "psms", "Percolator tab-delimited output (PSM level)"),
     TypeNameBinding(FileTypes::PIN, "pin", "Percolator tab-delimited input (PSM level)"),
     TypeNameBinding(FileTypes::PARAMXML, "paramXML", "OpenMS internal XML file"),
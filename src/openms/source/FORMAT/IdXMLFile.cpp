@@ -43,13 +43,25 @@
 #include <OpenMS/FORMAT/FileHandler.h>
 #include <OpenMS/SYSTEM/File.h>
 
+#include <algorithm>
+#include <cctype>
 #include <fstream>
+#include <iterator>
 #include <unordered_map>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace std;
 
 namespace OpenMS
 {
+  namespace
+  {
+    /// Placeholder element that stands for a chunk of PeptideIdentification elements
+    const String PEPTIDE_CHUNK_TAG = "PeptideIdentificationChunk";
+  }
 
   IdXMLFile::IdXMLFile() :
     XMLHandler("", "1.5"),
@@ -80,7 +92,17 @@ namespace OpenMS
     pep_ids_ = &peptide_ids;
     document_id_ = &document_id;
 
-    parse_(filename, this);
+    bool parsed = false;
+#ifdef _OPENMP
+    if (omp_get_max_threads() > 1)
+    {
+      parsed = parseChunked_(filename);
+    }
+#endif
+    if (!parsed)
+    {
+      parse_(filename, this);
+    }
 
     //reset members
     prot_ids_ = nullptr;
@@ -94,10 +116,295 @@ namespace OpenMS
     prot_hit_ = ProteinHit();
     pep_hit_ = PeptideHit();
     proteinid_to_accession_.clear();
+    sequence_cache_.clear();
+    chunk_identifiers_.clear();
 
     endProgress();
   }
 
+  bool IdXMLFile::parseChunked_(const String& filename)
+  {
+    std::ifstream is(filename.c_str(), std::ios::in | std::ios::binary);
+    if (!is)
+    {
+      return false; // let the serial parser report the problem
+    }
+
+    // The file is scanned block by block. Only the offsets of the <PeptideIdentification>
+    // elements are kept; they can neither nest nor be empty in valid idXML. The rest of the
+    // document (with placeholders for runs of consecutive elements) forms the skeleton.
+    const std::string open_tag = "<PeptideIdentification";
+    const std::string close_tag = "</PeptideIdentification>";
+    const std::string placeholder = "<" + PEPTIDE_CHUNK_TAG + "/>";
+    const Size block_size = 1 << 20;
+
+    std::vector<char> block(block_size);
+    std::string window; // unprocessed part of the file
+    Size window_offset = 0; // file offset of window[0]
+    Size pos = 0; // scan position in window
+    bool inside = false; // true while scanning for the end of an element
+    Size element_begin = 0;
+    std::string gap; // text since the end of the last element
+    std::string skeleton;
+    std::string declaration;
+    std::vector<std::pair<Size, Size> > elements;
+    std::vector<Size> element_run; // index of the run of consecutive elements each element belongs to
+    Size run_count = 0;
+    bool first_block = true;
+
+    while (true)
+    {
+      is.read(block.data(), block_size);
+      const std::streamsize count = is.gcount();
+      const bool eof = (count <= 0);
+      window.append(block.data(), count);
+
+      if (first_block)
+      {
+        first_block = false;
+        // compressed input is left to the serial parser
+        if (window.size() >= 2 &&
+            ((window[0] == 'B' && window[1] == 'Z') || (window[0] == '\x1f' && window[1] == '\x8b')))
+        {
+          return false;
+        }
+        // the XML declaration is repeated for every chunk (it may specify the encoding)
+        if (window.compare(0, 5, "<?xml") == 0)
+        {
+          Size end = window.find("?>");
+          if (end == std::string::npos)
+          {
+            return false;
+          }
+          declaration = window.substr(0, end + 2);
+        }
+      }
+
+      bool need_more = false;
+      while (!need_more)
+      {
+        if (!inside)
+        {
+          Size found = window.find(open_tag, pos);
+          if (found == std::string::npos)
+          {
+            // keep a possibly incomplete tag at the end of the window
+            Size safe = window.size() > open_tag.size() ? std::max(pos, window.size() - open_tag.size()) : pos;
+            gap.append(window, pos, safe - pos);
+            pos = safe;
+            need_more = true;
+          }
+          else if (found + open_tag.size() >= window.size())
+          {
+            gap.append(window, pos, found - pos);
+            pos = found;
+            need_more = true;
+          }
+          else if (window[found + open_tag.size()] != '>' && !std::isspace(static_cast<unsigned char>(window[found + open_tag.size()])))
+          {
+            // different element name with the same prefix
+            gap.append(window, pos, found + open_tag.size() - pos);
+            pos = found + open_tag.size();
+          }
+          else
+          {
+            gap.append(window, pos, found - pos);
+            bool adjacent = !elements.empty() &&
+              std::all_of(gap.begin(), gap.end(), [](char c) { return std::isspace(static_cast<unsigned char>(c)); });
+            skeleton.append(gap);
+            gap.clear();
+            if (!adjacent)
+            {
+              skeleton.append(placeholder);
+              ++run_count;
+            }
+            inside = true;
+            element_begin = window_offset + found;
+            pos = found + open_tag.size();
+          }
+        }
+        else
+        {
+          Size end = window.find(close_tag, pos);
+          Size next = window.find(open_tag, pos);
+          if (next < end)
+          {
+            return false; // self-closing or otherwise unexpected element
+          }
+          if (end == std::string::npos)
+          {
+            pos = window.size() > close_tag.size() ? std::max(pos, window.size() - close_tag.size()) : pos;
+            need_more = true;
+          }
+          else
+          {
+            pos = end + close_tag.size();
+            elements.emplace_back(element_begin, window_offset + pos);
+            element_run.push_back(run_count - 1);
+            inside = false;
+          }
+        }
+      }
+
+      if (eof)
+      {
+        if (inside)
+        {
+          return false;
+        }
+        gap.append(window, pos, std::string::npos);
+        skeleton.append(gap);
+        break;
+      }
+      window.erase(0, pos);
+      window_offset += pos;
+      pos = 0;
+    }
+    is.close();
+    window.clear();
+    window.shrink_to_fit();
+    gap.clear();
+    gap.shrink_to_fit();
+
+    if (elements.empty())
+    {
+      return false;
+    }
+
+    // parse the document without the peptide identifications
+    chunk_identifiers_.clear();
+    parseBuffer_(skeleton, this);
+    skeleton.clear();
+    skeleton.shrink_to_fit();
+
+    if (chunk_identifiers_.size() != run_count)
+    {
+      fatalError(LOAD, "Unexpected structure of PeptideIdentification elements");
+    }
+
+    // split the runs of consecutive elements into chunks
+    Size threads = 1;
+#ifdef _OPENMP
+    threads = omp_get_max_threads();
+#endif
+    const Size per_chunk = std::max(Size(64), elements.size() / (8 * threads) + 1);
+    std::vector<std::pair<Size, Size> > chunks;
+    std::vector<Size> chunk_run;
+    for (Size i = 0; i < elements.size(); ++i)
+    {
+      if (!chunks.empty() && chunk_run.back() == element_run[i] && (i % per_chunk != 0))
+      {
+        chunks.back().second = elements[i].second;
+      }
+      else
+      {
+        chunks.push_back(elements[i]);
+        chunk_run.push_back(element_run[i]);
+      }
+    }
+    elements.clear();
+    elements.shrink_to_fit();
+
+    // parse the chunks in parallel, each thread with its own handler and file stream,
+    // so only the chunks currently being parsed are held in memory
+    std::vector<std::vector<PeptideIdentification> > results(chunks.size());
+    Size error_count = 0;
+    String error_message;
+#pragma omp parallel
+    {
+      IdXMLFile worker;
+      worker.file_ = file_;
+      worker.proteinid_to_accession_ = proteinid_to_accession_;
+      std::ifstream chunk_stream(filename.c_str(), std::ios::in | std::ios::binary);
+      std::string buffer;
+#pragma omp for schedule(dynamic)
+      for (SignedSize i = 0; i < (SignedSize)chunks.size(); ++i)
+      {
+        if (error_count != 0)
+        {
+          continue; // no need to parse further if already an error was encountered
+        }
+        try
+        {
+          const Size length = chunks[i].second - chunks[i].first;
+          buffer.assign(declaration);
+          buffer.append("<" + PEPTIDE_CHUNK_TAG + ">");
+          const Size content_begin = buffer.size();
+          buffer.resize(content_begin + length);
+          chunk_stream.clear();
+          chunk_stream.seekg(static_cast<std::streamoff>(chunks[i].first));
+          chunk_stream.read(&buffer[content_begin], static_cast<std::streamsize>(length));
+          if (chunk_stream.gcount() != static_cast<std::streamsize>(length))
+          {
+            throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, file_, "File changed while reading");
+          }
+          buffer.append("</" + PEPTIDE_CHUNK_TAG + ">");
+          worker.parsePeptideChunk_(buffer, chunk_identifiers_[chunk_run[i]], results[i]);
+        }
+        catch (Exception::BaseException& e)
+        {
+#pragma omp critical (OpenMS_IdXMLFile_load)
+          {
+            ++error_count;
+            error_message = e.what();
+          }
+        }
+        catch (...)
+        {
+#pragma omp atomic
+          ++error_count;
+        }
+      }
+    }
+    if (error_count != 0)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, file_, "Error during parsing of peptide identifications: '" + error_message + "'");
+    }
+
+    Size total = 0;
+    for (const auto& result : results)
+    {
+      total += result.size();
+    }
+    pep_ids_->reserve(total);
+    for (auto& result : results)
+    {
+      std::move(result.begin(), result.end(), std::back_inserter(*pep_ids_));
+    }
+    return true;
+  }
+
+  void IdXMLFile::parsePeptideChunk_(const std::string& buffer, const String& identifier, std::vector<PeptideIdentification>& peptide_ids)
+  {
+    std::vector<ProteinIdentification> protein_ids(1);
+    protein_ids[0].setIdentifier(identifier);
+    String document_id;
+
+    prot_ids_ = &protein_ids;
+    pep_ids_ = &peptide_ids;
+    document_id_ = &document_id;
+    // the run is already known, no empty ProteinIdentification has to be created for it
+    prot_id_in_run_ = true;
+
+    parseBuffer_(buffer, this);
+
+    prot_ids_ = nullptr;
+    pep_ids_ = nullptr;
+    document_id_ = nullptr;
+    last_meta_ = nullptr;
+    chunk_identifiers_.clear();
+  }
+
+  const AASequence& IdXMLFile::getSequence_(const String& sequence)
+  {
+    auto it = sequence_cache_.find(sequence);
+    if (it == sequence_cache_.end())
+    {
+      it = sequence_cache_.emplace(sequence, AASequence::fromString(sequence)).first;
+    }
+    return it->second;
+  }
+
   void IdXMLFile::store(const String& filename, const std::vector<ProteinIdentification>& protein_ids, const std::vector<PeptideIdentification>& peptide_ids, const String& document_id)
   {
     if (!FileHandler::hasValidExtension(filename, FileTypes::IDXML))
@@ -609,6 +916,16 @@ namespace OpenMS
       proteinid_to_accession_[attributeAsString_(attributes, "id")] = accession;
     }
     // PEPTIDES
+    else if (tag == PEPTIDE_CHUNK_TAG)
+    {
+      // placeholder for PeptideIdentification elements that are parsed separately (see parseChunked_)
+      if (!prot_id_in_run_)
+      {
+        prot_ids_->push_back(prot_id_);
+        prot_id_in_run_ = true;
+      }
+      chunk_identifiers_.push_back(prot_ids_->back().getIdentifier());
+    }
     else if (tag == "PeptideIdentification")
     {
       // check whether a prot id has been given, add "empty" one to list else
@@ -664,7 +981,7 @@ namespace OpenMS
 
       pep_hit_.setCharge(attributeAsInt_(attributes, "charge"));
       pep_hit_.setScore(attributeAsDouble_(attributes, "score"));
-      pep_hit_.setSequence(AASequence::fromString(String(attributeAsString_(attributes, "sequence"))));
+      pep_hit_.setSequence(getSequence_(attributeAsString_(attributes, "sequence")));
 
       //parse optional protein ids to determine accessions
       const XMLCh* refs = attributes.getValue(sm_.convert("protein_refs").c_str());
@@ -41,13 +41,119 @@
 #include <OpenMS/FORMAT/VALIDATORS/MzMLValidator.h>
 #include <OpenMS/FORMAT/TextFile.h>
 #include <OpenMS/FORMAT/DATAACCESS/MSDataTransformingConsumer.h>
+#include <OpenMS/FORMAT/HANDLERS/IndexedMzMLDecoder.h>
 #include <OpenMS/SYSTEM/File.h>
 
+#include <algorithm>
+#include <exception>
 #include <sstream>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace OpenMS
 {
 
+  namespace
+  {
+    /// Reads the spectrum and chromatogram offsets of an indexed mzML file; returns false if there is no usable index
+    bool readIndexOffsets(const String& filename, IndexedMzMLDecoder::OffsetVector& spectra_offsets,
+                          IndexedMzMLDecoder::OffsetVector& chromatograms_offsets)
+    {
+      // check the beginning of the file first (IndexedMzMLDecoder complains about non-indexed files)
+      {
+        std::ifstream ifs(filename.c_str(), std::ios::binary);
+        if (!ifs.is_open())
+        {
+          throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+        }
+        char buffer[1024];
+        ifs.read(buffer, sizeof(buffer));
+        if (std::string(buffer, ifs.gcount()).find("<indexedmzML") == std::string::npos) return false;
+      }
+
+      IndexedMzMLDecoder decoder;
+      try
+      {
+        std::streampos index_offset = decoder.findIndexListOffset(filename);
+        if (index_offset == std::streampos(-1)) return false;
+        if (decoder.parseOffsets(filename, index_offset, spectra_offsets, chromatograms_offsets) != 0) return false;
+      }
+      catch (Exception::ParseError&)
+      {
+        return false;
+      }
+      return true;
+    }
+
+    bool isSortedByOffset(const IndexedMzMLDecoder::OffsetVector& offsets)
+    {
+      return std::is_sorted(offsets.begin(), offsets.end(),
+        [](const std::pair<std::string, std::streampos>& a, const std::pair<std::string, std::streampos>& b)
+        {
+          return a.second < b.second;
+        });
+    }
+
+    /// Reads the bytes [start, end) of a file
+    std::string readRange(std::ifstream& ifs, std::streampos start, std::streampos end)
+    {
+      std::string data(static_cast<Size>(end - start), '\0');
+      ifs.clear();
+      ifs.seekg(start);
+      ifs.read(&data[0], data.size());
+      if (static_cast<Size>(ifs.gcount()) != data.size())
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String(start), "offset beyond the end of the file");
+      }
+      return data;
+    }
+
+    /// Finds the start of the last occurrence of @p tag before @p pos (searches at most 64 kB); returns -1 if not found
+    std::streampos findTagBefore(std::ifstream& ifs, std::streampos pos, const std::string& tag)
+    {
+      std::streampos start = std::max(std::streamoff(0), std::streamoff(pos) - std::streamoff(65536));
+      std::string data = readRange(ifs, start, pos);
+      Size found = data.rfind(tag);
+      if (found == std::string::npos) return std::streampos(-1);
+      return start + std::streamoff(found);
+    }
+
+    /// Finds the first occurrence of @p tag at or after @p pos; returns -1 if not found
+    std::streampos findTagAfter(std::ifstream& ifs, std::streampos pos, const std::string& tag)
+    {
+      const Size block_size = 1 << 16;
+      std::vector<char> buffer(block_size);
+      std::string data;
+      std::streampos data_start = pos;
+      ifs.clear();
+      ifs.seekg(pos);
+      while (ifs.read(buffer.data(), block_size) || ifs.gcount() > 0)
+      {
+        data.append(buffer.data(), ifs.gcount());
+        Size found = data.find(tag);
+        if (found != std::string::npos) return data_start + std::streamoff(found);
+        // keep the end in case the tag spans two blocks
+        Size keep = std::min(data.size(), tag.size());
+        data_start += std::streamoff(data.size() - keep);
+        data.erase(0, data.size() - keep);
+      }
+      return std::streampos(-1);
+    }
+
+    /// Replaces the value of the "count" attribute in a start tag
+    std::string setCountAttribute(const std::string& start_tag, Size count)
+    {
+      Size pos = start_tag.find(" count=\"");
+      if (pos == std::string::npos) return start_tag;
+      pos += 8;
+      Size end = start_tag.find('"', pos);
+      if (end == std::string::npos) return start_tag;
+      return start_tag.substr(0, pos) + String(count) + start_tag.substr(end);
+    }
+  }
+
   MzMLFile::MzMLFile() :
     XMLFile("/SCHEMAS/mzML_1_10.xsd", "1.1.0"),
     indexed_schema_location_("/SCHEMAS/mzML_idx_1_10.xsd")
@@ -235,6 +341,14 @@ namespace OpenMS
 
   void MzMLFile::transformFirstPass_(const String& filename_in, Interfaces::IMSDataConsumer* consumer, bool skip_full_count)
   {
+    // the index of an indexed mzML file provides the full counts, so only the header needs to be parsed
+    IndexedMzMLDecoder::OffsetVector spectra_offsets, chromatograms_offsets;
+    if (!skip_full_count && readIndexOffsets(filename_in, spectra_offsets, chromatograms_offsets))
+    {
+      transformHeader_(filename_in, consumer, spectra_offsets.size(), chromatograms_offsets.size());
+      return;
+    }
+
     // Create temporary objects and counters
     PeakFileOptions tmp_options(options_);
     Size scount = 0, ccount = 0;
@@ -254,6 +368,216 @@ namespace OpenMS
     consumer->setExperimentalSettings(experimental_settings);
   }
 
+  void MzMLFile::transformHeader_(const String& filename_in, Interfaces::IMSDataConsumer* consumer, Size scount, Size ccount)
+  {
+    PeakFileOptions tmp_options(options_);
+    PeakMap experimental_settings;
+    Internal::MzMLHandler handler(experimental_settings, filename_in, getVersion(), *this);
+
+    // parsing ends at the start of the spectrum/chromatogram list
+    tmp_options.setMetadataOnly(true);
+    handler.setOptions(tmp_options);
+    handler.setLoadDetail(Internal::XMLHandler::LD_RAWCOUNTS);
+
+    safeParse_(filename_in, &handler);
+
+    consumer->setExpectedSize(scount, ccount);
+    consumer->setExperimentalSettings(experimental_settings);
+  }
+
+  void MzMLFile::transformIndexed(const String& filename_in, Interfaces::IMSDataConsumer* consumer, Size chunk_size)
+  {
+    IndexedMzMLDecoder::OffsetVector spectra_offsets, chromatograms_offsets;
+    if (!readIndexOffsets(filename_in, spectra_offsets, chromatograms_offsets) ||
+        !isSortedByOffset(spectra_offsets) || !isSortedByOffset(chromatograms_offsets) ||
+        (!spectra_offsets.empty() && !chromatograms_offsets.empty() &&
+         chromatograms_offsets.front().second < spectra_offsets.back().second))
+    {
+      transform(filename_in, consumer);
+      return;
+    }
+
+    std::ifstream ifs(filename_in.c_str(), std::ios::binary);
+    if (!ifs.is_open())
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename_in);
+    }
+
+    // locate the list elements around the indexed elements
+    std::streampos spectra_start(-1), spectra_end(-1), chromatograms_start(-1), chromatograms_end(-1);
+    if (!spectra_offsets.empty())
+    {
+      spectra_start = findTagBefore(ifs, spectra_offsets.front().second, "<spectrumList");
+      spectra_end = findTagAfter(ifs, spectra_offsets.back().second, "</spectrumList");
+    }
+    if (!chromatograms_offsets.empty())
+    {
+      chromatograms_start = findTagBefore(ifs, chromatograms_offsets.front().second, "<chromatogramList");
+      chromatograms_end = findTagAfter(ifs, chromatograms_offsets.back().second, "</chromatogramList");
+    }
+    if ((!spectra_offsets.empty() && (spectra_start == std::streampos(-1) || spectra_end == std::streampos(-1))) ||
+        (!chromatograms_offsets.empty() && (chromatograms_start == std::streampos(-1) || chromatograms_end == std::streampos(-1))))
+    {
+      // index does not match the file content
+      transform(filename_in, consumer);
+      return;
+    }
+
+    transformHeader_(filename_in, consumer, spectra_offsets.size(), chromatograms_offsets.size());
+    if (spectra_offsets.empty() && chromatograms_offsets.empty()) return;
+
+    // everything before the first list (header, <run> start tag) is prepended to each chunk
+    std::string document_start = readRange(ifs, 0, spectra_offsets.empty() ? chromatograms_start : spectra_start);
+    chunk_size = std::max(chunk_size, Size(1));
+    if (!spectra_offsets.empty())
+    {
+      transformIndexedList_(ifs, spectra_offsets, spectra_end, document_start,
+                            readRange(ifs, spectra_start, spectra_offsets.front().second), true, consumer, chunk_size);
+    }
+    if (!chromatograms_offsets.empty())
+    {
+      transformIndexedList_(ifs, chromatograms_offsets, chromatograms_end, document_start,
+                            readRange(ifs, chromatograms_start, chromatograms_offsets.front().second), false, consumer, chunk_size);
+    }
+  }
+
+  void MzMLFile::transformIndexedList_(std::ifstream& ifs, const std::vector<std::pair<std::string, std::streampos> >& offsets,
+                                       std::streampos list_end, const std::string& document_start, const std::string& list_start,
+                                       bool is_spectrum, Interfaces::IMSDataConsumer* consumer, Size chunk_size)
+  {
+    const std::string document_end = is_spectrum ? "</spectrumList></run></mzML></indexedmzML>" : "</chromatogramList></run></mzML></indexedmzML>";
+
+    Size threads = 1;
+#ifdef _OPENMP
+    threads = omp_get_max_threads();
+#endif
+    const Size nr_chunks = (offsets.size() + chunk_size - 1) / chunk_size;
+    const Size wave_size = threads; // chunks processed concurrently
+
+    std::vector<std::string> documents;
+    std::vector<PeakMap> results;
+    Size error_count = 0;
+    String error_message;
+    // exception thrown by the consumer (passed on to the caller unchanged)
+    std::exception_ptr consumer_error;
+
+#pragma omp parallel
+    {
+      // one handler per thread (its construction loads the controlled vocabularies)
+      MzMLFile worker;
+      PeakMap thread_map;
+      ProgressLogger logger;
+      Internal::MzMLHandler handler(thread_map, "", getVersion(), logger);
+      handler.setOptions(options_);
+
+      for (Size wave_start = 0; wave_start < nr_chunks; wave_start += wave_size)
+      {
+        const Size wave_end = std::min(nr_chunks, wave_start + wave_size);
+
+#pragma omp single
+        {
+          // read the byte ranges of this wave and build one document per chunk
+          documents.clear();
+          results.assign(wave_end - wave_start, PeakMap());
+          if (error_count == 0)
+          {
+            try
+            {
+              for (Size chunk = wave_start; chunk < wave_end; ++chunk)
+              {
+                Size first = chunk * chunk_size;
+                Size last = std::min(offsets.size(), first + chunk_size); // exclusive
+                std::streampos end = (last < offsets.size()) ? offsets[last].second : list_end;
+                documents.push_back(document_start + setCountAttribute(list_start, last - first) +
+                                    readRange(ifs, offsets[first].second, end) + document_end);
+              }
+            }
+            catch (Exception::BaseException& e)
+            {
+              error_message = e.what();
+              ++error_count;
+            }
+            catch (...)
+            {
+              ++error_count;
+            }
+          }
+        } // implicit barrier
+
+#pragma omp for schedule(dynamic)
+        for (SignedSize i = 0; i < (SignedSize)documents.size(); ++i)
+        {
+          try
+          {
+            worker.parseBuffer_(documents[i], &handler);
+            if (is_spectrum)
+            {
+              results[i].getSpectra().swap(thread_map.getSpectra());
+            }
+            else
+            {
+              results[i].getChromatograms().swap(thread_map.getChromatograms());
+            }
+          }
+          catch (Exception::BaseException& e)
+          {
+#pragma omp critical (OpenMS_MzMLFile_transformIndexed)
+            {
+              if (error_message.empty()) error_message = e.what();
+              ++error_count;
+            }
+          }
+          catch (...)
+          {
+#pragma omp critical (OpenMS_MzMLFile_transformIndexed)
+            ++error_count;
+          }
+          thread_map.clear(true);
+        } // implicit barrier
+
+#pragma omp single
+        {
+          // hand the results to the consumer in the original order
+          // (exceptions must not leave the parallel region)
+          if (error_count == 0)
+          {
+            try
+            {
+              for (PeakMap& result : results)
+              {
+                for (MSSpectrum& s : result.getSpectra()) consumer->consumeSpectrum(s);
+                for (MSChromatogram& c : result.getChromatograms()) consumer->consumeChromatogram(c);
+              }
+            }
+            catch (Exception::BaseException& e)
+            {
+              error_message = e.what();
+              consumer_error = std::current_exception();
+              ++error_count;
+            }
+            catch (...)
+            {
+              consumer_error = std::current_exception();
+              ++error_count;
+            }
+          }
+          results.clear();
+          documents.clear();
+        } // implicit barrier
+      }
+    }
+
+    if (consumer_error)
+    {
+      std::rethrow_exception(consumer_error);
+    }
+    if (error_count > 0)
+    {
+      throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, error_message,
+        "Error during parallel parsing of indexed mzML: " + String(error_count) + " chunk(s) failed");
+    }
+  }
+
   std::map<UInt, MzMLFile::SpecInfo> MzMLFile::getCentroidInfo(const String& filename, const Size first_n_spectra_only)
   {
     bool oldoption = options_.getFillData();
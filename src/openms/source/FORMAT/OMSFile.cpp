@@ -0,0 +1,1406 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/FORMAT/OMSFile.h>
+
+#include <OpenMS/CHEMISTRY/ProteaseDB.h>
+#include <OpenMS/CHEMISTRY/RNaseDB.h>
+#include <OpenMS/DATASTRUCTURES/ListUtils.h>
+#include <OpenMS/FORMAT/SqliteConnector.h>
+#include <OpenMS/SYSTEM/File.h>
+
+#include <sqlite3.h>
+
+#include <map>
+#include <memory>
+#include <unordered_map>
+
+using namespace std;
+
+namespace OpenMS
+{
+  const int OMSFile::VERSION = 2;
+
+  namespace
+  {
+    typedef IdentificationData ID;
+
+    /// Format used for storing dates (keeps milliseconds, so that processing steps stay distinguishable)
+    const String DATE_FORMAT = "yyyy-MM-ddThh:mm:ss.zzz";
+
+    /// Tables that can have meta values attached (suffix "_MetaData", elements of list values in "_MetaData_ListValue")
+    const vector<String> META_TABLES = {
+      "ID_IdentificationData", "ID_ScoreType", "ID_DataProcessingSoftware",
+      "ID_DataProcessingStep", "ID_DBSearchParam", "ID_DataQuery",
+      "ID_ParentMolecule", "ID_ParentMoleculeGrouping",
+      "ID_IdentifiedMolecule", "ID_MoleculeQueryMatch", "ID_QueryMatchGroup"
+    };
+
+    /// Tables that can have processing steps and scores attached (suffix "_AppliedProcessingStep")
+    const vector<String> STEP_TABLES = {
+      "ID_ParentMolecule", "ID_ParentMoleculeGrouping",
+      "ID_IdentifiedMolecule", "ID_MoleculeQueryMatch", "ID_QueryMatchGroup"
+    };
+
+    /// RAII wrapper for a prepared SQLite statement
+    class Statement
+    {
+    public:
+      Statement(sqlite3* db, const String& sql)
+      {
+        SqliteConnector::prepareStatement(db, &stmt_, sql);
+      }
+
+      ~Statement()
+      {
+        sqlite3_finalize(stmt_);
+      }
+
+      Statement(const Statement&) = delete;
+      Statement& operator=(const Statement&) = delete;
+
+      void bindInt(int pos, Int64 value)
+      {
+        sqlite3_bind_int64(stmt_, pos, value);
+      }
+
+      void bindDouble(int pos, double value)
+      {
+        sqlite3_bind_double(stmt_, pos, value);
+      }
+
+      void bindText(int pos, const String& value)
+      {
+        sqlite3_bind_text(stmt_, pos, value.c_str(), int(value.size()), SQLITE_TRANSIENT);
+      }
+
+      void bindNull(int pos)
+      {
+        sqlite3_bind_null(stmt_, pos);
+      }
+
+      /// Bind an ID, or NULL if the ID is not known (negative)
+      void bindRef(int pos, Int64 id)
+      {
+        if (id < 0) bindNull(pos);
+        else bindInt(pos, id);
+      }
+
+      /// Execute a statement that doesn't return data; the statement can be reused afterwards
+      void execute()
+      {
+        int rc = sqlite3_step(stmt_);
+        sqlite3_reset(stmt_);
+        sqlite3_clear_bindings(stmt_);
+        if (rc != SQLITE_DONE)
+        {
+          throw Exception::SqlOperationFailed(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String("Error executing SQL statement: ") + sqlite3_errmsg(sqlite3_db_handle(stmt_)));
+        }
+      }
+
+      /// Reset a query, so that it can be executed again with different bindings
+      void reset()
+      {
+        sqlite3_reset(stmt_);
+        sqlite3_clear_bindings(stmt_);
+      }
+
+      /// Step to the next result row; returns false if there is none
+      bool next()
+      {
+        return Internal::SqliteHelper::nextRow(stmt_) == Internal::SqliteHelper::SqlState::SQL_ROW;
+      }
+
+      bool isNull(int pos) const
+      {
+        return sqlite3_column_type(stmt_, pos) == SQLITE_NULL;
+      }
+
+      Int64 getInt(int pos) const
+      {
+        return sqlite3_column_int64(stmt_, pos);
+      }
+
+      /// Return an ID, or -1 for NULL
+      Int64 getRef(int pos) const
+      {
+        return isNull(pos) ? -1 : getInt(pos);
+      }
+
+      double getDouble(int pos) const
+      {
+        return sqlite3_column_double(stmt_, pos);
+      }
+
+      String getText(int pos) const
+      {
+        const unsigned char* text = sqlite3_column_text(stmt_, pos);
+        if (text == nullptr) return String();
+        return String(reinterpret_cast<const char*>(text), sqlite3_column_bytes(stmt_, pos));
+      }
+
+    private:
+      sqlite3_stmt* stmt_ = nullptr;
+    };
+
+    /// Return the address of an identified molecule (regardless of type)
+    uintptr_t moleculeAddress(const ID::IdentifiedMoleculeRef& ref)
+    {
+      if (const ID::IdentifiedPeptideRef* ptr = boost::get<ID::IdentifiedPeptideRef>(&ref)) return *ptr;
+      if (const ID::IdentifiedCompoundRef* ptr = boost::get<ID::IdentifiedCompoundRef>(&ref)) return *ptr;
+      return boost::get<ID::IdentifiedOligoRef>(ref);
+    }
+
+    /// Look up the ID of a stored object (address of the object -> ID)
+    Int64 lookupID(const unordered_map<uintptr_t, Int64>& ids, uintptr_t address)
+    {
+      auto pos = ids.find(address);
+      if (pos == ids.end())
+      {
+        throw Exception::MissingInformation(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "reference to an object that has not been stored");
+      }
+      return pos->second;
+    }
+
+    /// Look up an object reference (ID -> reference)
+    template <typename RefType>
+    RefType lookupRef(const unordered_map<Int64, RefType>& refs, Int64 id, const String& what)
+    {
+      auto pos = refs.find(id);
+      if (pos == refs.end())
+      {
+        throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, String(id), "invalid reference to " + what);
+      }
+      return pos->second;
+    }
+
+
+    /// Helper class for writing OMS files
+    class OMSFileStore
+    {
+    public:
+      explicit OMSFileStore(const String& filename):
+        conn_(filename, SqliteConnector::SqlOpenMode::READWRITE_OR_CREATE), db_(conn_.getDB())
+      {
+      }
+
+      void store(const ID& id_data)
+      {
+        conn_.executeStatement("BEGIN TRANSACTION");
+        createTables_();
+        storeMetaInfo_(id_data, "ID_IdentificationData", 1);
+        storeInputFiles_(id_data);
+        storeScoreTypes_(id_data);
+        storeDataProcessingSoftwares_(id_data);
+        storeDBSearchParams_(id_data);
+        storeDataProcessingSteps_(id_data);
+        storeDataQueries_(id_data);
+        storeParentMolecules_(id_data);
+        storeParentMoleculeGroupings_(id_data);
+        storeIdentifiedMolecules_(id_data);
+        storeMoleculeQueryMatches_(id_data);
+        storeQueryMatchGroups_(id_data);
+        conn_.executeStatement("END TRANSACTION");
+      }
+
+    private:
+      void createTables_()
+      {
+        conn_.executeStatement("CREATE TABLE version (version INT NOT NULL)");
+        conn_.executeStatement("INSERT INTO version VALUES (" + String(OMSFile::VERSION) + ")");
+
+        conn_.executeStatement("CREATE TABLE ID_InputFile (id INTEGER PRIMARY KEY NOT NULL, file TEXT UNIQUE NOT NULL)");
+        conn_.executeStatement("CREATE TABLE ID_ScoreType (id INTEGER PRIMARY KEY NOT NULL, accession TEXT, name TEXT NOT NULL, cv_identifier_ref TEXT, higher_better NUMERIC NOT NULL CHECK (higher_better in (0, 1)))");
+        conn_.executeStatement("CREATE TABLE ID_DataProcessingSoftware (id INTEGER PRIMARY KEY NOT NULL, name TEXT NOT NULL, version TEXT)");
+        conn_.executeStatement("CREATE TABLE ID_DataProcessingSoftware_AssignedScore (software_id INTEGER NOT NULL, score_type_id INTEGER NOT NULL, score_type_order INTEGER NOT NULL, PRIMARY KEY (software_id, score_type_order))");
+        conn_.executeStatement("CREATE TABLE ID_DBSearchParam (id INTEGER PRIMARY KEY NOT NULL, molecule_type_id INTEGER NOT NULL, mass_type_average NUMERIC NOT NULL CHECK (mass_type_average in (0, 1)), database TEXT, database_version TEXT, taxonomy TEXT, charges TEXT, precursor_mass_tolerance REAL, fragment_mass_tolerance REAL, precursor_tolerance_ppm NUMERIC NOT NULL CHECK (precursor_tolerance_ppm in (0, 1)), fragment_tolerance_ppm NUMERIC NOT NULL CHECK (fragment_tolerance_ppm in (0, 1)), digestion_enzyme TEXT, enzyme_term_specificity INTEGER NOT NULL, missed_cleavages INTEGER NOT NULL, min_length INTEGER NOT NULL, max_length INTEGER NOT NULL)");
+        conn_.executeStatement("CREATE TABLE ID_DBSearchParam_Modification (search_param_id INTEGER NOT NULL, name TEXT NOT NULL, fixed NUMERIC NOT NULL CHECK (fixed in (0, 1)))");
+        conn_.executeStatement("CREATE TABLE ID_DataProcessingStep (id INTEGER PRIMARY KEY NOT NULL, software_id INTEGER NOT NULL, date_time TEXT, search_param_id INTEGER)");
+        conn_.executeStatement("CREATE TABLE ID_DataProcessingStep_InputFile (processing_step_id INTEGER NOT NULL, input_file_id INTEGER NOT NULL, file_order INTEGER NOT NULL)");
+        conn_.executeStatement("CREATE TABLE ID_DataProcessingStep_PrimaryFile (processing_step_id INTEGER NOT NULL, primary_file TEXT NOT NULL, file_order INTEGER NOT NULL)");
+        conn_.executeStatement("CREATE TABLE ID_DataProcessingStep_ProcessingAction (processing_step_id INTEGER NOT NULL, action INTEGER NOT NULL)");
+        conn_.executeStatement("CREATE TABLE ID_DataQuery (id INTEGER PRIMARY KEY NOT NULL, data_id TEXT NOT NULL, input_file_id INTEGER, rt REAL, mz REAL)");
+        conn_.executeStatement("CREATE INDEX ID_DataQuery_input_file_id ON ID_DataQuery (input_file_id)");
+        conn_.executeStatement("CREATE TABLE ID_ParentMolecule (id INTEGER PRIMARY KEY NOT NULL, accession TEXT UNIQUE NOT NULL, molecule_type_id INTEGER NOT NULL, sequence TEXT, description TEXT, coverage REAL, is_decoy NUMERIC NOT NULL CHECK (is_decoy in (0, 1)))");
+        conn_.executeStatement("CREATE TABLE ID_ParentMoleculeGrouping (id INTEGER PRIMARY KEY NOT NULL, label TEXT)");
+        conn_.executeStatement("CREATE TABLE ID_ParentMoleculeGroup (id INTEGER PRIMARY KEY NOT NULL, grouping_id INTEGER NOT NULL)");
+        conn_.executeStatement("CREATE TABLE ID_ParentMoleculeGroup_Score (parent_group_id INTEGER NOT NULL, score_type_id INTEGER NOT NULL, score REAL)");
+        conn_.executeStatement("CREATE TABLE ID_ParentMoleculeGroup_ParentMolecule (parent_group_id INTEGER NOT NULL, parent_molecule_id INTEGER NOT NULL)");
+        conn_.executeStatement("CREATE TABLE ID_IdentifiedMolecule (id INTEGER PRIMARY KEY NOT NULL, molecule_type_id INTEGER NOT NULL, identifier TEXT NOT NULL, UNIQUE (molecule_type_id, identifier))");
+        conn_.executeStatement("CREATE TABLE ID_IdentifiedCompound (molecule_id INTEGER PRIMARY KEY NOT NULL, formula TEXT, name TEXT, smile TEXT, inchi TEXT)");
+        conn_.executeStatement("CREATE TABLE ID_ParentMatch (molecule_id INTEGER NOT NULL, parent_id INTEGER NOT NULL, start_pos INTEGER, end_pos INTEGER, left_neighbor TEXT, right_neighbor TEXT)");
+        conn_.executeStatement("CREATE INDEX ID_ParentMatch_molecule_id ON ID_ParentMatch (molecule_id)");
+        conn_.executeStatement("CREATE TABLE ID_MoleculeQueryMatch (id INTEGER PRIMARY KEY NOT NULL, identified_molecule_id INTEGER NOT NULL, data_query_id INTEGER NOT NULL, charge INTEGER)");
+        conn_.executeStatement("CREATE INDEX ID_MoleculeQueryMatch_data_query_id ON ID_MoleculeQueryMatch (data_query_id)");
+        conn_.executeStatement("CREATE TABLE ID_MoleculeQueryMatch_PeakAnnotation (parent_id INTEGER NOT NULL, processing_step_id INTEGER, peak_annotation TEXT, peak_charge INTEGER, peak_mz REAL, peak_intensity REAL)");
+        conn_.executeStatement("CREATE INDEX ID_MoleculeQueryMatch_PeakAnnotation_parent_id ON ID_MoleculeQueryMatch_PeakAnnotation (parent_id)");
+        conn_.executeStatement("CREATE TABLE ID_QueryMatchGroup (id INTEGER PRIMARY KEY NOT NULL)");
+        conn_.executeStatement("CREATE TABLE ID_QueryMatchGroup_MoleculeQueryMatch (group_id INTEGER NOT NULL, query_match_id INTEGER NOT NULL)");
+
+        for (const String& table : META_TABLES)
+        {
+          // unit columns are NULL for values without unit; list values are NULL (elements are in the "_ListValue" table):
+          conn_.executeStatement("CREATE TABLE " + table + "_MetaData (parent_id INTEGER NOT NULL, name TEXT NOT NULL, data_type_id INTEGER NOT NULL, value, unit_type INTEGER, unit INTEGER, PRIMARY KEY (parent_id, name))");
+          conn_.executeStatement("CREATE TABLE " + table + "_MetaData_ListValue (parent_id INTEGER NOT NULL, name TEXT NOT NULL, list_order INTEGER NOT NULL, value, PRIMARY KEY (parent_id, name, list_order))");
+        }
+        for (const String& table : STEP_TABLES)
+        {
+          // one row per score (or one row without score if a step has none):
+          conn_.executeStatement("CREATE TABLE " + table + "_AppliedProcessingStep (parent_id INTEGER NOT NULL, processing_step_id INTEGER, step_order INTEGER NOT NULL, score_type_id INTEGER, score REAL)");
+          conn_.executeStatement("CREATE INDEX " + table + "_AppliedProcessingStep_parent_id ON " + table + "_AppliedProcessingStep (parent_id)");
+        }
+      }
+
+      void storeMetaInfo_(const MetaInfoInterface& info, const String& parent_table, Int64 parent_id)
+      {
+        if (info.isMetaEmpty()) return;
+        unique_ptr<Statement>& stmt = meta_statements_[parent_table];
+        if (!stmt)
+        {
+          stmt.reset(new Statement(db_, "INSERT INTO " + parent_table + "_MetaData VALUES (?, ?, ?, ?, ?, ?)"));
+        }
+        vector<String> keys;
+        info.getKeys(keys);
+        for (const String& key : keys)
+        {
+          const DataValue& value = info.getMetaValue(key);
+          stmt->bindInt(1, parent_id);
+          stmt->bindText(2, key);
+          stmt->bindInt(3, Int64(value.valueType()));
+          switch (value.valueType())
+          {
+            case DataValue::INT_VALUE:
+              stmt->bindInt(4, Int64(SignedSize(value)));
+              break;
+            case DataValue::DOUBLE_VALUE:
+              stmt->bindDouble(4, double(value));
+              break;
+            case DataValue::STRING_VALUE:
+              stmt->bindText(4, value.toString());
+              break;
+            case DataValue::STRING_LIST:
+            case DataValue::INT_LIST:
+            case DataValue::DOUBLE_LIST:
+              stmt->bindNull(4);
+              storeMetaList_(value, parent_table, parent_id, key);
+              break;
+            default: // empty value
+              stmt->bindNull(4);
+          }
+          if (value.hasUnit())
+          {
+            stmt->bindInt(5, Int64(value.getUnitType()));
+            stmt->bindInt(6, Int64(value.getUnit()));
+          }
+          else
+          {
+            stmt->bindNull(5);
+            stmt->bindNull(6);
+          }
+          stmt->execute();
+        }
+      }
+
+      /// Store the elements of a list meta value (one row per element, so no separator is needed)
+      void storeMetaList_(const DataValue& value, const String& parent_table, Int64 parent_id, const String& key)
+      {
+        unique_ptr<Statement>& stmt = meta_list_statements_[parent_table];
+        if (!stmt)
+        {
+          stmt.reset(new Statement(db_, "INSERT INTO " + parent_table + "_MetaData_ListValue VALUES (?, ?, ?, ?)"));
+        }
+        auto bind_row = [&](Size order)
+        {
+          stmt->bindInt(1, parent_id);
+          stmt->bindText(2, key);
+          stmt->bindInt(3, Int64(order));
+        };
+        if (value.valueType() == DataValue::STRING_LIST)
+        {
+          StringList values = value.toStringList();
+          for (Size i = 0; i < values.size(); ++i)
+          {
+            bind_row(i);
+            stmt->bindText(4, values[i]);
+            stmt->execute();
+          }
+        }
+        else if (value.valueType() == DataValue::INT_LIST)
+        {
+          IntList values = value.toIntList();
+          for (Size i = 0; i < values.size(); ++i)
+          {
+            bind_row(i);
+            stmt->bindInt(4, values[i]);
+            stmt->execute();
+          }
+        }
+        else
+        {
+          DoubleList values = value.toDoubleList();
+          for (Size i = 0; i < values.size(); ++i)
+          {
+            bind_row(i);
+            stmt->bindDouble(4, values[i]);
+            stmt->execute();
+          }
+        }
+      }
+
+      void storeAppliedSteps_(const IdentificationDataInternal::ScoredProcessingResult& result, const String& parent_table, Int64 parent_id)
+      {
+        unique_ptr<Statement>& stmt = step_statements_[parent_table];
+        if (!stmt)
+        {
+          stmt.reset(new Statement(db_, "INSERT INTO " + parent_table + "_AppliedProcessingStep VALUES (?, ?, ?, ?, ?)"));
+        }
+        Int64 step_order = 0;
+        for (const auto& step : result.steps_and_scores)
+        {
+          Int64 step_id = step.processing_step_opt ? lookupID(step_ids_, *step.processing_step_opt) : -1;
+          if (step.scores.empty())
+          {
+            stmt->bindInt(1, parent_id);
+            stmt->bindRef(2, step_id);
+            stmt->bindInt(3, step_order);
+            stmt->execute();
+          }
+          for (const auto& pair : step.scores)
+          {
+            stmt->bindInt(1, parent_id);
+            stmt->bindRef(2, step_id);
+            stmt->bindInt(3, step_order);
+            stmt->bindInt(4, lookupID(score_type_ids_, pair.first));
+            stmt->bindDouble(5, pair.second);
+            stmt->execute();
+          }
+          ++step_order;
+        }
+      }
+
+      void storeInputFiles_(const ID& id_data)
+      {
+        Statement stmt(db_, "INSERT INTO ID_InputFile VALUES (?, ?)");
+        Int64 id = 1;
+        for (const String& file : id_data.getInputFiles())
+        {
+          stmt.bindInt(1, id);
+          stmt.bindText(2, file);
+          stmt.execute();
+          input_file_ids_[uintptr_t(&file)] = id++;
+        }
+      }
+
+      void storeScoreTypes_(const ID& id_data)
+      {
+        Statement stmt(db_, "INSERT INTO ID_ScoreType VALUES (?, ?, ?, ?, ?)");
+        Int64 id = 1;
+        for (const ID::ScoreType& score_type : id_data.getScoreTypes())
+        {
+          stmt.bindInt(1, id);
+          stmt.bindText(2, score_type.cv_term.getAccession());
+          stmt.bindText(3, score_type.cv_term.getName());
+          stmt.bindText(4, score_type.cv_term.getCVIdentifierRef());
+          stmt.bindInt(5, score_type.higher_better);
+          stmt.execute();
+          storeMetaInfo_(score_type, "ID_ScoreType", id);
+          score_type_ids_[uintptr_t(&score_type)] = id++;
+        }
+      }
+
+      void storeDataProcessingSoftwares_(const ID& id_data)
+      {
+        Statement stmt(db_, "INSERT INTO ID_DataProcessingSoftware VALUES (?, ?, ?)");
+        Statement stmt_scores(db_, "INSERT INTO ID_DataProcessingSoftware_AssignedScore VALUES (?, ?, ?)");
+        Int64 id = 1;
+        for (const ID::DataProcessingSoftware& software : id_data.getDataProcessingSoftwares())
+        {
+          stmt.bindInt(1, id);
+          stmt.bindText(2, software.getName());
+          stmt.bindText(3, software.getVersion());
+          stmt.execute();
+          Int64 order = 0;
+          for (ID::ScoreTypeRef score_ref : software.assigned_scores)
+          {
+            stmt_scores.bindInt(1, id);
+            stmt_scores.bindInt(2, lookupID(score_type_ids_, score_ref));
+            stmt_scores.bindInt(3, order++);
+            stmt_scores.execute();
+          }
+          storeMetaInfo_(software, "ID_DataProcessingSoftware", id);
+          software_ids_[uintptr_t(&software)] = id++;
+        }
+      }
+
+      void storeDBSearchParams_(const ID& id_data)
+      {
+        Statement stmt(db_, "INSERT INTO ID_DBSearchParam VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+        Statement stmt_mods(db_, "INSERT INTO ID_DBSearchParam_Modification VALUES (?, ?, ?)");
+        Int64 id = 1;
+        for (const ID::DBSearchParam& param : id_data.getDBSearchParams())
+        {
+          stmt.bindInt(1, id);
+          stmt.bindInt(2, Int64(param.molecule_type));
+          stmt.bindInt(3, param.mass_type == ID::MassType::AVERAGE);
+          stmt.bindText(4, param.database);
+          stmt.bindText(5, param.database_version);
+          stmt.bindText(6, param.taxonomy);
+          stmt.bindText(7, ListUtils::concatenate(vector<Int>(param.charges.begin(), param.charges.end()), ","));
+          stmt.bindDouble(8, param.precursor_mass_tolerance);
+          stmt.bindDouble(9, param.fragment_mass_tolerance);
+          stmt.bindInt(10, param.precursor_tolerance_ppm);
+          stmt.bindInt(11, param.fragment_tolerance_ppm);
+          if (param.digestion_enzyme)
+          {
+            stmt.bindText(12, param.digestion_enzyme->getName());
+          }
+          else
+          {
+            stmt.bindNull(12);
+          }
+          stmt.bindInt(13, Int64(param.enzyme_term_specificity));
+          stmt.bindInt(14, Int64(param.missed_cleavages));
+          stmt.bindInt(15, Int64(param.min_length));
+          stmt.bindInt(16, Int64(param.max_length));
+          stmt.execute();
+          for (const String& mod : param.fixed_mods)
+          {
+            stmt_mods.bindInt(1, id);
+            stmt_mods.bindText(2, mod);
+            stmt_mods.bindInt(3, 1);
+            stmt_mods.execute();
+          }
+          for (const String& mod : param.variable_mods)
+          {
+            stmt_mods.bindInt(1, id);
+            stmt_mods.bindText(2, mod);
+            stmt_mods.bindInt(3, 0);
+            stmt_mods.execute();
+          }
+          storeMetaInfo_(param, "ID_DBSearchParam", id);
+          search_param_ids_[uintptr_t(&param)] = id++;
+        }
+      }
+
+      void storeDataProcessingSteps_(const ID& id_data)
+      {
+        Statement stmt(db_, "INSERT INTO ID_DataProcessingStep VALUES (?, ?, ?, ?)");
+        Statement stmt_inputs(db_, "INSERT INTO ID_DataProcessingStep_InputFile VALUES (?, ?, ?)");
+        Statement stmt_primary(db_, "INSERT INTO ID_DataProcessingStep_PrimaryFile VALUES (?, ?, ?)");
+        Statement stmt_actions(db_, "INSERT INTO ID_DataProcessingStep_ProcessingAction VALUES (?, ?)");
+        const ID::DBSearchSteps& search_steps = id_data.getDBSearchSteps();
+        Int64 id = 1;
+        for (auto it = id_data.getDataProcessingSteps().begin(); it != id_data.getDataProcessingSteps().end(); ++it)
+        {
+          const ID::DataProcessingStep& step = *it;
+          stmt.bindInt(1, id);
+          stmt.bindInt(2, lookupID(software_ids_, step.software_ref));
+          if (step.date_time.isValid())
+          {
+            stmt.bindText(3, step.date_time.toString(DATE_FORMAT));
+          }
+          else
+          {
+            stmt.bindNull(3);
+          }
+          auto search_pos = search_steps.find(it);
+          stmt.bindRef(4, (search_pos != search_steps.end()) ? lookupID(search_param_ids_, search_pos->second) : -1);
+          stmt.execute();
+          Int64 order = 0;
+          for (ID::InputFileRef file_ref : step.input_file_refs)
+          {
+            stmt_inputs.bindInt(1, id);
+            stmt_inputs.bindInt(2, lookupID(input_file_ids_, file_ref));
+            stmt_inputs.bindInt(3, order++);
+            stmt_inputs.execute();
+          }
+          order = 0;
+          for (const String& primary_file : step.primary_files)
+          {
+            stmt_primary.bindInt(1, id);
+            stmt_primary.bindText(2, primary_file);
+            stmt_primary.bindInt(3, order++);
+            stmt_primary.execute();
+          }
+          for (DataProcessing::ProcessingAction action : step.actions)
+          {
+            stmt_actions.bindInt(1, id);
+            stmt_actions.bindInt(2, Int64(action));
+            stmt_actions.execute();
+          }
+          storeMetaInfo_(step, "ID_DataProcessingStep", id);
+          step_ids_[uintptr_t(&step)] = id++;
+        }
+      }
+
+      void storeDataQueries_(const ID& id_data)
+      {
+        Statement stmt(db_, "INSERT INTO ID_DataQuery VALUES (?, ?, ?, ?, ?)");
+        Int64 id = 1;
+        for (const ID::DataQuery& query : id_data.getDataQueries())
+        {
+          stmt.bindInt(1, id);
+          stmt.bindText(2, query.data_id);
+          stmt.bindRef(3, query.input_file_opt ? lookupID(input_file_ids_, *query.input_file_opt) : -1);
+          stmt.bindDouble(4, query.rt);
+          stmt.bindDouble(5, query.mz);
+          stmt.execute();
+          storeMetaInfo_(query, "ID_DataQuery", id);
+          query_ids_[uintptr_t(&query)] = id++;
+        }
+      }
+
+      void storeParentMolecules_(const ID& id_data)
+      {
+        Statement stmt(db_, "INSERT INTO ID_ParentMolecule VALUES (?, ?, ?, ?, ?, ?, ?)");
+        Int64 id = 1;
+        for (const ID::ParentMolecule& parent : id_data.getParentMolecules())
+        {
+          stmt.bindInt(1, id);
+          stmt.bindText(2, parent.accession);
+          stmt.bindInt(3, Int64(parent.molecule_type));
+          stmt.bindText(4, parent.sequence);
+          stmt.bindText(5, parent.description);
+          stmt.bindDouble(6, parent.coverage);
+          stmt.bindInt(7, parent.is_decoy);
+          stmt.execute();
+          storeAppliedSteps_(parent, "ID_ParentMolecule", id);
+          storeMetaInfo_(parent, "ID_ParentMolecule", id);
+          parent_ids_[uintptr_t(&parent)] = id++;
+        }
+      }
+
+      void storeParentMoleculeGroupings_(const ID& id_data)
+      {
+        Statement stmt(db_, "INSERT INTO ID_ParentMoleculeGrouping VALUES (?, ?)");
+        Statement stmt_group(db_, "INSERT INTO ID_ParentMoleculeGroup VALUES (?, ?)");
+        Statement stmt_scores(db_, "INSERT INTO ID_ParentMoleculeGroup_Score VALUES (?, ?, ?)");
+        Statement stmt_parents(db_, "INSERT INTO ID_ParentMoleculeGroup_ParentMolecule VALUES (?, ?)");
+        Int64 id = 1, group_id = 1;
+        for (const ID::ParentMoleculeGrouping& grouping : id_data.getParentMoleculeGroupings())
+        {
+          stmt.bindInt(1, id);
+          stmt.bindText(2, grouping.label);
+          stmt.execute();
+          for (const ID::ParentMoleculeGroup& group : grouping.groups)
+          {
+            stmt_group.bindInt(1, group_id);
+            stmt_group.bindInt(2, id);
+            stmt_group.execute();
+            for (const auto& pair : group.scores)
+            {
+              stmt_scores.bindInt(1, group_id);
+              stmt_scores.bindInt(2, lookupID(score_type_ids_, pair.first));
+              stmt_scores.bindDouble(3, pair.second);
+              stmt_scores.execute();
+            }
+            for (ID::ParentMoleculeRef parent_ref : group.parent_molecule_refs)
+            {
+              stmt_parents.bindInt(1, group_id);
+              stmt_parents.bindInt(2, lookupID(parent_ids_, parent_ref));
+              stmt_parents.execute();
+            }
+            ++group_id;
+          }
+          storeAppliedSteps_(grouping, "ID_ParentMoleculeGrouping", id);
+          storeMetaInfo_(grouping, "ID_ParentMoleculeGrouping", id);
+          ++id;
+        }
+      }
+
+      void storeParentMatches_(const IdentificationDataInternal::ParentMatches& matches, Int64 molecule_id, Statement& stmt)
+      {
+        for (const auto& pair : matches)
+        {
+          Int64 parent_id = lookupID(parent_ids_, pair.first);
+          for (const ID::MoleculeParentMatch& match : pair.second)
+          {
+            stmt.bindInt(1, molecule_id);
+            stmt.bindInt(2, parent_id);
+            stmt.bindRef(3, match.start_pos == ID::MoleculeParentMatch::UNKNOWN_POSITION ? -1 : Int64(match.start_pos));
+            stmt.bindRef(4, match.end_pos == ID::MoleculeParentMatch::UNKNOWN_POSITION ? -1 : Int64(match.end_pos));
+            stmt.bindText(5, match.left_neighbor);
+            stmt.bindText(6, match.right_neighbor);
+            stmt.execute();
+          }
+        }
+      }
+
+      void storeIdentifiedMolecules_(const ID& id_data)
+      {
+        Statement stmt(db_, "INSERT INTO ID_IdentifiedMolecule VALUES (?, ?, ?)");
+        Statement stmt_compound(db_, "INSERT INTO ID_IdentifiedCompound VALUES (?, ?, ?, ?, ?)");
+        Statement stmt_matches(db_, "INSERT INTO ID_ParentMatch VALUES (?, ?, ?, ?, ?, ?)");
+        Int64 id = 1;
+        for (const ID::IdentifiedPeptide& peptide : id_data.getIdentifiedPeptides())
+        {
+          stmt.bindInt(1, id);
+          stmt.bindInt(2, Int64(ID::MoleculeType::PROTEIN));
+          stmt.bindText(3, peptide.sequence.toString());
+          stmt.execute();
+          storeParentMatches_(peptide.parent_matches, id, stmt_matches);
+          storeAppliedSteps_(peptide, "ID_IdentifiedMolecule", id);
+          storeMetaInfo_(peptide, "ID_IdentifiedMolecule", id);
+          molecule_ids_[uintptr_t(&peptide)] = id++;
+        }
+        for (const ID::IdentifiedCompound& compound : id_data.getIdentifiedCompounds())
+        {
+          stmt.bindInt(1, id);
+          stmt.bindInt(2, Int64(ID::MoleculeType::COMPOUND));
+          stmt.bindText(3, compound.identifier);
+          stmt.execute();
+          stmt_compound.bindInt(1, id);
+          stmt_compound.bindText(2, compound.formula.toString());
+          stmt_compound.bindText(3, compound.name);
+          stmt_compound.bindText(4, compound.smile);
+          stmt_compound.bindText(5, compound.inchi);
+          stmt_compound.execute();
+          storeAppliedSteps_(compound, "ID_IdentifiedMolecule", id);
+          storeMetaInfo_(compound, "ID_IdentifiedMolecule", id);
+          molecule_ids_[uintptr_t(&compound)] = id++;
+        }
+        for (const ID::IdentifiedOligo& oligo : id_data.getIdentifiedOligos())
+        {
+          stmt.bindInt(1, id);
+          stmt.bindInt(2, Int64(ID::MoleculeType::RNA));
+          stmt.bindText(3, oligo.sequence.toString());
+          stmt.execute();
+          storeParentMatches_(oligo.parent_matches, id, stmt_matches);
+          storeAppliedSteps_(oligo, "ID_IdentifiedMolecule", id);
+          storeMetaInfo_(oligo, "ID_IdentifiedMolecule", id);
+          molecule_ids_[uintptr_t(&oligo)] = id++;
+        }
+      }
+
+      void storeMoleculeQueryMatches_(const ID& id_data)
+      {
+        Statement stmt(db_, "INSERT INTO ID_MoleculeQueryMatch VALUES (?, ?, ?, ?)");
+        Statement stmt_peaks(db_, "INSERT INTO ID_MoleculeQueryMatch_PeakAnnotation VALUES (?, ?, ?, ?, ?, ?)");
+        Int64 id = 1;
+        for (const ID::MoleculeQueryMatch& match : id_data.getMoleculeQueryMatches())
+        {
+          stmt.bindInt(1, id);
+          stmt.bindInt(2, lookupID(molecule_ids_, moleculeAddress(match.identified_molecule_ref)));
+          stmt.bindInt(3, lookupID(query_ids_, match.data_query_ref));
+          stmt.bindInt(4, match.charge);
+          stmt.execute();
+          for (const auto& pair : match.peak_annotations)
+          {
+            Int64 step_id = pair.first ? lookupID(step_ids_, *pair.first) : -1;
+            for (const auto& peak : pair.second)
+            {
+              stmt_peaks.bindInt(1, id);
+              stmt_peaks.bindRef(2, step_id);
+              stmt_peaks.bindText(3, peak.annotation);
+              stmt_peaks.bindInt(4, peak.charge);
+              stmt_peaks.bindDouble(5, peak.mz);
+              stmt_peaks.bindDouble(6, peak.intensity);
+              stmt_peaks.execute();
+            }
+          }
+          storeAppliedSteps_(match, "ID_MoleculeQueryMatch", id);
+          storeMetaInfo_(match, "ID_MoleculeQueryMatch", id);
+          match_ids_[uintptr_t(&match)] = id++;
+        }
+      }
+
+      void storeQueryMatchGroups_(const ID& id_data)
+      {
+        Statement stmt(db_, "INSERT INTO ID_QueryMatchGroup VALUES (?)");
+        Statement stmt_matches(db_, "INSERT INTO ID_QueryMatchGroup_MoleculeQueryMatch VALUES (?, ?)");
+        Int64 id = 1;
+        for (const ID::QueryMatchGroup& group : id_data.getQueryMatchGroups())
+        {
+          stmt.bindInt(1, id);
+          stmt.execute();
+          for (ID::QueryMatchRef match_ref : group.query_match_refs)
+          {
+            stmt_matches.bindInt(1, id);
+            stmt_matches.bindInt(2, lookupID(match_ids_, match_ref));
+            stmt_matches.execute();
+          }
+          storeAppliedSteps_(group, "ID_QueryMatchGroup", id);
+          storeMetaInfo_(group, "ID_QueryMatchGroup", id);
+          ++id;
+        }
+      }
+
+      SqliteConnector conn_;
+      sqlite3* db_;
+      map<String, unique_ptr<Statement>> meta_statements_;
+      map<String, unique_ptr<Statement>> meta_list_statements_;
+      map<String, unique_ptr<Statement>> step_statements_;
+      // IDs of stored objects (by address):
+      unordered_map<uintptr_t, Int64> input_file_ids_, score_type_ids_, software_ids_, search_param_ids_, step_ids_, query_ids_, parent_ids_, molecule_ids_, match_ids_;
+    };
+
+
+    /// Helper class for reading OMS files
+    class OMSFileLoad
+    {
+    public:
+      OMSFileLoad(const String& filename, ID& id_data):
+        conn_(filename, SqliteConnector::SqlOpenMode::READONLY), db_(conn_.getDB()), id_data_(id_data)
+      {
+        // memory-map the database file for faster (partial) reading:
+        conn_.executeStatement("PRAGMA mmap_size = 1073741824");
+      }
+
+      void load(const String& input_file, bool restrict)
+      {
+        checkVersion_();
+        loadMetaInfo_("ID_IdentificationData", {{1, &id_data_}});
+        loadInputFiles_();
+        if (restrict)
+        {
+          Int64 file_id = -1;
+          for (const auto& pair : input_file_refs_)
+          {
+            if (*pair.second == input_file) file_id = pair.first;
+          }
+          if (file_id < 0)
+          {
+            throw Exception::ElementNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, input_file);
+          }
+          query_filter_ = " WHERE input_file_id = " + String(file_id);
+          match_filter_ = " WHERE data_query_id IN (SELECT id FROM ID_DataQuery" + query_filter_ + ")";
+          molecule_filter_ = " WHERE id IN (SELECT identified_molecule_id FROM ID_MoleculeQueryMatch" + match_filter_ + ")";
+        }
+        loadScoreTypes_();
+        loadDataProcessingSoftwares_();
+        loadDBSearchParams_();
+        loadDataProcessingSteps_();
+        loadDataQueries_();
+        loadParentMolecules_();
+        loadParentMoleculeGroupings_();
+        loadIdentifiedMolecules_();
+        loadMoleculeQueryMatches_();
+        loadQueryMatchGroups_();
+      }
+
+    private:
+      /// Restrict child rows of @p table to the parents that pass @p filter
+      static String parentFilter_(const String& table, const String& filter)
+      {
+        if (filter.empty()) return "";
+        return " WHERE parent_id IN (SELECT id FROM " + table + filter + ")";
+      }
+
+      void checkVersion_()
+      {
+        if (!conn_.tableExists("version"))
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "database contains no version information - not an OMS file?");
+        }
+        Statement stmt(db_, "SELECT version FROM version");
+        if (!stmt.next() || (stmt.getInt(0) != OMSFile::VERSION))
+        {
+          throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "", "unsupported OMS file version (expected " + String(OMSFile::VERSION) + ")");
+        }
+      }
+
+      /// Create a meta value from the columns (type, value, unit type, unit) starting at @p type_pos; list elements are read with @p list_stmt
+      static DataValue makeDataValue_(const Statement& stmt, int type_pos, Statement& list_stmt)
+      {
+        DataValue value;
+        switch (DataValue::DataType(stmt.getInt(type_pos)))
+        {
+          case DataValue::STRING_VALUE:
+            if (!stmt.isNull(type_pos + 1)) value = DataValue(stmt.getText(type_pos + 1));
+            break;
+          case DataValue::INT_VALUE:
+            if (!stmt.isNull(type_pos + 1)) value = DataValue(SignedSize(stmt.getInt(type_pos + 1)));
+            break;
+          case DataValue::DOUBLE_VALUE:
+            if (!stmt.isNull(type_pos + 1)) value = DataValue(stmt.getDouble(type_pos + 1));
+            break;
+          case DataValue::STRING_LIST:
+          {
+            StringList values;
+            while (list_stmt.next()) values.push_back(list_stmt.getText(0));
+            value = DataValue(values);
+            break;
+          }
+          case DataValue::INT_LIST:
+          {
+            IntList values;
+            while (list_stmt.next()) values.push_back(int(list_stmt.getInt(0)));
+            value = DataValue(values);
+            break;
+          }
+          case DataValue::DOUBLE_LIST:
+          {
+            DoubleList values;
+            while (list_stmt.next()) values.push_back(list_stmt.getDouble(0));
+            value = DataValue(values);
+            break;
+          }
+          default:
+            break;
+        }
+        if (!stmt.isNull(type_pos + 3))
+        {
+          value.setUnitType(DataValue::UnitType(stmt.getInt(type_pos + 2)));
+          value.setUnit(int32_t(stmt.getInt(type_pos + 3)));
+        }
+        return value;
+      }
+
+      void loadMetaInfo_(const String& parent_table, const unordered_map<Int64, MetaInfoInterface*>& objects, const String& filter = "")
+      {
+        if (objects.empty()) return;
+        Statement stmt(db_, "SELECT parent_id, name, data_type_id, value, unit_type, unit FROM " + parent_table + "_MetaData" + parentFilter_(parent_table, filter));
+        Statement list_stmt(db_, "SELECT value FROM " + parent_table + "_MetaData_ListValue WHERE parent_id = ? AND name = ? ORDER BY list_order");
+        while (stmt.next())
+        {
+          auto pos = objects.find(stmt.getInt(0));
+          if (pos != objects.end())
+          {
+            String name = stmt.getText(1);
+            list_stmt.bindInt(1, stmt.getInt(0));
+            list_stmt.bindText(2, name);
+            pos->second->setMetaValue(name, makeDataValue_(stmt, 2, list_stmt));
+            list_stmt.reset();
+          }
+        }
+      }
+
+      void loadAppliedSteps_(const String& parent_table, const unordered_map<Int64, IdentificationDataInternal::ScoredProcessingResult*>& objects, const String& filter = "")
+      {
+        if (objects.empty()) return;
+        Statement stmt(db_, "SELECT parent_id, processing_step_id, step_order, score_type_id, score FROM " + parent_table + "_AppliedProcessingStep" + parentFilter_(parent_table, filter) + " ORDER BY parent_id, step_order");
+        IdentificationDataInternal::ScoredProcessingResult* current = nullptr;
+        Int64 current_order = -1;
+        ID::AppliedProcessingStep applied;
+        while (stmt.next())
+        {
+          auto pos = objects.find(stmt.getInt(0));
+          if (pos == objects.end()) continue;
+          Int64 step_order = stmt.getInt(2);
+          if ((pos->second != current) || (step_order != current_order)) // next step
+          {
+            if (current) current->addProcessingStep(applied);
+            current = pos->second;
+            current_order = step_order;
+            applied = ID::AppliedProcessingStep();
+            if (!stmt.isNull(1))
+            {
+              applied.processing_step_opt = lookupRef(step_refs_, stmt.getInt(1), "processing step");
+            }
+          }
+          if (!stmt.isNull(3))
+          {
+            applied.scores[lookupRef(score_type_refs_, stmt.getInt(3), "score type")] = stmt.getDouble(4);
+          }
+        }
+        if (current) current->addProcessingStep(applied);
+      }
+
+      void loadInputFiles_()
+      {
+        Statement stmt(db_, "SELECT id, file FROM ID_InputFile");
+        while (stmt.next())
+        {
+          input_file_refs_[stmt.getInt(0)] = id_data_.registerInputFile(stmt.getText(1));
+        }
+      }
+
+      void loadScoreTypes_()
+      {
+        map<Int64, ID::ScoreType> score_types;
+        Statement stmt(db_, "SELECT id, accession, name, cv_identifier_ref, higher_better FROM ID_ScoreType");
+        while (stmt.next())
+        {
+          CVTerm cv_term(stmt.getText(1), stmt.getText(2), stmt.getText(3));
+          score_types.emplace(stmt.getInt(0), ID::ScoreType(cv_term, stmt.getInt(4) != 0));
+        }
+        unordered_map<Int64, MetaInfoInterface*> meta;
+        for (auto& pair : score_types) meta[pair.first] = &pair.second;
+        loadMetaInfo_("ID_ScoreType", meta);
+        for (const auto& pair : score_types)
+        {
+          score_type_refs_[pair.first] = id_data_.registerScoreType(pair.second);
+        }
+      }
+
+      void loadDataProcessingSoftwares_()
+      {
+        map<Int64, ID::DataProcessingSoftware> softwares;
+        Statement stmt(db_, "SELECT id, name, version FROM ID_DataProcessingSoftware");
+        while (stmt.next())
+        {
+          softwares.emplace(stmt.getInt(0), ID::DataProcessingSoftware(stmt.getText(1), stmt.getText(2)));
+        }
+        Statement stmt_scores(db_, "SELECT software_id, score_type_id FROM ID_DataProcessingSoftware_AssignedScore ORDER BY software_id, score_type_order");
+        while (stmt_scores.next())
+        {
+          softwares.at(stmt_scores.getInt(0)).assigned_scores.push_back(lookupRef(score_type_refs_, stmt_scores.getInt(1), "score type"));
+        }
+        unordered_map<Int64, MetaInfoInterface*> meta;
+        for (auto& pair : softwares) meta[pair.first] = &pair.second;
+        loadMetaInfo_("ID_DataProcessingSoftware", meta);
+        for (const auto& pair : softwares)
+        {
+          software_refs_[pair.first] = id_data_.registerDataProcessingSoftware(pair.second);
+        }
+      }
+
+      void loadDBSearchParams_()
+      {
+        map<Int64, ID::DBSearchParam> params;
+        Statement stmt(db_, "SELECT * FROM ID_DBSearchParam");
+        while (stmt.next())
+        {
+          ID::DBSearchParam param;
+          param.molecule_type = ID::MoleculeType(stmt.getInt(1));
+          param.mass_type = (stmt.getInt(2) != 0) ? ID::MassType::AVERAGE : ID::MassType::MONOISOTOPIC;
+          param.database = stmt.getText(3);
+          param.database_version = stmt.getText(4);
+          param.taxonomy = stmt.getText(5);
+          for (Int charge : ListUtils::create<Int>(stmt.getText(6)))
+          {
+            param.charges.insert(charge);
+          }
+          param.precursor_mass_tolerance = stmt.getDouble(7);
+          param.fragment_mass_tolerance = stmt.getDouble(8);
+          param.precursor_tolerance_ppm = stmt.getInt(9) != 0;
+          param.fragment_tolerance_ppm = stmt.getInt(10) != 0;
+          if (!stmt.isNull(11))
+          {
+            String enzyme = stmt.getText(11);
+            if (param.molecule_type == ID::MoleculeType::RNA)
+            {
+              param.digestion_enzyme = RNaseDB::getInstance()->getEnzyme(enzyme);
+            }
+            else
+            {
+              param.digestion_enzyme = ProteaseDB::getInstance()->getEnzyme(enzyme);
+            }
+          }
+          param.enzyme_term_specificity = EnzymaticDigestion::Specificity(stmt.getInt(12));
+          param.missed_cleavages = Size(stmt.getInt(13));
+          param.min_length = Size(stmt.getInt(14));
+          param.max_length = Size(stmt.getInt(15));
+          params.emplace(stmt.getInt(0), param);
+        }
+        Statement stmt_mods(db_, "SELECT search_param_id, name, fixed FROM ID_DBSearchParam_Modification");
+        while (stmt_mods.next())
+        {
+          ID::DBSearchParam& param = params.at(stmt_mods.getInt(0));
+          if (stmt_mods.getInt(2) != 0)
+          {
+            param.fixed_mods.insert(stmt_mods.getText(1));
+          }
+          else
+          {
+            param.variable_mods.insert(stmt_mods.getText(1));
+          }
+        }
+        unordered_map<Int64, MetaInfoInterface*> meta;
+        for (auto& pair : params) meta[pair.first] = &pair.second;
+        loadMetaInfo_("ID_DBSearchParam", meta);
+        for (const auto& pair : params)
+        {
+          search_param_refs_[pair.first] = id_data_.registerDBSearchParam(pair.second);
+        }
+      }
+
+      void loadDataProcessingSteps_()
+      {
+        map<Int64, ID::DataProcessingStep> steps;
+        map<Int64, Int64> search_params;
+        Statement stmt(db_, "SELECT id, software_id, date_time, search_param_id FROM ID_DataProcessingStep");
+        while (stmt.next())
+        {
+          ID::DataProcessingStep step(lookupRef(software_refs_, stmt.getInt(1), "data processing software"));
+          step.date_time = stmt.isNull(2) ? DateTime() : DateTime::fromString(stmt.getText(2), DATE_FORMAT);
+          if (!stmt.isNull(3)) search_params[stmt.getInt(0)] = stmt.getInt(3);
+          steps.emplace(stmt.getInt(0), step);
+        }
+        Statement stmt_inputs(db_, "SELECT processing_step_id, input_file_id FROM ID_DataProcessingStep_InputFile ORDER BY processing_step_id, file_order");
+        while (stmt_inputs.next())
+        {
+          steps.at(stmt_inputs.getInt(0)).input_file_refs.push_back(lookupRef(input_file_refs_, stmt_inputs.getInt(1), "input file"));
+        }
+        Statement stmt_primary(db_, "SELECT processing_step_id, primary_file FROM ID_DataProcessingStep_PrimaryFile ORDER BY processing_step_id, file_order");
+        while (stmt_primary.next())
+        {
+          steps.at(stmt_primary.getInt(0)).primary_files.push_back(stmt_primary.getText(1));
+        }
+        Statement stmt_actions(db_, "SELECT processing_step_id, action FROM ID_DataProcessingStep_ProcessingAction");
+        while (stmt_actions.next())
+        {
+          steps.at(stmt_actions.getInt(0)).actions.insert(DataProcessing::ProcessingAction(stmt_actions.getInt(1)));
+        }
+        unordered_map<Int64, MetaInfoInterface*> meta;
+        for (auto& pair : steps) meta[pair.first] = &pair.second;
+        loadMetaInfo_("ID_DataProcessingStep", meta);
+        for (const auto& pair : steps)
+        {
+          auto search_pos = search_params.find(pair.first);
+          if (search_pos != search_params.end())
+          {
+            step_refs_[pair.first] = id_data_.registerDataProcessingStep(pair.second, lookupRef(search_param_refs_, search_pos->second, "search parameters"));
+          }
+          else
+          {
+            step_refs_[pair.first] = id_data_.registerDataProcessingStep(pair.second);
+          }
+        }
+      }
+
+      void loadDataQueries_()
+      {
+        map<Int64, ID::DataQuery> queries;
+        Statement stmt(db_, "SELECT id, data_id, input_file_id, rt, mz FROM ID_DataQuery" + query_filter_);
+        while (stmt.next())
+        {
+          ID::DataQuery query(stmt.getText(1));
+          if (!stmt.isNull(2))
+          {
+            query.input_file_opt = lookupRef(input_file_refs_, stmt.getInt(2), "input file");
+          }
+          // NaN is stored as NULL by SQLite:
+          query.rt = stmt.isNull(3) ? numeric_limits<double>::quiet_NaN() : stmt.getDouble(3);
+          query.mz = stmt.isNull(4) ? numeric_limits<double>::quiet_NaN() : stmt.getDouble(4);
+          queries.emplace(stmt.getInt(0), query);
+        }
+        unordered_map<Int64, MetaInfoInterface*> meta;
+        for (auto& pair : queries) meta[pair.first] = &pair.second;
+        loadMetaInfo_("ID_DataQuery", meta, query_filter_);
+        for (const auto& pair : queries)
+        {
+          query_refs_[pair.first] = id_data_.registerDataQuery(pair.second);
+        }
+      }
+
+      void loadParentMolecules_()
+      {
+        map<Int64, ID::ParentMolecule> parents;
+        Statement stmt(db_, "SELECT id, accession, molecule_type_id, sequence, description, coverage, is_decoy FROM ID_ParentMolecule");
+        while (stmt.next())
+        {
+          parents.emplace(stmt.getInt(0), ID::ParentMolecule(stmt.getText(1), ID::MoleculeType(stmt.getInt(2)), stmt.getText(3), stmt.getText(4), stmt.getDouble(5), stmt.getInt(6) != 0));
+        }
+        unordered_map<Int64, MetaInfoInterface*> meta;
+        unordered_map<Int64, IdentificationDataInternal::ScoredProcessingResult*> scored;
+        for (auto& pair : parents)
+        {
+          meta[pair.first] = &pair.second;
+          scored[pair.first] = &pair.second;
+        }
+        loadMetaInfo_("ID_ParentMolecule", meta);
+        loadAppliedSteps_("ID_ParentMolecule", scored);
+        for (const auto& pair : parents)
+        {
+          parent_refs_[pair.first] = id_data_.registerParentMolecule(pair.second);
+        }
+      }
+
+      void loadParentMoleculeGroupings_()
+      {
+        map<Int64, ID::ParentMoleculeGrouping> groupings;
+        Statement stmt(db_, "SELECT id, label FROM ID_ParentMoleculeGrouping");
+        while (stmt.next())
+        {
+          groupings[stmt.getInt(0)].label = stmt.getText(1);
+        }
+        if (groupings.empty()) return;
+
+        map<Int64, pair<Int64, ID::ParentMoleculeGroup>> groups; // group ID -> (grouping ID, group)
+        Statement stmt_groups(db_, "SELECT id, grouping_id FROM ID_ParentMoleculeGroup");
+        while (stmt_groups.next())
+        {
+          groups[stmt_groups.getInt(0)].first = stmt_groups.getInt(1);
+        }
+        Statement stmt_scores(db_, "SELECT parent_group_id, score_type_id, score FROM ID_ParentMoleculeGroup_Score");
+        while (stmt_scores.next())
+        {
+          groups.at(stmt_scores.getInt(0)).second.scores[lookupRef(score_type_refs_, stmt_scores.getInt(1), "score type")] = stmt_scores.getDouble(2);
+        }
+        Statement stmt_parents(db_, "SELECT parent_group_id, parent_molecule_id FROM ID_ParentMoleculeGroup_ParentMolecule");
+        while (stmt_parents.next())
+        {
+          groups.at(stmt_parents.getInt(0)).second.parent_molecule_refs.insert(lookupRef(parent_refs_, stmt_parents.getInt(1), "parent molecule"));
+        }
+        for (auto& pair : groups)
+        {
+          groupings.at(pair.second.first).groups.insert(std::move(pair.second.second));
+        }
+
+        unordered_map<Int64, MetaInfoInterface*> meta;
+        unordered_map<Int64, IdentificationDataInternal::ScoredProcessingResult*> scored;
+        for (auto& pair : groupings)
+        {
+          meta[pair.first] = &pair.second;
+          scored[pair.first] = &pair.second;
+        }
+        loadMetaInfo_("ID_ParentMoleculeGrouping", meta);
+        loadAppliedSteps_("ID_ParentMoleculeGrouping", scored);
+        for (const auto& pair : groupings)
+        {
+          id_data_.registerParentMoleculeGrouping(pair.second);
+        }
+      }
+
+      void loadIdentifiedMolecules_()
+      {
+        map<Int64, ID::IdentifiedPeptide> peptides;
+        map<Int64, ID::IdentifiedCompound> compounds;
+        map<Int64, ID::IdentifiedOligo> oligos;
+        unordered_map<Int64, MetaInfoInterface*> meta;
+        unordered_map<Int64, IdentificationDataInternal::ScoredProcessingResult*> scored;
+        unordered_map<Int64, IdentificationDataInternal::ParentMatches*> parent_matches;
+
+        Statement stmt(db_, "SELECT id, molecule_type_id, identifier FROM ID_IdentifiedMolecule" + molecule_filter_);
+        while (stmt.next())
+        {
+          Int64 id = stmt.getInt(0);
+          String identifier = stmt.getText(2);
+          switch (ID::MoleculeType(stmt.getInt(1)))
+          {
+            case ID::MoleculeType::PROTEIN:
+            {
+              ID::IdentifiedPeptide& peptide = peptides.emplace(id, ID::IdentifiedPeptide(AASequence::fromString(identifier))).first->second;
+              meta[id] = &peptide;
+              scored[id] = &peptide;
+              parent_matches[id] = &peptide.parent_matches;
+              break;
+            }
+            case ID::MoleculeType::COMPOUND:
+            {
+              ID::IdentifiedCompound& compound = compounds.emplace(id, ID::IdentifiedCompound(identifier)).first->second;
+              meta[id] = &compound;
+              scored[id] = &compound;
+              break;
+            }
+            case ID::MoleculeType::RNA:
+            {
+              ID::IdentifiedOligo& oligo = oligos.emplace(id, ID::IdentifiedOligo(NASequence::fromString(identifier))).first->second;
+              meta[id] = &oligo;
+              scored[id] = &oligo;
+              parent_matches[id] = &oligo.parent_matches;
+              break;
+            }
+            default:
+              throw Exception::ParseError(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, identifier, "invalid molecule type");
+          }
+        }
+
+        if (!compounds.empty())
+        {
+          Statement stmt_compounds(db_, "SELECT molecule_id, formula, name, smile, inchi FROM ID_IdentifiedCompound");
+          while (stmt_compounds.next())
+          {
+            auto pos = compounds.find(stmt_compounds.getInt(0));
+            if (pos == compounds.end()) continue;
+            pos->second.formula = EmpiricalFormula(stmt_compounds.getText(1));
+            pos->second.name = stmt_compounds.getText(2);
+            pos->second.smile = stmt_compounds.getText(3);
+            pos->second.inchi = stmt_compounds.getText(4);
+          }
+        }
+
+        if (!parent_matches.empty())
+        {
+          String filter = molecule_filter_.empty() ? "" : " WHERE molecule_id IN (SELECT id FROM ID_IdentifiedMolecule" + molecule_filter_ + ")";
+          Statement stmt_matches(db_, "SELECT molecule_id, parent_id, start_pos, end_pos, left_neighbor, right_neighbor FROM ID_ParentMatch" + filter);
+          while (stmt_matches.next())
+          {
+            auto pos = parent_matches.find(stmt_matches.getInt(0));
+            if (pos == parent_matches.end()) continue;
+            ID::MoleculeParentMatch match(
+              stmt_matches.isNull(2) ? ID::MoleculeParentMatch::UNKNOWN_POSITION : Size(stmt_matches.getInt(2)),
+              stmt_matches.isNull(3) ? ID::MoleculeParentMatch::UNKNOWN_POSITION : Size(stmt_matches.getInt(3)),
+              stmt_matches.getText(4), stmt_matches.getText(5));
+            (*pos->second)[lookupRef(parent_refs_, stmt_matches.getInt(1), "parent molecule")].insert(match);
+          }
+        }
+
+        loadMetaInfo_("ID_IdentifiedMolecule", meta, molecule_filter_);
+        loadAppliedSteps_("ID_IdentifiedMolecule", scored, molecule_filter_);
+
+        for (const auto& pair : peptides)
+        {
+          molecule_refs_.emplace(pair.first, id_data_.registerIdentifiedPeptide(pair.second));
+        }
+        for (const auto& pair : compounds)
+        {
+          molecule_refs_.emplace(pair.first, id_data_.registerIdentifiedCompound(pair.second));
+        }
+        for (const auto& pair : oligos)
+        {
+          molecule_refs_.emplace(pair.first, id_data_.registerIdentifiedOligo(pair.second));
+        }
+      }
+
+      void loadMoleculeQueryMatches_()
+      {
+        map<Int64, ID::MoleculeQueryMatch> matches;
+        Statement stmt(db_, "SELECT id, identified_molecule_id, data_query_id, charge FROM ID_MoleculeQueryMatch" + match_filter_);
+        while (stmt.next())
+        {
+          matches.emplace(stmt.getInt(0), ID::MoleculeQueryMatch(
+            lookupRef(molecule_refs_, stmt.getInt(1), "identified molecule"),
+            lookupRef(query_refs_, stmt.getInt(2), "data query"), Int(stmt.getInt(3))));
+        }
+        if (matches.empty()) return;
+
+        Statement stmt_peaks(db_, "SELECT parent_id, processing_step_id, peak_annotation, peak_charge, peak_mz, peak_intensity FROM ID_MoleculeQueryMatch_PeakAnnotation" + parentFilter_("ID_MoleculeQueryMatch", match_filter_));
+        while (stmt_peaks.next())
+        {
+          auto pos = matches.find(stmt_peaks.getInt(0));
+          if (pos == matches.end()) continue;
+          boost::optional<ID::ProcessingStepRef> step_opt;
+          if (!stmt_peaks.isNull(1))
+          {
+            step_opt = lookupRef(step_refs_, stmt_peaks.getInt(1), "processing step");
+          }
+          PeptideHit::PeakAnnotation peak;
+          peak.annotation = stmt_peaks.getText(2);
+          peak.charge = int(stmt_peaks.getInt(3));
+          peak.mz = stmt_peaks.getDouble(4);
+          peak.intensity = stmt_peaks.getDouble(5);
+          pos->second.peak_annotations[step_opt].push_back(peak);
+        }
+
+        unordered_map<Int64, MetaInfoInterface*> meta;
+        unordered_map<Int64, IdentificationDataInternal::ScoredProcessingResult*> scored;
+        for (auto& pair : matches)
+        {
+          meta[pair.first] = &pair.second;
+          scored[pair.first] = &pair.second;
+        }
+        loadMetaInfo_("ID_MoleculeQueryMatch", meta, match_filter_);
+        loadAppliedSteps_("ID_MoleculeQueryMatch", scored, match_filter_);
+        for (const auto& pair : matches)
+        {
+          match_refs_[pair.first] = id_data_.registerMoleculeQueryMatch(pair.second);
+        }
+      }
+
+      void loadQueryMatchGroups_()
+      {
+        map<Int64, ID::QueryMatchGroup> groups;
+        set<Int64> incomplete; // groups with matches that were not loaded
+        Statement stmt(db_, "SELECT id FROM ID_QueryMatchGroup");
+        while (stmt.next())
+        {
+          groups[stmt.getInt(0)];
+        }
+        if (groups.empty()) return;
+        Statement stmt_matches(db_, "SELECT group_id, query_match_id FROM ID_QueryMatchGroup_MoleculeQueryMatch");
+        while (stmt_matches.next())
+        {
+          Int64 group_id = stmt_matches.getInt(0);
+          auto pos = match_refs_.find(stmt_matches.getInt(1));
+          if (pos == match_refs_.end())
+          {
+            incomplete.insert(group_id);
+          }
+          else
+          {
+            groups.at(group_id).query_match_refs.insert(pos->second);
+          }
+        }
+        for (Int64 group_id : incomplete)
+        {
+          groups.erase(group_id);
+        }
+
+        unordered_map<Int64, MetaInfoInterface*> meta;
+        unordered_map<Int64, IdentificationDataInternal::ScoredProcessingResult*> scored;
+        for (auto& pair : groups)
+        {
+          meta[pair.first] = &pair.second;
+          scored[pair.first] = &pair.second;
+        }
+        loadMetaInfo_("ID_QueryMatchGroup", meta);
+        loadAppliedSteps_("ID_QueryMatchGroup", scored);
+        for (const auto& pair : groups)
+        {
+          id_data_.registerQueryMatchGroup(pair.second);
+        }
+      }
+
+      SqliteConnector conn_;
+      sqlite3* db_;
+      ID& id_data_;
+      // SQL conditions for partial loading:
+      String query_filter_, match_filter_, molecule_filter_;
+      // references to loaded objects (by ID):
+      unordered_map<Int64, ID::InputFileRef> input_file_refs_;
+      unordered_map<Int64, ID::ScoreTypeRef> score_type_refs_;
+      unordered_map<Int64, ID::ProcessingSoftwareRef> software_refs_;
+      unordered_map<Int64, ID::SearchParamRef> search_param_refs_;
+      unordered_map<Int64, ID::ProcessingStepRef> step_refs_;
+      unordered_map<Int64, ID::DataQueryRef> query_refs_;
+      unordered_map<Int64, ID::ParentMoleculeRef> parent_refs_;
+      unordered_map<Int64, ID::IdentifiedMoleculeRef> molecule_refs_;
+      unordered_map<Int64, ID::QueryMatchRef> match_refs_;
+    };
+  }
+
+
+  void OMSFile::store(const String& filename, const IdentificationData& id_data)
+  {
+    if (File::exists(filename) && !File::remove(filename))
+    {
+      throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    startProgress(0, 0, "Storing OMS file");
+    OMSFileStore(filename).store(id_data);
+    endProgress();
+  }
+
+  void OMSFile::load(const String& filename, IdentificationData& id_data)
+  {
+    load_(filename, id_data, "", false);
+  }
+
+  void OMSFile::load(const String& filename, IdentificationData& id_data, const String& input_file)
+  {
+    load_(filename, id_data, input_file, true);
+  }
+
+  void OMSFile::load_(const String& filename, IdentificationData& id_data, const String& input_file, bool restrict)
+  {
+    if (!File::exists(filename))
+    {
+      throw Exception::FileNotFound(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, filename);
+    }
+    startProgress(0, 0, "Loading OMS file");
+    OMSFileLoad(filename, id_data).load(input_file, restrict);
+    endProgress();
+  }
+}
@@ -327,9 +327,35 @@ namespace OpenMS
   {
     if (chunks.size() == 1 && chunks[0].is_sorted) return;
 
-    if (float_data_arrays_.empty() && string_data_arrays_.empty() && integer_data_arrays_.empty())
+    if (chunks.empty())
     {
-      std::stable_sort(ContainerType::begin(), ContainerType::end(), PeakType::PositionLess());
+      sortByPosition();
+    }
+    else if (float_data_arrays_.empty() && string_data_arrays_.empty() && integer_data_arrays_.empty())
+    {
+      // sort all chunks, that haven't been sorted yet, and merge them in place
+      // (stable, i.e. the same result as a stable_sort of the whole spectrum)
+      ContainerType::iterator first_peak = ContainerType::begin();
+      for (const Chunk& chunk : chunks)
+      {
+        if (!chunk.is_sorted)
+        {
+          std::stable_sort(first_peak + chunk.start, first_peak + chunk.end, PeakType::PositionLess());
+        }
+      }
+
+      std::function<void(Size,Size)> rec;
+      rec = [&chunks, &first_peak, &rec] (Size first, Size last)->void {
+        if (last > first)
+        {
+          Size mid = first + (last - first) / 2;
+          rec(first, mid);
+          rec(mid + 1, last);
+          std::inplace_merge(first_peak + chunks[first].start, first_peak + chunks[mid].end, first_peak + chunks[last].end, PeakType::PositionLess());
+        }
+      };
+
+      rec(0, chunks.size() - 1);
     }
     else
     {
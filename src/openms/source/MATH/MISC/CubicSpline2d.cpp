@@ -105,6 +105,36 @@ namespace OpenMS
     return ((d_[i] * xx + c_[i]) * xx + b_[i]) * xx + a_[i];
   }
 
+  double CubicSpline2d::eval(double x, size_t& segment) const
+  {
+    if (x < x_.front() || x > x_.back())
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Argument out of range of spline interpolation.");
+    }
+
+    // same node as in eval(x): the last one left of (or exactly at) x, but
+    // never the last knot itself (all coefficient vectors are one element shorter)
+    const size_t last_segment = x_.size() - 2;
+    if (segment > last_segment || x_[segment] > x)
+    {
+      // invalid hint, search all knots
+      segment = static_cast<size_t>(std::upper_bound(x_.begin(), x_.end(), x) - x_.begin()) - 1;
+    }
+    else if (segment < last_segment && x_[segment + 1] <= x)
+    {
+      // x lies further right: check the next interval, then search the remainder
+      ++segment;
+      if (segment < last_segment && x_[segment + 1] <= x)
+      {
+        segment = static_cast<size_t>(std::upper_bound(x_.begin() + segment + 1, x_.end(), x) - x_.begin()) - 1;
+      }
+    }
+    segment = std::min(segment, last_segment);
+
+    const double xx = x - x_[segment];
+    return ((d_[segment] * xx + c_[segment]) * xx + b_[segment]) * xx + a_[segment];
+  }
+
   double CubicSpline2d::derivatives(double x, unsigned order) const
   {
     if (x < x_.front() || x > x_.back())
@@ -48,6 +48,7 @@
 #include <QDir>
 
 #include <algorithm>
+#include <array>
 
 
 
@@ -57,6 +58,50 @@ namespace OpenMS
 {
   namespace Math
   {
+    namespace
+    {
+      /// number of scores per block for the parallel evaluation of densities, posteriors and sums
+      const Size EM_BLOCK_SIZE = 4096;
+
+      /**
+        @brief Accumulates @p N sums over @p n data points in parallel
+
+        Fixed-size blocks are summed in parallel and the block sums are added up in order afterwards.
+        The result therefore does not depend on the number of threads (i.e. the EM algorithm stays deterministic).
+
+        @p add_terms(i, sums) adds the terms of data point @p i to @p sums.
+      */
+      template <Size N, typename AddTerms>
+      std::array<double, N> blockwiseSums(Size n, const AddTerms& add_terms)
+      {
+        const Size n_blocks = (n + EM_BLOCK_SIZE - 1) / EM_BLOCK_SIZE;
+        std::vector<std::array<double, N> > block_sums(n_blocks);
+#pragma omp parallel for schedule(static) if (n_blocks > 1)
+        for (SignedSize b = 0; b < (SignedSize)n_blocks; ++b)
+        {
+          std::array<double, N> sums;
+          sums.fill(0.0);
+          const Size end = std::min(n, (b + 1) * EM_BLOCK_SIZE);
+          for (Size i = b * EM_BLOCK_SIZE; i < end; ++i)
+          {
+            add_terms(i, sums);
+          }
+          block_sums[b] = sums;
+        }
+
+        std::array<double, N> result;
+        result.fill(0.0);
+        for (const std::array<double, N>& sums : block_sums)
+        {
+          for (Size k = 0; k < N; ++k)
+          {
+            result[k] += sums[k];
+          }
+        }
+        return result;
+      }
+    }
+
     PosteriorErrorProbabilityModel::PosteriorErrorProbabilityModel() :
       DefaultParamHandler("PosteriorErrorProbabilityModel"),
       incorrectly_assigned_fit_param_(GaussFitter::GaussFitResult(-1, -1, -1)),
@@ -76,6 +121,8 @@ namespace OpenMS
                                                                    "- ignore_extreme_percentiles: ignore everything outside 99th and 1st percentile (also removes equal values like potential censored max values in XTandem)\n"
                                                                    "- none: do nothing");
       defaults_.setValidStrings("outlier_handling", {"ignore_iqr_outliers","set_iqr_to_closest_valid","ignore_extreme_percentiles","none"});
+      defaults_.setValue("max_fit_points", 1000000, "If more scores are given, the EM algorithm is first run on this many evenly spaced quantiles of the scores and then refined on all scores (which needs only a few iterations). Speeds up fitting of very large data sets. Use 0 to always fit on all scores.", ListUtils::create<String>("advanced"));
+      defaults_.setMinInt("max_fit_points", 0);
       defaultsToParam_();
       getNegativeGnuplotFormula_ = &PosteriorErrorProbabilityModel::getGumbelGnuplotFormula;
       getPositiveGnuplotFormula_ = &PosteriorErrorProbabilityModel::getGaussGnuplotFormula;
@@ -141,104 +188,16 @@ namespace OpenMS
       // Estimate Parameters - EM algorithm
       //-------------------------------------------------------------
       bool good_fit = true;
-      bool stop_em_init = false;
-      Int max_itns = param_.getValue("max_nr_iterations");
-      int delta = param_.getValue("neg_log_delta");
-      int itns = 0;
-
-      vector<double> incorrect_log_density, correct_log_density;
-      fillLogDensitiesGumbel(x_scores, incorrect_log_density, correct_log_density);
-      vector<double> bins;
-      vector<double> incorrect_posteriors;
-      double maxlike = computeLLAndIncorrectPosteriorsFromLogDensities(incorrect_log_density, correct_log_density, incorrect_posteriors);
-      double sumIncorrectPosteriors = Math::sum(incorrect_posteriors.begin(),incorrect_posteriors.end());
-      double sumCorrectPosteriors = x_scores.size() - sumIncorrectPosteriors;
-
-      OpenMS::Math::GumbelMaxLikelihoodFitter gmlf{incorrectly_assigned_fit_gumbel_param_};
-
-      do
+      TextFile* plot_file = output_plots ? &file : nullptr;
+      vector<double> subsample = sampleQuantiles_(x_scores, (Int)param_.getValue("max_fit_points"));
+      if (!subsample.empty() && !fitGumbelGaussEM_(subsample, plot_file, good_fit))
       {
-        //-------------------------------------------------------------
-        // E-STEP (gauss)
-        double newGaussMean = 0.0;
-        auto the_x = x_scores.cbegin();
-
-        for (auto incorrect = incorrect_posteriors.cbegin(); incorrect != incorrect_posteriors.cend(); ++incorrect, ++the_x)
-        {
-          newGaussMean += (1.-*incorrect) * *the_x;
-        }
-        newGaussMean /= sumCorrectPosteriors;
-
-        double newGaussSigma = 0.0;
-        the_x = x_scores.cbegin();
-
-        for (auto incorrect = incorrect_posteriors.cbegin(); incorrect != incorrect_posteriors.cend(); ++incorrect, ++the_x)
-        {
-          newGaussSigma += (1. - *incorrect) * pow((*the_x) - newGaussMean, 2);
-        }
-        newGaussSigma = sqrt(newGaussSigma/sumCorrectPosteriors);
-
-        GumbelMaxLikelihoodFitter::GumbelDistributionFitResult newGumbelParams = gmlf.fitWeighted(x_scores, incorrect_posteriors);
-
-        if (newGumbelParams.b <= 0 || std::isnan(newGumbelParams.b))
-        {
-          OPENMS_LOG_WARN << "Warning: encountered impossible standard deviations. Aborting fit." << std::endl;
-          break;
-        }
-
-        // update parameters
-        correctly_assigned_fit_param_.x0 = newGaussMean;
-        correctly_assigned_fit_param_.sigma = newGaussSigma;
-        correctly_assigned_fit_param_.A = 1 / sqrt(2 * Constants::PI * pow(newGaussSigma, 2));
-
-        incorrectly_assigned_fit_gumbel_param_ = newGumbelParams;
-
-
-        // compute new prior probabilities negative peptides
-        fillLogDensitiesGumbel(x_scores, incorrect_log_density, correct_log_density);
-        double new_maxlike = computeLLAndIncorrectPosteriorsFromLogDensities(incorrect_log_density, correct_log_density, incorrect_posteriors);
-        sumIncorrectPosteriors = Math::sum(incorrect_posteriors.begin(),incorrect_posteriors.end());
-        sumCorrectPosteriors = x_scores.size() - sumIncorrectPosteriors;
-        negative_prior_ = sumIncorrectPosteriors / x_scores.size();
-
-        if (std::isnan(new_maxlike - maxlike))
-        {
-          OPENMS_LOG_WARN << "Numerical instabilities. Aborting." << endl;
-          return false;
-        }
-
-        // check termination criterium
-        if ((new_maxlike - maxlike) < pow(10.0, -delta) || itns >= max_itns)
-        {
-          if (itns >= max_itns)
-          {
-            OPENMS_LOG_WARN << "Number of iterations exceeded. Convergence criterion not met. Last log likelihood increase: " << (new_maxlike - maxlike) << endl;
-            OPENMS_LOG_WARN << "Algorithm returns probabilities for suboptimal fit. You might want to try raising the max. number of iterations and have a look at the distribution." << endl;
-          }
-          stop_em_init = true;
-          good_fit = true;
-        }
-        else if (new_maxlike < maxlike)
-          {
-            OPENMS_LOG_WARN << "Log Likelihood of fit decreased: " << (new_maxlike - maxlike) << ". Abort fitting. Please check"
-                                                                                                 " the gnuplot scripts and adapt search engine settings or outlier settings of IDPEP."<< endl;
-            stop_em_init = true;
-            good_fit = false;
-          }
-
-        if (output_plots)
-        {
-          String formula1, formula2, formula3;
-          formula1 = ((this)->*(getNegativeGnuplotFormula_))(incorrectly_assigned_fit_param_) + "* " + String(negative_prior_); //String(incorrectly_assigned_fit_param_.A) +" * exp(-(x - " + String(incorrectly_assigned_fit_param_.x0) + ") ** 2 / 2 / (" + String(incorrectly_assigned_fit_param_.sigma) + ") ** 2)"+ "*" + String(negative_prior_);
-          formula2 = ((this)->*(getPositiveGnuplotFormula_))(correctly_assigned_fit_param_) + "* (1 - " + String(negative_prior_) + ")"; //String(correctly_assigned_fit_param_.A) +" * exp(-(x - " + String(correctly_assigned_fit_param_.x0) + ") ** 2 / 2 / (" + String(correctly_assigned_fit_param_.sigma) + ") ** 2)"+ "* (1 - " + String(negative_prior_) + ")";
-          formula3 = getBothGnuplotFormula(incorrectly_assigned_fit_param_, correctly_assigned_fit_param_);
-          // important: use single quotes for paths, since otherwise backslashes will not be accepted on Windows!
-          file.addLine("plot '" + (String)param_.getValue("out_plot") + "_scores.txt' with boxes, " + formula1 + " , " + formula2 + " , " + formula3);
-        }
-        //update maximum likelihood
-        maxlike = new_maxlike;
-        ++itns;
-      } while (!stop_em_init);
+        return false;
+      }
+      if (!fitGumbelGaussEM_(x_scores, plot_file, good_fit))
+      {
+        return false;
+      }
 
       //-------------------------------------------------------------
       // Finished fitting
@@ -327,8 +286,172 @@ namespace OpenMS
       //-------------------------------------------------------------
       // Estimate Parameters - EM algorithm
       //-------------------------------------------------------------
-      bool stop_em_init = false;
       bool good_fit = true;
+      TextFile* plot_file = output_plots ? &file : nullptr;
+      vector<double> subsample = sampleQuantiles_(x_scores, (Int)param_.getValue("max_fit_points"));
+      if (!subsample.empty() && !fitGaussGaussEM_(subsample, plot_file, good_fit))
+      {
+        return false;
+      }
+      if (!fitGaussGaussEM_(x_scores, plot_file, good_fit))
+      {
+        return false;
+      }
+
+      //-------------------------------------------------------------
+      // Finished fitting
+      //-------------------------------------------------------------
+      if (param_.getValue("incorrectly_assigned") == "Gumbel")
+      {
+        max_incorrectly_ = getGumbel_(incorrectly_assigned_fit_param_.x0, incorrectly_assigned_fit_param_);
+      }
+      else
+      {
+        max_incorrectly_ = incorrectly_assigned_fit_param_.eval(incorrectly_assigned_fit_param_.x0);
+      }
+      max_correctly_ = correctly_assigned_fit_param_.eval(correctly_assigned_fit_param_.x0);
+
+      if (output_plots)
+      {
+        String formula1 = ((this)->*(getNegativeGnuplotFormula_))(incorrectly_assigned_fit_param_) + "*" + String(negative_prior_); //String(incorrectly_assigned_fit_param_.A) +" * exp(-(x - " + String(incorrectly_assigned_fit_param_.x0) + ") ** 2 / 2 / (" + String(incorrectly_assigned_fit_param_.sigma) + ") ** 2)"+ "*" + String(negative_prior_);
+        String formula2 = ((this)->*(getPositiveGnuplotFormula_))(correctly_assigned_fit_param_) + "* (1 - " + String(negative_prior_) + ")"; // String(correctly_assigned_fit_param_.A) +" * exp(-(x - " + String(correctly_assigned_fit_param_.x0) + ") ** 2 / 2 / (" + String(correctly_assigned_fit_param_.sigma) + ") ** 2)"+ "* (1 - " + String(negative_prior_) + ")";
+        String formula3 = getBothGnuplotFormula(incorrectly_assigned_fit_param_, correctly_assigned_fit_param_);
+        // important: use single quotes for paths, since otherwise backslashes will not be accepted on Windows!
+        file.addLine("plot '" + (String)param_.getValue("out_plot") + "_scores.txt' with boxes, " + formula1 + " , " + formula2 + " , " + formula3);
+        file.store((String)param_.getValue("out_plot"));
+        tryGnuplot((String)param_.getValue("out_plot"));
+      }
+      return good_fit;
+    }
+
+    bool PosteriorErrorProbabilityModel::fit(std::vector<double>& search_engine_scores, vector<double>& probabilities, const String& outlier_handling)
+    {
+      bool return_value = fit(search_engine_scores, outlier_handling);
+
+      if (!return_value) return false;
+
+      probabilities.resize(search_engine_scores.size());
+#pragma omp parallel for schedule(static) if (search_engine_scores.size() > EM_BLOCK_SIZE)
+      for (SignedSize i = 0; i < (SignedSize)search_engine_scores.size(); ++i)
+      {
+        probabilities[i] = computeProbability(search_engine_scores[i]);
+      }
+
+      return true;
+    }
+
+    vector<double> PosteriorErrorProbabilityModel::sampleQuantiles_(const vector<double>& sorted_scores, Size n)
+    {
+      vector<double> quantiles;
+      if (n == 0 || sorted_scores.size() <= n) { return quantiles; }
+
+      quantiles.reserve(n);
+      const double step = double(sorted_scores.size()) / n;
+      for (Size k = 0; k < n; ++k)
+      {
+        quantiles.push_back(sorted_scores[Size((k + 0.5) * step)]);
+      }
+      return quantiles;
+    }
+
+    bool PosteriorErrorProbabilityModel::fitGumbelGaussEM_(const vector<double>& x_scores, TextFile* plot_file, bool& good_fit)
+    {
+      good_fit = true;
+      bool stop_em_init = false;
+      Int max_itns = param_.getValue("max_nr_iterations");
+      int delta = param_.getValue("neg_log_delta");
+      int itns = 0;
+
+      vector<double> incorrect_log_density, correct_log_density;
+      fillLogDensitiesGumbel(x_scores, incorrect_log_density, correct_log_density);
+      vector<double> incorrect_posteriors;
+      double maxlike = computeLLAndIncorrectPosteriorsFromLogDensities(incorrect_log_density, correct_log_density, incorrect_posteriors);
+      double sumIncorrectPosteriors = Math::sum(incorrect_posteriors.begin(),incorrect_posteriors.end());
+      double sumCorrectPosteriors = x_scores.size() - sumIncorrectPosteriors;
+
+      OpenMS::Math::GumbelMaxLikelihoodFitter gmlf{incorrectly_assigned_fit_gumbel_param_};
+
+      do
+      {
+        //-------------------------------------------------------------
+        // E-STEP (gauss)
+        double newGaussMean = blockwiseSums<1>(x_scores.size(), [&](Size i, std::array<double, 1>& sums)
+        {
+          sums[0] += (1. - incorrect_posteriors[i]) * x_scores[i];
+        })[0];
+        newGaussMean /= sumCorrectPosteriors;
+
+        double newGaussSigma = blockwiseSums<1>(x_scores.size(), [&](Size i, std::array<double, 1>& sums)
+        {
+          const double diff = x_scores[i] - newGaussMean;
+          sums[0] += (1. - incorrect_posteriors[i]) * diff * diff;
+        })[0];
+        newGaussSigma = sqrt(newGaussSigma/sumCorrectPosteriors);
+
+        GumbelMaxLikelihoodFitter::GumbelDistributionFitResult newGumbelParams = gmlf.fitWeighted(x_scores, incorrect_posteriors);
+
+        if (newGumbelParams.b <= 0 || std::isnan(newGumbelParams.b))
+        {
+          OPENMS_LOG_WARN << "Warning: encountered impossible standard deviations. Aborting fit." << std::endl;
+          break;
+        }
+
+        // update parameters
+        correctly_assigned_fit_param_.x0 = newGaussMean;
+        correctly_assigned_fit_param_.sigma = newGaussSigma;
+        correctly_assigned_fit_param_.A = 1 / sqrt(2 * Constants::PI * pow(newGaussSigma, 2));
+
+        incorrectly_assigned_fit_gumbel_param_ = newGumbelParams;
+
+
+        // compute new prior probabilities negative peptides
+        fillLogDensitiesGumbel(x_scores, incorrect_log_density, correct_log_density);
+        double new_maxlike = computeLLAndIncorrectPosteriorsFromLogDensities(incorrect_log_density, correct_log_density, incorrect_posteriors);
+        sumIncorrectPosteriors = Math::sum(incorrect_posteriors.begin(),incorrect_posteriors.end());
+        sumCorrectPosteriors = x_scores.size() - sumIncorrectPosteriors;
+        negative_prior_ = sumIncorrectPosteriors / x_scores.size();
+
+        if (std::isnan(new_maxlike - maxlike))
+        {
+          OPENMS_LOG_WARN << "Numerical instabilities. Aborting." << endl;
+          return false;
+        }
+
+        // check termination criterium
+        if ((new_maxlike - maxlike) < pow(10.0, -delta) || itns >= max_itns)
+        {
+          if (itns >= max_itns)
+          {
+            OPENMS_LOG_WARN << "Number of iterations exceeded. Convergence criterion not met. Last log likelihood increase: " << (new_maxlike - maxlike) << endl;
+            OPENMS_LOG_WARN << "Algorithm returns probabilities for suboptimal fit. You might want to try raising the max. number of iterations and have a look at the distribution." << endl;
+          }
+          stop_em_init = true;
+          good_fit = true;
+        }
+        else if (new_maxlike < maxlike)
+          {
+            OPENMS_LOG_WARN << "Log Likelihood of fit decreased: " << (new_maxlike - maxlike) << ". Abort fitting. Please check"
+                                                                                                 " the gnuplot scripts and adapt search engine settings or outlier settings of IDPEP."<< endl;
+            stop_em_init = true;
+            good_fit = false;
+          }
+
+        if (plot_file != nullptr)
+        {
+          addPlotLine_(*plot_file);
+        }
+        //update maximum likelihood
+        maxlike = new_maxlike;
+        ++itns;
+      } while (!stop_em_init);
+
+      return true;
+    }
+
+    bool PosteriorErrorProbabilityModel::fitGaussGaussEM_(const vector<double>& x_scores, TextFile* plot_file, bool& good_fit)
+    {
+      bool stop_em_init = false;
+      good_fit = true;
       Int max_itns = param_.getValue("max_nr_iterations");
       int delta = param_.getValue("neg_log_delta");
       int itns = 0;
@@ -402,56 +525,26 @@ namespace OpenMS
           good_fit = false;
         }
 
-        if (output_plots)
+        if (plot_file != nullptr)
         {
-          String formula1, formula2, formula3;
-          formula1 = ((this)->*(getNegativeGnuplotFormula_))(incorrectly_assigned_fit_param_) + "* " + String(negative_prior_); //String(incorrectly_assigned_fit_param_.A) +" * exp(-(x - " + String(incorrectly_assigned_fit_param_.x0) + ") ** 2 / 2 / (" + String(incorrectly_assigned_fit_param_.sigma) + ") ** 2)"+ "*" + String(negative_prior_);
-          formula2 = ((this)->*(getPositiveGnuplotFormula_))(correctly_assigned_fit_param_) + "* (1 - " + String(negative_prior_) + ")"; //String(correctly_assigned_fit_param_.A) +" * exp(-(x - " + String(correctly_assigned_fit_param_.x0) + ") ** 2 / 2 / (" + String(correctly_assigned_fit_param_.sigma) + ") ** 2)"+ "* (1 - " + String(negative_prior_) + ")";
-          formula3 = getBothGnuplotFormula(incorrectly_assigned_fit_param_, correctly_assigned_fit_param_);
-          // important: use single quotes for paths, since otherwise backslashes will not be accepted on Windows!
-          file.addLine("plot '" + (String)param_.getValue("out_plot") + "_scores.txt' with boxes, " + formula1 + " , " + formula2 + " , " + formula3);
+          addPlotLine_(*plot_file);
         }
         //update maximum likelihood
         maxlike = new_maxlike;
         ++itns;
       } while (!stop_em_init);
 
-      //-------------------------------------------------------------
-      // Finished fitting
-      //-------------------------------------------------------------
-      if (param_.getValue("incorrectly_assigned") == "Gumbel")
-      {
-        max_incorrectly_ = getGumbel_(incorrectly_assigned_fit_param_.x0, incorrectly_assigned_fit_param_);
-      }
-      else
-      {
-        max_incorrectly_ = incorrectly_assigned_fit_param_.eval(incorrectly_assigned_fit_param_.x0);
-      }
-      max_correctly_ = correctly_assigned_fit_param_.eval(correctly_assigned_fit_param_.x0);
-
-      if (output_plots)
-      {
-        String formula1 = ((this)->*(getNegativeGnuplotFormula_))(incorrectly_assigned_fit_param_) + "*" + String(negative_prior_); //String(incorrectly_assigned_fit_param_.A) +" * exp(-(x - " + String(incorrectly_assigned_fit_param_.x0) + ") ** 2 / 2 / (" + String(incorrectly_assigned_fit_param_.sigma) + ") ** 2)"+ "*" + String(negative_prior_);
-        String formula2 = ((this)->*(getPositiveGnuplotFormula_))(correctly_assigned_fit_param_) + "* (1 - " + String(negative_prior_) + ")"; // String(correctly_assigned_fit_param_.A) +" * exp(-(x - " + String(correctly_assigned_fit_param_.x0) + ") ** 2 / 2 / (" + String(correctly_assigned_fit_param_.sigma) + ") ** 2)"+ "* (1 - " + String(negative_prior_) + ")";
-        String formula3 = getBothGnuplotFormula(incorrectly_assigned_fit_param_, correctly_assigned_fit_param_);
-        // important: use single quotes for paths, since otherwise backslashes will not be accepted on Windows!
-        file.addLine("plot '" + (String)param_.getValue("out_plot") + "_scores.txt' with boxes, " + formula1 + " , " + formula2 + " , " + formula3);
-        file.store((String)param_.getValue("out_plot"));
-        tryGnuplot((String)param_.getValue("out_plot"));
-      }
-      return good_fit;
+      return true;
     }
 
-    bool PosteriorErrorProbabilityModel::fit(std::vector<double>& search_engine_scores, vector<double>& probabilities, const String& outlier_handling)
+    void PosteriorErrorProbabilityModel::addPlotLine_(TextFile& file) const
     {
-      bool return_value = fit(search_engine_scores, outlier_handling);
-
-      if (!return_value) return false;
-
-      probabilities = std::vector<double>(search_engine_scores);
-      for (double & p : probabilities) { p = computeProbability(p); }
-
-      return true;
+      String formula1, formula2, formula3;
+      formula1 = ((this)->*(getNegativeGnuplotFormula_))(incorrectly_assigned_fit_param_) + "* " + String(negative_prior_); //String(incorrectly_assigned_fit_param_.A) +" * exp(-(x - " + String(incorrectly_assigned_fit_param_.x0) + ") ** 2 / 2 / (" + String(incorrectly_assigned_fit_param_.sigma) + ") ** 2)"+ "*" + String(negative_prior_);
+      formula2 = ((this)->*(getPositiveGnuplotFormula_))(correctly_assigned_fit_param_) + "* (1 - " + String(negative_prior_) + ")"; //String(correctly_assigned_fit_param_.A) +" * exp(-(x - " + String(correctly_assigned_fit_param_.x0) + ") ** 2 / 2 / (" + String(correctly_assigned_fit_param_.sigma) + ") ** 2)"+ "* (1 - " + String(negative_prior_) + ")";
+      formula3 = getBothGnuplotFormula(incorrectly_assigned_fit_param_, correctly_assigned_fit_param_);
+      // important: use single quotes for paths, since otherwise backslashes will not be accepted on Windows!
+      file.addLine("plot '" + (String)param_.getValue("out_plot") + "_scores.txt' with boxes, " + formula1 + " , " + formula2 + " , " + formula3);
     }
 
     void PosteriorErrorProbabilityModel::fillDensities(const vector<double>& x_scores, vector<double>& incorrect_density, vector<double>& correct_density)
@@ -461,15 +554,12 @@ namespace OpenMS
         incorrect_density.resize(x_scores.size());
         correct_density.resize(x_scores.size());
       }
-      auto incorrect(incorrect_density.begin());
-      auto correct(correct_density.begin());
-      for (double const & score : x_scores)
+#pragma omp parallel for schedule(static) if (x_scores.size() > EM_BLOCK_SIZE)
+      for (SignedSize i = 0; i < (SignedSize)x_scores.size(); ++i)
       {
         // TODO: incorrect is currently filled with gauss as fitting gumble is not supported
-        *incorrect = incorrectly_assigned_fit_param_.eval(score);
-        *correct = correctly_assigned_fit_param_.eval(score);
-        ++incorrect;
-        ++correct;
+        incorrect_density[i] = incorrectly_assigned_fit_param_.eval(x_scores[i]);
+        correct_density[i] = correctly_assigned_fit_param_.eval(x_scores[i]);
       }
     }
 
@@ -480,14 +570,22 @@ namespace OpenMS
         incorrect_density.resize(x_scores.size());
         correct_density.resize(x_scores.size());
       }
-      auto incorrect(incorrect_density.begin());
-      auto correct(correct_density.begin());
-      for (double const & score : x_scores)
+      // same as GumbelDistributionFitResult::log_eval_no_normalize and GaussFitResult::log_eval_no_normalize,
+      // but with the logarithms of the scale parameters hoisted out of the loop
+      const double gumbel_a = incorrectly_assigned_fit_gumbel_param_.a;
+      const double gumbel_b = incorrectly_assigned_fit_gumbel_param_.b;
+      const double gumbel_log_b = log(gumbel_b);
+      const double gauss_x0 = correctly_assigned_fit_param_.x0;
+      const double gauss_sigma = correctly_assigned_fit_param_.sigma;
+      const double gauss_log_sigma = log(gauss_sigma);
+      const double half_log_two_pi = 0.5 * log(2.0 * Constants::PI);
+#pragma omp parallel for schedule(static) if (x_scores.size() > EM_BLOCK_SIZE)
+      for (SignedSize i = 0; i < (SignedSize)x_scores.size(); ++i)
       {
-        *incorrect = incorrectly_assigned_fit_gumbel_param_.log_eval_no_normalize(score);
-        *correct = correctly_assigned_fit_param_.log_eval_no_normalize(score);
-        ++incorrect;
-        ++correct;
+        const double gumbel_diff = (x_scores[i] - gumbel_a) / gumbel_b;
+        incorrect_density[i] = -gumbel_log_b - gumbel_diff - exp(-gumbel_diff);
+        const double gauss_diff = (x_scores[i] - gauss_x0) / gauss_sigma;
+        correct_density[i] = -gauss_log_sigma - half_log_two_pi - 0.5 * gauss_diff * gauss_diff;
       }
     }
 
@@ -498,47 +596,48 @@ namespace OpenMS
         incorrect_density.resize(x_scores.size());
         correct_density.resize(x_scores.size());
       }
-      auto incorrect(incorrect_density.begin());
-      auto correct(correct_density.begin());
-      for (double const & score : x_scores)
+      // same as GaussFitResult::log_eval_no_normalize, but with the logarithms of the standard deviations hoisted out of the loop
+      // TODO: incorrect is currently filled with gauss as fitting gumble is not supported
+      const double incorrect_x0 = incorrectly_assigned_fit_param_.x0;
+      const double incorrect_sigma = incorrectly_assigned_fit_param_.sigma;
+      const double incorrect_log_sigma = log(incorrect_sigma);
+      const double correct_x0 = correctly_assigned_fit_param_.x0;
+      const double correct_sigma = correctly_assigned_fit_param_.sigma;
+      const double correct_log_sigma = log(correct_sigma);
+      const double half_log_two_pi = 0.5 * log(2.0 * Constants::PI);
+#pragma omp parallel for schedule(static) if (x_scores.size() > EM_BLOCK_SIZE)
+      for (SignedSize i = 0; i < (SignedSize)x_scores.size(); ++i)
       {
-        // TODO: incorrect is currently filled with gauss as fitting gumble is not supported
-        *incorrect = incorrectly_assigned_fit_param_.log_eval_no_normalize(score);
-        *correct = correctly_assigned_fit_param_.log_eval_no_normalize(score);
-        ++incorrect;
-        ++correct;
+        const double incorrect_diff = (x_scores[i] - incorrect_x0) / incorrect_sigma;
+        incorrect_density[i] = -incorrect_log_sigma - half_log_two_pi - 0.5 * incorrect_diff * incorrect_diff;
+        const double correct_diff = (x_scores[i] - correct_x0) / correct_sigma;
+        correct_density[i] = -correct_log_sigma - half_log_two_pi - 0.5 * correct_diff * correct_diff;
       }
     }
 
     double PosteriorErrorProbabilityModel::computeLogLikelihood(const vector<double>& incorrect_density, const vector<double>& correct_density)
     {
-      double maxlike(0);
-      auto incorrect = incorrect_density.cbegin();
-      for (auto correct = correct_density.cbegin(); correct < correct_density.cend(); ++correct, ++incorrect)
+      return blockwiseSums<1>(correct_density.size(), [&](Size i, std::array<double, 1>& sums)
       {
-        maxlike += log10(negative_prior_ * (*incorrect) + (1 - negative_prior_) * (*correct));
-      }
-      return maxlike;
+        sums[0] += log10(negative_prior_ * incorrect_density[i] + (1 - negative_prior_) * correct_density[i]);
+      })[0];
     }
 
     double PosteriorErrorProbabilityModel::computeLLAndIncorrectPosteriorsFromLogDensities(
         const vector<double>& incorrect_log_density, const vector<double>& correct_log_density,
         vector<double>& incorrect_posterior)
     {
-      double loglikelihood = 0.0;
-      double log_prior_pos = log(1. - negative_prior_);
-      double log_prior_neg = log(negative_prior_);
-      auto incorrect = incorrect_log_density.cbegin();
+      const double log_prior_pos = log(1. - negative_prior_);
+      const double log_prior_neg = log(negative_prior_);
       if (incorrect_posterior.size() != incorrect_log_density.size())
       {
         incorrect_posterior.resize(incorrect_log_density.size());
       }
-      auto incorrect_posterior_it = incorrect_posterior.begin();
 
-      for (auto correct = correct_log_density.cbegin(); correct < correct_log_density.cend(); ++correct, ++incorrect, ++incorrect_posterior_it)
+      return blockwiseSums<1>(correct_log_density.size(), [&](Size i, std::array<double, 1>& sums)
       {
-        double log_resp_correct = log_prior_pos + *correct;
-        double log_resp_incorrect = log_prior_neg + *incorrect;
+        double log_resp_correct = log_prior_pos + correct_log_density[i];
+        double log_resp_incorrect = log_prior_neg + incorrect_log_density[i];
         double max_log_resp = std::max(log_resp_correct,log_resp_incorrect);
         log_resp_correct -= max_log_resp;
         log_resp_incorrect -= max_log_resp;
@@ -546,24 +645,19 @@ namespace OpenMS
         double resp_incorrect = exp(log_resp_incorrect);
         double sum = resp_correct + resp_incorrect;
         // normalize
-        *incorrect_posterior_it = resp_incorrect / sum; //TODO can we somehow stay in log space (i.e. fill as log posteriors?)
-        loglikelihood += max_log_resp + log(sum);
-      }
-      return loglikelihood;
+        incorrect_posterior[i] = resp_incorrect / sum; //TODO can we somehow stay in log space (i.e. fill as log posteriors?)
+        sums[0] += max_log_resp + log(sum);
+      })[0];
     }
 
     std::pair<double,double> PosteriorErrorProbabilityModel::pos_neg_mean_weighted_posteriors(const vector<double>& x_scores, const vector<double>& incorrect_posteriors)
     {
-      double pos_x0(0);
-      double neg_x0(0);
-      auto the_x = x_scores.cbegin();
-
-      for (auto incorrect = incorrect_posteriors.cbegin(); incorrect < incorrect_posteriors.end(); ++incorrect, ++the_x)
+      std::array<double, 2> x0 = blockwiseSums<2>(incorrect_posteriors.size(), [&](Size i, std::array<double, 2>& sums)
       {
-        pos_x0 += (1. - *incorrect) * (*the_x);
-        neg_x0 += (*incorrect) * (*the_x);
-      }
-      return {pos_x0,neg_x0};
+        sums[0] += (1. - incorrect_posteriors[i]) * x_scores[i];
+        sums[1] += incorrect_posteriors[i] * x_scores[i];
+      });
+      return {x0[0], x0[1]};
     }
 
 
@@ -573,16 +667,14 @@ namespace OpenMS
         const vector<double>& incorrect_posteriors,
         const std::pair<double,double>& pos_neg_mean)
     {
-      double pos_sigma(0);
-      double neg_sigma(0);
-      auto the_x = x_scores.cbegin();
-
-      for (auto incorrect = incorrect_posteriors.cbegin(); incorrect < incorrect_posteriors.end(); ++incorrect, ++the_x)
+      std::array<double, 2> sigma = blockwiseSums<2>(incorrect_posteriors.size(), [&](Size i, std::array<double, 2>& sums)
       {
-        pos_sigma += (1. - *incorrect) * pow((*the_x) - pos_neg_mean.first, 2);
-        neg_sigma += (*incorrect) * pow((*the_x) - pos_neg_mean.second, 2);
-      }
-      return {pos_sigma, neg_sigma};
+        const double pos_diff = x_scores[i] - pos_neg_mean.first;
+        const double neg_diff = x_scores[i] - pos_neg_mean.second;
+        sums[0] += (1. - incorrect_posteriors[i]) * pos_diff * pos_diff;
+        sums[1] += incorrect_posteriors[i] * neg_diff * neg_diff;
+      });
+      return {sigma[0], sigma[1]};
     }
 
     double PosteriorErrorProbabilityModel::computeProbability(double score) const
@@ -44,16 +44,43 @@
 #include <OpenMS/MATH/MISC/MathFunctions.h>
 #include <OpenMS/CHEMISTRY/Element.h>
 #include <OpenMS/CHEMISTRY/ElementDB.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/AveragineIsotopeTable.h>
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopeDistribution.h>
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
 
 #include <QtCore/QDir>
 
+#include <atomic>
+#include <memory>
+
 #ifdef _OPENMP
 #endif
 
 namespace OpenMS
 {
+  namespace
+  {
+    /// Marks a seed as done when going out of scope (also on 'continue') and then calls @p on_done
+    template <typename Function>
+    struct SeedDoneGuard
+    {
+      SeedDoneGuard(std::atomic<bool>& done, Function& on_done) :
+        done_(done),
+        on_done_(on_done)
+      {
+      }
+
+      ~SeedDoneGuard()
+      {
+        done_.store(true, std::memory_order_release);
+        on_done_();
+      }
+
+      std::atomic<bool>& done_;
+      Function& on_done_;
+    };
+  }
+
   FeatureFinderAlgorithmPicked::FeatureFinderAlgorithmPicked() :
     FeatureFinderAlgorithm(),
     map_(),
@@ -170,6 +197,8 @@ namespace OpenMS
     UInt max_iterations = param_.getValue("fit:max_iterations");
 
     Size max_isotopes = 20;
+    // precomputed averagine patterns can only be used with the natural isotope abundances
+    bool natural_abundances = true;
 
     // check if non-natural isotopic abundances are set. If so modify
     double abundance_12C = param_.getValue("isotopic_pattern:abundance_12C");
@@ -181,6 +210,7 @@ namespace OpenMS
     if (param_.getValue("isotopic_pattern:abundance_12C") != defaults_.getValue("isotopic_pattern:abundance_12C"))
     {
       max_isotopes += 1000; // Why?
+      natural_abundances = false;
       IsotopeDistribution isotopes;
       isotopes.insert(12, abundance_12C / 100.0);
       isotopes.insert(13, 1.0 - (abundance_12C / 100.0));
@@ -193,6 +223,7 @@ namespace OpenMS
     if (param_.getValue("isotopic_pattern:abundance_14N") != defaults_.getValue("isotopic_pattern:abundance_14N"))
     {
       max_isotopes += 1000; // Why?
+      natural_abundances = false;
       IsotopeDistribution isotopes;
       isotopes.insert(14, abundance_14N / 100.0);
       isotopes.insert(15, 1.0 - (abundance_14N / 100.0));
@@ -382,23 +413,43 @@ namespace OpenMS
       //reserve enough space
       isotope_distributions_.resize(num_isotopes);
 
+      //with natural isotope abundances, the window centers are grid masses of a
+      //shared table with half the window width as resolution
+      const AveragineIsotopeTable* table = nullptr;
+      if (natural_abundances)
+      {
+        table = &AveragineIsotopeTable::getTable(AveragineIsotopeTable::PEPTIDE,
+          0.5 * mass_window_width_, 0.5 * mass_window_width_ + (num_isotopes - 1) * mass_window_width_, max_isotopes);
+      }
+      std::vector<double> d;
+
       //calculate distribution if necessary
       for (Size index = 0; index < num_isotopes; ++index)
       {
         //if(debug_) log_ << "Calculating iso dist for mass: " << 0.5*mass_window_width_ + index * mass_window_width_ << std::endl;
-        CoarseIsotopePatternGenerator solver(max_isotopes);
-        auto d = solver.estimateFromPeptideWeight(0.5 * mass_window_width_ + index * mass_window_width_);
-        //trim left and right. And store the number of isotopes on the left, to reconstruct the monoisotopic peak
-        Size size_before = d.size();
-        d.trimLeft(intensity_percentage_optional_);
-        isotope_distributions_[index].trimmed_left = size_before - d.size();
-        d.trimRight(intensity_percentage_optional_);
-
-        for (auto& peak : d)
+        const double mass = 0.5 * mass_window_width_ + index * mass_window_width_;
+        if (table != nullptr)
         {
-          isotope_distributions_[index].intensity.push_back(peak.getIntensity());
-          //if(debug_) log_ << " - " << it->second << std::endl;
+          table->getIntensities(mass, max_isotopes, d);
         }
+        else
+        {
+          CoarseIsotopePatternGenerator solver(max_isotopes);
+          d.clear();
+          for (const auto& peak : solver.estimateFromPeptideWeight(mass))
+          {
+            d.push_back(peak.getIntensity());
+          }
+        }
+        //trim left and right. And store the number of isotopes on the left, to reconstruct the monoisotopic peak
+        Size left = 0;
+        while (left < d.size() && d[left] < intensity_percentage_optional_) ++left;
+        if (left == d.size()) left = 0; // nothing above the cutoff: nothing is trimmed on the left
+        Size right = d.size();
+        while (right > left && d[right - 1] < intensity_percentage_optional_) --right;
+        isotope_distributions_[index].trimmed_left = left;
+
+        isotope_distributions_[index].intensity.assign(d.begin() + left, d.begin() + right);
 
         //determine the number of optional peaks at the beginning/end
         Size begin = 0;
@@ -593,22 +644,89 @@ namespace OpenMS
       //------------------------------------------------------------------
 
       // We do not want to store features whose seeds lie within other
-      // features with higher intensity. We thus store this information in
-      // the map seeds_in_features which contains for each seed i a vector
-      // of other seeds that are contained in the corresponding feature i.
+      // features with higher intensity. We thus store for each seed i a
+      // vector of other seeds that are contained in the corresponding
+      // feature i (seeds_in_features).
       //
-      // The features are stored in an temporary feature map until it is
-      // decided whether they are contained within a seed of higher
-      // intensity.
-      std::map<Size, std::vector<Size> > seeds_in_features;
-      typedef std::map<Size, Feature> FeatureMapType;
-      FeatureMapType tmp_feature_map;
+      // Seeds are extended in order of decreasing intensity. As soon as the
+      // next seeds in this order are done, it is decided whether their
+      // features are accepted, i.e. whether the seed is not contained in an
+      // accepted feature of higher intensity (resolve_seeds). The seeds
+      // within accepted features are claimed and skipped instead of being
+      // extended redundantly. Results are stored in per-seed slots and the
+      // seed states are atomic, so no thread ever waits for another one.
+      const Size seed_count = seeds.size();
+      std::vector<std::unique_ptr<Feature> > seed_features(seed_count);
+      std::vector<std::vector<Size> > seeds_in_features(seed_count);
+      std::vector<std::atomic<bool> > seed_done(seed_count); // seed extended (or skipped)
+      std::vector<std::atomic<bool> > seed_claimed(seed_count); // seed lies in an accepted feature
+      std::vector<Feature> accepted_features;
+      std::atomic<bool> resolving(false);
+      std::atomic<Size> next_to_resolve(0);
+
+      // accept features in seed order, as far as the seeds are done (only one thread at a time)
+      auto resolve_seeds = [&]()
+      {
+        Size seed_nr = next_to_resolve.load(std::memory_order_relaxed);
+        for (; seed_nr < seed_count && seed_done[seed_nr].load(std::memory_order_acquire); ++seed_nr)
+        {
+          std::unique_ptr<Feature> f = std::move(seed_features[seed_nr]);
+          if (!f || seed_claimed[seed_nr].load(std::memory_order_relaxed))
+          {
+            continue;
+          }
+          ++feature_candidates;
+
+          //re-set label
+          f->setMetaValue(3, feature_nr_global);
+          ++feature_nr_global;
+          accepted_features.push_back(std::move(*f));
+
+          for (Size k : seeds_in_features[seed_nr])
+          {
+            seed_claimed[k].store(true, std::memory_order_relaxed);
+          }
+        }
+        next_to_resolve.store(seed_nr, std::memory_order_relaxed);
+      };
+      auto try_resolve_seeds = [&]()
+      {
+        // if another thread is resolving, just carry on; but re-check afterwards,
+        // since seeds finished during our attempt might not have been seen
+        while (!resolving.exchange(true, std::memory_order_acquire))
+        {
+          resolve_seeds();
+          resolving.store(false, std::memory_order_release);
+          Size next = next_to_resolve.load(std::memory_order_relaxed);
+          if (next >= seed_count || !seed_done[next].load(std::memory_order_acquire))
+          {
+            break;
+          }
+        }
+      };
+
       int gl_progress = 0;
       ff_->startProgress(0, seeds.size(), String("Extending seeds for charge ") + String(c));
 
-#pragma omp parallel for
+#pragma omp parallel
+      {
+      // the trace fitter is reused for all seeds of a thread
+      double egh_tau_init = 0.0;
+      std::unique_ptr<TraceFitter> fitter(chooseTraceFitter_(egh_tau_init));
+      fitter->setParameters(trace_fitter_params);
+
+#pragma omp for schedule(dynamic)
       for (SignedSize i = 0; i < (SignedSize)seeds.size(); ++i)
       {
+        // marks the seed as done (also when aborted via 'continue') and tries to resolve
+        SeedDoneGuard done_guard(seed_done[i], try_resolve_seeds);
+
+        // seed lies in an accepted feature of a more intense seed
+        if (seed_claimed[i].load(std::memory_order_relaxed))
+        {
+          continue;
+        }
+
         //------------------------------------------------------------------
         //Step 3.3.1:
         //Extend all mass traces
@@ -676,11 +794,7 @@ namespace OpenMS
 
         traces[traces.max_trace].updateMaximum();
 
-        // choose fitter
-        double egh_tau = 0.0;
-        TraceFitter* fitter = chooseTraceFitter_(egh_tau);
-
-        fitter->setParameters(trace_fitter_params);
+        double egh_tau = egh_tau_init;
         fitter->fit(traces);
 
 #if 0
@@ -707,7 +821,7 @@ namespace OpenMS
         //Crop feature according to RT fit (2.5*sigma) and remove badly fitting traces
         //------------------------------------------------------------------
         MassTraces new_traces;
-        cropFeature_(fitter, traces, new_traces);
+        cropFeature_(fitter.get(), traces, new_traces);
 
         //------------------------------------------------------------------
         //Step 3.3.4:
@@ -719,14 +833,14 @@ namespace OpenMS
         double correlation = 0.0;
         double final_score = 0.0;
 
-        bool feature_ok = checkFeatureQuality_(fitter, new_traces, seed_mz, min_feature_score, error_msg, fit_score, correlation, final_score);
+        bool feature_ok = checkFeatureQuality_(fitter.get(), new_traces, seed_mz, min_feature_score, error_msg, fit_score, correlation, final_score);
 
         {
           //write debug output of feature
           if (debug_)
           {
 #pragma omp critical (FeatureFinderAlgorithmPicked_DEBUG)
-            writeFeatureDebugInfo_(fitter, traces, new_traces, feature_ok, error_msg, final_score, plot_nr, peak);
+            writeFeatureDebugInfo_(fitter.get(), traces, new_traces, feature_ok, error_msg, final_score, plot_nr, peak);
           }
         }
 
@@ -737,7 +851,7 @@ namespace OpenMS
           abort_(seeds[i], error_msg);
           continue;
         }
-        traces = new_traces;
+        std::swap(traces, new_traces);
 
         //------------------------------------------------------------------
         //Step 3.3.5:
@@ -756,10 +870,10 @@ namespace OpenMS
         // Extract some of the model parameters.
         if (egh_tau != 0.0)
         {
-          egh_tau = (static_cast<EGHTraceFitter*>(fitter))->getTau();
+          egh_tau = (static_cast<EGHTraceFitter*>(fitter.get()))->getTau();
           f.setMetaValue("EGH_tau", egh_tau);
-          f.setMetaValue("EGH_height", (static_cast<EGHTraceFitter*>(fitter))->getHeight());
-          f.setMetaValue("EGH_sigma", (static_cast<EGHTraceFitter*>(fitter))->getSigma());
+          f.setMetaValue("EGH_height", (static_cast<EGHTraceFitter*>(fitter.get()))->getHeight());
+          f.setMetaValue("EGH_sigma", (static_cast<EGHTraceFitter*>(fitter.get()))->getSigma());
         }
 
         // Calculate the mass of the feature: maximum, average, monoisotopic
@@ -794,65 +908,37 @@ namespace OpenMS
         // - as we scaled the isotope distribution to
         f.setIntensity(fitter->getArea() / getIsotopeDistribution_(f.getMZ()).max);
 
-        // we do not need the fitter anymore
-        delete fitter;
-
         //add convex hulls of mass traces
         for (Size j = 0; j < traces.size(); ++j)
         {
           f.getConvexHulls().push_back(traces[j].getConvexhull());
         }
 
-#pragma omp critical (FeatureFinderAlgorithmPicked_TMPFEATUREMAP)
-        {
-          tmp_feature_map[i] = f;
-        }
-
         //----------------------------------------------------------------
         //Remember all seeds that lie inside the convex hull of the new feature
         DBoundingBox<2> bb = f.getConvexHull().getBoundingBox();
+        std::vector<Size>& contained_seeds = seeds_in_features[i];
         for (Size j = i + 1; j < seeds.size(); ++j)
         {
           double rt = map_[seeds[j].spectrum].getRT();
           double mz = map_[seeds[j].spectrum][seeds[j].peak].getMZ();
           if (bb.encloses(rt, mz) && f.encloses(rt, mz))
           {
-#pragma omp critical (FeatureFinderAlgorithmPicked_SEEDSINFEATURES)
-            {
-              seeds_in_features[i].push_back(j);
-            }
+            contained_seeds.push_back(j);
           }
         }
+
+        seed_features[i].reset(new Feature(std::move(f)));
       } // end of OPENMP over seeds
+      }
 
-      // Here we have to evaluate which seeds are already contained in
-      // features of seeds with higher intensities. Only if the seed is not
-      // used in any feature with higher intensity, we can add it to the
-      // features_ list.
-      std::vector<Size> seeds_contained;
-      for (auto& f : tmp_feature_map)
+      // Resolve the seeds that were not resolved during the extension. Only
+      // if a seed is not used in any feature with higher intensity, its
+      // feature is added to the features_ list.
+      resolve_seeds();
+      for (Feature& f : accepted_features)
       {
-        Size seed_nr = f.first;
-        bool is_used = false;
-        for (Size i : seeds_contained)
-        {
-          if (seed_nr == i) { is_used = true; break; }
-        }
-        if (!is_used)
-        {
-          ++feature_candidates;
-
-          //re-set label
-          f.second.setMetaValue(3, feature_nr_global);
-          ++feature_nr_global;
-          features_->push_back(f.second);
-
-          std::vector<Size> curr_seed = seeds_in_features[seed_nr];
-          for (Size k : curr_seed)
-          {
-            seeds_contained.push_back(k);
-          }
-        }
+        features_->push_back(std::move(f));
       }
 
       IF_MASTERTHREAD ff_->endProgress();
@@ -1037,9 +1123,12 @@ namespace OpenMS
   /// Writes the abort reason to the log file and counts occurrences for each reason
   void FeatureFinderAlgorithmPicked::abort_(const Seed& seed, const String& reason)
   {
-    if (debug_) log_ << "Abort: " << reason << std::endl;
-    aborts_[reason]++;
-    if (debug_) abort_reasons_[seed] = reason;
+#pragma omp critical (FeatureFinderAlgorithmPicked_ABORT)
+    {
+      if (debug_) log_ << "Abort: " << reason << std::endl;
+      aborts_[reason]++;
+      if (debug_) abort_reasons_[seed] = reason;
+    }
   }
 
   double FeatureFinderAlgorithmPicked::intersection_(const Feature& f1, const Feature& f2) const
@@ -176,17 +176,37 @@ namespace OpenMS
     unsigned progress = 0;
     startProgress(0, filter_results.size(), "clustering filtered LC-MS data");
       
-    std::vector<std::map<int, GridBasedCluster> > cluster_results;
+    std::vector<std::map<int, GridBasedCluster> > cluster_results(filter_results.size());
+    Size error_count(0);
+    String error_message;
 
-    // loop over patterns i.e. cluster each of the corresponding filter results
-    for (unsigned i = 0; i < filter_results.size(); ++i)
+    // loop over patterns i.e. cluster each of the corresponding filter results (independent of each other)
+#pragma omp parallel for schedule(dynamic)
+    for (SignedSize i = 0; i < (SignedSize)filter_results.size(); ++i)
     {
+      try
+      {
+        GridBasedClustering<MultiplexDistance> clustering(MultiplexDistance(rt_scaling_), filter_results[i].getMZ(), filter_results[i].getRT(), grid_spacing_mz_, grid_spacing_rt_);
+        clustering.cluster();
+        //clustering.extendClustersY();
+        cluster_results[i] = clustering.getResults();
+      }
+      catch (Exception::BaseException& e)
+      {
+#pragma omp critical (OpenMS_MultiplexClustering_cluster)
+        {
+          if (error_message.empty()) error_message = e.what();
+          ++error_count;
+        }
+      }
+
+#pragma omp critical (OpenMS_MultiplexClustering_progress)
       setProgress(++progress);
-        
-      GridBasedClustering<MultiplexDistance> clustering(MultiplexDistance(rt_scaling_), filter_results[i].getMZ(), filter_results[i].getRT(), grid_spacing_mz_, grid_spacing_rt_);
-      clustering.cluster();
-      //clustering.extendClustersY();
-      cluster_results.push_back(clustering.getResults());
+    }
+
+    if (error_count > 0)
+    {
+      throw Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Clustering failed for " + String(error_count) + " pattern(s): " + error_message);
     }
 
     endProgress();
@@ -36,8 +36,7 @@
 #include <OpenMS/KERNEL/BaseFeature.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/CONCEPT/Constants.h>
-#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopeDistribution.h>
-#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/AveragineIsotopeTable.h>
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/MultiplexFiltering.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/MultiplexIsotopicPeakPattern.h>
@@ -55,8 +54,18 @@ namespace OpenMS
   patterns_(patterns), isotopes_per_peptide_min_(isotopes_per_peptide_min), isotopes_per_peptide_max_(isotopes_per_peptide_max),
   intensity_cutoff_(intensity_cutoff), rt_band_(rt_band), mz_tolerance_(mz_tolerance), mz_tolerance_unit_in_ppm_(mz_tolerance_unit),
   peptide_similarity_(peptide_similarity), averagine_similarity_(averagine_similarity),
-  averagine_similarity_scaling_(averagine_similarity_scaling), averagine_type_(averagine_type)
+  averagine_similarity_scaling_(averagine_similarity_scaling), averagine_type_(averagine_type), averagine_table_(nullptr)
   {
+    // shared averagine patterns (an invalid type is reported when the averagine filter is applied)
+    for (Size model = 0; model < AveragineIsotopeTable::SIZE_OF_AVERAGINEMODEL; ++model)
+    {
+      if (averagine_type_ == AveragineIsotopeTable::NamesOfAveragineModel[model])
+      {
+        averagine_table_ = &AveragineIsotopeTable::getTable(static_cast<AveragineIsotopeTable::AveragineModel>(model), 1.0, 10000.0,
+                                                            std::max<Size>(20, isotopes_per_peptide_max_));
+      }
+    }
+
     // initialise experiment exp_centroided_
     // Any peaks below the intensity cutoff cannot be relevant. They are therefore removed resulting in reduced memory footprint and runtime.
     exp_centroided_.reserve(exp_centroided.getNrSpectra());
@@ -425,28 +434,22 @@ namespace OpenMS
     return exp_blacklist;
   }
   
-  bool MultiplexFiltering::filterAveragineModel_(const MultiplexIsotopicPeakPattern& pattern, const MultiplexFilteredPeak& peak) const
+  void MultiplexFiltering::getAveragineIntensities_(double mass, std::vector<double>& intensities) const
   {
-    // construct averagine distribution
-    double mass = peak.getMZ() * pattern.getCharge();
-    CoarseIsotopePatternGenerator solver(isotopes_per_peptide_max_);
-    IsotopeDistribution distribution;
-    if (averagine_type_ == "peptide")
-    {
-      distribution = solver.estimateFromPeptideWeight(mass);
-    }
-    else if (averagine_type_ == "RNA")
-    {
-      distribution = solver.estimateFromRNAWeight(mass);
-    }
-    else if (averagine_type_ == "DNA")
-    {
-      distribution = solver.estimateFromDNAWeight(mass);
-    }
-    else
+    if (averagine_table_ == nullptr)
     {
       throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Invalid averagine type.");
     }
+    averagine_table_->getIntensities(mass, isotopes_per_peptide_max_, intensities);
+    intensities.resize(isotopes_per_peptide_max_, 0.0);
+  }
+
+  bool MultiplexFiltering::filterAveragineModel_(const MultiplexIsotopicPeakPattern& pattern, const MultiplexFilteredPeak& peak) const
+  {
+    // construct averagine distribution
+    double mass = peak.getMZ() * pattern.getCharge();
+    std::vector<double> distribution;
+    getAveragineIntensities_(mass, distribution);
     
     // loop over peptides
     for (size_t peptide = 0; peptide < pattern.getMassShiftCount(); ++peptide)
@@ -485,7 +488,7 @@ namespace OpenMS
         if (count > 0)
         {
           //intensities_model.push_back(distribution.getContainer()[isotope].second);
-          intensities_model.push_back(distribution[isotope].getIntensity());
+          intensities_model.push_back(distribution[isotope]);
           intensities_data.push_back(sum_intensities/count);
         }
         
@@ -34,8 +34,7 @@
 
 #include <OpenMS/KERNEL/StandardTypes.h>
 #include <OpenMS/KERNEL/BaseFeature.h>
-#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopeDistribution.h>
-#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/AveragineIsotopeTable.h>
 #include <OpenMS/TRANSFORMATIONS/RAW2PEAK/PeakPickerHiRes.h>
 #include <OpenMS/TRANSFORMATIONS/FEATUREFINDER/MultiplexFilteringProfile.h>
 #include <OpenMS/MATH/STATISTICS/StatisticFunctions.h>
@@ -288,24 +287,8 @@ namespace OpenMS
     // construct averagine distribution
     // Note that the peptide(s) are very close in mass. We therefore calculate the averagine distribution only once (for the lightest peptide).
     double mass = peak.getMZ() * pattern.getCharge();
-    CoarseIsotopePatternGenerator solver(isotopes_per_peptide_max_);
-    IsotopeDistribution distribution;
-    if (averagine_type_ == "peptide")
-    {
-      distribution = solver.estimateFromPeptideWeight(mass);
-    }
-    else if (averagine_type_ == "RNA")
-    {
-      distribution = solver.estimateFromRNAWeight(mass);
-    }
-    else if (averagine_type_ == "DNA")
-    {
-      distribution = solver.estimateFromDNAWeight(mass);
-    }
-    else
-    {
-      throw Exception::InvalidParameter(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "Invalid averagine type.");
-    }   
+    std::vector<double> distribution;
+    getAveragineIntensities_(mass, distribution);
     
     // loop over peptides
     for (size_t peptide = 0; peptide < pattern.getMassShiftCount(); ++peptide)
@@ -333,7 +316,7 @@ namespace OpenMS
         
         if (count > 0)
         {
-          intensities_model.push_back(distribution[isotope].getIntensity());
+          intensities_model.push_back(distribution[isotope]);
           intensities_data.push_back(sum_intensities/count);
         }
         
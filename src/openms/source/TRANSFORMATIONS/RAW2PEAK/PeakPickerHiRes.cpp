@@ -41,6 +41,11 @@
 #include <OpenMS/MATH/MISC/SplineBisection.h>
 #include <OpenMS/MATH/MISC/CubicSpline2d.h>
 
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace std;
 
@@ -83,6 +88,38 @@ namespace OpenMS
   {
   }
 
+  template <typename ContainerType>
+  struct PeakPickerHiRes::Workspace_
+  {
+    explicit Workspace_(const Param& snt_param)
+    {
+      snt.setParameters(snt_param);
+    }
+
+    /// S/N estimator (parameters are only set once)
+    SignalToNoiseEstimatorMedian<ContainerType> snt;
+    /// positions (m/z or RT), intensities and S/N values of the input data points
+    std::vector<double> pos, intensity, sn;
+    /// data points of the current peak, sorted by position
+    std::vector<double> peak_pos, peak_int;
+
+    /// adds a data point to the current peak (replaces the intensity if the position exists already)
+    void addPeakPoint(double p, double i)
+    {
+      auto it = std::lower_bound(peak_pos.begin(), peak_pos.end(), p);
+      Size idx = it - peak_pos.begin();
+      if (it != peak_pos.end() && *it == p)
+      {
+        peak_int[idx] = i;
+      }
+      else
+      {
+        peak_pos.insert(it, p);
+        peak_int.insert(peak_int.begin() + idx, i);
+      }
+    }
+  };
+
   void PeakPickerHiRes::pick(const MSSpectrum& input, MSSpectrum& output) const
   {
     std::vector<PeakBoundary> boundaries;
@@ -96,6 +133,18 @@ namespace OpenMS
   }
 
   void PeakPickerHiRes::pick(const MSSpectrum& input, MSSpectrum& output, std::vector<PeakBoundary>& boundaries, bool check_spacings) const
+  {
+    Workspace_<MSSpectrum> workspace(param_.copy("SignalToNoise:", true));
+    pickSpectrum_(input, output, boundaries, check_spacings, workspace);
+  }
+
+  void PeakPickerHiRes::pick(const MSChromatogram& input, MSChromatogram& output, std::vector<PeakBoundary>& boundaries, bool check_spacings) const
+  {
+    Workspace_<MSChromatogram> workspace(param_.copy("SignalToNoise:", true));
+    pickChromatogram_(input, output, boundaries, check_spacings, workspace);
+  }
+
+  void PeakPickerHiRes::pickSpectrum_(const MSSpectrum& input, MSSpectrum& output, std::vector<PeakBoundary>& boundaries, bool check_spacings, Workspace_<MSSpectrum>& workspace) const
   {
     // copy meta data of the input spectrum
     output.clear(true);
@@ -105,10 +154,10 @@ namespace OpenMS
     output.setMSLevel(input.getMSLevel());
     output.setName(input.getName());
     output.setType(SpectrumSettings::CENTROID);
-    pick_(input, output, boundaries, check_spacings);
+    pick_(input, output, boundaries, check_spacings, workspace);
   }
 
-  void PeakPickerHiRes::pick(const MSChromatogram& input, MSChromatogram& output, std::vector<PeakBoundary>& boundaries, bool check_spacings) const
+  void PeakPickerHiRes::pickChromatogram_(const MSChromatogram& input, MSChromatogram& output, std::vector<PeakBoundary>& boundaries, bool check_spacings, Workspace_<MSChromatogram>& workspace) const
   {
     // copy meta data of the input chromatogram
     output.clear(true);
@@ -116,11 +165,11 @@ namespace OpenMS
     output.MetaInfoInterface::operator=(input);
     output.setName(input.getName());
 
-    pick_(input, output, boundaries, check_spacings);
+    pick_(input, output, boundaries, check_spacings, workspace);
   }
 
   template <typename ContainerType>
-  void PeakPickerHiRes::pick_(const ContainerType& input, ContainerType& output, std::vector<PeakBoundary>& boundaries, bool check_spacings) const
+  void PeakPickerHiRes::pick_(const ContainerType& input, ContainerType& output, std::vector<PeakBoundary>& boundaries, bool check_spacings, Workspace_<ContainerType>& workspace) const
   {
     if (report_FWHM_)
     {
@@ -138,21 +187,39 @@ namespace OpenMS
       check_spacings = false;
     }
 
-    // signal-to-noise estimation
-    SignalToNoiseEstimatorMedian< ContainerType > snt;
-    snt.setParameters(param_.copy("SignalToNoise:", true));
+    // copy the data into contiguous arrays (the loops below access each point several times)
+    const Size size = input.size();
+    std::vector<double>& mz = workspace.pos;
+    std::vector<double>& intensity = workspace.intensity;
+    std::vector<double>& sn = workspace.sn;
+    mz.resize(size);
+    intensity.resize(size);
+    for (Size j = 0; j < size; ++j)
+    {
+      mz[j] = input[j].getMZ();
+      intensity[j] = input[j].getIntensity();
+    }
 
+    // signal-to-noise estimation (all values are 0 if disabled)
+    sn.assign(size, 0.0);
     if (signal_to_noise_ > 0.0)
     {
-      snt.init(input);
+      workspace.snt.init(input);
+      for (Size j = 0; j < size; ++j)
+      {
+        sn[j] = workspace.snt.getSignalToNoise(j);
+      }
     }
 
+    std::vector<double>& peak_mz = workspace.peak_pos;
+    std::vector<double>& peak_int = workspace.peak_int;
+
     // find local maxima in profile data
-    for (Size i = 2; i < input.size() - 2; ++i)
+    for (Size i = 2; i < size - 2; ++i)
     {
-      double central_peak_mz = input[i].getMZ(), central_peak_int = input[i].getIntensity();
-      double left_neighbor_mz = input[i - 1].getMZ(), left_neighbor_int = input[i - 1].getIntensity();
-      double right_neighbor_mz = input[i + 1].getMZ(), right_neighbor_int = input[i + 1].getIntensity();
+      double central_peak_mz = mz[i], central_peak_int = intensity[i];
+      double left_neighbor_mz = mz[i - 1], left_neighbor_int = intensity[i - 1];
+      double right_neighbor_mz = mz[i + 1], right_neighbor_int = intensity[i + 1];
 
       // do not interpolate when the left or right support is a zero-data-point
       if (std::fabs(left_neighbor_int) < std::numeric_limits<double>::epsilon()) continue;
@@ -167,20 +234,12 @@ namespace OpenMS
         min_spacing = (left_to_central < central_to_right) ? left_to_central : central_to_right;
       }
 
-      double act_snt = 0.0, act_snt_l1 = 0.0, act_snt_r1 = 0.0;
-      if (signal_to_noise_ > 0.0)
-      {
-        act_snt = snt.getSignalToNoise(i);
-        act_snt_l1 = snt.getSignalToNoise(i - 1);
-        act_snt_r1 = snt.getSignalToNoise(i + 1);
-      }
-
       // look for peak cores meeting MZ and intensity/SNT criteria
       if ((central_peak_int > left_neighbor_int) && 
         (central_peak_int > right_neighbor_int) && 
-        (act_snt >= signal_to_noise_) && 
-        (act_snt_l1 >= signal_to_noise_) && 
-        (act_snt_r1 >= signal_to_noise_) &&
+        (sn[i] >= signal_to_noise_) && 
+        (sn[i - 1] >= signal_to_noise_) && 
+        (sn[i + 1] >= signal_to_noise_) &&
         (!check_spacings || 
         ((left_to_central < spacing_difference_ * min_spacing) && 
           (central_to_right < spacing_difference_ * min_spacing))))
@@ -189,34 +248,26 @@ namespace OpenMS
         // satellite peaks (indicates oscillation rather than
         // real peaks) -> remove
 
-        double act_snt_l2 = 0.0, act_snt_r2 = 0.0;
-
-        if (signal_to_noise_ > 0.0)
-        {
-          act_snt_l2 = snt.getSignalToNoise(i - 2);
-          act_snt_r2 = snt.getSignalToNoise(i + 2);
-        }
-
         // checking signal-to-noise?
         if ((i > 1) &&
-          (i + 2 < input.size()) &&
-          (left_neighbor_int < input[i - 2].getIntensity()) &&
-          (right_neighbor_int < input[i + 2].getIntensity()) &&
-          (act_snt_l2 >= signal_to_noise_) &&
-          (act_snt_r2 >= signal_to_noise_) &&
+          (i + 2 < size) &&
+          (left_neighbor_int < intensity[i - 2]) &&
+          (right_neighbor_int < intensity[i + 2]) &&
+          (sn[i - 2] >= signal_to_noise_) &&
+          (sn[i + 2] >= signal_to_noise_) &&
           (!check_spacings ||
-          ((left_neighbor_mz - input[i - 2].getMZ() < spacing_difference_ * min_spacing) && 
-            (input[i + 2].getMZ() - right_neighbor_mz < spacing_difference_ * min_spacing))))
+          ((left_neighbor_mz - mz[i - 2] < spacing_difference_ * min_spacing) && 
+            (mz[i + 2] - right_neighbor_mz < spacing_difference_ * min_spacing))))
         {
           ++i;
           continue;
         }
 
-        std::map<double, double> peak_raw_data;
-
-        peak_raw_data[central_peak_mz] = central_peak_int;
-        peak_raw_data[left_neighbor_mz] = left_neighbor_int;
-        peak_raw_data[right_neighbor_mz] = right_neighbor_int;
+        peak_mz.clear();
+        peak_int.clear();
+        workspace.addPeakPoint(central_peak_mz, central_peak_int);
+        workspace.addPeakPoint(left_neighbor_mz, left_neighbor_int);
+        workspace.addPeakPoint(right_neighbor_mz, right_neighbor_int);
 
         // peak core found, now extend it
         // to the left
@@ -230,33 +281,26 @@ namespace OpenMS
           (i - k + 1 > 0) && 
           !previous_zero_left && 
           (missing_left <= missing_) && 
-          (input[i - k].getIntensity() <= peak_raw_data.begin()->second) &&
+          (intensity[i - k] <= peak_int.front()) &&
           (!check_spacings || 
-          (peak_raw_data.begin()->first - input[i - k].getMZ() < spacing_difference_gap_ * min_spacing)))
+          (peak_mz.front() - mz[i - k] < spacing_difference_gap_ * min_spacing)))
         {
-          double act_snt_lk = 0.0;
-
-          if (signal_to_noise_ > 0.0)
-          {
-            act_snt_lk = snt.getSignalToNoise(i - k);
-          }
-
-          if ((act_snt_lk >= signal_to_noise_) && 
+          if ((sn[i - k] >= signal_to_noise_) && 
             (!check_spacings ||
-            (peak_raw_data.begin()->first - input[i - k].getMZ() < spacing_difference_ * min_spacing)))
+            (peak_mz.front() - mz[i - k] < spacing_difference_ * min_spacing)))
           {
-            peak_raw_data[input[i - k].getMZ()] = input[i - k].getIntensity();
+            workspace.addPeakPoint(mz[i - k], intensity[i - k]);
           }
           else
           {
             ++missing_left;
             if (missing_left <= missing_)
             {
-              peak_raw_data[input[i - k].getMZ()] = input[i - k].getIntensity();
+              workspace.addPeakPoint(mz[i - k], intensity[i - k]);
             }
           }
 
-          previous_zero_left = (input[i - k].getIntensity() == 0);
+          previous_zero_left = (intensity[i - k] == 0);
           left_boundary = i - k;
           ++k;
         }
@@ -268,44 +312,37 @@ namespace OpenMS
         Size missing_right(0);
         Size right_boundary(i+1); // index of the right boundary for the spline interpolation
 
-        while ((i + k < input.size()) && 
+        while ((i + k < size) && 
           !previous_zero_right && 
           (missing_right <= missing_) && 
-          (input[i + k].getIntensity() <= peak_raw_data.rbegin()->second) &&
+          (intensity[i + k] <= peak_int.back()) &&
           (!check_spacings ||
-          (input[i + k].getMZ() - peak_raw_data.rbegin()->first < spacing_difference_gap_ * min_spacing)))
+          (mz[i + k] - peak_mz.back() < spacing_difference_gap_ * min_spacing)))
         {
-          double act_snt_rk = 0.0;
-
-          if (signal_to_noise_ > 0.0)
-          {
-            act_snt_rk = snt.getSignalToNoise(i + k);
-          }
-
-          if ((act_snt_rk >= signal_to_noise_) && 
+          if ((sn[i + k] >= signal_to_noise_) && 
             (!check_spacings ||
-            (input[i + k].getMZ() - peak_raw_data.rbegin()->first < spacing_difference_ * min_spacing)))
+            (mz[i + k] - peak_mz.back() < spacing_difference_ * min_spacing)))
           {
-            peak_raw_data[input[i + k].getMZ()] = input[i + k].getIntensity();
+            workspace.addPeakPoint(mz[i + k], intensity[i + k]);
           }
           else
           {
             ++missing_right;
             if (missing_right <= missing_)
             {
-              peak_raw_data[input[i + k].getMZ()] = input[i + k].getIntensity();
+              workspace.addPeakPoint(mz[i + k], intensity[i + k]);
             }
           }
 
-          previous_zero_right = (input[i + k].getIntensity() == 0);
+          previous_zero_right = (intensity[i + k] == 0);
           right_boundary = i + k;
           ++k;
         }
 
         // skip if the minimal number of 3 points for fitting is not reached
-        if (peak_raw_data.size() < 3) continue;
+        if (peak_mz.size() < 3) continue;
 
-        CubicSpline2d peak_spline (peak_raw_data);
+        CubicSpline2d peak_spline(peak_mz, peak_int);
 
         // calculate maximum by evaluating the spline's 1st derivative
         // (bisection method)
@@ -323,7 +360,7 @@ namespace OpenMS
           threshold = 0.01 * fwhm_int;
           double mz_mid, int_mid; 
           // left:
-          double mz_left = peak_raw_data.begin()->first;
+          double mz_left = peak_mz.front();
           double mz_center = max_peak_mz;
           if (peak_spline.eval(mz_left) > fwhm_int)
           { // the spline ends before half max is reached -- take the leftmost point (probably an underestimation)
@@ -348,7 +385,7 @@ namespace OpenMS
           const double fwhm_left_mz = mz_mid;
 
           // right ...
-          double mz_right = peak_raw_data.rbegin()->first;
+          double mz_right = peak_mz.back();
           mz_center = max_peak_mz;
           if (peak_spline.eval(mz_right) > fwhm_int)
           { // the spline ends before half max is reached -- take the rightmost point (probably an underestimation)
@@ -381,8 +418,8 @@ namespace OpenMS
         PeakBoundary peak_boundary;
         peak.setMZ(max_peak_mz);
         peak.setIntensity(max_peak_int);
-        peak_boundary.mz_min = input[left_boundary].getMZ();
-        peak_boundary.mz_max = input[right_boundary].getMZ();
+        peak_boundary.mz_min = mz[left_boundary];
+        peak_boundary.mz_max = mz[right_boundary];
         output.push_back(peak);
 
         boundaries.push_back(peak_boundary);
@@ -426,63 +463,140 @@ namespace OpenMS
     Size progress = 0;
     startProgress(0, input.size() + input.getChromatograms().size(), "picking peaks");
 
-    // MSLevel -> stats
-    map<int, SpectraPickInfo> pick_info;
+    const Param snt_param = param_.copy("SignalToNoise:", true);
+    std::vector<std::vector<PeakBoundary> > boundaries_all(input.size()); // boundaries per spectrum
+    std::vector<char> was_picked(input.size(), false);
+    bool centroided_input(false);
+    Size error_count(0);
+    String error_message;
 
-    if (input.getNrSpectra() > 0)
+#pragma omp parallel
     {
-      for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
+      // scratch memory of this thread
+      Workspace_<MSSpectrum> workspace(snt_param);
+
+#pragma omp for schedule(dynamic)
+      for (SignedSize scan_idx = 0; scan_idx < (SignedSize)input.size(); ++scan_idx)
       {
-        bool was_picked{false};
-        // auto mode
-        if (ms_levels_.empty()) 
+        IF_MASTERTHREAD setProgress(progress);
+
+        try
         {
-          SpectrumSettings::SpectrumType spectrum_type = input[scan_idx].getType(true); // uses meta-info and inspects data if needed
-          if (spectrum_type == SpectrumSettings::CENTROID)
+          const MSSpectrum& spectrum = input[scan_idx];
+          bool pick_spectrum(false);
+          // auto mode
+          if (ms_levels_.empty())
+          {
+            pick_spectrum = (spectrum.getType(true) != SpectrumSettings::CENTROID); // uses meta-info and inspects data if needed
+          }
+          // manual mode
+          else if (ListUtils::contains(ms_levels_, spectrum.getMSLevel()))
           {
-            output[scan_idx] = input[scan_idx];
+            pick_spectrum = true;
+            if (check_spectrum_type && spectrum.getType(true) == SpectrumSettings::CENTROID)
+            {
+#pragma omp critical (OpenMS_PeakPickerHiRes_error)
+              centroided_input = true;
+              pick_spectrum = false;
+            }
+          }
+
+          if (pick_spectrum)
+          {
+            pickSpectrum_(spectrum, output[scan_idx], boundaries_all[scan_idx], true, workspace);
+            was_picked[scan_idx] = true;
           }
           else
           {
-            std::vector<PeakBoundary> boundaries_s; // peak boundaries of a single spectrum
-            pick(input[scan_idx], output[scan_idx], boundaries_s);
-            was_picked = true;
-            boundaries_spec.push_back(std::move(boundaries_s));
+            output[scan_idx] = spectrum;
+          }
+        }
+        catch (Exception::BaseException& e)
+        {
+#pragma omp critical (OpenMS_PeakPickerHiRes_error)
+          {
+            if (error_message.empty()) error_message = e.what();
+            ++error_count;
           }
         }
-        // manual mode
-        else if (!ListUtils::contains(ms_levels_, input[scan_idx].getMSLevel())) 
+        catch (...)
         {
-          output[scan_idx] = input[scan_idx];
+#pragma omp atomic
+          ++error_count;
         }
-        else
+
+#pragma omp atomic
+        ++progress;
+      }
+    }
+
+    if (centroided_input)
+    {
+      throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
+    }
+    if (error_count > 0)
+    {
+      throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Error during peak picking of " + String(error_count) + " spectra: " + error_message);
+    }
+
+    // MSLevel -> stats
+    map<int, SpectraPickInfo> pick_info;
+    for (Size scan_idx = 0; scan_idx < input.size(); ++scan_idx)
+    {
+      if (was_picked[scan_idx])
+      {
+        boundaries_spec.push_back(std::move(boundaries_all[scan_idx]));
+      }
+      pick_info[input[scan_idx].getMSLevel()].picked += was_picked[scan_idx];
+      ++pick_info[input[scan_idx].getMSLevel()].total;
+    }
+
+    std::vector<MSChromatogram> chromatograms(input.getChromatograms().size());
+    std::vector<std::vector<PeakBoundary> > boundaries_c(chromatograms.size()); // boundaries per chromatogram
+
+#pragma omp parallel
+    {
+      Workspace_<MSChromatogram> workspace(snt_param);
+
+#pragma omp for schedule(dynamic)
+      for (SignedSize i = 0; i < (SignedSize)chromatograms.size(); ++i)
+      {
+        IF_MASTERTHREAD setProgress(progress);
+
+        try
+        {
+          pickChromatogram_(input.getChromatograms()[i], chromatograms[i], boundaries_c[i], false, workspace);
+        }
+        catch (Exception::BaseException& e)
         {
-          std::vector<PeakBoundary> boundaries_s; // peak boundaries of a single spectrum
-          SpectrumSettings::SpectrumType spectrum_type = input[scan_idx].getType(true); // uses meta-info and inspects data if needed
-          if (spectrum_type == SpectrumSettings::CENTROID && check_spectrum_type)
+#pragma omp critical (OpenMS_PeakPickerHiRes_error)
           {
-            throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
+            if (error_message.empty()) error_message = e.what();
+            ++error_count;
           }
-
-          pick(input[scan_idx], output[scan_idx], boundaries_s);
-          was_picked = true;
-          boundaries_spec.push_back(std::move(boundaries_s));
         }
-        pick_info[input[scan_idx].getMSLevel()].picked += was_picked;
-        ++pick_info[input[scan_idx].getMSLevel()].total;
-        setProgress(++progress);
+        catch (...)
+        {
+#pragma omp atomic
+          ++error_count;
+        }
+
+#pragma omp atomic
+        ++progress;
       }
     }
 
+    if (error_count > 0)
+    {
+      throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Error during peak picking of " + String(error_count) + " chromatograms: " + error_message);
+    }
 
-    for (Size i = 0; i < input.getChromatograms().size(); ++i)
+    for (Size i = 0; i < chromatograms.size(); ++i)
     {
-      MSChromatogram chromatogram;
-      std::vector<PeakBoundary> boundaries_c; // peak boundaries of a single chromatogram
-      pick(input.getChromatograms()[i], chromatogram, boundaries_c);
-      output.addChromatogram(chromatogram);
-      boundaries_chrom.push_back(boundaries_c);
-      setProgress(++progress);
+      output.addChromatogram(std::move(chromatograms[i]));
+      boundaries_chrom.push_back(std::move(boundaries_c[i]));
     }
     endProgress();
 
@@ -509,54 +623,94 @@ namespace OpenMS
     // resize output with respect to input
     output.resize(input.size());
 
-    if (input.getNrSpectra() > 0)
+    const Param snt_param = param_.copy("SignalToNoise:", true);
+    bool centroided_input(false);
+    Size error_count(0);
+    String error_message;
+
+#pragma omp parallel
     {
-      for (Size scan_idx = 0; scan_idx != input.size(); ++scan_idx)
+      // scratch memory of this thread
+      Workspace_<MSSpectrum> workspace(snt_param);
+      std::vector<PeakBoundary> boundaries;
+
+#pragma omp for schedule(dynamic)
+      for (SignedSize scan_idx = 0; scan_idx < (SignedSize)input.size(); ++scan_idx)
       {
-        if (ms_levels_.empty()) //auto mode
+        IF_MASTERTHREAD setProgress(progress);
+
+        try
         {
-          MSSpectrum s = input[scan_idx];
-          s.sortByPosition();
+          // reading from disk is not thread-safe
+          MSSpectrum s;
+#pragma omp critical (OpenMS_PeakPickerHiRes_readOnDisc)
+          s = input.getSpectrum(scan_idx);
+
+          bool pick_spectrum(false);
+          if (ms_levels_.empty()) //auto mode
+          {
+            // determine type of spectral data (profile or centroided)
+            pick_spectrum = (s.getType() != SpectrumSettings::CENTROID);
+          }
+          else if (ListUtils::contains(ms_levels_, s.getMSLevel())) // manual mode
+          {
+            pick_spectrum = true;
+            if (s.getType() == SpectrumSettings::CENTROID && check_spectrum_type)
+            {
+#pragma omp critical (OpenMS_PeakPickerHiRes_error)
+              centroided_input = true;
+              pick_spectrum = false;
+            }
+          }
 
-          // determine type of spectral data (profile or centroided)
-          SpectrumSettings::SpectrumType spectrumType = s.getType();
-          if (spectrumType == SpectrumSettings::CENTROID)
+          if (pick_spectrum)
           {
-            output[scan_idx] = input[scan_idx];
+            s.sortByPosition();
+            boundaries.clear();
+            pickSpectrum_(s, output[scan_idx], boundaries, true, workspace);
           }
           else
           {
-            pick(s, output[scan_idx]);
+            output[scan_idx] = std::move(s);
           }
         }
-        else if (!ListUtils::contains(ms_levels_, input[scan_idx].getMSLevel())) // manual mode
+        catch (Exception::BaseException& e)
         {
-          output[scan_idx] = input[scan_idx];
-        }
-        else
-        {
-          MSSpectrum s = input[scan_idx];
-          s.sortByPosition();
-
-          // determine type of spectral data (profile or centroided)
-          SpectrumSettings::SpectrumType spectrum_type = s.getType();
-
-          if (spectrum_type == SpectrumSettings::CENTROID && check_spectrum_type)
+#pragma omp critical (OpenMS_PeakPickerHiRes_error)
           {
-            throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
+            if (error_message.empty()) error_message = e.what();
+            ++error_count;
           }
-
-          pick(s, output[scan_idx]);
         }
-        setProgress(++progress);
+        catch (...)
+        {
+#pragma omp atomic
+          ++error_count;
+        }
+
+#pragma omp atomic
+        ++progress;
       }
     }
 
+    if (centroided_input)
+    {
+      throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, __FUNCTION__, "Error: Centroided data provided but profile spectra expected.");
+    }
+    if (error_count > 0)
+    {
+      throw OpenMS::Exception::IllegalArgument(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION,
+        "Error during peak picking of " + String(error_count) + " spectra: " + error_message);
+    }
+
+    Workspace_<MSChromatogram> workspace(snt_param);
+    std::vector<PeakBoundary> boundaries;
     for (Size i = 0; i < input.getNrChromatograms(); ++i)
     {
       MSChromatogram chromatogram;
-      pick(input.getChromatogram(i), chromatogram);
-      output.addChromatogram(chromatogram);
+      boundaries.clear();
+      pickChromatogram_(input.getChromatogram(i), chromatogram, boundaries, false, workspace);
+      output.addChromatogram(std::move(chromatogram));
       setProgress(++progress);
     }
     endProgress();
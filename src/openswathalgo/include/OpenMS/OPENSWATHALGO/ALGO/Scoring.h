@@ -138,6 +138,9 @@ public:
     // Estimate rank-transformed mutual information between two vectors of data points
     OPENSWATHALGO_DLLAPI double rankedMutualInformation(std::vector<double>& data1, std::vector<double>& data2);
 
+    // Estimate mutual information between two vectors of ranks (as returned by computeRank)
+    OPENSWATHALGO_DLLAPI double rankedMutualInformation(std::vector<unsigned int>& ranks1, std::vector<unsigned int>& ranks2);
+
     //@}
 
   }
@@ -0,0 +1,123 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#pragma once
+
+#include <OpenMS/OPENSWATHALGO/OpenSwathAlgoConfig.h>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace OpenSwath
+{
+
+  /**
+    @brief Per-thread pool of scratch buffers used while scoring a transition group
+
+    Scoring a peak group repeatedly needs short-lived intensity vectors (one
+    per transition and per pair of transitions). Instead of allocating them
+    anew for every group, the buffers are handed out from a pool that keeps
+    its capacity between groups. Each thread uses its own pool, obtained
+    through threadLocal(), so no synchronization is needed.
+
+    Buffers are acquired inside a Frame; when the frame goes out of scope all
+    buffers acquired within it are returned to the pool. Callers scoring a
+    new group call reset() first, which also restarts the allocation counter
+    that can be queried with getAllocationCount() to verify that the pool has
+    reached a steady state (i.e. no further heap allocations per group).
+
+    @note References returned by acquire() stay valid until the enclosing
+    Frame is destroyed or reset() is called.
+  */
+  class OPENSWATHALGO_DLLAPI ScoringScratch
+  {
+public:
+
+    /**
+      @brief Scope guard that returns all buffers acquired during its lifetime
+    */
+    class OPENSWATHALGO_DLLAPI Frame
+    {
+public:
+      explicit Frame(ScoringScratch& scratch);
+      ~Frame();
+
+      Frame(const Frame&) = delete;
+      Frame& operator=(const Frame&) = delete;
+
+private:
+      ScoringScratch& scratch_;
+      std::size_t mark_;
+    };
+
+    ScoringScratch() = default;
+
+    ScoringScratch(const ScoringScratch&) = delete;
+    ScoringScratch& operator=(const ScoringScratch&) = delete;
+
+    /// Returns the scratch pool of the calling thread
+    static ScoringScratch& threadLocal();
+
+    /// Returns all buffers to the pool and restarts the allocation counter (call once per scored group)
+    void reset();
+
+    /**
+      @brief Returns an empty buffer with capacity for at least @p capacity elements
+
+      The buffer is owned by the pool; its content is unspecified after the
+      enclosing Frame ends.
+    */
+    std::vector<double>& acquire(std::size_t capacity = 0);
+
+    /// Number of heap allocations (new buffers or buffer growth) since the last reset()
+    std::size_t getAllocationCount() const;
+
+    /// Number of buffers currently held by the pool
+    std::size_t getPoolSize() const;
+
+private:
+
+    /// Returns buffers [mark, end) to the pool and accounts for any growth they underwent
+    void release_(std::size_t mark);
+
+    std::vector<std::unique_ptr<std::vector<double> > > buffers_;
+    /// Capacity of each buffer when it was last handed out or returned
+    std::vector<std::size_t> capacities_;
+    /// Index of the next free buffer
+    std::size_t next_ = 0;
+    std::size_t allocations_ = 0;
+  };
+
+}
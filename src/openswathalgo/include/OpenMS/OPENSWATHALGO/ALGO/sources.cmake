@@ -6,6 +6,7 @@ set(sources_list_h
 StatsHelpers.h
 MRMScoring.h
 Scoring.h
+ScoringScratch.h
 )
 
 ### add path to the filenames
@@ -33,6 +33,7 @@
 // --------------------------------------------------------------------------
 
 #include <OpenMS/OPENSWATHALGO/ALGO/MRMScoring.h>
+#include <OpenMS/OPENSWATHALGO/ALGO/ScoringScratch.h>
 #include <OpenMS/OPENSWATHALGO/ALGO/StatsHelpers.h>
 #include <OpenMS/OPENSWATHALGO/Macros.h>
 //#define MRMSCORING_TESTING
@@ -41,6 +42,103 @@
 #include <iterator>
 
 
+namespace
+{
+  using OpenSwath::MRMScoring;
+  using OpenSwath::ScoringScratch;
+
+  typedef std::vector<const std::vector<double>*> IntensityRefs;
+
+  std::vector<MRMScoring::FeatureType> getFeatures(OpenSwath::IMRMFeature* mrmfeature, const std::vector<MRMScoring::String>& native_ids)
+  {
+    std::vector<MRMScoring::FeatureType> features;
+    features.reserve(native_ids.size());
+    for (const auto& native_id : native_ids)
+    {
+      features.push_back(mrmfeature->getFeature(native_id));
+    }
+    return features;
+  }
+
+  std::vector<MRMScoring::FeatureType> getPrecursorFeatures(OpenSwath::IMRMFeature* mrmfeature, const std::vector<MRMScoring::String>& precursor_ids)
+  {
+    std::vector<MRMScoring::FeatureType> features;
+    features.reserve(precursor_ids.size());
+    for (const auto& precursor_id : precursor_ids)
+    {
+      features.push_back(mrmfeature->getPrecursorFeature(precursor_id));
+    }
+    return features;
+  }
+
+  /// Fetches the intensities of each feature once into buffers of the scratch pool (valid until the enclosing frame ends)
+  IntensityRefs fetchIntensities(const std::vector<MRMScoring::FeatureType>& features, ScoringScratch& scratch)
+  {
+    IntensityRefs intensities;
+    intensities.reserve(features.size());
+    for (const auto& feature : features)
+    {
+      std::vector<double>& buffer = scratch.acquire();
+      feature->getIntensity(buffer);
+      intensities.push_back(&buffer);
+    }
+    return intensities;
+  }
+
+  /**
+    @brief Fills the cross-correlation matrix of @p rows vs. @p cols (only j >= i if @p upper_triangle is set)
+
+    normalizedCrossCorrelation() standardizes its input in place; as before,
+    the row trace is copied once per row (and is thus re-standardized for
+    every column) while the column trace is copied afresh for every pair.
+  */
+  void fillXCorrMatrix(const IntensityRefs& rows, const IntensityRefs& cols, bool upper_triangle,
+                       MRMScoring::XCorrMatrixType& matrix, ScoringScratch& scratch)
+  {
+    std::vector<double>& intensityi = scratch.acquire();
+    std::vector<double>& intensityj = scratch.acquire();
+    matrix.resize(rows.size());
+    for (std::size_t i = 0; i < rows.size(); i++)
+    {
+      matrix[i].resize(cols.size());
+      intensityi.assign(rows[i]->begin(), rows[i]->end());
+      for (std::size_t j = (upper_triangle ? i : 0); j < cols.size(); j++)
+      {
+        intensityj.assign(cols[j]->begin(), cols[j]->end());
+        // compute normalized cross correlation
+        matrix[i][j] = OpenSwath::Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
+      }
+    }
+  }
+
+  std::vector<std::vector<unsigned int> > computeRanks(const IntensityRefs& intensities)
+  {
+    std::vector<std::vector<unsigned int> > ranks;
+    ranks.reserve(intensities.size());
+    for (const auto& intensity : intensities)
+    {
+      ranks.push_back(OpenSwath::Scoring::computeRank(*intensity));
+    }
+    return ranks;
+  }
+
+  /// Fills the mutual information matrix of @p rows vs. @p cols (only j >= i if @p upper_triangle is set), each trace is ranked only once
+  void fillMIMatrix(std::vector<std::vector<unsigned int> >& rows, std::vector<std::vector<unsigned int> >& cols, bool upper_triangle,
+                    std::vector<std::vector<double> >& matrix)
+  {
+    matrix.resize(rows.size());
+    for (std::size_t i = 0; i < rows.size(); i++)
+    {
+      matrix[i].resize(cols.size());
+      for (std::size_t j = (upper_triangle ? i : 0); j < cols.size(); j++)
+      {
+        // compute ranked mutual information
+        matrix[i][j] = OpenSwath::Scoring::rankedMutualInformation(rows[i], cols[j]);
+      }
+    }
+  }
+}
+
 namespace OpenSwath
 {
 
@@ -51,6 +149,10 @@ namespace OpenSwath
 
   void MRMScoring::initializeXCorrMatrix(const std::vector< std::vector< double > >& data)
   {
+    ScoringScratch& scratch = ScoringScratch::threadLocal();
+    ScoringScratch::Frame frame(scratch);
+    std::vector<double>& tmp1 = scratch.acquire();
+    std::vector<double>& tmp2 = scratch.acquire();
     xcorr_matrix_.resize(data.size());
     for (std::size_t i = 0; i < data.size(); i++)
     {
@@ -58,8 +160,8 @@ namespace OpenSwath
       for (std::size_t j = i; j < data.size(); j++)
       {
         // compute normalized cross correlation
-        std::vector< double > tmp1(data[i]);
-        std::vector< double > tmp2(data[j]);
+        tmp1.assign(data[i].begin(), data[i].end());
+        tmp2.assign(data[j].begin(), data[j].end());
         xcorr_matrix_[i][j] = Scoring::normalizedCrossCorrelation(tmp1, tmp2, boost::numeric_cast<int>(data[i].size()), 1);
       }
     }
@@ -82,98 +184,44 @@ namespace OpenSwath
 
   void MRMScoring::initializeXCorrMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    xcorr_matrix_.resize(native_ids.size());
-    for (std::size_t i = 0; i < native_ids.size(); i++)
-    {
-      String native_id = native_ids[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
-      xcorr_matrix_[i].resize(native_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = i; j < native_ids.size(); j++)
-      {
-        String native_id2 = native_ids[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
-      }
-    }
+    ScoringScratch& scratch = ScoringScratch::threadLocal();
+    ScoringScratch::Frame frame(scratch);
+    IntensityRefs intensities = fetchIntensities(getFeatures(mrmfeature, native_ids), scratch);
+    fillXCorrMatrix(intensities, intensities, true, xcorr_matrix_, scratch);
   }
 
   void MRMScoring::initializeXCorrContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& native_ids_set1, const std::vector<String>& native_ids_set2)
   {
-    std::vector<double> intensityi, intensityj;
-    xcorr_contrast_matrix_.resize(native_ids_set1.size());
-    for (std::size_t i = 0; i < native_ids_set1.size(); i++)
-    { 
-      String native_id = native_ids_set1[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
-      xcorr_contrast_matrix_[i].resize(native_ids_set2.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < native_ids_set2.size(); j++)
-      {
-        String native_id2 = native_ids_set2[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_contrast_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
-      }
-    }
+    ScoringScratch& scratch = ScoringScratch::threadLocal();
+    ScoringScratch::Frame frame(scratch);
+    IntensityRefs intensities1 = fetchIntensities(getFeatures(mrmfeature, native_ids_set1), scratch);
+    IntensityRefs intensities2 = fetchIntensities(getFeatures(mrmfeature, native_ids_set2), scratch);
+    fillXCorrMatrix(intensities1, intensities2, false, xcorr_contrast_matrix_, scratch);
   }
 
   void MRMScoring::initializeXCorrPrecursorMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    xcorr_precursor_matrix_.resize(precursor_ids.size());
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    {
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      xcorr_precursor_matrix_[i].resize(precursor_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = i; j < precursor_ids.size(); j++)
-      {
-        String precursor_id2 = precursor_ids[j];
-        FeatureType fj = mrmfeature->getPrecursorFeature(precursor_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_precursor_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
-      }
-    }
+    ScoringScratch& scratch = ScoringScratch::threadLocal();
+    ScoringScratch::Frame frame(scratch);
+    IntensityRefs intensities = fetchIntensities(getPrecursorFeatures(mrmfeature, precursor_ids), scratch);
+    fillXCorrMatrix(intensities, intensities, true, xcorr_precursor_matrix_, scratch);
   }
 
   void MRMScoring::initializeXCorrPrecursorContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    xcorr_precursor_contrast_matrix_.resize(precursor_ids.size());
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    { 
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      xcorr_precursor_contrast_matrix_[i].resize(native_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < native_ids.size(); j++)
-      {
-        String native_id = native_ids[j];
-        FeatureType fj = mrmfeature->getFeature(native_id);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_precursor_contrast_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
-      }
-    }
+    ScoringScratch& scratch = ScoringScratch::threadLocal();
+    ScoringScratch::Frame frame(scratch);
+    IntensityRefs precursor_intensities = fetchIntensities(getPrecursorFeatures(mrmfeature, precursor_ids), scratch);
+    IntensityRefs fragment_intensities = fetchIntensities(getFeatures(mrmfeature, native_ids), scratch);
+    fillXCorrMatrix(precursor_intensities, fragment_intensities, false, xcorr_precursor_contrast_matrix_, scratch);
   }
 
   void MRMScoring::initializeXCorrPrecursorContrastMatrix(const std::vector< std::vector< double > >& data_precursor, const std::vector< std::vector< double > >& data_fragments)
   {
+    ScoringScratch& scratch = ScoringScratch::threadLocal();
+    ScoringScratch::Frame frame(scratch);
+    std::vector<double>& tmp1 = scratch.acquire();
+    std::vector<double>& tmp2 = scratch.acquire();
     xcorr_precursor_contrast_matrix_.resize(data_precursor.size());
     for (std::size_t i = 0; i < data_precursor.size(); i++)
     { 
@@ -181,8 +229,8 @@ namespace OpenSwath
       for (std::size_t j = 0; j < data_fragments.size(); j++)
       {
         // compute normalized cross correlation
-        std::vector< double > tmp1(data_precursor[i]);
-        std::vector< double > tmp2(data_fragments[j]);
+        tmp1.assign(data_precursor[i].begin(), data_precursor[i].end());
+        tmp2.assign(data_fragments[j].begin(), data_fragments[j].end());
         xcorr_precursor_contrast_matrix_[i][j] = Scoring::normalizedCrossCorrelation(tmp1, tmp2, boost::numeric_cast<int>(tmp1.size()), 1);
 #ifdef MRMSCORING_TESTING
         std::cout << " fill xcorr_precursor_contrast_matrix_ "<< tmp1.size() << " / " << tmp2.size() << " : " << xcorr_precursor_contrast_matrix_[i][j].data.size() << std::endl;
@@ -193,38 +241,14 @@ namespace OpenSwath
 
   void MRMScoring::initializeXCorrPrecursorCombinedMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    std::vector<FeatureType> features;
-
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    { 
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      features.push_back(fi);
-    }
-    for (std::size_t j = 0; j < native_ids.size(); j++)
-    {
-      String native_id = native_ids[j];
-      FeatureType fj = mrmfeature->getFeature(native_id);
-      features.push_back(fj);
-    }
+    std::vector<FeatureType> features = getPrecursorFeatures(mrmfeature, precursor_ids);
+    std::vector<FeatureType> fragment_features = getFeatures(mrmfeature, native_ids);
+    features.insert(features.end(), fragment_features.begin(), fragment_features.end());
 
-    xcorr_precursor_combined_matrix_.resize(features.size());
-    for (std::size_t i = 0; i < features.size(); i++)
-    { 
-      FeatureType fi = features[i];
-      xcorr_precursor_combined_matrix_[i].resize(features.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < features.size(); j++)
-      {
-        FeatureType fj = features[j];
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute normalized cross correlation
-        xcorr_precursor_combined_matrix_[i][j] = Scoring::normalizedCrossCorrelation(intensityi, intensityj, boost::numeric_cast<int>(intensityi.size()), 1);
-      }
-    }
+    ScoringScratch& scratch = ScoringScratch::threadLocal();
+    ScoringScratch::Frame frame(scratch);
+    IntensityRefs intensities = fetchIntensities(features, scratch);
+    fillXCorrMatrix(intensities, intensities, false, xcorr_precursor_combined_matrix_, scratch);
   }
 
   // see /IMSB/users/reiterl/bin/code/biognosys/trunk/libs/mrm_libs/MRM_pgroup.pm
@@ -710,130 +734,48 @@ namespace OpenSwath
 
   void MRMScoring::initializeMIMatrix(OpenSwath::IMRMFeature* mrmfeature, std::vector<String> native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    mi_matrix_.resize(native_ids.size());
-    for (std::size_t i = 0; i < native_ids.size(); i++)
-    {
-      String native_id = native_ids[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
-      mi_matrix_[i].resize(native_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = i; j < native_ids.size(); j++)
-      {
-        String native_id2 = native_ids[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute ranked mutual information
-        mi_matrix_[i][j] = Scoring::rankedMutualInformation(intensityi, intensityj);
-      }
-    }
+    ScoringScratch& scratch = ScoringScratch::threadLocal();
+    ScoringScratch::Frame frame(scratch);
+    std::vector<std::vector<unsigned int> > ranks = computeRanks(fetchIntensities(getFeatures(mrmfeature, native_ids), scratch));
+    fillMIMatrix(ranks, ranks, true, mi_matrix_);
   }
 
   void MRMScoring::initializeMIContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, std::vector<String> native_ids_set1, std::vector<String> native_ids_set2)
-  { 
-    std::vector<double> intensityi, intensityj;
-    mi_contrast_matrix_.resize(native_ids_set1.size());
-    for (std::size_t i = 0; i < native_ids_set1.size(); i++)
-    { 
-      String native_id = native_ids_set1[i];
-      FeatureType fi = mrmfeature->getFeature(native_id);
-      mi_contrast_matrix_[i].resize(native_ids_set2.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < native_ids_set2.size(); j++)
-      {
-        String native_id2 = native_ids_set2[j];
-        FeatureType fj = mrmfeature->getFeature(native_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute ranked mutual information
-        mi_contrast_matrix_[i][j] = Scoring::rankedMutualInformation(intensityi, intensityj);
-      }
-    }
+  {
+    ScoringScratch& scratch = ScoringScratch::threadLocal();
+    ScoringScratch::Frame frame(scratch);
+    std::vector<std::vector<unsigned int> > ranks1 = computeRanks(fetchIntensities(getFeatures(mrmfeature, native_ids_set1), scratch));
+    std::vector<std::vector<unsigned int> > ranks2 = computeRanks(fetchIntensities(getFeatures(mrmfeature, native_ids_set2), scratch));
+    fillMIMatrix(ranks1, ranks2, false, mi_contrast_matrix_);
   }
 
   void MRMScoring::initializeMIPrecursorMatrix(OpenSwath::IMRMFeature* mrmfeature, std::vector<String> precursor_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    mi_precursor_matrix_.resize(precursor_ids.size());
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    {
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      mi_precursor_matrix_[i].resize(precursor_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = i; j < precursor_ids.size(); j++)
-      {
-        String precursor_id2 = precursor_ids[j];
-        FeatureType fj = mrmfeature->getPrecursorFeature(precursor_id2);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute ranked mutual information
-        mi_precursor_matrix_[i][j] = Scoring::rankedMutualInformation(intensityi, intensityj);
-      }
-    }
+    ScoringScratch& scratch = ScoringScratch::threadLocal();
+    ScoringScratch::Frame frame(scratch);
+    std::vector<std::vector<unsigned int> > ranks = computeRanks(fetchIntensities(getPrecursorFeatures(mrmfeature, precursor_ids), scratch));
+    fillMIMatrix(ranks, ranks, true, mi_precursor_matrix_);
   }
 
   void MRMScoring::initializeMIPrecursorContrastMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    mi_precursor_contrast_matrix_.resize(precursor_ids.size());
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    { 
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      mi_precursor_contrast_matrix_[i].resize(native_ids.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < native_ids.size(); j++)
-      {
-        String native_id = native_ids[j];
-        FeatureType fj = mrmfeature->getFeature(native_id);
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute ranked mutual information
-        mi_precursor_contrast_matrix_[i][j] = Scoring::rankedMutualInformation(intensityi, intensityj);
-      }
-    }
+    ScoringScratch& scratch = ScoringScratch::threadLocal();
+    ScoringScratch::Frame frame(scratch);
+    std::vector<std::vector<unsigned int> > precursor_ranks = computeRanks(fetchIntensities(getPrecursorFeatures(mrmfeature, precursor_ids), scratch));
+    std::vector<std::vector<unsigned int> > fragment_ranks = computeRanks(fetchIntensities(getFeatures(mrmfeature, native_ids), scratch));
+    fillMIMatrix(precursor_ranks, fragment_ranks, false, mi_precursor_contrast_matrix_);
   }
 
   void MRMScoring::initializeMIPrecursorCombinedMatrix(OpenSwath::IMRMFeature* mrmfeature, const std::vector<String>& precursor_ids, const std::vector<String>& native_ids)
   {
-    std::vector<double> intensityi, intensityj;
-    std::vector<FeatureType> features;
-
-    for (std::size_t i = 0; i < precursor_ids.size(); i++)
-    { 
-      String precursor_id = precursor_ids[i];
-      FeatureType fi = mrmfeature->getPrecursorFeature(precursor_id);
-      features.push_back(fi);
-    }
-    for (std::size_t j = 0; j < native_ids.size(); j++)
-    {
-      String native_id = native_ids[j];
-      FeatureType fj = mrmfeature->getFeature(native_id);
-      features.push_back(fj);
-    }
+    std::vector<FeatureType> features = getPrecursorFeatures(mrmfeature, precursor_ids);
+    std::vector<FeatureType> fragment_features = getFeatures(mrmfeature, native_ids);
+    features.insert(features.end(), fragment_features.begin(), fragment_features.end());
 
-    mi_precursor_combined_matrix_.resize(features.size());
-    for (std::size_t i = 0; i < features.size(); i++)
-    { 
-      FeatureType fi = features[i];
-      mi_precursor_combined_matrix_[i].resize(features.size());
-      intensityi.clear();
-      fi->getIntensity(intensityi);
-      for (std::size_t j = 0; j < features.size(); j++)
-      {
-        FeatureType fj = features[j];
-        intensityj.clear();
-        fj->getIntensity(intensityj);
-        // compute ranked mutual information
-        mi_precursor_combined_matrix_[i][j] = Scoring::rankedMutualInformation(intensityi, intensityj);
-      }
-    }
+    ScoringScratch& scratch = ScoringScratch::threadLocal();
+    ScoringScratch::Frame frame(scratch);
+    std::vector<std::vector<unsigned int> > ranks = computeRanks(fetchIntensities(features, scratch));
+    fillMIMatrix(ranks, ranks, false, mi_precursor_combined_matrix_);
   }
 
   double MRMScoring::calcMIScore()
@@ -296,10 +296,17 @@ namespace OpenSwath
       std::vector<unsigned int> int_data1 = computeRank(data1);
       std::vector<unsigned int> int_data2 = computeRank(data2);
 
-      unsigned int* arr_int_data1 = &int_data1[0];
-      unsigned int* arr_int_data2 = &int_data2[0];
+      return rankedMutualInformation(int_data1, int_data2);
+    }
+
+    double rankedMutualInformation(std::vector<unsigned int>& ranks1, std::vector<unsigned int>& ranks2)
+    {
+      OPENSWATH_PRECONDITION(ranks1.size() != 0 && ranks1.size() == ranks2.size(), "Both rank vectors need to have the same length");
+
+      unsigned int* arr_int_data1 = &ranks1[0];
+      unsigned int* arr_int_data2 = &ranks2[0];
 
-      double result = calcMutualInformation(arr_int_data1, arr_int_data2, int_data1.size());
+      double result = calcMutualInformation(arr_int_data1, arr_int_data2, ranks1.size());
 
       return result;
     }
@@ -0,0 +1,114 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/OPENSWATHALGO/ALGO/ScoringScratch.h>
+
+namespace OpenSwath
+{
+
+  ScoringScratch::Frame::Frame(ScoringScratch& scratch) :
+    scratch_(scratch),
+    mark_(scratch.next_)
+  {
+  }
+
+  ScoringScratch::Frame::~Frame()
+  {
+    scratch_.release_(mark_);
+  }
+
+  ScoringScratch& ScoringScratch::threadLocal()
+  {
+    static thread_local ScoringScratch scratch;
+    return scratch;
+  }
+
+  void ScoringScratch::reset()
+  {
+    release_(0);
+    allocations_ = 0;
+  }
+
+  std::vector<double>& ScoringScratch::acquire(std::size_t capacity)
+  {
+    if (next_ == buffers_.size())
+    {
+      buffers_.push_back(std::unique_ptr<std::vector<double> >(new std::vector<double>()));
+      capacities_.push_back(0);
+    }
+    std::vector<double>& buffer = *buffers_[next_];
+    buffer.clear();
+    if (buffer.capacity() < capacity)
+    {
+      buffer.reserve(capacity);
+    }
+    if (buffer.capacity() > capacities_[next_])
+    {
+      ++allocations_;
+      capacities_[next_] = buffer.capacity();
+    }
+    ++next_;
+    return buffer;
+  }
+
+  std::size_t ScoringScratch::getAllocationCount() const
+  {
+    // buffers still in use may have grown since they were handed out
+    std::size_t count = allocations_;
+    for (std::size_t i = 0; i < next_; ++i)
+    {
+      if (buffers_[i]->capacity() > capacities_[i]) ++count;
+    }
+    return count;
+  }
+
+  std::size_t ScoringScratch::getPoolSize() const
+  {
+    return buffers_.size();
+  }
+
+  void ScoringScratch::release_(std::size_t mark)
+  {
+    for (std::size_t i = mark; i < next_; ++i)
+    {
+      if (buffers_[i]->capacity() > capacities_[i])
+      {
+        ++allocations_;
+        capacities_[i] = buffers_[i]->capacity();
+      }
+    }
+    if (mark < next_) next_ = mark;
+  }
+
+}
@@ -39,6 +39,7 @@ set(directory source/OPENSWATHALGO)
 set(sources_algo_list
   ALGO/MRMScoring.cpp
   ALGO/Scoring.cpp
+  ALGO/ScoringScratch.cpp
   ALGO/StatsHelpers.cpp
 )
 
@@ -76,6 +77,7 @@ set(header_directory include/OpenMS/OPENSWATHALGO)
 set(header_algo_list
   ALGO/MRMScoring.h
   ALGO/Scoring.h
+  ALGO/ScoringScratch.h
   ALGO/StatsHelpers.h
 )
 set(header_dataaccess_list
@@ -225,6 +225,7 @@ set(format_executables_list
   MzXMLFile_test
   NoopMSDataConsumer_test
   TraMLValidator_test
+  OMSFile_test
   OMSSACSVFile_test
   OMSSAXMLFile_test
   OSWFile_test
@@ -264,6 +265,7 @@ set(format_executables_list
   MSDataCachedConsumer_test
   MSDataTransformingConsumer_test
   MSDataChainingConsumer_test
+  MSDataParallelConsumer_test
   MSDataStoringConsumer_test
   MSDataAggregatingConsumer_test
   SpectrumAccessQuadMZTransforming_test
@@ -351,6 +353,7 @@ set(filtering_executables_list
   Scaler_test
   SignalToNoiseEstimatorMeanIterative_test
   SignalToNoiseEstimatorMedian_test
+  SignalToNoiseEstimatorMedianExact_test
   SignalToNoiseEstimatorMedianRapid_test
   SignalToNoiseEstimator_test
   SqrtMower_test
@@ -388,7 +391,9 @@ set(comparison_executables_list
 set(chemistry_executables_list
   AAIndex_test
   AASequence_test
+  AveragineIsotopeTable_test
   CoarseIsotopeDistribution_test
+  CompactAASequence_test
   CrossLinksDB_test
   DecoyGenerator_test
   DigestionEnzymeProtein_test
@@ -398,6 +403,7 @@ set(chemistry_executables_list
   EnzymaticDigestionLogModel_test
   EnzymaticDigestion_test
   FineIsotopeDistribution_test
+  FineIsotopePatternCache_test
   IMSAlphabetParser_test
   IMSAlphabetTextParser_test
   IMSAlphabet_test
@@ -524,6 +530,7 @@ set(analysis_executables_list
   MassDecompositionAlgorithm_test
   MassDecomposition_test
   MetaboliteFeatureDeconvolution_test
+  MetaboliteSpectralLibraryIndex_test
   MetaboliteSpectralMatching_test
   ModifiedPeptideGenerator_test
   OfflinePrecursorIonSelection_test
@@ -669,6 +676,7 @@ if(NOT DISABLE_OPENSWATH)
     DIAPrescoring_test
     OpenSwathMRMFeatureAccessOpenMS_test
     SpectrumAddition_test
+    SwathSpectrumCache_test
     TargetedSpectraExtractor_test
     OpenSwathSpectrumAccessOpenMS_test
     OpenSwathDataAccessHelper_test
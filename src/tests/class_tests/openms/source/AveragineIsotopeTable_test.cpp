@@ -0,0 +1,236 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/AveragineIsotopeTable.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/CoarseIsotopePatternGenerator.h>
+///////////////////////////
+
+#include <fstream>
+#include <iterator>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(AveragineIsotopeTable, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+AveragineIsotopeTable* ptr = nullptr;
+AveragineIsotopeTable* null_ptr = nullptr;
+START_SECTION((AveragineIsotopeTable(AveragineModel model, double mass_resolution, double max_mass, Size max_isotopes)))
+{
+  ptr = new AveragineIsotopeTable(AveragineIsotopeTable::PEPTIDE, 1.0, 3000.0, 10);
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EXCEPTION(Exception::InvalidValue, AveragineIsotopeTable(AveragineIsotopeTable::PEPTIDE, 0.0, 3000.0, 10))
+  TEST_EXCEPTION(Exception::InvalidValue, AveragineIsotopeTable(AveragineIsotopeTable::PEPTIDE, 1.0, 0.5, 10))
+  TEST_EXCEPTION(Exception::InvalidValue, AveragineIsotopeTable(AveragineIsotopeTable::PEPTIDE, 1.0, 3000.0, 0))
+}
+END_SECTION
+
+START_SECTION((AveragineModel getModel() const))
+  TEST_EQUAL(ptr->getModel(), AveragineIsotopeTable::PEPTIDE)
+END_SECTION
+
+START_SECTION((double getMassResolution() const))
+  TEST_REAL_SIMILAR(ptr->getMassResolution(), 1.0)
+END_SECTION
+
+START_SECTION((double getMaxMass() const))
+  TEST_REAL_SIMILAR(ptr->getMaxMass(), 3000.0)
+END_SECTION
+
+START_SECTION((Size getMaxIsotopes() const))
+  TEST_EQUAL(ptr->getMaxIsotopes(), 10)
+END_SECTION
+
+START_SECTION((void getIntensities(double mass, Size n_isotopes, std::vector<double>& intensities) const))
+{
+  vector<double> intensities;
+
+  // at the precomputed masses, the patterns are the ones of the generator
+  // (also when using fewer isotopes than stored)
+  Size n_isotopes[] = {10, 4};
+  double masses[] = {500.0, 1234.0, 2999.0};
+  for (Size n : n_isotopes)
+  {
+    for (double mass : masses)
+    {
+      IsotopeDistribution exact = CoarseIsotopePatternGenerator(n).estimateFromPeptideWeight(mass);
+      ptr->getIntensities(mass, n, intensities);
+      TEST_EQUAL(intensities.size(), exact.size())
+      for (Size i = 0; i < intensities.size(); ++i)
+      {
+        TEST_REAL_SIMILAR(intensities[i], exact[i].getIntensity())
+      }
+    }
+  }
+
+  // in between, they are interpolated (and normalized)
+  vector<double> left, right;
+  ptr->getIntensities(1234.0, 5, left);
+  ptr->getIntensities(1235.0, 5, right);
+  ptr->getIntensities(1234.25, 5, intensities);
+  TEST_EQUAL(intensities.size(), 5)
+  double sum = 0.0;
+  for (Size i = 0; i < intensities.size(); ++i)
+  {
+    TEST_EQUAL(intensities[i] >= min(left[i], right[i]) - 1e-12, true)
+    TEST_EQUAL(intensities[i] <= max(left[i], right[i]) + 1e-12, true)
+    sum += intensities[i];
+  }
+  TEST_REAL_SIMILAR(sum, 1.0)
+
+  // beyond the table, the pattern is computed directly
+  IsotopeDistribution exact = CoarseIsotopePatternGenerator(6).estimateFromPeptideWeight(4321.5);
+  ptr->getIntensities(4321.5, 6, intensities);
+  TEST_EQUAL(intensities.size(), exact.size())
+  for (Size i = 0; i < intensities.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(intensities[i], exact[i].getIntensity())
+  }
+
+  TEST_EXCEPTION(Exception::InvalidValue, ptr->getIntensities(1000.0, 11, intensities))
+
+  // other models
+  AveragineIsotopeTable rna(AveragineIsotopeTable::RNA, 2.0, 5000.0, 5);
+  exact = CoarseIsotopePatternGenerator(5).estimateFromRNAWeight(3000.0);
+  rna.getIntensities(3000.0, 5, intensities);
+  TEST_EQUAL(intensities.size(), exact.size())
+  for (Size i = 0; i < intensities.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(intensities[i], exact[i].getIntensity())
+  }
+}
+END_SECTION
+
+START_SECTION((void store(const String& filename) const))
+{
+  String filename;
+  NEW_TMP_FILE(filename)
+  ptr->store(filename);
+
+  AveragineIsotopeTable loaded(filename);
+  TEST_EQUAL(loaded.getModel(), ptr->getModel())
+  TEST_REAL_SIMILAR(loaded.getMassResolution(), ptr->getMassResolution())
+  TEST_REAL_SIMILAR(loaded.getMaxMass(), ptr->getMaxMass())
+  TEST_EQUAL(loaded.getMaxIsotopes(), ptr->getMaxIsotopes())
+
+  vector<double> expected, intensities;
+  for (double mass = 0.0; mass < 3000.0; mass += 17.3)
+  {
+    ptr->getIntensities(mass, 10, expected);
+    loaded.getIntensities(mass, 10, intensities);
+    TEST_EQUAL(intensities == expected, true)
+  }
+}
+END_SECTION
+
+START_SECTION((explicit AveragineIsotopeTable(const String& filename)))
+{
+  TEST_EXCEPTION(Exception::FileNotFound, AveragineIsotopeTable("this_file_does_not_exist.bin"))
+  TEST_EXCEPTION(Exception::ParseError, AveragineIsotopeTable(OPENMS_GET_TEST_DATA_PATH("ConsensusXMLFile_1.consensusXML")))
+  // loading of a stored table: see store()
+
+  // header dimensions that do not match the file size
+  String filename, corrupted;
+  NEW_TMP_FILE(filename)
+  NEW_TMP_FILE(corrupted)
+  AveragineIsotopeTable(AveragineIsotopeTable::PEPTIDE, 10.0, 1000.0, 5).store(filename);
+  string bytes;
+  {
+    ifstream ifs(filename.c_str(), ios::binary);
+    bytes.assign(istreambuf_iterator<char>(ifs), istreambuf_iterator<char>());
+  }
+  // layout: identifier (int), model (int), mass resolution (double), number of masses, max. isotopes
+  const Size n_masses_offset = 2 * sizeof(int) + sizeof(double);
+
+  string header = bytes;
+  Size huge = Size(1) << 60;
+  header.replace(n_masses_offset, sizeof(Size), (const char*)&huge, sizeof(Size));
+  ofstream(corrupted.c_str(), ios::binary) << header;
+  TEST_EXCEPTION(Exception::ParseError, AveragineIsotopeTable table(corrupted))
+
+  header = bytes;
+  header.replace(n_masses_offset + sizeof(Size), sizeof(Size), (const char*)&huge, sizeof(Size));
+  ofstream(corrupted.c_str(), ios::binary) << header;
+  TEST_EXCEPTION(Exception::ParseError, AveragineIsotopeTable table(corrupted))
+
+  ofstream(corrupted.c_str(), ios::binary) << bytes.substr(0, bytes.size() - 1);
+  TEST_EXCEPTION(Exception::ParseError, AveragineIsotopeTable table(corrupted))
+
+  ofstream(corrupted.c_str(), ios::binary) << bytes;
+  AveragineIsotopeTable table(corrupted);
+  TEST_EQUAL(table.getMaxIsotopes(), 5)
+}
+END_SECTION
+
+START_SECTION((static const AveragineIsotopeTable& getTable(AveragineModel model, double mass_resolution = 1.0, double max_mass = 10000.0, Size max_isotopes = 20)))
+{
+  const AveragineIsotopeTable& table = AveragineIsotopeTable::getTable(AveragineIsotopeTable::DNA, 5.0, 2000.0, 8);
+  TEST_EQUAL(table.getModel(), AveragineIsotopeTable::DNA)
+  TEST_REAL_SIMILAR(table.getMassResolution(), 5.0)
+  TEST_REAL_SIMILAR(table.getMaxMass(), 2000.0)
+  TEST_EQUAL(table.getMaxIsotopes(), 8)
+
+  // a covered request returns the same table
+  TEST_EQUAL(&AveragineIsotopeTable::getTable(AveragineIsotopeTable::DNA, 5.0, 1500.0, 6), &table)
+  // other requests don't
+  TEST_NOT_EQUAL(&AveragineIsotopeTable::getTable(AveragineIsotopeTable::DNA, 5.0, 2500.0, 8), &table)
+  TEST_NOT_EQUAL(&AveragineIsotopeTable::getTable(AveragineIsotopeTable::DNA, 2.5, 1500.0, 8), &table)
+  TEST_NOT_EQUAL(&AveragineIsotopeTable::getTable(AveragineIsotopeTable::RNA, 5.0, 1500.0, 8), &table)
+}
+END_SECTION
+
+START_SECTION((static const AveragineIsotopeTable& registerTable(const String& filename)))
+{
+  String filename;
+  NEW_TMP_FILE(filename)
+  AveragineIsotopeTable(AveragineIsotopeTable::PEPTIDE, 0.25, 1000.0, 12).store(filename);
+
+  const AveragineIsotopeTable& table = AveragineIsotopeTable::registerTable(filename);
+  TEST_REAL_SIMILAR(table.getMassResolution(), 0.25)
+  TEST_EQUAL(&AveragineIsotopeTable::getTable(AveragineIsotopeTable::PEPTIDE, 0.25, 800.0, 10), &table)
+}
+END_SECTION
+
+delete ptr;
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -73,6 +73,64 @@ START_TEST(BayesianProteinInferenceAlgorithm, "$Id$")
         }
     END_SECTION
 
+    START_SECTION(BayesianProteinInferenceAlgorithm test parallel grid search)
+        {
+          vector<ProteinIdentification> prots;
+          vector<PeptideIdentification> peps;
+          IdXMLFile idf;
+          idf.load(OPENMS_GET_TEST_DATA_PATH("BayesianProteinInference_test.idXML"),prots,peps);
+          BayesianProteinInferenceAlgorithm bpia;
+          Param p = bpia.getParameters();
+          p.setValue("update_PSM_probabilities", "false");
+          p.setValue("param_optimize:parallel_grid_search", "true");
+          bpia.setParameters(p);
+          bpia.inferPosteriorProbabilities(prots,peps);
+          // same result as the serial grid search
+          TEST_EQUAL(peps.size(), 9)
+          TEST_EQUAL(peps[0].getHits()[0].getScore(), 0.6)
+          TEST_REAL_SIMILAR(prots[0].getHits()[0].getScore(), 0.624641)
+          TEST_REAL_SIMILAR(prots[0].getHits()[1].getScore(), 0.648346)
+        }
+    END_SECTION
+
+    START_SECTION(BayesianProteinInferenceAlgorithm test parallel grid search with group annotation)
+        {
+          // the parallel grid search has to optimize the same objective as the serial one
+          vector<ProteinIdentification> prots_serial, prots_parallel;
+          vector<PeptideIdentification> peps_serial, peps_parallel;
+          IdXMLFile idf;
+          idf.load(OPENMS_GET_TEST_DATA_PATH("BayesianProteinInference_test.idXML"), prots_serial, peps_serial);
+          idf.load(OPENMS_GET_TEST_DATA_PATH("BayesianProteinInference_test.idXML"), prots_parallel, peps_parallel);
+          BayesianProteinInferenceAlgorithm bpia;
+          Param p = bpia.getParameters();
+          p.setValue("update_PSM_probabilities", "false");
+          p.setValue("annotate_group_probabilities", "true");
+          bpia.setParameters(p);
+          bpia.inferPosteriorProbabilities(prots_serial, peps_serial);
+          p.setValue("param_optimize:parallel_grid_search", "true");
+          bpia.setParameters(p);
+          bpia.inferPosteriorProbabilities(prots_parallel, peps_parallel);
+
+          // identical posteriors imply that the same parameters were picked
+          TEST_EQUAL(prots_parallel[0].getHits().size(), prots_serial[0].getHits().size())
+          ABORT_IF(prots_parallel[0].getHits().size() != prots_serial[0].getHits().size())
+          for (Size i = 0; i < prots_serial[0].getHits().size(); ++i)
+          {
+            TEST_STRING_EQUAL(prots_parallel[0].getHits()[i].getAccession(), prots_serial[0].getHits()[i].getAccession())
+            TEST_REAL_SIMILAR(prots_parallel[0].getHits()[i].getScore(), prots_serial[0].getHits()[i].getScore())
+          }
+          const vector<ProteinIdentification::ProteinGroup>& groups_serial = prots_serial[0].getIndistinguishableProteins();
+          const vector<ProteinIdentification::ProteinGroup>& groups_parallel = prots_parallel[0].getIndistinguishableProteins();
+          TEST_EQUAL(groups_parallel.size(), groups_serial.size())
+          ABORT_IF(groups_parallel.size() != groups_serial.size())
+          for (Size i = 0; i < groups_serial.size(); ++i)
+          {
+            TEST_EQUAL(groups_parallel[i].accessions == groups_serial[i].accessions, true)
+            TEST_REAL_SIMILAR(groups_parallel[i].probability, groups_serial[i].probability)
+          }
+        }
+    END_SECTION
+
     START_SECTION(BayesianProteinInferenceAlgorithm test2)
         {
           vector<ProteinIdentification> prots;
@@ -0,0 +1,244 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+
+#include <OpenMS/CHEMISTRY/CompactAASequence.h>
+#include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/CHEMISTRY/ResidueDB.h>
+
+#include <map>
+
+using namespace OpenMS;
+using namespace std;
+
+///////////////////////////
+
+START_TEST(CompactAASequence, "$Id$")
+
+/////////////////////////////////////////////////////////////
+
+CompactAASequence* ptr = nullptr;
+CompactAASequence* nullPointer = nullptr;
+START_SECTION(CompactAASequence())
+  ptr = new CompactAASequence();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->empty(), true)
+  TEST_EQUAL(ptr->size(), 0)
+END_SECTION
+
+START_SECTION(~CompactAASequence())
+  delete ptr;
+END_SECTION
+
+const AASequence modified = AASequence::fromString(".(Acetyl)PEPTM(Oxidation)IDEK.(Amidated)");
+
+START_SECTION(explicit CompactAASequence(const AASequence& seq))
+  CompactAASequence seq(modified);
+  TEST_EQUAL(seq.size(), modified.size())
+  TEST_EQUAL(seq.getNTerminalModification(), modified.getNTerminalModification())
+  TEST_EQUAL(seq.getCTerminalModification(), modified.getCTerminalModification())
+  for (Size i = 0; i != seq.size(); ++i)
+  {
+    TEST_EQUAL(&seq.getResidue(i), &modified[i])
+  }
+END_SECTION
+
+START_SECTION(CompactAASequence(const CompactAASequence& rhs))
+  CompactAASequence seq(modified);
+  TEST_EQUAL(seq.getPrefixMonoMasses().size(), modified.size())
+  CompactAASequence copy(seq);
+  TEST_EQUAL(copy == seq, true)
+  TEST_EQUAL(copy.getPrefixMonoMasses() == seq.getPrefixMonoMasses(), true)
+END_SECTION
+
+START_SECTION(CompactAASequence& operator=(const CompactAASequence& rhs))
+  CompactAASequence seq(modified);
+  CompactAASequence other = CompactAASequence::fromString("ACDEFGHIK");
+  TEST_EQUAL(other.getPrefixMonoMasses().size(), 9)
+  other = seq;
+  TEST_EQUAL(other == seq, true)
+  TEST_EQUAL(other.getPrefixMonoMasses().size(), seq.size())
+END_SECTION
+
+START_SECTION(static CompactAASequence fromString(const String& s, bool permissive = true))
+  CompactAASequence seq = CompactAASequence::fromString(".(Acetyl)PEPTM(Oxidation)IDEK.(Amidated)");
+  TEST_EQUAL(seq == CompactAASequence(modified), true)
+  TEST_EXCEPTION(Exception::ParseError, CompactAASequence::fromString("blDABCDEF"))
+END_SECTION
+
+START_SECTION(AASequence toAASequence() const)
+  CompactAASequence seq(modified);
+  TEST_EQUAL(seq.toAASequence(), modified)
+  TEST_EQUAL(CompactAASequence().toAASequence(), AASequence())
+END_SECTION
+
+START_SECTION(String toString() const)
+  CompactAASequence seq(modified);
+  TEST_STRING_EQUAL(seq.toString(), modified.toString())
+END_SECTION
+
+START_SECTION(const Residue& getResidue(Size index) const)
+  CompactAASequence seq = CompactAASequence::fromString("PEPM(Oxidation)");
+  TEST_EQUAL(seq.getResidue(0).getOneLetterCode(), "P")
+  TEST_EQUAL(seq.getResidue(3).isModified(), true)
+  TEST_EXCEPTION(Exception::IndexOverflow, seq.getResidue(4))
+END_SECTION
+
+START_SECTION(bool has(const Residue& residue) const)
+  CompactAASequence seq = CompactAASequence::fromString("PEPTIDE");
+  TEST_EQUAL(seq.has(*ResidueDB::getInstance()->getResidue('P')), true)
+  TEST_EQUAL(seq.has(*ResidueDB::getInstance()->getResidue('K')), false)
+END_SECTION
+
+START_SECTION(double getMonoWeight(Residue::ResidueType type = Residue::Full, Int charge = 0) const)
+  CompactAASequence seq(modified);
+  TOLERANCE_ABSOLUTE(1e-6)
+  TEST_REAL_SIMILAR(seq.getMonoWeight(), modified.getMonoWeight())
+  TEST_REAL_SIMILAR(seq.getMonoWeight(Residue::Full, 2), modified.getMonoWeight(Residue::Full, 2))
+  TEST_REAL_SIMILAR(seq.getMonoWeight(Residue::Internal), modified.getMonoWeight(Residue::Internal))
+  TEST_REAL_SIMILAR(seq.getMonoWeight(Residue::BIon, 1), modified.getMonoWeight(Residue::BIon, 1))
+  TEST_REAL_SIMILAR(seq.getMonoWeight(Residue::YIon, 1), modified.getMonoWeight(Residue::YIon, 1))
+  TEST_REAL_SIMILAR(seq.getMonoWeight(Residue::ZIon, 3), modified.getMonoWeight(Residue::ZIon, 3))
+  TEST_EXCEPTION(Exception::InvalidValue, CompactAASequence::fromString("PEPTIXDE").getMonoWeight())
+  // tags with a known mass are fine
+  TEST_REAL_SIMILAR(CompactAASequence::fromString("PEPTX[123.0]DE").getMonoWeight(), AASequence::fromString("PEPTX[123.0]DE").getMonoWeight())
+END_SECTION
+
+START_SECTION(double getAverageWeight(Residue::ResidueType type = Residue::Full, Int charge = 0) const)
+  CompactAASequence seq(modified);
+  TOLERANCE_ABSOLUTE(1e-4)
+  TEST_REAL_SIMILAR(seq.getAverageWeight(), modified.getAverageWeight())
+  TEST_REAL_SIMILAR(seq.getAverageWeight(Residue::YIon, 2), modified.getAverageWeight(Residue::YIon, 2))
+END_SECTION
+
+START_SECTION(double getMZ(Int charge, Residue::ResidueType type = Residue::Full) const)
+  CompactAASequence seq(modified);
+  TEST_REAL_SIMILAR(seq.getMZ(2), modified.getMZ(2))
+  TEST_EXCEPTION(Exception::InvalidValue, seq.getMZ(0))
+END_SECTION
+
+START_SECTION(const std::vector<double>& getPrefixMonoMasses() const)
+  CompactAASequence seq = CompactAASequence::fromString("PEPTIDE");
+  const vector<double>& prefix = seq.getPrefixMonoMasses();
+  TEST_EQUAL(prefix.size(), 7)
+  TEST_REAL_SIMILAR(prefix[0], ResidueDB::getInstance()->getResidue('P')->getMonoWeight(Residue::Internal))
+  TEST_REAL_SIMILAR(prefix.back(), seq.getMonoWeight(Residue::Internal))
+  // repeated calls return the cached array
+  TEST_EQUAL(&seq.getPrefixMonoMasses(), &prefix)
+END_SECTION
+
+START_SECTION(double getPrefixMonoWeight(Size length, Residue::ResidueType type = Residue::BIon, Int charge = 0) const)
+  CompactAASequence seq(modified);
+  TOLERANCE_ABSOLUTE(1e-6)
+  for (Size i = 1; i <= modified.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(seq.getPrefixMonoWeight(i, Residue::BIon, 1), modified.getPrefix(i).getMonoWeight(Residue::BIon, 1))
+    TEST_REAL_SIMILAR(seq.getPrefixMonoWeight(i, Residue::AIon, 2), modified.getPrefix(i).getMonoWeight(Residue::AIon, 2))
+  }
+  TEST_EXCEPTION(Exception::IndexOverflow, seq.getPrefixMonoWeight(0))
+  TEST_EXCEPTION(Exception::IndexOverflow, seq.getPrefixMonoWeight(modified.size() + 1))
+END_SECTION
+
+START_SECTION(double getSuffixMonoWeight(Size length, Residue::ResidueType type = Residue::YIon, Int charge = 0) const)
+  CompactAASequence seq(modified);
+  TOLERANCE_ABSOLUTE(1e-6)
+  for (Size i = 1; i <= modified.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(seq.getSuffixMonoWeight(i, Residue::YIon, 1), modified.getSuffix(i).getMonoWeight(Residue::YIon, 1))
+    TEST_REAL_SIMILAR(seq.getSuffixMonoWeight(i, Residue::XIon, 2), modified.getSuffix(i).getMonoWeight(Residue::XIon, 2))
+  }
+  TEST_EXCEPTION(Exception::IndexOverflow, seq.getSuffixMonoWeight(0))
+END_SECTION
+
+START_SECTION(bool operator==(const CompactAASequence& rhs) const)
+  TEST_EQUAL(CompactAASequence::fromString("PEPTIDE") == CompactAASequence::fromString("PEPTIDE"), true)
+  TEST_EQUAL(CompactAASequence::fromString("PEPTIDE") == CompactAASequence::fromString("PEPTIDEK"), false)
+  TEST_EQUAL(CompactAASequence::fromString("PEPM(Oxidation)") == CompactAASequence::fromString("PEPM"), false)
+  TEST_EQUAL(CompactAASequence::fromString(".(Acetyl)PEPM") == CompactAASequence::fromString("PEPM"), false)
+END_SECTION
+
+START_SECTION(bool operator!=(const CompactAASequence& rhs) const)
+  TEST_EQUAL(CompactAASequence::fromString("PEPTIDE") != CompactAASequence::fromString("PEPTIDE"), false)
+  TEST_EQUAL(CompactAASequence::fromString("PEPTIDE") != CompactAASequence::fromString("PEPTIDEK"), true)
+END_SECTION
+
+START_SECTION(bool operator<(const CompactAASequence& rhs) const)
+  CompactAASequence a = CompactAASequence::fromString("PEPTIDE");
+  CompactAASequence b = CompactAASequence::fromString("PEPTIDEK");
+  CompactAASequence c = CompactAASequence::fromString("PEPM(Oxidation)IDE");
+  TEST_EQUAL(a < b, true)
+  TEST_EQUAL(b < a, false)
+  TEST_EQUAL(a < a, false)
+  TEST_EQUAL((a < c) != (c < a), true)
+
+  map<CompactAASequence, Size> m;
+  m[a] = 1;
+  m[b] = 2;
+  m[c] = 3;
+  m[CompactAASequence::fromString("PEPTIDE")] = 4;
+  TEST_EQUAL(m.size(), 3)
+  TEST_EQUAL(m[a], 4)
+END_SECTION
+
+START_SECTION(static ResidueIndex internResidue(const Residue* residue))
+  const Residue* r = ResidueDB::getInstance()->getResidue('W');
+  CompactAASequence::ResidueIndex index = CompactAASequence::internResidue(r);
+  TEST_EQUAL(CompactAASequence::internResidue(r), index)
+  TEST_EQUAL(CompactAASequence::fromString("W").getResidueIndex(0), index)
+END_SECTION
+
+START_SECTION(static const Residue* getResidueByIndex(ResidueIndex index))
+  const Residue* r = ResidueDB::getInstance()->getResidue('W');
+  TEST_EQUAL(CompactAASequence::getResidueByIndex(CompactAASequence::internResidue(r)), r)
+END_SECTION
+
+START_SECTION(static double getInternalMonoWeight(ResidueIndex index))
+  const Residue* r = ResidueDB::getInstance()->getResidue('W');
+  TEST_REAL_SIMILAR(CompactAASequence::getInternalMonoWeight(CompactAASequence::internResidue(r)), r->getMonoWeight(Residue::Internal))
+END_SECTION
+
+START_SECTION(static Size getNumberOfInternedResidues())
+  Size before = CompactAASequence::getNumberOfInternedResidues();
+  CompactAASequence::fromString("WWWW");
+  TEST_EQUAL(CompactAASequence::getNumberOfInternedResidues() >= before, true)
+  TEST_EQUAL(CompactAASequence::getNumberOfInternedResidues() > 0, true)
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
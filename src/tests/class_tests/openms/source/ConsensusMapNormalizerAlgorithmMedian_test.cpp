@@ -79,6 +79,56 @@ START_SECTION((static std::vector<double> computeNormalizationFactors(const Cons
 }
 END_SECTION
 
+START_SECTION((static std::vector<char> computeFilterResults_(const ConsensusMap& map, const String& acc_filter, const String& desc_filter)))
+{
+  ConsensusMap map;
+  map.getProteinIdentifications().resize(1);
+  ProteinHit prot_hit;
+  prot_hit.setAccession("P1");
+  prot_hit.setDescription("keratin");
+  map.getProteinIdentifications()[0].insertHit(prot_hit);
+  prot_hit.setAccession("P2");
+  prot_hit.setDescription("albumin");
+  map.getProteinIdentifications()[0].insertHit(prot_hit);
+
+  // features identified as P1, P2, P1+P3, and an unidentified feature
+  vector<vector<String> > accessions = { {"P1"}, {"P2"}, {"P1", "P3"}, {} };
+  for (const vector<String>& accs : accessions)
+  {
+    ConsensusFeature cf;
+    if (!accs.empty())
+    {
+      PeptideHit pep_hit;
+      for (const String& acc : accs)
+      {
+        PeptideEvidence pe;
+        pe.setProteinAccession(acc);
+        pep_hit.addPeptideEvidence(pe);
+      }
+      PeptideIdentification pep_id;
+      pep_id.insertHit(pep_hit);
+      cf.getPeptideIdentifications().push_back(pep_id);
+    }
+    map.push_back(cf);
+  }
+
+  vector<pair<String, String> > filters = { {"", ""}, {"P1", ""}, {"P[23]", ""}, {"", "albumin"}, {"P", "ker"}, {"P3", "keratin"} };
+  for (const pair<String, String>& filter : filters)
+  {
+    vector<char> passes = ConsensusMapNormalizerAlgorithmMedian::computeFilterResults_(map, filter.first, filter.second);
+    TEST_EQUAL(passes.size(), map.size())
+    for (Size i = 0; i < map.size(); ++i)
+    {
+      TEST_EQUAL(bool(passes[i]), ConsensusMapNormalizerAlgorithmMedian::passesFilters_(map.begin() + i, map, filter.first, filter.second))
+    }
+  }
+  vector<char> passes = ConsensusMapNormalizerAlgorithmMedian::computeFilterResults_(map, "", "albumin");
+  TEST_EQUAL(bool(passes[0]), false)
+  TEST_EQUAL(bool(passes[1]), true)
+  TEST_EQUAL(bool(passes[2]), false)
+  TEST_EQUAL(bool(passes[3]), false)
+}
+END_SECTION
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
@@ -135,6 +135,27 @@ START_SECTION(double eval(double x))
   }
 END_SECTION
 
+START_SECTION(double eval(double x, size_t& segment))
+  // ascending positions (including the nodes), reusing the segment
+  size_t segment = 0;
+  for (Size i = 0; i <= 4 * n; ++i)
+  {
+    double xx = x_min + (double)i / (4 * n) * (x_max - x_min);
+    TEST_EQUAL(sp5.eval(xx, segment), sp5.eval(xx));
+  }
+  TEST_EQUAL(segment, n - 1);
+  // descending and jumping positions (invalid hints)
+  for (Size i = 0; i <= 4 * n; ++i)
+  {
+    double xx = x_max - (double)((i * 7) % (4 * n + 1)) / (4 * n) * (x_max - x_min);
+    TEST_EQUAL(sp5.eval(xx, segment), sp5.eval(xx));
+  }
+  segment = 1000;
+  TEST_EQUAL(sp1.eval(486.794, segment), sp1.eval(486.794));
+  TEST_EQUAL(segment, 3);
+  TEST_EXCEPTION(Exception::IllegalArgument, sp1.eval(486.7, segment));
+END_SECTION
+
 START_SECTION(double derivatives(double x, unsigned order))
   // near border of spline range
   TEST_REAL_SIMILAR(sp1.derivatives(486.785,1), 39270152.2996247)
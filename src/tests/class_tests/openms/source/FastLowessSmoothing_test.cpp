@@ -41,6 +41,10 @@
 #include <boost/random/normal_distribution.hpp>
 ///////////////////////////
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace OpenMS;
 using namespace std;
 
@@ -246,6 +250,53 @@ START_SECTION([FastLowessSmoothing]void smoothData(const DoubleVector&, const Do
 }
 END_SECTION
 
+// large input: the local regressions are computed in parallel (number of
+// fits x neighborhood size is above the threshold), results must not depend
+// on the number of threads
+START_SECTION([FastLowessSmoothing_parallel]void smoothData(const DoubleVector&, const DoubleVector&, DoubleVector&))
+{
+  std::vector<double> x, y, out_serial, out_parallel;
+
+  // noisy data with some repeated x values
+  boost::random::mt19937 rnd_gen_;
+  for (Size i = 1; i <= 20000; ++i)
+  {
+    double xi = (i - i % 7 / 6) / 1000.0;
+    boost::normal_distribution<double> udist(targetFunction(xi), 0.5);
+    x.push_back(xi);
+    y.push_back(udist(rnd_gen_));
+  }
+
+#ifdef _OPENMP
+  int threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+  FastLowessSmoothing::lowess(x, y, 0.01, 3, 0.0, out_serial);
+#ifdef _OPENMP
+  omp_set_num_threads(4);
+#endif
+  FastLowessSmoothing::lowess(x, y, 0.01, 3, 0.0, out_parallel);
+#ifdef _OPENMP
+  omp_set_num_threads(threads);
+#endif
+
+  TEST_EQUAL(out_parallel.size(), x.size())
+  TEST_EQUAL(out_serial.size(), out_parallel.size())
+  Size n_different = 0;
+  for (Size i = 0; i < out_serial.size(); ++i)
+  {
+    if (out_serial[i] != out_parallel[i]) ++n_different;
+  }
+  TEST_EQUAL(n_different, 0)
+
+  // the parallel fit is still a sensible smooth
+  for (Size i = 0; i < out_parallel.size(); i += 1000)
+  {
+    TEST_REAL_SIMILAR(out_parallel[i], targetFunction(x[i]))
+  }
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
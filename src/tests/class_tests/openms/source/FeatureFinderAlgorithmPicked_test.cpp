@@ -43,6 +43,10 @@
 #include <OpenMS/FORMAT/MzDataFile.h>
 #include <OpenMS/FORMAT/ParamXMLFile.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 START_TEST(FeatureFinderAlgorithmPicked, "$Id$")
 
 /////////////////////////////////////////////////////////////
@@ -123,6 +127,55 @@ START_SECTION((virtual void run()))
 
 END_SECTION
 
+START_SECTION(([EXTRA] run() gives the same features independent of the number of threads))
+{
+#ifdef _OPENMP
+  PeakMap input;
+  MzDataFile mzdata_file;
+  mzdata_file.getOptions().addMSLevel(1);
+  mzdata_file.load(OPENMS_GET_TEST_DATA_PATH("FeatureFinderAlgorithmPicked.mzData"),input);
+  input.updateRanges(1);
+
+  Param param;
+  ParamXMLFile paramFile;
+  paramFile.load(OPENMS_GET_TEST_DATA_PATH("FeatureFinderAlgorithmPicked.ini"), param);
+  param = param.copy("FeatureFinder:1:algorithm:",true);
+  FeatureFinder ff;
+
+  int threads = omp_get_max_threads();
+
+  // seeds are resolved in intensity order, so the accepted features must not depend on the scheduling
+  omp_set_num_threads(1);
+  FeatureMap single;
+  FFPP ffpp_single;
+  ffpp_single.setParameters(param);
+  ffpp_single.setData(input, single, ff);
+  ffpp_single.run();
+
+  omp_set_num_threads(4);
+  FeatureMap multi;
+  FFPP ffpp_multi;
+  ffpp_multi.setParameters(param);
+  ffpp_multi.setData(input, multi, ff);
+  ffpp_multi.run();
+
+  omp_set_num_threads(threads);
+
+  TEST_EQUAL(single.size(), 8)
+  ABORT_IF(single.size() != multi.size())
+  for (Size i = 0; i < single.size(); ++i)
+  {
+    TEST_EQUAL(multi[i].getRT(), single[i].getRT())
+    TEST_EQUAL(multi[i].getMZ(), single[i].getMZ())
+    TEST_EQUAL(multi[i].getCharge(), single[i].getCharge())
+    TEST_EQUAL(multi[i].getIntensity(), single[i].getIntensity())
+    TEST_EQUAL(multi[i].getOverallQuality(), single[i].getOverallQuality())
+    TEST_EQUAL(multi[i].getConvexHulls().size(), single[i].getConvexHulls().size())
+  }
+#endif
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 
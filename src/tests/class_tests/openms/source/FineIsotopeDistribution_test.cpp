@@ -39,6 +39,7 @@
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/FineIsotopePatternGenerator.h>
 ///////////////////////////
 
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/FineIsotopePatternCache.h>
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsotopeDistribution.h>
 #include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/IsoSpecWrapper.h>
 #include <OpenMS/CHEMISTRY/Element.h>
@@ -461,6 +462,102 @@ START_SECTION(( void setAbsolute(bool absolute) ))
 }
 END_SECTION
 
+START_SECTION(( std::vector<IsotopeDistribution> run(const std::vector<EmpiricalFormula>& formulas) const ))
+{
+  vector<EmpiricalFormula> formulas;
+  formulas.push_back(EmpiricalFormula("C6H12O6"));
+  formulas.push_back(EmpiricalFormula("C100H202"));
+  formulas.push_back(EmpiricalFormula("C6H12O6"));
+  formulas.push_back(EmpiricalFormula("C520H817N139O147S8"));
+
+  FineIsotopePatternGenerator gen(1e-3, false, false);
+  vector<IsotopeDistribution> ids = gen.run(formulas);
+  TEST_EQUAL(ids.size(), formulas.size())
+  for (Size i = 0; i < formulas.size(); ++i)
+  {
+    IsotopeDistribution id = gen.run(formulas[i]);
+    TEST_EQUAL(ids[i].size(), id.size())
+    TEST_EQUAL(ids[i] == id, true)
+  }
+  TEST_EQUAL(ids[3].size(), 151)
+
+  TEST_EQUAL(gen.run(vector<EmpiricalFormula>()).size(), 0)
+}
+END_SECTION
+
+START_SECTION(( void setMaxIsotopes(Size max_isotopes) ))
+{
+  FineIsotopePatternGenerator gen(0.01, false, false);
+  TEST_EQUAL(gen.getMaxIsotopes(), 0)
+  gen.setMaxIsotopes(100);
+  TEST_EQUAL(gen.getMaxIsotopes(), 100)
+
+  // limit is not reached: same result as without limit
+  EmpiricalFormula ef("C6H12O6");
+  IsotopeDistribution id = gen.run(ef);
+  TEST_EQUAL(id.size(), 3)
+  TEST_REAL_SIMILAR(id[0].getMZ(), 180.063)
+  TEST_REAL_SIMILAR(id[0].getIntensity(), 0.922633)
+  TEST_REAL_SIMILAR(id[2].getMZ(), 182.068)
+  TEST_REAL_SIMILAR(id[2].getIntensity(), 0.0113774)
+
+  // limit is reached: the most intense isotopes are kept (sorted by mass)
+  EmpiricalFormula insulin("C520H817N139O147S8");
+  gen.setThreshold(1e-3);
+  gen.setMaxIsotopes(0);
+  IsotopeDistribution full = gen.run(insulin);
+  TEST_EQUAL(full.size(), 151)
+  gen.setMaxIsotopes(10);
+  IsotopeDistribution bounded = gen.run(insulin);
+  TEST_EQUAL(bounded.size(), 10)
+
+  vector<Peak1D> expected(full.begin(), full.end());
+  sort(expected.begin(), expected.end(), [](const Peak1D& a, const Peak1D& b) { return a.getIntensity() > b.getIntensity(); });
+  expected.resize(10);
+  sort(expected.begin(), expected.end(), [](const Peak1D& a, const Peak1D& b) { return a.getMZ() < b.getMZ(); });
+  for (Size i = 0; i < bounded.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(bounded[i].getMZ(), expected[i].getMZ())
+    TEST_REAL_SIMILAR(bounded[i].getIntensity(), expected[i].getIntensity())
+  }
+
+  // total probability: stops once the requested probability is covered
+  FineIsotopePatternGenerator total_gen(0.01, true);
+  total_gen.setMaxIsotopes(1000);
+  id = total_gen.run(insulin);
+  double sum = 0.0;
+  for (const Peak1D& p : id) sum += p.getIntensity();
+  TEST_EQUAL(sum >= 0.99, true)
+  TEST_EQUAL(id.size() <= total_gen.run(insulin).size(), true)
+  total_gen.setMaxIsotopes(5);
+  TEST_EQUAL(total_gen.run(insulin).size(), 5)
+}
+END_SECTION
+
+START_SECTION(( void setCache(const std::shared_ptr<FineIsotopePatternCache>& cache) ))
+{
+  FineIsotopePatternGenerator gen(0.01, false, false);
+  TEST_EQUAL(gen.getCache() == nullptr, true)
+  shared_ptr<FineIsotopePatternCache> cache = make_shared<FineIsotopePatternCache>(100);
+  gen.setCache(cache);
+  TEST_EQUAL(gen.getCache() == cache, true)
+
+  EmpiricalFormula ef("C6H12O6");
+  IsotopeDistribution id = gen.run(ef);
+  TEST_EQUAL(id.size(), 3)
+  TEST_EQUAL(cache->getMisses(), 1)
+  id = gen.run(ef);
+  TEST_EQUAL(id.size(), 3)
+  TEST_EQUAL(cache->getHits(), 1)
+
+  // different settings are cached separately
+  gen.setThreshold(1e-5);
+  id = gen.run(ef);
+  TEST_EQUAL(id.size(), 14)
+  TEST_EQUAL(cache->size(), 2)
+}
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
@@ -0,0 +1,184 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/FineIsotopePatternCache.h>
+///////////////////////////
+
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/FineIsotopePatternGenerator.h>
+#include <OpenMS/CHEMISTRY/EmpiricalFormula.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(FineIsotopePatternCache, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+FineIsotopePatternCache* ptr = nullptr;
+FineIsotopePatternCache* nullPointer = nullptr;
+
+START_SECTION(FineIsotopePatternCache(Size capacity = 10000, Size shards = 16))
+{
+  ptr = new FineIsotopePatternCache();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->getCapacity(), 10000)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_REAL_SIMILAR(ptr->getHitRate(), 0.0)
+}
+END_SECTION
+
+START_SECTION(~FineIsotopePatternCache())
+{
+  delete ptr;
+}
+END_SECTION
+
+FineIsotopePatternGenerator gen(0.01, false, false);
+EmpiricalFormula glucose("C6H12O6");
+EmpiricalFormula water("H2O");
+IsotopeDistribution glucose_pattern = gen.run(glucose);
+IsotopeDistribution water_pattern = gen.run(water);
+
+START_SECTION((bool get(const FineIsotopePatternGenerator& generator, const EmpiricalFormula& formula, IsotopeDistribution& pattern)))
+{
+  FineIsotopePatternCache cache;
+  IsotopeDistribution pattern;
+  TEST_EQUAL(cache.get(gen, glucose, pattern), false)
+  TEST_EQUAL(cache.getMisses(), 1)
+
+  cache.insert(gen, glucose, glucose_pattern);
+  TEST_EQUAL(cache.get(gen, glucose, pattern), true)
+  TEST_EQUAL(pattern == glucose_pattern, true)
+  TEST_EQUAL(cache.getHits(), 1)
+  TEST_REAL_SIMILAR(cache.getHitRate(), 0.5)
+
+  // other settings of the generator are a different key
+  FineIsotopePatternGenerator other(0.01, false, true);
+  TEST_EQUAL(cache.get(other, glucose, pattern), false)
+  other.setMaxIsotopes(2);
+  other.setAbsolute(false);
+  TEST_EQUAL(cache.get(other, glucose, pattern), false)
+  TEST_EQUAL(cache.get(FineIsotopePatternGenerator(0.01, false, false), glucose, pattern), true)
+}
+END_SECTION
+
+START_SECTION((void insert(const FineIsotopePatternGenerator& generator, const EmpiricalFormula& formula, const IsotopeDistribution& pattern)))
+{
+  // single shard with two entries: least recently used is evicted
+  FineIsotopePatternCache cache(2, 1);
+  EmpiricalFormula methane("CH4");
+  cache.insert(gen, glucose, glucose_pattern);
+  cache.insert(gen, water, water_pattern);
+  TEST_EQUAL(cache.size(), 2)
+
+  IsotopeDistribution pattern;
+  TEST_EQUAL(cache.get(gen, glucose, pattern), true) // glucose is now most recently used
+  cache.insert(gen, methane, gen.run(methane));
+  TEST_EQUAL(cache.size(), 2)
+  TEST_EQUAL(cache.get(gen, water, pattern), false)
+  TEST_EQUAL(cache.get(gen, glucose, pattern), true)
+  TEST_EQUAL(cache.get(gen, methane, pattern), true)
+
+  // inserting an existing key keeps the size
+  cache.insert(gen, methane, gen.run(methane));
+  TEST_EQUAL(cache.size(), 2)
+
+  // capacity 0 disables the cache
+  FineIsotopePatternCache disabled(0);
+  disabled.insert(gen, glucose, glucose_pattern);
+  TEST_EQUAL(disabled.size(), 0)
+}
+END_SECTION
+
+START_SECTION((void clear()))
+{
+  FineIsotopePatternCache cache;
+  cache.insert(gen, glucose, glucose_pattern);
+  cache.insert(gen, water, water_pattern);
+  TEST_EQUAL(cache.size(), 2)
+  cache.clear();
+  TEST_EQUAL(cache.size(), 0)
+}
+END_SECTION
+
+START_SECTION((void resetStatistics()))
+{
+  FineIsotopePatternCache cache;
+  IsotopeDistribution pattern;
+  cache.get(gen, glucose, pattern);
+  cache.insert(gen, glucose, glucose_pattern);
+  cache.get(gen, glucose, pattern);
+  TEST_EQUAL(cache.getHits(), 1)
+  TEST_EQUAL(cache.getMisses(), 1)
+  cache.resetStatistics();
+  TEST_EQUAL(cache.getHits(), 0)
+  TEST_EQUAL(cache.getMisses(), 0)
+  TEST_EQUAL(cache.size(), 1)
+}
+END_SECTION
+
+START_SECTION([EXTRA] concurrent use)
+{
+  shared_ptr<FineIsotopePatternCache> cache = make_shared<FineIsotopePatternCache>(100, 4);
+  FineIsotopePatternGenerator cached_gen(0.01, false, false);
+  cached_gen.setCache(cache);
+
+  vector<EmpiricalFormula> formulas;
+  for (Size i = 1; i <= 50; ++i)
+  {
+    formulas.push_back(EmpiricalFormula("C" + String(i % 10 + 1) + "H" + String(2 * (i % 10) + 4)));
+  }
+  vector<IsotopeDistribution> patterns(formulas.size());
+#pragma omp parallel for
+  for (SignedSize i = 0; i < (SignedSize)formulas.size(); ++i)
+  {
+    patterns[i] = cached_gen.run(formulas[i]);
+  }
+  for (Size i = 0; i < formulas.size(); ++i)
+  {
+    TEST_EQUAL(patterns[i] == gen.run(formulas[i]), true)
+  }
+  TEST_EQUAL(cache->size(), 10)
+  TEST_EQUAL(cache->getHits() + cache->getMisses(), 50)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -40,6 +40,10 @@
 #include <OpenMS/FORMAT/IdXMLFile.h>
 #include <OpenMS/CONCEPT/FuzzyStringComparator.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 ///////////////////////////
 
 START_TEST(IdXMLFile, "$Id$")
@@ -296,6 +300,62 @@ START_SECTION(([EXTRA] XLMS data labeled cross-linker))
   TEST_EQUAL(peptide_ids[0].getHits()[0].getPeakAnnotations()[25].annotation, "[alpha|xi$y8]")
 
 END_SECTION
+
+START_SECTION(([EXTRA] parallel loading yields the same result as serial loading))
+  vector<ProteinIdentification> protein_ids;
+  vector<PeptideIdentification> peptide_ids, many_peptide_ids;
+  IdXMLFile().load(OPENMS_GET_TEST_DATA_PATH("IdXMLFile_whole.idXML"), protein_ids, peptide_ids);
+  // enough peptide identifications (in both runs) to be split into several chunks
+  for (Size i = 0; i < 500; ++i)
+  {
+    many_peptide_ids.insert(many_peptide_ids.end(), peptide_ids.begin(), peptide_ids.end());
+  }
+  String filename;
+  NEW_TMP_FILE(filename)
+  IdXMLFile().store(filename, protein_ids, many_peptide_ids);
+
+  vector<ProteinIdentification> protein_ids_serial, protein_ids_parallel;
+  vector<PeptideIdentification> peptide_ids_serial, peptide_ids_parallel;
+#ifdef _OPENMP
+  int threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+  IdXMLFile().load(filename, protein_ids_serial, peptide_ids_serial);
+#ifdef _OPENMP
+  omp_set_num_threads(4);
+#endif
+  IdXMLFile().load(filename, protein_ids_parallel, peptide_ids_parallel);
+#ifdef _OPENMP
+  omp_set_num_threads(threads);
+#endif
+
+  TEST_EQUAL(peptide_ids_parallel.size(), 1500)
+  ABORT_IF(protein_ids_serial.size() != protein_ids_parallel.size())
+  ABORT_IF(peptide_ids_serial.size() != peptide_ids_parallel.size())
+  // identifiers contain a random number; check that peptides still reference the right run
+  Size wrong_run = 0;
+  for (Size i = 0; i < peptide_ids_serial.size(); ++i)
+  {
+    Size run_serial = 0, run_parallel = 0;
+    for (Size r = 0; r < protein_ids_serial.size(); ++r)
+    {
+      if (protein_ids_serial[r].getIdentifier() == peptide_ids_serial[i].getIdentifier()) run_serial = r;
+      if (protein_ids_parallel[r].getIdentifier() == peptide_ids_parallel[i].getIdentifier()) run_parallel = r;
+    }
+    if (run_serial != run_parallel) ++wrong_run;
+    peptide_ids_serial[i].setIdentifier("");
+    peptide_ids_parallel[i].setIdentifier("");
+  }
+  TEST_EQUAL(wrong_run, 0)
+  for (Size r = 0; r < protein_ids_serial.size(); ++r)
+  {
+    protein_ids_serial[r].setIdentifier("");
+    protein_ids_parallel[r].setIdentifier("");
+  }
+  TEST_EQUAL(protein_ids_serial == protein_ids_parallel, true)
+  TEST_EQUAL(peptide_ids_serial == peptide_ids_parallel, true)
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
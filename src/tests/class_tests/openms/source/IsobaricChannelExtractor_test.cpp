@@ -515,6 +515,107 @@ START_SECTION((void extractChannels(const PeakMap&ms_exp_data, ConsensusMap & co
 }
 END_SECTION
 
+START_SECTION((ChannelExtractingConsumer(const IsobaricChannelExtractor& extractor, ConsensusMap& consensus_map, Size batch_size = 1000)))
+{
+  IsobaricChannelExtractor ice(q_method);
+  ConsensusMap cm_out;
+  cm_out.resize(3);
+  IsobaricChannelExtractor::ChannelExtractingConsumer* consumer_ptr = new IsobaricChannelExtractor::ChannelExtractingConsumer(ice, cm_out);
+  TEST_NOT_EQUAL(consumer_ptr, nullptr)
+  // the output map is cleared
+  TEST_EQUAL(cm_out.size(), 0)
+  TEST_EQUAL(cm_out.getExperimentType(), "labeled_MS2")
+  delete consumer_ptr;
+}
+END_SECTION
+
+START_SECTION((void consumeSpectrum(SpectrumType& s)))
+{
+  IsobaricChannelExtractor ice(q_method);
+  ConsensusMap cm_out;
+  IsobaricChannelExtractor::ChannelExtractingConsumer consumer(ice, cm_out);
+
+  MSSpectrum s;
+  s.setMSLevel(1);
+  s.setRT(10.0);
+  consumer.consumeSpectrum(s);
+  // spectra need to be sorted by RT
+  s.setRT(5.0);
+  TEST_EXCEPTION(Exception::InvalidParameter, consumer.consumeSpectrum(s))
+}
+END_SECTION
+
+START_SECTION((void finish()))
+{
+  IsobaricChannelExtractor ice(q_method);
+  Param p = ice.getParameters();
+  p.setValue("select_activation", "");
+  ice.setParameters(p);
+
+  // no spectra
+  {
+    ConsensusMap cm_out;
+    IsobaricChannelExtractor::ChannelExtractingConsumer consumer(ice, cm_out);
+    TEST_EXCEPTION(Exception::MissingInformation, consumer.finish())
+  }
+
+  // streaming yields the same result as the in-memory extraction, independent of the batch size
+  PeakMap exp;
+  MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("IsobaricChannelExtractor_6.mzML"), exp);
+  ConsensusMap cm_in_memory;
+  ice.extractChannels(exp, cm_in_memory);
+  TEST_EQUAL(cm_in_memory.size(), 5)
+
+  for (Size batch_size : {1, 2, 1000})
+  {
+    ConsensusMap cm_out;
+    IsobaricChannelExtractor::ChannelExtractingConsumer consumer(ice, cm_out, batch_size);
+    MzMLFile().transform(OPENMS_GET_TEST_DATA_PATH("IsobaricChannelExtractor_6.mzML"), &consumer);
+    consumer.finish();
+    // further calls have no effect
+    consumer.finish();
+
+    TEST_EQUAL(cm_out.size(), cm_in_memory.size())
+    ABORT_IF(cm_out.size() != cm_in_memory.size())
+    TEST_EQUAL(cm_out.getColumnHeaders().size(), 4)
+    for (Size i = 0; i < cm_out.size(); ++i)
+    {
+      TEST_REAL_SIMILAR(cm_out[i].getRT(), cm_in_memory[i].getRT())
+      TEST_REAL_SIMILAR(cm_out[i].getMZ(), cm_in_memory[i].getMZ())
+      TEST_REAL_SIMILAR(cm_out[i].getIntensity(), cm_in_memory[i].getIntensity())
+      TEST_EQUAL(cm_out[i].getMetaValue("scan_id"), cm_in_memory[i].getMetaValue("scan_id"))
+      TEST_REAL_SIMILAR(cm_out[i].getMetaValue("precursor_purity"), cm_in_memory[i].getMetaValue("precursor_purity"))
+      TEST_EQUAL(cm_out[i].size(), cm_in_memory[i].size())
+      ABORT_IF(cm_out[i].size() != cm_in_memory[i].size())
+      ConsensusFeature::const_iterator it_stream = cm_out[i].begin();
+      ConsensusFeature::const_iterator it_mem = cm_in_memory[i].begin();
+      for (; it_stream != cm_out[i].end(); ++it_stream, ++it_mem)
+      {
+        TEST_EQUAL(it_stream->getMapIndex(), it_mem->getMapIndex())
+        TEST_EQUAL(it_stream->getUniqueId(), it_mem->getUniqueId())
+        TEST_REAL_SIMILAR(it_stream->getIntensity(), it_mem->getIntensity())
+      }
+    }
+  }
+
+  // purity filter is applied while streaming as well
+  p.setValue("min_precursor_purity", 0.75);
+  ice.setParameters(p);
+  ConsensusMap cm_filtered;
+  IsobaricChannelExtractor::ChannelExtractingConsumer consumer(ice, cm_filtered, 2);
+  for (Size i = 0; i < exp.size(); ++i)
+  {
+    consumer.consumeSpectrum(exp[i]);
+  }
+  consumer.finish();
+  TEST_EQUAL(cm_filtered.size(), 3)
+  ABORT_IF(cm_filtered.size() != 3)
+  TEST_REAL_SIMILAR(cm_filtered[0].getMetaValue("precursor_purity"), 1.0)
+  TEST_REAL_SIMILAR(cm_filtered[1].getMetaValue("precursor_purity"), 0.824561)
+  TEST_REAL_SIMILAR(cm_filtered[2].getMetaValue("precursor_purity"), 1.0)
+}
+END_SECTION
+
 START_SECTION(([EXTRA] purity computation without interpolation))
 {
   // check precursor purity computation
@@ -0,0 +1,177 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+
+#include <OpenMS/FORMAT/DATAACCESS/MSDataParallelConsumer.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataStoringConsumer.h>
+
+///////////////////////////
+
+#include <OpenMS/KERNEL/MSSpectrum.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+START_TEST(MSDataParallelConsumer, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+using namespace OpenMS;
+
+MSDataParallelConsumer* ptr = nullptr;
+MSDataParallelConsumer* null_ptr = nullptr;
+
+START_SECTION((MSDataParallelConsumer(Interfaces::IMSDataConsumer* next_consumer, Size batch_size = 0)))
+{
+  MSDataStoringConsumer storing_consumer;
+  ptr = new MSDataParallelConsumer(&storing_consumer);
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->getBatchSize() > 0, true)
+}
+END_SECTION
+
+START_SECTION((~MSDataParallelConsumer()))
+{
+  delete ptr;
+}
+END_SECTION
+
+START_SECTION((void consumeSpectrum(SpectrumType& s)))
+{
+  MSDataStoringConsumer storing_consumer;
+  {
+    MSDataParallelConsumer parallel_consumer(&storing_consumer, 7);
+    parallel_consumer.setSpectraProcessingFunc([](MSSpectrum& s)
+    {
+      s.push_back(Peak1D(s.getRT(), 2.0 * s.getRT()));
+    });
+
+    for (Size i = 0; i < 100; ++i)
+    {
+      MSSpectrum s;
+      s.setRT(double(i));
+      parallel_consumer.consumeSpectrum(s);
+      // bounded buffer: at most one batch is held back
+      TEST_EQUAL(i + 1 - storing_consumer.getData().size() <= 7, true)
+    }
+    // remaining spectra are passed on by the destructor
+  }
+
+  const PeakMap& exp = storing_consumer.getData();
+  TEST_EQUAL(exp.size(), 100)
+  bool order_ok = true;
+  for (Size i = 0; i < exp.size(); ++i)
+  {
+    if ((exp[i].getRT() != double(i)) || (exp[i].size() != 1) || (exp[i][0].getIntensity() != float(2.0 * i)))
+    {
+      order_ok = false;
+    }
+  }
+  TEST_EQUAL(order_ok, true)
+}
+END_SECTION
+
+START_SECTION((void consumeChromatogram(ChromatogramType& c)))
+{
+  MSDataStoringConsumer storing_consumer;
+  MSDataParallelConsumer parallel_consumer(&storing_consumer, 4);
+  parallel_consumer.setChromatogramProcessingFunc([](MSChromatogram& c)
+  {
+    c.setNativeID(c.getNativeID() + "_processed");
+  });
+
+  // spectra without processing function are passed on unchanged
+  MSSpectrum s;
+  s.setRT(5.0);
+  parallel_consumer.consumeSpectrum(s);
+  for (Size i = 0; i < 10; ++i)
+  {
+    MSChromatogram c;
+    c.setNativeID("chrom" + String(i));
+    parallel_consumer.consumeChromatogram(c);
+  }
+  parallel_consumer.flush();
+
+  const PeakMap& exp = storing_consumer.getData();
+  TEST_EQUAL(exp.size(), 1)
+  TEST_EQUAL(exp[0].getRT(), 5.0)
+  TEST_EQUAL(exp.getChromatograms().size(), 10)
+  TEST_EQUAL(exp.getChromatograms()[0].getNativeID(), "chrom0_processed")
+  TEST_EQUAL(exp.getChromatograms()[9].getNativeID(), "chrom9_processed")
+}
+END_SECTION
+
+START_SECTION((void flush()))
+{
+  MSDataStoringConsumer storing_consumer;
+  MSDataParallelConsumer parallel_consumer(&storing_consumer, 100);
+  parallel_consumer.setSpectraProcessingFunc([](MSSpectrum& s)
+  {
+    if (s.getRT() == 3.0)
+    {
+      throw Exception::InvalidValue(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "invalid RT", String(s.getRT()));
+    }
+  });
+  for (Size i = 0; i < 5; ++i)
+  {
+    MSSpectrum s;
+    s.setRT(double(i));
+    parallel_consumer.consumeSpectrum(s);
+  }
+  TEST_EQUAL(storing_consumer.getData().size(), 0)
+  TEST_EXCEPTION(Exception::InvalidValue, parallel_consumer.flush())
+  // failed batch is discarded, consumer is empty afterwards
+  parallel_consumer.flush();
+  TEST_EQUAL(storing_consumer.getData().size(), 0)
+}
+END_SECTION
+
+START_SECTION((void setExpectedSize(Size s_size, Size c_size)))
+{
+  NOT_TESTABLE // forwarded to the downstream consumer
+}
+END_SECTION
+
+START_SECTION((void setExperimentalSettings(const ExperimentalSettings& settings)))
+{
+  NOT_TESTABLE // forwarded to the downstream consumer
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
+
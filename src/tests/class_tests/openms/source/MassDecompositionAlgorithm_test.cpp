@@ -82,6 +82,56 @@ START_SECTION((void getDecompositions(std::vector<MassDecomposition>& decomps, d
   decomps.clear();
   mda.getDecompositions(decomps, mass);
   TEST_EQUAL(decomps.size(), 911);
+
+  // memoized results are identical
+  decomps.clear();
+  mda.getDecompositions(decomps, mass);
+  TEST_EQUAL(decomps.size(), 911);
+}
+END_SECTION
+
+START_SECTION((void getDecompositions(std::vector<std::vector<MassDecomposition> >& decomps, const std::vector<double>& weights)))
+{
+  // typical mass differences of MS2 peaks (unsorted, with duplicates)
+  vector<double> masses;
+  masses.push_back(AASequence::fromString("PEP").getMonoWeight(Residue::Internal));
+  masses.push_back(AASequence::fromString("G").getMonoWeight(Residue::Internal));
+  masses.push_back(AASequence::fromString("GG").getMonoWeight(Residue::Internal));
+  masses.push_back(AASequence::fromString("N").getMonoWeight(Residue::Internal));
+  masses.push_back(AASequence::fromString("PEP").getMonoWeight(Residue::Internal) + 0.02);
+  masses.push_back(AASequence::fromString("DFPIA").getMonoWeight(Residue::Internal));
+  masses.push_back(AASequence::fromString("G").getMonoWeight(Residue::Internal));
+  masses.push_back(100.0);
+
+  for (Int cache_size = 0; cache_size <= 10000; cache_size += 10000)
+  {
+    MassDecompositionAlgorithm mda;
+    Param p(mda.getParameters());
+    p.setValue("tolerance", 0.05);
+    p.setValue("cache_size", cache_size);
+    mda.setParameters(p);
+
+    vector<vector<MassDecomposition> > batch;
+    mda.getDecompositions(batch, masses);
+    TEST_EQUAL(batch.size(), masses.size())
+
+    MassDecompositionAlgorithm single_mda;
+    p.setValue("cache_size", 0);
+    single_mda.setParameters(p);
+    for (Size i = 0; i < masses.size(); ++i)
+    {
+      vector<MassDecomposition> decomps;
+      single_mda.getDecompositions(decomps, masses[i]);
+      TEST_EQUAL(batch[i].size(), decomps.size())
+      for (Size j = 0; j < min(decomps.size(), batch[i].size()); ++j)
+      {
+        TEST_EQUAL(batch[i][j].toString(), decomps[j].toString())
+      }
+    }
+    TEST_EQUAL(batch[1].size(), 1)
+    TEST_EQUAL(batch[1][0].toString(), "G1")
+    TEST_EQUAL(batch[3].size(), 2) // N and GG
+  }
 }
 END_SECTION
 
@@ -0,0 +1,335 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/ID/MetaboliteSpectralLibraryIndex.h>
+///////////////////////////
+
+#include <OpenMS/ANALYSIS/ID/MetaboliteSpectralMatching.h>
+#include <OpenMS/CHEMISTRY/ISOTOPEDISTRIBUTION/AveragineIsotopeTable.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+#include <fstream>
+#include <iterator>
+
+using namespace OpenMS;
+using namespace std;
+
+MSSpectrum makeSpectrum(double precursor_mz, Int charge, const vector<double>& mzs)
+{
+  MSSpectrum spec;
+  if (precursor_mz > 0.0)
+  {
+    Precursor prec;
+    prec.setMZ(precursor_mz);
+    prec.setCharge(charge);
+    spec.getPrecursors().push_back(prec);
+  }
+  for (double mz : mzs)
+  {
+    spec.push_back(Peak1D(mz, 10.0));
+  }
+  return spec;
+}
+
+START_TEST(MetaboliteSpectralLibraryIndex, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+PeakMap library;
+library.addSpectrum(makeSpectrum(300.0, 1, {100.0, 150.0, 200.0}));
+library.addSpectrum(makeSpectrum(200.0, -1, {80.0, 120.0}));
+library.addSpectrum(makeSpectrum(-1.0, 0, {50.0}));
+library.addSpectrum(makeSpectrum(300.0, 1, {100.005, 150.0, 250.0, 251.0}));
+
+MSSpectrum query = makeSpectrum(250.0, 1, {100.0, 150.0, 200.0, 300.0});
+
+MetaboliteSpectralLibraryIndex* ptr = nullptr;
+MetaboliteSpectralLibraryIndex* null_ptr = nullptr;
+START_SECTION(MetaboliteSpectralLibraryIndex())
+{
+  ptr = new MetaboliteSpectralLibraryIndex();
+  TEST_NOT_EQUAL(ptr, null_ptr)
+  TEST_EQUAL(ptr->size(), 0)
+}
+END_SECTION
+
+START_SECTION(~MetaboliteSpectralLibraryIndex())
+{
+  delete ptr;
+}
+END_SECTION
+
+MetaboliteSpectralLibraryIndex index;
+
+START_SECTION((void build(const PeakMap& library, double bin_size = 0.01)))
+{
+  index.build(library);
+  TEST_EQUAL(index.size(), 4)
+  TEST_REAL_SIMILAR(index.getBinSize(), 0.01)
+
+  MetaboliteSpectralLibraryIndex invalid;
+  TEST_EXCEPTION(Exception::InvalidParameter, invalid.build(library, 0.0))
+}
+END_SECTION
+
+START_SECTION((Size size() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((double getBinSize() const))
+{
+  NOT_TESTABLE // tested above
+}
+END_SECTION
+
+START_SECTION((bool isIndexOf(const PeakMap& library) const))
+{
+  TEST_EQUAL(index.isIndexOf(library), true)
+
+  PeakMap changed = library;
+  changed[1].push_back(Peak1D(130.0, 10.0));
+  TEST_EQUAL(index.isIndexOf(changed), false)
+
+  changed = library;
+  changed[0].getPrecursors()[0].setMZ(301.0);
+  TEST_EQUAL(index.isIndexOf(changed), false)
+
+  changed = library;
+  changed[0].getPrecursors()[0].setCharge(2);
+  TEST_EQUAL(index.isIndexOf(changed), false)
+
+  // same number of peaks, but a different fragment m/z
+  changed = library;
+  changed[3][2].setMZ(260.0);
+  TEST_EQUAL(index.isIndexOf(changed), false)
+
+  // intensities are not part of the index
+  changed = library;
+  changed[3][2].setIntensity(50.0);
+  TEST_EQUAL(index.isIndexOf(changed), true)
+
+  TEST_EQUAL(MetaboliteSpectralLibraryIndex().isIndexOf(library), false)
+}
+END_SECTION
+
+START_SECTION((void findCandidates(double mz_lower, double mz_upper, std::vector<Size>& candidates) const))
+{
+  vector<Size> candidates;
+  // equal precursors are reported in library order
+  index.findCandidates(299.0, 301.0, candidates);
+  TEST_EQUAL(candidates.size(), 2)
+  ABORT_IF(candidates.size() != 2)
+  TEST_EQUAL(candidates[0], 0)
+  TEST_EQUAL(candidates[1], 3)
+
+  // spectra without precursor are never candidates
+  index.findCandidates(0.0, 1000.0, candidates);
+  TEST_EQUAL(candidates.size(), 3)
+  ABORT_IF(candidates.size() != 3)
+  TEST_EQUAL(candidates[0], 1)
+  TEST_EQUAL(candidates[1], 0)
+  TEST_EQUAL(candidates[2], 3)
+
+  index.findCandidates(400.0, 500.0, candidates);
+  TEST_EQUAL(candidates.empty(), true)
+}
+END_SECTION
+
+START_SECTION((double getPrecursorMZ(Size index) const))
+{
+  TEST_REAL_SIMILAR(index.getPrecursorMZ(0), 300.0)
+  TEST_REAL_SIMILAR(index.getPrecursorMZ(1), 200.0)
+  TEST_REAL_SIMILAR(index.getPrecursorMZ(2), -1.0)
+}
+END_SECTION
+
+START_SECTION((Int getPrecursorCharge(Size index) const))
+{
+  TEST_EQUAL(index.getPrecursorCharge(0), 1)
+  TEST_EQUAL(index.getPrecursorCharge(1), -1)
+  TEST_EQUAL(index.getPrecursorCharge(2), 0)
+}
+END_SECTION
+
+START_SECTION((void getQueryBins(const MSSpectrum& spectrum, double fragment_mass_error, bool fragment_mass_tolerance_unit_ppm, QueryBins& query) const))
+{
+  MetaboliteSpectralLibraryIndex::QueryBins bins;
+  index.getQueryBins(query, 0.01, false, bins);
+  TEST_EQUAL(bins.size(), query.size())
+  for (const auto& range : bins)
+  {
+    TEST_EQUAL(range.first <= range.second, true)
+  }
+
+  index.getQueryBins(MSSpectrum(), 0.01, false, bins);
+  TEST_EQUAL(bins.empty(), true)
+}
+END_SECTION
+
+START_SECTION((Size countMatchingPeaks(const QueryBins& query, Size index, Size max_count) const))
+{
+  MetaboliteSpectralLibraryIndex::QueryBins bins;
+  index.getQueryBins(query, 0.01, false, bins);
+  TEST_EQUAL(index.countMatchingPeaks(bins, 0, 10), 3)
+  TEST_EQUAL(index.countMatchingPeaks(bins, 0, 2), 2)
+  TEST_EQUAL(index.countMatchingPeaks(bins, 1, 10), 0)
+  TEST_EQUAL(index.countMatchingPeaks(bins, 2, 10), 0)
+  TEST_EQUAL(index.countMatchingPeaks(bins, 3, 10), 2)
+
+  index.getQueryBins(query, 500.0, true, bins);
+  TEST_EQUAL(index.countMatchingPeaks(bins, 0, 10), 3)
+  TEST_EQUAL(index.countMatchingPeaks(bins, 3, 10), 2)
+
+  // the count is an upper bound of the peaks matched by the hyperscore,
+  // which needs at least three matches to be non-zero
+  index.getQueryBins(query, 0.01, false, bins);
+  for (Size i = 0; i < library.size(); ++i)
+  {
+    double score = MetaboliteSpectralMatching::computeHyperScore(0.01, false, query, library[i]);
+    if (index.countMatchingPeaks(bins, i, 3) < 3)
+    {
+      TEST_REAL_SIMILAR(score, 0.0)
+    }
+  }
+  TEST_NOT_EQUAL(MetaboliteSpectralMatching::computeHyperScore(0.01, false, query, library[0]), 0.0)
+}
+END_SECTION
+
+START_SECTION((void store(const String& filename) const))
+{
+  String filename;
+  NEW_TMP_FILE(filename)
+  index.store(filename);
+
+  MetaboliteSpectralLibraryIndex loaded;
+  loaded.load(filename);
+  TEST_EQUAL(loaded.size(), index.size())
+  TEST_REAL_SIMILAR(loaded.getBinSize(), index.getBinSize())
+  TEST_EQUAL(loaded.isIndexOf(library), true)
+
+  vector<Size> candidates;
+  loaded.findCandidates(299.0, 301.0, candidates);
+  TEST_EQUAL(candidates.size(), 2)
+
+  MetaboliteSpectralLibraryIndex::QueryBins bins;
+  loaded.getQueryBins(query, 0.01, false, bins);
+  for (Size i = 0; i < library.size(); ++i)
+  {
+    TEST_EQUAL(loaded.countMatchingPeaks(bins, i, 10), index.countMatchingPeaks(bins, i, 10))
+  }
+}
+END_SECTION
+
+START_SECTION((void load(const String& filename)))
+{
+  MetaboliteSpectralLibraryIndex loaded;
+  TEST_EXCEPTION(Exception::FileNotFound, loaded.load("this_file_does_not_exist.idx"))
+  TEST_EXCEPTION(Exception::ParseError, loaded.load(OPENMS_GET_TEST_DATA_PATH("FASTAFile_test.fasta")))
+
+  // other binary formats must not be mistaken for an index
+  String other_format;
+  NEW_TMP_FILE(other_format)
+  AveragineIsotopeTable(AveragineIsotopeTable::RNA, 10.0, 1000.0, 5).store(other_format);
+  TEST_EXCEPTION(Exception::ParseError, loaded.load(other_format))
+
+  // corrupted index files
+  String filename, corrupted;
+  NEW_TMP_FILE(filename)
+  NEW_TMP_FILE(corrupted)
+  index.store(filename);
+  std::string bytes;
+  {
+    ifstream ifs(filename.c_str(), ios::binary);
+    bytes.assign(istreambuf_iterator<char>(ifs), istreambuf_iterator<char>());
+  }
+  loaded.load(filename);
+  // layout: identifier (int), version (int), bin size (double), then vectors (UInt64 length + data):
+  // precursor m/z (double), precursor charge (Int), peak count (UInt32), bin offsets (UInt64), bins (UInt32), ...
+  const Size n = library.size();
+  const Size bin_size_offset = 2 * sizeof(int);
+  const Size precursor_mz_offset = bin_size_offset + sizeof(double);
+  // start of the bin offset data (after its length)
+  const Size bin_offset_offset = precursor_mz_offset + 4 * sizeof(UInt64) + n * (sizeof(double) + sizeof(Int) + sizeof(UInt32));
+
+  std::string content = bytes;
+  double zero = 0.0;
+  content.replace(bin_size_offset, sizeof(double), (const char*)&zero, sizeof(double));
+  ofstream(corrupted.c_str(), ios::binary) << content;
+  TEST_EXCEPTION(Exception::ParseError, loaded.load(corrupted))
+
+  content = bytes;
+  UInt64 huge = UInt64(1) << 60;
+  content.replace(precursor_mz_offset, sizeof(UInt64), (const char*)&huge, sizeof(UInt64));
+  ofstream(corrupted.c_str(), ios::binary) << content;
+  TEST_EXCEPTION(Exception::ParseError, loaded.load(corrupted))
+
+  // bin offsets 0, 3, 5, 6, 10 -> 0, 7, 5, 6, 10 (not non-decreasing, but ends at the number of bins)
+  content = bytes;
+  UInt64 offset = 7;
+  content.replace(bin_offset_offset + sizeof(UInt64), sizeof(UInt64), (const char*)&offset, sizeof(UInt64));
+  ofstream(corrupted.c_str(), ios::binary) << content;
+  TEST_EXCEPTION(Exception::ParseError, loaded.load(corrupted))
+
+  ofstream(corrupted.c_str(), ios::binary) << bytes.substr(0, bytes.size() - 1);
+  TEST_EXCEPTION(Exception::ParseError, loaded.load(corrupted))
+
+  // a failed load keeps the previous index
+  TEST_EQUAL(loaded.size(), n)
+  TEST_EQUAL(loaded.isIndexOf(library), true)
+}
+END_SECTION
+
+START_SECTION([EXTRA] MetaboliteSpectralMatching::run with an index of a different library)
+{
+  MetaboliteSpectralLibraryIndex other;
+  other.build(PeakMap());
+
+  PeakMap msexp;
+  msexp.addSpectrum(query);
+  MzTab mztab;
+  MetaboliteSpectralMatching msm;
+  TEST_EXCEPTION(Exception::InvalidParameter, msm.run(msexp, library, other, mztab))
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
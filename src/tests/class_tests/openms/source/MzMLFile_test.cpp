@@ -40,6 +40,8 @@
 ///////////////////////////
 
 #include <OpenMS/FORMAT/FileTypes.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataStoringConsumer.h>
+#include <OpenMS/FORMAT/DATAACCESS/MSDataTransformingConsumer.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 
 using namespace OpenMS;
@@ -1232,6 +1234,60 @@ START_SECTION(void transform(const String& filename_in, Interfaces::IMSDataConsu
 }
 END_SECTION
 
+START_SECTION(void transformIndexed(const String& filename_in, Interfaces::IMSDataConsumer * consumer, Size chunk_size = 50))
+{
+  MzMLFile mzml;
+  PeakMap reference;
+  String in = OPENMS_GET_TEST_DATA_PATH("MzMLFile_4_indexed.mzML");
+  mzml.load(in, reference);
+
+  // chunks of different size (including chunks not evenly dividing the spectra)
+  for (Size chunk_size : {1, 3, 50})
+  {
+    MSDataStoringConsumer consumer;
+    mzml.transformIndexed(in, &consumer, chunk_size);
+    const PeakMap& result = consumer.getData();
+    TEST_EQUAL(result.size(), reference.size())
+    ABORT_IF(result.size() != reference.size())
+    for (Size i = 0; i < result.size(); ++i)
+    {
+      TEST_EQUAL(result[i].getNativeID(), reference[i].getNativeID())
+      TEST_EQUAL(result[i].size(), reference[i].size())
+      TEST_EQUAL(result[i] == reference[i], true)
+    }
+    TEST_EQUAL(result.getInstrument() == reference.getInstrument(), true)
+  }
+
+  // spectra and chromatograms
+  PeakMap reference2;
+  in = OPENMS_GET_TEST_DATA_PATH("IndexedmzMLFile_1.mzML");
+  mzml.load(in, reference2);
+  MSDataStoringConsumer consumer2;
+  mzml.transformIndexed(in, &consumer2, 1);
+  TEST_EQUAL(consumer2.getData().getNrSpectra(), reference2.getNrSpectra())
+  TEST_EQUAL(consumer2.getData().getNrChromatograms(), reference2.getNrChromatograms())
+  TEST_EQUAL(consumer2.getData().getSpectra() == reference2.getSpectra(), true)
+  TEST_EQUAL(consumer2.getData().getChromatograms() == reference2.getChromatograms(), true)
+
+  // non-indexed files fall back to transform()
+  MSDataStoringConsumer consumer3;
+  mzml.transformIndexed(OPENMS_GET_TEST_DATA_PATH("MzMLFile_1.mzML"), &consumer3);
+  TEST_EQUAL(consumer3.getData().getNrSpectra(), 4)
+
+  TEST_EXCEPTION(Exception::FileNotFound, mzml.transformIndexed("this_file_does_not_exist.mzML", &consumer3))
+
+  // exceptions of the consumer reach the caller unchanged
+  Size consumed = 0;
+  MSDataTransformingConsumer failing_consumer;
+  failing_consumer.setSpectraProcessingFunc([&consumed](MSSpectrum&)
+  {
+    if (++consumed == 2) throw Exception::UnableToCreateFile(__FILE__, __LINE__, OPENMS_PRETTY_FUNCTION, "out.mzML");
+  });
+  TEST_EXCEPTION(Exception::UnableToCreateFile, mzml.transformIndexed(OPENMS_GET_TEST_DATA_PATH("MzMLFile_4_indexed.mzML"), &failing_consumer, 1))
+  TEST_EQUAL(consumed, 2)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
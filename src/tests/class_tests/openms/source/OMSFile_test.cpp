@@ -0,0 +1,226 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+
+#include <OpenMS/FORMAT/OMSFile.h>
+#include <OpenMS/FORMAT/IdXMLFile.h>
+#include <OpenMS/METADATA/ID/IdentificationDataConverter.h>
+
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+typedef IdentificationData ID;
+
+START_TEST(OMSFile, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+IdentificationData ids;
+vector<ProteinIdentification> proteins_in;
+vector<PeptideIdentification> peptides_in;
+IdXMLFile().load(OPENMS_GET_TEST_DATA_PATH("IdXMLFile_whole.idXML"), proteins_in, peptides_in);
+// IdentificationData doesn't allow score types with the same name, but different orientations:
+peptides_in[0].setHigherScoreBetter(true);
+IdentificationDataConverter::importIDs(ids, proteins_in, peptides_in);
+
+String oms_file;
+NEW_TMP_FILE(oms_file);
+
+START_SECTION((void store(const String& filename, const IdentificationData& id_data)))
+{
+  OMSFile().store(oms_file, ids);
+  TEST_EQUAL(File::exists(oms_file), true);
+  // overwriting an existing file works:
+  OMSFile().store(oms_file, ids);
+  TEST_EQUAL(File::exists(oms_file), true);
+}
+END_SECTION
+
+START_SECTION((void load(const String& filename, IdentificationData& id_data)))
+{
+  IdentificationData out;
+  OMSFile().load(oms_file, out);
+
+  TEST_EQUAL(ids.getInputFiles().size(), out.getInputFiles().size());
+  TEST_EQUAL(ids.getScoreTypes().size(), out.getScoreTypes().size());
+  TEST_EQUAL(ids.getDataProcessingSoftwares().size(), out.getDataProcessingSoftwares().size());
+  TEST_EQUAL(ids.getDataProcessingSteps().size(), out.getDataProcessingSteps().size());
+  TEST_EQUAL(ids.getDBSearchParams().size(), out.getDBSearchParams().size());
+  TEST_EQUAL(ids.getDBSearchSteps().size(), out.getDBSearchSteps().size());
+  TEST_EQUAL(ids.getDataQueries().size(), out.getDataQueries().size());
+  TEST_EQUAL(ids.getParentMolecules().size(), out.getParentMolecules().size());
+  TEST_EQUAL(ids.getParentMoleculeGroupings().size(), out.getParentMoleculeGroupings().size());
+  TEST_EQUAL(ids.getIdentifiedPeptides().size(), out.getIdentifiedPeptides().size());
+  TEST_EQUAL(ids.getIdentifiedCompounds().size(), out.getIdentifiedCompounds().size());
+  TEST_EQUAL(ids.getIdentifiedOligos().size(), out.getIdentifiedOligos().size());
+  TEST_EQUAL(ids.getMoleculeQueryMatches().size(), out.getMoleculeQueryMatches().size());
+  TEST_EQUAL(ids.getQueryMatchGroups().size(), out.getQueryMatchGroups().size());
+
+  // round trip back to the "legacy" classes:
+  vector<ProteinIdentification> proteins_out;
+  vector<PeptideIdentification> peptides_out;
+  IdentificationDataConverter::exportIDs(out, proteins_out, peptides_out);
+  TEST_EQUAL(peptides_out.size(), peptides_in.size());
+  TEST_EQUAL(proteins_out.size(), proteins_in.size());
+  Size hits_in = 0, hits_out = 0;
+  for (const PeptideIdentification& pep : peptides_in) hits_in += pep.getHits().size();
+  for (const PeptideIdentification& pep : peptides_out) hits_out += pep.getHits().size();
+  TEST_EQUAL(hits_out, hits_in);
+
+  // compare content (not just sizes) with the data before storing:
+  vector<ProteinIdentification> proteins_ref;
+  vector<PeptideIdentification> peptides_ref;
+  IdentificationDataConverter::exportIDs(ids, proteins_ref, peptides_ref);
+  auto collect_hits = [](const vector<PeptideIdentification>& peptides)
+  {
+    vector<pair<String, double>> hits;
+    for (const PeptideIdentification& pep : peptides)
+    {
+      for (const PeptideHit& hit : pep.getHits())
+      {
+        hits.emplace_back(hit.getSequence().toString(), hit.getScore());
+      }
+    }
+    sort(hits.begin(), hits.end());
+    return hits;
+  };
+  vector<pair<String, double>> hits_ref = collect_hits(peptides_ref), hits_loaded = collect_hits(peptides_out);
+  TEST_EQUAL(hits_loaded.size(), hits_ref.size());
+  ABORT_IF(hits_loaded.size() != hits_ref.size());
+  for (Size i = 0; i < hits_ref.size(); ++i)
+  {
+    TEST_STRING_EQUAL(hits_loaded[i].first, hits_ref[i].first);
+    TEST_REAL_SIMILAR(hits_loaded[i].second, hits_ref[i].second);
+  }
+  set<String> accessions_ref, accessions_loaded;
+  for (const ID::ParentMolecule& parent : ids.getParentMolecules()) accessions_ref.insert(parent.accession);
+  for (const ID::ParentMolecule& parent : out.getParentMolecules()) accessions_loaded.insert(parent.accession);
+  TEST_EQUAL(accessions_loaded == accessions_ref, true);
+
+  // not an OMS file:
+  TEST_EXCEPTION(Exception::FileNotFound, OMSFile().load("this_file_does_not_exist.oms", out));
+}
+END_SECTION
+
+START_SECTION((void load(const String& filename, IdentificationData& id_data, const String& input_file)))
+{
+  const String& input_file = *ids.getInputFiles().begin();
+  Size n_queries = 0;
+  for (const IdentificationData::DataQuery& query : ids.getDataQueries())
+  {
+    if (query.input_file_opt && (**query.input_file_opt == input_file)) ++n_queries;
+  }
+
+  IdentificationData out;
+  OMSFile().load(oms_file, out, input_file);
+  TEST_EQUAL(out.getInputFiles().size(), ids.getInputFiles().size());
+  TEST_EQUAL(out.getDataProcessingSteps().size(), ids.getDataProcessingSteps().size());
+  TEST_EQUAL(out.getDataQueries().size(), n_queries);
+  for (const IdentificationData::DataQuery& query : out.getDataQueries())
+  {
+    TEST_EQUAL(**query.input_file_opt, input_file);
+  }
+  for (const IdentificationData::MoleculeQueryMatch& match : out.getMoleculeQueryMatches())
+  {
+    TEST_EQUAL(**match.data_query_ref->input_file_opt, input_file);
+  }
+
+  TEST_EXCEPTION(Exception::ElementNotFound, OMSFile().load(oms_file, out, "unknown_file.mzML"));
+}
+END_SECTION
+
+START_SECTION(([EXTRA] meta values round trip))
+{
+  ID meta_data;
+  ID::ScoreType score_type("test_score", true);
+  // list elements containing the old list separator must survive:
+  score_type.setMetaValue("strings_sep", StringList{"first, second", "[third]", ""});
+  score_type.setMetaValue("ints", IntList{1, -2, 3});
+  score_type.setMetaValue("empty_list", DoubleList());
+  DataValue doubles(DoubleList{0.5, -1.25e-10});
+  doubles.setUnitType(DataValue::UNIT_ONTOLOGY);
+  doubles.setUnit(10);
+  score_type.setMetaValue("doubles", doubles);
+  DataValue with_unit(123.456);
+  with_unit.setUnitType(DataValue::MS_ONTOLOGY);
+  with_unit.setUnit(1000040);
+  score_type.setMetaValue("with_unit", with_unit);
+  score_type.setMetaValue("string", String("x, y"));
+  score_type.setMetaValue("int", 42);
+  meta_data.registerScoreType(score_type);
+
+  String meta_file;
+  NEW_TMP_FILE(meta_file);
+  OMSFile().store(meta_file, meta_data);
+  ID out;
+  OMSFile().load(meta_file, out);
+  TEST_EQUAL(out.getScoreTypes().size(), 1);
+  ABORT_IF(out.getScoreTypes().size() != 1);
+  const ID::ScoreType& loaded = *out.getScoreTypes().begin();
+
+  StringList strings_sep = loaded.getMetaValue("strings_sep");
+  TEST_EQUAL(strings_sep.size(), 3);
+  ABORT_IF(strings_sep.size() != 3);
+  TEST_STRING_EQUAL(strings_sep[0], "first, second");
+  TEST_STRING_EQUAL(strings_sep[1], "[third]");
+  TEST_STRING_EQUAL(strings_sep[2], "");
+  TEST_EQUAL(loaded.getMetaValue("ints").valueType(), DataValue::INT_LIST);
+  TEST_EQUAL(loaded.getMetaValue("ints") == score_type.getMetaValue("ints"), true);
+  TEST_EQUAL(loaded.getMetaValue("empty_list").valueType(), DataValue::DOUBLE_LIST);
+  TEST_EQUAL(loaded.getMetaValue("empty_list").toDoubleList().size(), 0);
+  DoubleList loaded_doubles = loaded.getMetaValue("doubles");
+  TEST_EQUAL(loaded_doubles.size(), 2);
+  ABORT_IF(loaded_doubles.size() != 2);
+  TEST_EQUAL(loaded_doubles[0], 0.5);
+  TEST_EQUAL(loaded_doubles[1], -1.25e-10);
+  TEST_EQUAL(loaded.getMetaValue("doubles").getUnitType(), DataValue::UNIT_ONTOLOGY);
+  TEST_EQUAL(loaded.getMetaValue("doubles").getUnit(), 10);
+  TEST_REAL_SIMILAR(double(loaded.getMetaValue("with_unit")), 123.456);
+  TEST_EQUAL(loaded.getMetaValue("with_unit").getUnitType(), DataValue::MS_ONTOLOGY);
+  TEST_EQUAL(loaded.getMetaValue("with_unit").getUnit(), 1000040);
+  TEST_STRING_EQUAL(loaded.getMetaValue("string").toString(), "x, y");
+  TEST_EQUAL(loaded.getMetaValue("string").hasUnit(), false);
+  TEST_EQUAL(int(loaded.getMetaValue("int")), 42);
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
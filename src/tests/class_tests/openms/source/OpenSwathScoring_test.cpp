@@ -273,6 +273,53 @@ START_SECTION((OpenSwath::SpectrumPtr OpenSwathScoring::fetchSpectrumSwath(std::
 }
 END_SECTION
 
+START_SECTION((void setSpectrumCache(const boost::shared_ptr<SwathSpectrumCache>& cache)))
+{
+  PeakMap* eptr = new PeakMap;
+  for (int k = 0; k < 3; ++k)
+  {
+    MSSpectrum s;
+    Peak1D p;
+    p.setMZ(100.0 + k);
+    p.setIntensity(100.0);
+    s.push_back(p);
+    p.setMZ(200.0);
+    s.push_back(p);
+    s.setRT(10.0 * (k + 1));
+    eptr->addSpectrum(s);
+  }
+  boost::shared_ptr<PeakMap > swath_map (eptr);
+  OpenSwath::SpectrumAccessPtr swath_ptr = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(swath_map);
+
+  boost::shared_ptr<SwathSpectrumCache> cache(new SwathSpectrumCache(4));
+  OpenSwathScoring sc;
+  OpenSwath_Scores_Usage su;
+  sc.initialize(1.0, 3, 0.005, 0.0, su, "simple");
+  sc.setSpectrumCache(cache);
+
+  OpenSwath::SpectrumPtr sp = sc.fetchSpectrumSwath(swath_ptr, 20.0, 3, 0, 0);
+  TEST_EQUAL(cache->getMisses(), 1)
+  TEST_EQUAL(cache->getHits(), 0)
+  // the sorted spectra are merged, equal m/z keep the order of addition (apex first)
+  TEST_EQUAL(sp->getMZArray()->data.size(), 6)
+  TEST_REAL_SIMILAR(sp->getMZArray()->data[0], 100.0)
+  TEST_REAL_SIMILAR(sp->getMZArray()->data[1], 101.0)
+  TEST_REAL_SIMILAR(sp->getMZArray()->data[2], 102.0)
+  TEST_REAL_SIMILAR(sp->getMZArray()->data[5], 200.0)
+
+  // a retention time close to the same apex scan is served from the cache
+  OpenSwath::SpectrumPtr sp2 = sc.fetchSpectrumSwath(swath_ptr, 21.0, 3, 0, 0);
+  TEST_EQUAL(sp2 == sp, true)
+  TEST_EQUAL(cache->getHits(), 1)
+
+  // a different apex scan is not
+  sc.fetchSpectrumSwath(swath_ptr, 30.0, 3, 0, 0);
+  TEST_EQUAL(cache->getMisses(), 2)
+  TEST_EQUAL(cache->size(), 2)
+  TEST_REAL_SIMILAR(cache->getHitRate(), 1.0 / 3.0)
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -491,4 +491,30 @@ START_SECTION(void pick(const MSSpectrum& input, MSSpectrum& output, std::vector
     
 END_SECTION
 
+START_SECTION([EXTRA] pickExperiment (parallel) matches picking single spectra)
+{
+  PeakPickerHiRes pp;
+  Param p = pp.getParameters();
+  p.setValue("signal_to_noise", 1.0);
+  pp.setParameters(p);
+
+  PeakMap picked;
+  std::vector<std::vector<PeakPickerHiRes::PeakBoundary> > boundaries_s, boundaries_c;
+  pp.pickExperiment(input, picked, boundaries_s, boundaries_c);
+  TEST_EQUAL(picked.size(), input.size())
+
+  Size nr_boundaries(0), nr_boundaries_parallel(0);
+  for (Size i = 0; i < input.size(); ++i)
+  {
+    MSSpectrum single;
+    std::vector<PeakPickerHiRes::PeakBoundary> boundaries;
+    pp.pick(input[i], single, boundaries);
+    TEST_EQUAL(picked[i] == single, true)
+    nr_boundaries += boundaries.size();
+  }
+  for (const auto& b : boundaries_s) nr_boundaries_parallel += b.size();
+  TEST_EQUAL(nr_boundaries_parallel, nr_boundaries)
+}
+END_SECTION
+
 END_TEST
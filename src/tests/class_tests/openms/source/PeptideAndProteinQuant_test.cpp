@@ -130,6 +130,39 @@ START_SECTION((void quantifyProteins(const ProteinIdentification& proteins = Pro
 }
 END_SECTION
 
+START_SECTION(([EXTRA] repeated readQuantData(ConsensusMap& consensus, ExperimentalDesign& ed)))
+{
+  // results must not depend on data of a previous run
+  ConsensusMap consensus;
+  ConsensusXMLFile().load(OPENMS_GET_TEST_DATA_PATH("ProteinQuantifier_input.consensusXML"), consensus);
+  ExperimentalDesign design = ExperimentalDesign::fromConsensusMap(consensus);
+  PeptideAndProteinQuant quantifier;
+  quantifier.setParameters(params);
+  for (Size run = 0; run < 2; ++run)
+  {
+    quantifier.readQuantData(consensus, design);
+    quantifier.quantifyPeptides();
+    quantifier.quantifyProteins();
+
+    TEST_EQUAL(quantifier.getStatistics().quant_features, quantifier_consensus.getStatistics().quant_features);
+    TEST_EQUAL(quantifier.getStatistics().quant_peptides, quantifier_consensus.getStatistics().quant_peptides);
+    TEST_EQUAL(quantifier.getStatistics().quant_proteins, quantifier_consensus.getStatistics().quant_proteins);
+
+    const PeptideAndProteinQuant::PeptideQuant& expected = quantifier_consensus.getPeptideResults();
+    const PeptideAndProteinQuant::PeptideQuant& result = quantifier.getPeptideResults();
+    TEST_EQUAL(result.size(), expected.size());
+    ABORT_IF(result.size() != expected.size());
+    auto exp_it = expected.begin();
+    for (auto res_it = result.begin(); res_it != result.end(); ++res_it, ++exp_it)
+    {
+      TEST_EQUAL(res_it->first, exp_it->first);
+      TEST_EQUAL(res_it->second.abundances == exp_it->second.abundances, true);
+      TEST_EQUAL(res_it->second.total_abundances == exp_it->second.total_abundances, true);
+    }
+  }
+}
+END_SECTION
+
 START_SECTION((const Statistics& getStatistics()))
 {
   PeptideAndProteinQuant::Statistics stats;
@@ -207,6 +207,45 @@ START_SECTION((void fit( std::vector<double>& search_engine_scores, std::vector<
 
 END_SECTION
 
+START_SECTION((fit with subsampling (max_fit_points)))
+{
+  vector<double> scores;
+  CsvFile gauss_mix (OPENMS_GET_TEST_DATA_PATH("GaussMix_2_1D.csv"), ';');
+  StringList gauss_mix_strings;
+  gauss_mix.getRow(0, gauss_mix_strings);
+  for (const String& s : gauss_mix_strings)
+  {
+    if (!s.empty()) scores.push_back(s.toDouble());
+  }
+  vector<double> scores_subsampled(scores);
+
+  Param param;
+  param.setValue("incorrectly_assigned", "Gauss");
+  param.setValue("max_fit_points", 0);
+  PosteriorErrorProbabilityModel full;
+  full.setParameters(param);
+  TEST_EQUAL(full.fit(scores, "none"), true)
+
+  // fit on 200 quantiles first, then refine on all 2000 scores
+  param.setValue("max_fit_points", 200);
+  PosteriorErrorProbabilityModel subsampled;
+  subsampled.setParameters(param);
+  TEST_EQUAL(subsampled.fit(scores_subsampled, "none"), true)
+
+  // both converge to the same optimum (up to the convergence threshold)
+  TOLERANCE_ABSOLUTE(0.01)
+  TEST_REAL_SIMILAR(subsampled.getCorrectlyAssignedFitResult().x0, full.getCorrectlyAssignedFitResult().x0)
+  TEST_REAL_SIMILAR(subsampled.getCorrectlyAssignedFitResult().sigma, full.getCorrectlyAssignedFitResult().sigma)
+  TEST_REAL_SIMILAR(subsampled.getIncorrectlyAssignedFitResult().x0, full.getIncorrectlyAssignedFitResult().x0)
+  TEST_REAL_SIMILAR(subsampled.getIncorrectlyAssignedFitResult().sigma, full.getIncorrectlyAssignedFitResult().sigma)
+  TEST_REAL_SIMILAR(subsampled.getNegativePrior(), full.getNegativePrior())
+  for (double score = -1.0; score < 7.0; score += 0.5)
+  {
+    TEST_REAL_SIMILAR(subsampled.computeProbability(score), full.computeProbability(score))
+  }
+}
+END_SECTION
+
 START_SECTION((void fillLogDensities(std::vector<double>& x_scores,std::vector<double>& incorrect_density,std::vector<double>& correct_density)))
 NOT_TESTABLE
 //tested in fit
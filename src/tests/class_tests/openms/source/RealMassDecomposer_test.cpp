@@ -117,6 +117,65 @@ START_SECTION((number_of_decompositions_type getNumberOfDecompositions(double ma
 }
 END_SECTION
 
+RealMassDecomposer decomposer(createWeights());
+const double mass_G = ResidueDB::getInstance()->getResidue('G')->getMonoWeight(Residue::Internal);
+
+START_SECTION((std::pair<integer_value_type, integer_value_type> getIntegerMassRange(double mass, double error) const))
+{
+  pair<RealMassDecomposer::integer_value_type, RealMassDecomposer::integer_value_type> range = decomposer.getIntegerMassRange(500.0, 0.1);
+  TEST_EQUAL(range.first < range.second, true)
+
+  // a smaller error gives a sub-range
+  pair<RealMassDecomposer::integer_value_type, RealMassDecomposer::integer_value_type> narrow = decomposer.getIntegerMassRange(500.0, 0.05);
+  TEST_EQUAL(range.first <= narrow.first, true)
+  TEST_EQUAL(narrow.second <= range.second, true)
+
+  // distant masses give disjoint ranges
+  pair<RealMassDecomposer::integer_value_type, RealMassDecomposer::integer_value_type> other = decomposer.getIntegerMassRange(600.0, 0.1);
+  TEST_EQUAL(range.second < other.first, true)
+}
+END_SECTION
+
+START_SECTION((decompositions_type getIntegerMassDecompositions(integer_value_type integer_mass) const))
+{
+  // the decompositions of the integer masses in the range, filtered by their
+  // real mass, are the decompositions of the real mass
+  const double mass = 2 * mass_G, error = 0.05;
+  pair<RealMassDecomposer::integer_value_type, RealMassDecomposer::integer_value_type> range = decomposer.getIntegerMassRange(mass, error);
+  RealMassDecomposer::decompositions_type from_range;
+  Size n_unfiltered = 0;
+  for (RealMassDecomposer::integer_value_type integer_mass = range.first; integer_mass < range.second; ++integer_mass)
+  {
+    RealMassDecomposer::decompositions_type decompositions = decomposer.getIntegerMassDecompositions(integer_mass);
+    n_unfiltered += decompositions.size();
+    for (const RealMassDecomposer::decomposition_type& d : decompositions)
+    {
+      if (fabs(decomposer.getParentMass(d) - mass) <= error) from_range.push_back(d);
+    }
+  }
+  RealMassDecomposer::decompositions_type expected = decomposer.getDecompositions(mass, error);
+  TEST_EQUAL(from_range == expected, true)
+  TEST_EQUAL(n_unfiltered >= expected.size(), true)
+  // "GG" and "N" have the same elemental composition
+  TEST_EQUAL(expected.size(), 2)
+}
+END_SECTION
+
+START_SECTION((double getParentMass(const decomposition_type& decomposition) const))
+{
+  RealMassDecomposer::decompositions_type decompositions = decomposer.getDecompositions(mass_G, 0.01);
+  TEST_EQUAL(decompositions.size(), 1)
+  ABORT_IF(decompositions.size() != 1)
+  TEST_REAL_SIMILAR(decomposer.getParentMass(decompositions[0]), mass_G)
+
+  RealMassDecomposer::decomposition_type twice = decompositions[0];
+  for (unsigned int& count : twice) count *= 2;
+  TEST_REAL_SIMILAR(decomposer.getParentMass(twice), 2 * mass_G)
+
+  TEST_EXCEPTION(Exception::InvalidParameter, decomposer.getParentMass(RealMassDecomposer::decomposition_type(1, 1)))
+}
+END_SECTION
+
 
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
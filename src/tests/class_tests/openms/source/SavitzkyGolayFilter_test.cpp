@@ -157,6 +157,31 @@ START_SECTION((template <typename PeakType> void filterExperiment(MSExperiment<P
 
 END_SECTION
 
+START_SECTION([EXTRA] filter(MSSpectrum&) matches the iterator-based filter)
+{
+  Param p;
+  p.setValue("polynomial_order", 4);
+  p.setValue("frame_length", 11);
+  SavitzkyGolayFilter sgolay;
+  sgolay.setParameters(p);
+
+  MSSpectrum spectrum;
+  for (Size i = 0; i < 100; ++i)
+  {
+    spectrum.push_back(Peak1D(500.0 + i * 0.01, (i * 37) % 23 + (i % 7 == 0 ? 100.0 : 0.0)));
+  }
+  MSSpectrum expected = spectrum;
+  sgolay.filter(spectrum.begin(), spectrum.end(), expected.begin());
+  sgolay.filter(spectrum);
+
+  for (Size i = 0; i < spectrum.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(spectrum[i].getIntensity(), expected[i].getIntensity())
+    TEST_REAL_SIMILAR(spectrum[i].getMZ(), expected[i].getMZ())
+  }
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
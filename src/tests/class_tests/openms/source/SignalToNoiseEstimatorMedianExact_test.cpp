@@ -0,0 +1,197 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+#include <OpenMS/FORMAT/DTAFile.h>
+
+///////////////////////////
+#include <OpenMS/FILTERING/NOISEESTIMATION/SignalToNoiseEstimatorMedianExact.h>
+///////////////////////////
+
+using namespace OpenMS;
+using namespace std;
+
+// straightforward computation of the S/N values for comparison
+vector<double> bruteForceSTN(const MSSpectrum& spec, double win_len, int min_required, double noise_for_empty)
+{
+  vector<double> result;
+  for (const Peak1D& center : spec)
+  {
+    vector<double> window;
+    for (const Peak1D& peak : spec)
+    {
+      if (peak.getMZ() >= center.getMZ() - win_len / 2 && peak.getMZ() <= center.getMZ() + win_len / 2)
+      {
+        window.push_back(peak.getIntensity());
+      }
+    }
+    double noise = noise_for_empty;
+    if ((int)window.size() >= min_required)
+    {
+      sort(window.begin(), window.end());
+      Size mid = window.size() / 2;
+      double median = (window.size() % 2 == 1) ? window[mid] : (window[mid - 1] + window[mid]) / 2;
+      noise = max(1.0, median);
+    }
+    result.push_back(center.getIntensity() / noise);
+  }
+  return result;
+}
+
+START_TEST(SignalToNoiseEstimatorMedianExact, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+SignalToNoiseEstimatorMedianExact< >* ptr = nullptr;
+SignalToNoiseEstimatorMedianExact< >* nullPointer = nullptr;
+START_SECTION((SignalToNoiseEstimatorMedianExact()))
+  ptr = new SignalToNoiseEstimatorMedianExact<>;
+  TEST_NOT_EQUAL(ptr, nullPointer)
+END_SECTION
+
+START_SECTION((SignalToNoiseEstimatorMedianExact& operator=(const SignalToNoiseEstimatorMedianExact &source)))
+  MSSpectrum raw_data;
+  SignalToNoiseEstimatorMedianExact<> sne;
+  sne.init(raw_data);
+  SignalToNoiseEstimatorMedianExact<> sne2;
+  sne2 = sne;
+  NOT_TESTABLE
+END_SECTION
+
+START_SECTION((SignalToNoiseEstimatorMedianExact(const SignalToNoiseEstimatorMedianExact &source)))
+  MSSpectrum raw_data;
+  SignalToNoiseEstimatorMedianExact<> sne;
+  sne.init(raw_data);
+  SignalToNoiseEstimatorMedianExact<> sne2(sne);
+  NOT_TESTABLE
+END_SECTION
+
+START_SECTION((virtual ~SignalToNoiseEstimatorMedianExact()))
+  delete ptr;
+END_SECTION
+
+MSSpectrum raw_data;
+DTAFile().load(OPENMS_GET_TEST_DATA_PATH("SignalToNoiseEstimator_test.dta"), raw_data);
+
+START_SECTION([EXTRA](virtual void init(const Container& c)))
+{
+  SignalToNoiseEstimatorMedianExact< MSSpectrum > sne;
+  Param p;
+  p.setValue("win_len", 40.0);
+  p.setValue("noise_for_empty_window", 2.0);
+  p.setValue("min_required_elements", 10);
+  sne.setParameters(p);
+  sne.init(raw_data);
+
+  vector<double> expected = bruteForceSTN(raw_data, 40.0, 10, 2.0);
+  for (Size i = 0; i < raw_data.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(sne.getSignalToNoise(i), expected[i])
+  }
+
+  // windows with an odd and an even number of elements, ties and sparse windows
+  MSSpectrum spec;
+  const double intensities[] = {5.0, 3.0, 3.0, 100.0, 7.0, 2.0, 3.0, 50.0, 8.0, 8.0, 1.0, 4.0};
+  for (Size i = 0; i < 12; ++i)
+  {
+    spec.push_back(Peak1D(100.0 + i * (i % 3 + 1), intensities[i]));
+  }
+  for (double win_len : {1.0, 5.0, 10.0, 30.0, 100.0})
+  {
+    p.setValue("win_len", win_len);
+    p.setValue("min_required_elements", 3);
+    sne.setParameters(p);
+    sne.init(spec);
+    expected = bruteForceSTN(spec, win_len, 3, 2.0);
+    for (Size i = 0; i < spec.size(); ++i)
+    {
+      TEST_REAL_SIMILAR(sne.getSignalToNoise(i), expected[i])
+    }
+  }
+}
+END_SECTION
+
+START_SECTION((double getSparseWindowPercent() const))
+{
+  SignalToNoiseEstimatorMedianExact< MSSpectrum > sne;
+  Param p;
+  p.setValue("win_len", 1.0);
+  p.setValue("min_required_elements", 2);
+  p.setValue("write_log_messages", "false");
+  sne.setParameters(p);
+  MSSpectrum spec;
+  spec.push_back(Peak1D(100.0, 10.0));
+  spec.push_back(Peak1D(100.2, 20.0));
+  spec.push_back(Peak1D(200.0, 30.0));
+  spec.push_back(Peak1D(300.0, 40.0));
+  sne.init(spec);
+  TEST_REAL_SIMILAR(sne.getSparseWindowPercent(), 50.0)
+}
+END_SECTION
+
+START_SECTION((template <typename ContainerRange> void computeSTNBatch(const ContainerRange& containers, std::vector<std::vector<double> >& estimates) const))
+{
+  SignalToNoiseEstimatorMedianExact< MSSpectrum > sne;
+  Param p;
+  p.setValue("win_len", 40.0);
+  p.setValue("noise_for_empty_window", 2.0);
+  p.setValue("min_required_elements", 10);
+  sne.setParameters(p);
+  vector<double> expected = bruteForceSTN(raw_data, 40.0, 10, 2.0);
+
+  // the same spectrum several times (and an empty one)
+  std::vector<MSSpectrum> spectra(5, raw_data);
+  spectra[2].clear(false);
+  std::vector<std::vector<double> > estimates;
+  sne.computeSTNBatch(spectra, estimates);
+
+  TEST_EQUAL(estimates.size(), 5)
+  TEST_EQUAL(estimates[2].size(), 0)
+  for (Size s = 0; s < estimates.size(); ++s)
+  {
+    if (s == 2) continue;
+    TEST_EQUAL(estimates[s].size(), raw_data.size())
+    for (Size i = 0; i < raw_data.size(); ++i)
+    {
+      TEST_REAL_SIMILAR(estimates[s][i], expected[i])
+    }
+  }
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -115,6 +115,40 @@ START_SECTION([EXTRA](virtual void init(const Container& c)))
 END_SECTION
 
 
+START_SECTION((template <typename ContainerRange> void computeSTNBatch(const ContainerRange& containers, std::vector<std::vector<double> >& estimates) const))
+{
+  MSSpectrum raw_data;
+  DTAFile().load(OPENMS_GET_TEST_DATA_PATH("SignalToNoiseEstimator_test.dta"), raw_data);
+  MSSpectrum stn_data;
+  DTAFile().load(OPENMS_GET_TEST_DATA_PATH("SignalToNoiseEstimatorMedian_test.out"), stn_data);
+
+  SignalToNoiseEstimatorMedian< MSSpectrum > sne;
+  Param p;
+  p.setValue("win_len", 40.0);
+  p.setValue("noise_for_empty_window", 2.0);
+  p.setValue("min_required_elements", 10);
+  sne.setParameters(p);
+
+  // the same spectrum several times (and an empty one)
+  std::vector<MSSpectrum> spectra(5, raw_data);
+  spectra[2].clear(false);
+  std::vector<std::vector<double> > estimates;
+  sne.computeSTNBatch(spectra, estimates);
+
+  TEST_EQUAL(estimates.size(), 5)
+  TEST_EQUAL(estimates[2].size(), 0)
+  for (Size s = 0; s < estimates.size(); ++s)
+  {
+    if (s == 2) continue;
+    TEST_EQUAL(estimates[s].size(), raw_data.size())
+    for (Size i = 0; i < raw_data.size(); ++i)
+    {
+      TEST_REAL_SIMILAR(stn_data[i].getIntensity(), estimates[s][i])
+    }
+  }
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
@@ -223,6 +223,42 @@ START_SECTION((map<String, pair<double, double>> void getScaling()
 END_SECTION
 
 
+START_SECTION(([EXTRA] linear kernel (coordinate descent solver)))
+{
+  SimpleSVM linear_svm;
+  Param params = linear_svm.getParameters();
+  params.setValue("kernel", "linear");
+  linear_svm.setParameters(params);
+  SimpleSVM::PredictorMap tmp(predictors);
+  linear_svm.setup(tmp, labels);
+
+  vector<SimpleSVM::Prediction> predictions;
+  linear_svm.predict(predictions);
+  TEST_EQUAL(predictions.size(), predictors.begin()->second.size());
+  Size n_correct = 0;
+  for (const SimpleSVM::Prediction& pred : predictions)
+  {
+    TEST_EQUAL((pred.label == 0) || (pred.label == 1), true);
+    TEST_EQUAL(pred.probabilities.size(), 2);
+    TEST_REAL_SIMILAR(pred.probabilities.at(0) + pred.probabilities.at(1), 1.0);
+    TEST_EQUAL(pred.probabilities.at(pred.label) >= 0.5, true);
+  }
+  for (map<Size, Int>::const_iterator it = labels.begin(); it != labels.end(); ++it)
+  {
+    if (predictions[it->first].label == it->second) ++n_correct;
+  }
+  // the training data is (almost) linearly separable:
+  TEST_EQUAL(n_correct >= 0.9 * labels.size(), true);
+
+  map<String, double> feat_weights;
+  linear_svm.getFeatureWeights(feat_weights);
+  TEST_EQUAL(feat_weights.size(), predictors.size());
+
+  vector<Size> indexes(1, 100);
+  TEST_EXCEPTION(Exception::InvalidValue, linear_svm.predict(predictions, indexes));
+}
+END_SECTION
+
 START_SECTION((void writeXvalResults(const String& path) const))
 {
   string xval_file;
@@ -146,6 +146,50 @@ START_SECTION((template < typename MapType > void mergeSpectraPrecursors(MapType
 
 END_SECTION
 
+START_SECTION(([EXTRA] mergeSpectraPrecursors with single linkage chains))
+  // spectra 1-2 and 2-3 are within tolerance, 1-3 is not (RT): single linkage joins all three
+  PeakMap exp;
+  const double rts[] = {10.0, 12.0, 14.0, 16.0, 20.0};
+  const double pc_mzs[] = {0.0, 500.0, 500.00005, 500.0001, 600.0};
+  for (Size i = 0; i < 5; ++i)
+  {
+    MSSpectrum s;
+    s.setRT(rts[i]);
+    s.setMSLevel(i == 0 ? 1 : 2);
+    if (i > 0)
+    {
+      s.getPrecursors().resize(1);
+      s.getPrecursors()[0].setMZ(pc_mzs[i]);
+    }
+    s.push_back(Peak1D(100.0 + i, 10.0));
+    s.push_back(Peak1D(200.0, 20.0));
+    exp.addSpectrum(s);
+  }
+  SpectraMerger merger;
+  Param p(merger.getParameters());
+  p.setValue("mz_binning_width", 0.3);
+  p.setValue("mz_binning_width_unit", "Da");
+  p.setValue("precursor_method:mz_tolerance", 10e-5);
+  p.setValue("precursor_method:rt_tolerance", 2.5);
+  merger.setParameters(p);
+  merger.mergeSpectraPrecursors(exp);
+
+  ABORT_IF(exp.size() != 3)
+  TEST_EQUAL(exp[0].getMSLevel(), 1)
+  TEST_REAL_SIMILAR(exp[1].getRT(), 14.0)
+  TEST_REAL_SIMILAR(exp[1].getPrecursors()[0].getMZ(), 500.00005)
+  TEST_EQUAL(exp[1].size(), 4) // three distinct peaks plus the shared one at 200
+  TEST_REAL_SIMILAR(exp[1][3].getIntensity(), 60.0)
+  TEST_REAL_SIMILAR(exp[2].getRT(), 20.0)
+  TEST_REAL_SIMILAR(exp[2].getPrecursors()[0].getMZ(), 600.0)
+
+  // no MS2 spectra: nothing to merge
+  PeakMap exp_ms1;
+  exp_ms1.addSpectrum(exp[0]);
+  merger.mergeSpectraPrecursors(exp_ms1);
+  TEST_EQUAL(exp_ms1.size(), 1)
+END_SECTION
+
 START_SECTION((template < typename MapType > void averageGaussian(MapType &exp)))
 	PeakMap exp;
 	MzMLFile().load(OPENMS_GET_TEST_DATA_PATH("SpectraMerger_input_3.mzML"), exp);    // profile mode
@@ -0,0 +1,184 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#include <OpenMS/test_config.h>
+
+///////////////////////////
+#include <OpenMS/ANALYSIS/OPENSWATH/SwathSpectrumCache.h>
+///////////////////////////
+
+#include <OpenMS/ANALYSIS/OPENSWATH/DATAACCESS/SimpleOpenMSSpectraAccessFactory.h>
+#include <OpenMS/KERNEL/MSExperiment.h>
+
+using namespace OpenMS;
+using namespace std;
+
+START_TEST(SwathSpectrumCache, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+SwathSpectrumCache* ptr = nullptr;
+SwathSpectrumCache* nullPointer = nullptr;
+
+START_SECTION(SwathSpectrumCache(Size capacity = 16))
+{
+  ptr = new SwathSpectrumCache();
+  TEST_NOT_EQUAL(ptr, nullPointer)
+  TEST_EQUAL(ptr->getCapacity(), 16)
+  TEST_EQUAL(ptr->size(), 0)
+  TEST_REAL_SIMILAR(ptr->getHitRate(), 0.0)
+}
+END_SECTION
+
+START_SECTION(~SwathSpectrumCache())
+{
+  delete ptr;
+}
+END_SECTION
+
+boost::shared_ptr<PeakMap> exp(new PeakMap);
+OpenSwath::SpectrumAccessPtr swath_map = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+OpenSwath::SpectrumPtr spec1(new OpenSwath::Spectrum);
+OpenSwath::SpectrumPtr spec2(new OpenSwath::Spectrum);
+OpenSwath::SpectrumPtr spec3(new OpenSwath::Spectrum);
+OpenSwath::SpectrumPtr null_spec;
+
+START_SECTION((OpenSwath::SpectrumPtr get(const OpenSwath::SpectrumAccessPtr& swath_map, int apex_index, int nr_spectra_to_add, double drift_lower, double drift_upper)))
+{
+  SwathSpectrumCache cache(2);
+  TEST_EQUAL(cache.get(swath_map, 0, 1, 0, 0) == null_spec, true)
+  cache.insert(swath_map, 0, 1, 0, 0, spec1);
+  TEST_EQUAL(cache.get(swath_map, 0, 1, 0, 0) == spec1, true)
+
+  // all parts of the key have to match
+  TEST_EQUAL(cache.get(swath_map, 1, 1, 0, 0) == null_spec, true)
+  TEST_EQUAL(cache.get(swath_map, 0, 3, 0, 0) == null_spec, true)
+  TEST_EQUAL(cache.get(swath_map, 0, 1, 0.5, 1.0) == null_spec, true)
+  OpenSwath::SpectrumAccessPtr other_map = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+  TEST_EQUAL(cache.get(other_map, 0, 1, 0, 0) == null_spec, true)
+
+  TEST_EQUAL(cache.getHits(), 1)
+  TEST_EQUAL(cache.getMisses(), 5)
+}
+END_SECTION
+
+START_SECTION((void insert(const OpenSwath::SpectrumAccessPtr& swath_map, int apex_index, int nr_spectra_to_add, double drift_lower, double drift_upper, const OpenSwath::SpectrumPtr& spectrum)))
+{
+  SwathSpectrumCache cache(2);
+  cache.insert(swath_map, 0, 1, 0, 0, spec1);
+  cache.insert(swath_map, 1, 1, 0, 0, spec2);
+  TEST_EQUAL(cache.size(), 2)
+
+  // spectrum 0 was used most recently, spectrum 1 is evicted
+  TEST_EQUAL(cache.get(swath_map, 0, 1, 0, 0) == spec1, true)
+  cache.insert(swath_map, 2, 1, 0, 0, spec3);
+  TEST_EQUAL(cache.size(), 2)
+  TEST_EQUAL(cache.get(swath_map, 1, 1, 0, 0) == null_spec, true)
+  TEST_EQUAL(cache.get(swath_map, 0, 1, 0, 0) == spec1, true)
+  TEST_EQUAL(cache.get(swath_map, 2, 1, 0, 0) == spec3, true)
+
+  // re-inserting replaces the spectrum
+  cache.insert(swath_map, 2, 1, 0, 0, spec2);
+  TEST_EQUAL(cache.size(), 2)
+  TEST_EQUAL(cache.get(swath_map, 2, 1, 0, 0) == spec2, true)
+
+  // a disabled cache stores nothing
+  SwathSpectrumCache disabled(0);
+  disabled.insert(swath_map, 0, 1, 0, 0, spec1);
+  TEST_EQUAL(disabled.size(), 0)
+}
+END_SECTION
+
+START_SECTION(([EXTRA] entries of destroyed maps are not returned))
+{
+  SwathSpectrumCache cache(2);
+  {
+    OpenSwath::SpectrumAccessPtr tmp_map = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+    cache.insert(tmp_map, 0, 1, 0, 0, spec1);
+    TEST_EQUAL(cache.get(tmp_map, 0, 1, 0, 0) == spec1, true)
+  }
+  // a new map may reuse the address of the destroyed one
+  OpenSwath::SpectrumAccessPtr new_map = SimpleOpenMSSpectraFactory::getSpectrumAccessOpenMSPtr(exp);
+  TEST_EQUAL(cache.get(new_map, 0, 1, 0, 0) == null_spec, true)
+}
+END_SECTION
+
+START_SECTION(void setCapacity(Size capacity))
+{
+  SwathSpectrumCache cache(3);
+  cache.insert(swath_map, 0, 1, 0, 0, spec1);
+  cache.insert(swath_map, 1, 1, 0, 0, spec2);
+  cache.insert(swath_map, 2, 1, 0, 0, spec3);
+  cache.setCapacity(1);
+  TEST_EQUAL(cache.getCapacity(), 1)
+  TEST_EQUAL(cache.size(), 1)
+  TEST_EQUAL(cache.get(swath_map, 2, 1, 0, 0) == spec3, true)
+}
+END_SECTION
+
+START_SECTION(void clear())
+{
+  SwathSpectrumCache cache(3);
+  cache.insert(swath_map, 0, 1, 0, 0, spec1);
+  TEST_EQUAL(cache.get(swath_map, 0, 1, 0, 0) == spec1, true)
+  cache.clear();
+  TEST_EQUAL(cache.size(), 0)
+  TEST_EQUAL(cache.get(swath_map, 0, 1, 0, 0) == null_spec, true)
+  // statistics are kept
+  TEST_EQUAL(cache.getHits(), 1)
+  TEST_EQUAL(cache.getMisses(), 1)
+}
+END_SECTION
+
+START_SECTION(double getHitRate() const)
+{
+  SwathSpectrumCache cache(3);
+  cache.insert(swath_map, 0, 1, 0, 0, spec1);
+  cache.get(swath_map, 0, 1, 0, 0);
+  cache.get(swath_map, 0, 1, 0, 0);
+  cache.get(swath_map, 0, 1, 0, 0);
+  cache.get(swath_map, 1, 1, 0, 0);
+  TEST_REAL_SIMILAR(cache.getHitRate(), 0.75)
+  cache.resetStatistics();
+  TEST_EQUAL(cache.getHits(), 0)
+  TEST_EQUAL(cache.getMisses(), 0)
+  TEST_REAL_SIMILAR(cache.getHitRate(), 0.0)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
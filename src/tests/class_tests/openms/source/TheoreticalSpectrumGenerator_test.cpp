@@ -42,6 +42,7 @@
 
 #include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
 #include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/CHEMISTRY/CompactAASequence.h>
 #include <OpenMS/KERNEL/MSSpectrum.h>
 #include <OpenMS/KERNEL/MSExperiment.h>
 #include <OpenMS/CONCEPT/Constants.h>
@@ -474,6 +475,112 @@ START_SECTION(void getSpectrum(PeakSpectrum& spec, const AASequence& peptide, In
 
 END_SECTION
 
+START_SECTION(void getSpectrum(PeakSpectrum& spec, const CompactAASequence& peptide, Int min_charge, Int max_charge, Int precursor_charge = 0) const)
+{
+  TheoreticalSpectrumGenerator t_gen;
+  Param params = t_gen.getParameters();
+  params.setValue("add_a_ions", "true");
+  params.setValue("add_c_ions", "true");
+  params.setValue("add_x_ions", "true");
+  params.setValue("add_z_ions", "true");
+  params.setValue("add_first_prefix_ion", "true");
+  params.setValue("add_precursor_peaks", "true");
+  params.setValue("add_all_precursor_charges", "true");
+  params.setValue("add_abundant_immonium_ions", "true");
+  params.setValue("add_metainfo", "true");
+
+  AASequence seq = AASequence::fromString(".(Acetyl)PEPTM(Oxidation)IDEHWK.(Amidated)");
+  CompactAASequence compact(seq);
+
+  // fast path from the prefix masses and fallback path (losses) have to match the AASequence spectrum
+  for (String losses : {"false", "true"})
+  {
+    params.setValue("add_losses", losses);
+    t_gen.setParameters(params);
+
+    PeakSpectrum expected, spec;
+    t_gen.getSpectrum(expected, seq, 1, 3);
+    t_gen.getSpectrum(spec, compact, 1, 3);
+
+    TEST_EQUAL(spec.size(), expected.size())
+    TEST_EQUAL(spec.getPrecursors().size(), 1)
+    TEST_REAL_SIMILAR(spec.getPrecursors()[0].getMZ(), expected.getPrecursors()[0].getMZ())
+    ABORT_IF(spec.size() != expected.size())
+    for (Size i = 0; i != spec.size(); ++i)
+    {
+      TEST_REAL_SIMILAR(spec[i].getMZ(), expected[i].getMZ())
+      TEST_REAL_SIMILAR(spec[i].getIntensity(), expected[i].getIntensity())
+      TEST_STRING_EQUAL(spec.getStringDataArrays()[0][i], expected.getStringDataArrays()[0][i])
+      TEST_EQUAL(spec.getIntegerDataArrays()[0][i], expected.getIntegerDataArrays()[0][i])
+    }
+  }
+}
+END_SECTION
+
+START_SECTION(void getFragments(FragmentBuffer& buffer, const AASequence& peptide, Int min_charge, Int max_charge, bool add_intensities = false, bool add_ion_types = false) const)
+{
+  TheoreticalSpectrumGenerator t_gen;
+  Param params = t_gen.getParameters();
+  params.setValue("add_a_ions", "true");
+  params.setValue("add_z_ions", "true");
+  params.setValue("add_precursor_peaks", "true");
+  params.setValue("add_abundant_immonium_ions", "true");
+  params.setValue("add_metainfo", "true");
+  t_gen.setParameters(params);
+
+  AASequence seq = AASequence::fromString(".(Acetyl)PEPTM(Oxidation)IDEHWK.(Amidated)");
+  PeakSpectrum expected;
+  t_gen.getSpectrum(expected, seq, 1, 2);
+
+  TheoreticalSpectrumGenerator::FragmentBuffer buffer;
+  t_gen.getFragments(buffer, seq, 1, 2, true, true);
+  TEST_EQUAL(buffer.size(), expected.size())
+  TEST_EQUAL(buffer.intensity.size(), expected.size())
+  TEST_EQUAL(buffer.ion_type.size(), expected.size())
+  TEST_EQUAL(buffer.charge.size(), expected.size())
+  ABORT_IF(buffer.size() != expected.size())
+  TEST_EQUAL(std::is_sorted(buffer.mz.begin(), buffer.mz.end()), true)
+  for (Size i = 0; i != buffer.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(buffer.mz[i], expected[i].getMZ())
+    TEST_EQUAL(buffer.charge[i], expected.getIntegerDataArrays()[0][i])
+  }
+
+  // buffer is reused: memory stays, content is replaced
+  const double* data = buffer.mz.data();
+  t_gen.getFragments(buffer, AASequence::fromString("PEPTIDE"), 1, 1);
+  TEST_EQUAL(buffer.mz.data(), data)
+  TEST_EQUAL(buffer.intensity.empty(), true)
+  TEST_EQUAL(buffer.ion_type.empty(), true)
+  TEST_EQUAL(buffer.size(), 5 + 6 + 5 + 6 + 3 + 1) // b, y, a, z, precursor, immonium (P)
+
+  t_gen.getFragments(buffer, AASequence(), 1, 1);
+  TEST_EQUAL(buffer.size(), 0)
+}
+END_SECTION
+
+START_SECTION(void getFragments(FragmentBuffer& buffer, const CompactAASequence& peptide, Int min_charge, Int max_charge, bool add_intensities = false, bool add_ion_types = false) const)
+{
+  TheoreticalSpectrumGenerator t_gen;
+  AASequence seq = AASequence::fromString("IFSQVGK");
+  TheoreticalSpectrumGenerator::FragmentBuffer expected, buffer;
+  t_gen.getFragments(expected, seq, 1, 3, true, true);
+  t_gen.getFragments(buffer, CompactAASequence(seq), 1, 3, true, true);
+  TEST_EQUAL(buffer.size(), 33)
+  TEST_EQUAL(buffer.size(), expected.size())
+  ABORT_IF(buffer.size() != expected.size())
+  for (Size i = 0; i != buffer.size(); ++i)
+  {
+    TEST_REAL_SIMILAR(buffer.mz[i], expected.mz[i])
+    TEST_REAL_SIMILAR(buffer.intensity[i], expected.intensity[i])
+    TEST_EQUAL(buffer.ion_type[i], expected.ion_type[i])
+  }
+  TEST_REAL_SIMILAR(buffer.mz[0], (147.11285 + 2 * Constants::PROTON_MASS_U) / 3.0)
+  TEST_EQUAL(buffer.ion_type[0], Residue::YIon)
+  TEST_EQUAL(buffer.charge[0], 3)
+}
+END_SECTION
+
 START_SECTION(([EXTRA] bugfix test where losses lead to formulae with negative element frequencies))
 {
   // this tests for the loss of CONH2 on Arginine, however it is not clear how
@@ -538,16 +645,22 @@ START_SECTION(([EXTRA] test monomer extreme case))
   TheoreticalSpectrumGenerator t_gen;
   Param params;
 
+  TheoreticalSpectrumGenerator::FragmentBuffer buffer;
+
   params.setValue("add_first_prefix_ion", "true");
   params.setValue("add_x_ions", "true");
   t_gen.setParameters(params);
   TEST_EXCEPTION(Exception::InvalidSize, t_gen.getSpectrum(tmp, tmp_aa, 1, 1));
+  TEST_EXCEPTION(Exception::InvalidSize, t_gen.getFragments(buffer, tmp_aa, 1, 1));
+  TEST_EXCEPTION(Exception::InvalidSize, t_gen.getFragments(buffer, CompactAASequence(tmp_aa), 1, 1));
 
   params.setValue("add_first_prefix_ion", "true");
   params.setValue("add_x_ions", "false");
   params.setValue("add_c_ions", "true");
   t_gen.setParameters(params);
   TEST_EXCEPTION(Exception::InvalidSize, t_gen.getSpectrum(tmp, tmp_aa, 1, 1));
+  TEST_EXCEPTION(Exception::InvalidSize, t_gen.getFragments(buffer, tmp_aa, 1, 1));
+  TEST_EXCEPTION(Exception::InvalidSize, t_gen.getFragments(buffer, CompactAASequence(tmp_aa), 1, 1));
 
   params.setValue("add_x_ions", "false");
   params.setValue("add_c_ions", "false");
@@ -555,6 +668,8 @@ START_SECTION(([EXTRA] test monomer extreme case))
   t_gen.setParameters(params);
   t_gen.getSpectrum(tmp, tmp_aa, 1, 1);
   TEST_EQUAL(tmp.size(), 3)
+  t_gen.getFragments(buffer, tmp_aa, 1, 1);
+  TEST_EQUAL(buffer.size(), 3)
 }
 END_SECTION
 
@@ -187,6 +187,60 @@ START_SECTION(([EXTRA] TransformationModelInterpolated::evaluate() beyond the ac
 }
 END_SECTION
 
+START_SECTION((void evaluate(const std::vector<double>& values, std::vector<double>& results) const))
+{
+  TransformationModel::DataPoints data;
+  for (Size i = 0; i < 50; ++i)
+  {
+    data.push_back(make_pair(10.0 * i + (i % 3), 5.0 * i + sin(double(i))));
+  }
+
+  // sorted values (several blocks), inside and outside of the data range
+  vector<double> sorted_values;
+  for (double v = -100.0; v < 600.0; v += 0.1)
+  {
+    sorted_values.push_back(v);
+  }
+  // unsorted values
+  vector<double> unsorted_values;
+  for (Size i = 0; i < 1000; ++i)
+  {
+    unsorted_values.push_back(-50.0 + double((i * 7919) % 1000) * 0.6);
+  }
+
+  StringList types = ListUtils::create<String>("linear,cspline,akima");
+  for (Size t = 0; t < types.size(); ++t)
+  {
+    Param p;
+    TransformationModelInterpolated::getDefaultParameters(p);
+    p.setValue("interpolation_type", types[t]);
+    TransformationModelInterpolated model(data, p);
+
+    vector<double> results;
+    model.evaluate(sorted_values, results);
+    TEST_EQUAL(results.size(), sorted_values.size())
+    Size n_diff = 0;
+    for (Size i = 0; i < sorted_values.size(); ++i)
+    {
+      if (results[i] != model.evaluate(sorted_values[i])) ++n_diff;
+    }
+    TEST_EQUAL(n_diff, 0)
+
+    model.evaluate(unsorted_values, results);
+    TEST_EQUAL(results.size(), unsorted_values.size())
+    n_diff = 0;
+    for (Size i = 0; i < unsorted_values.size(); ++i)
+    {
+      if (results[i] != model.evaluate(unsorted_values[i])) ++n_diff;
+    }
+    TEST_EQUAL(n_diff, 0)
+
+    model.evaluate(vector<double>(), results);
+    TEST_EQUAL(results.empty(), true)
+  }
+}
+END_SECTION
+
 START_SECTION((static void getDefaultParameters(Param & params)))
 {
   Param p;
@@ -150,6 +150,31 @@ START_SECTION((virtual double evaluate(double value) const))
 }
 END_SECTION
 
+START_SECTION((void evaluate(const std::vector<double>& values, std::vector<double>& results) const))
+{
+  // same data and parameters as above
+  Param params;
+  params.setValue("span", 0.3);
+  params.setValue("num_iterations", 3);
+  params.setValue("delta", -1.0);
+  params.setValue("interpolation_type", "cspline");
+  params.setValue("extrapolation_type", "four-point-linear");
+  TransformationModelLowess tm(data, params);
+
+  vector<double> values, results;
+  for (double v = -4; v < 4.1; v += 0.2)
+  {
+    values.push_back(v);
+  }
+  tm.evaluate(values, results);
+  TEST_EQUAL(results.size(), values.size())
+  for (Size i = 0; i < values.size(); ++i)
+  {
+    TEST_EQUAL(results[i], tm.evaluate(values[i]))
+  }
+}
+END_SECTION
+
 START_SECTION((void getParameters(Param& params) const))
 {
   Param p_in;
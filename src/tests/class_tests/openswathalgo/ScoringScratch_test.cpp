@@ -0,0 +1,131 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry               
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+// 
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution 
+//    may be used to endorse or promote products derived from this software 
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS. 
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING 
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, 
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, 
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; 
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, 
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR 
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF 
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// 
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include "OpenMS/OPENSWATHALGO/OpenSwathAlgoConfig.h"
+
+#include "OpenMS/OPENSWATHALGO/ALGO/ScoringScratch.h"
+
+#ifdef USE_BOOST_UNIT_TEST
+
+// include boost unit test framework
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE MyTest
+#include <boost/test/unit_test.hpp>
+// macros for boost
+#define TEST_EQUAL(val1, val2) BOOST_CHECK_EQUAL(val1, val2);
+#define END_SECTION
+#define START_TEST(var1, var2)
+#define END_TEST
+
+#else
+
+#include <OpenMS/CONCEPT/ClassTest.h>
+#define BOOST_AUTO_TEST_CASE START_SECTION
+using namespace OpenMS;
+
+#endif
+
+using namespace std;
+using namespace OpenSwath;
+
+///////////////////////////
+
+START_TEST(ScoringScratch, "$Id$")
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE(test_acquire_and_frame)
+{
+  ScoringScratch scratch;
+  TEST_EQUAL(scratch.getPoolSize(), 0)
+  TEST_EQUAL(scratch.getAllocationCount(), 0)
+  {
+    ScoringScratch::Frame frame(scratch);
+    std::vector<double>& a = scratch.acquire(10);
+    std::vector<double>& b = scratch.acquire();
+    TEST_EQUAL(a.empty(), true)
+    TEST_EQUAL(a.capacity() >= 10, true)
+    TEST_EQUAL(&a != &b, true)
+    TEST_EQUAL(scratch.getPoolSize(), 2)
+    TEST_EQUAL(scratch.getAllocationCount(), 1)
+
+    // growth of a buffer in use is accounted for
+    b.assign(5, 1.0);
+    TEST_EQUAL(scratch.getAllocationCount(), 2)
+  }
+  {
+    // buffers of a finished frame are handed out again
+    ScoringScratch::Frame frame(scratch);
+    std::vector<double>& a = scratch.acquire(10);
+    std::vector<double>& b = scratch.acquire(5);
+    TEST_EQUAL(b.empty(), true)
+    TEST_EQUAL(scratch.getPoolSize(), 2)
+    TEST_EQUAL(scratch.getAllocationCount(), 2)
+    {
+      ScoringScratch::Frame inner(scratch);
+      std::vector<double>& c = scratch.acquire();
+      TEST_EQUAL(&c != &a, true)
+      TEST_EQUAL(scratch.getPoolSize(), 3)
+    }
+    TEST_EQUAL(&scratch.acquire() != &b, true)
+    TEST_EQUAL(scratch.getPoolSize(), 3)
+  }
+}
+END_SECTION
+
+BOOST_AUTO_TEST_CASE(test_reset)
+{
+  ScoringScratch scratch;
+  for (int group = 0; group < 3; ++group)
+  {
+    scratch.reset();
+    std::vector<double>& a = scratch.acquire();
+    a.assign(100, 2.0);
+    // only the first group needs to allocate
+    TEST_EQUAL(scratch.getAllocationCount(), group == 0 ? 1 : 0)
+  }
+  TEST_EQUAL(scratch.getPoolSize(), 1)
+}
+END_SECTION
+
+BOOST_AUTO_TEST_CASE(test_threadLocal)
+{
+  TEST_EQUAL(&ScoringScratch::threadLocal() == &ScoringScratch::threadLocal(), true)
+}
+END_SECTION
+
+/////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////
+END_TEST
@@ -451,6 +451,30 @@ m1 = mi(x_ranking,y_ranking)
 }
 END_SECTION
 
+BOOST_AUTO_TEST_CASE(test_rankedMutualInformation_ranks)
+{
+  static const double arr1[] =
+  {
+    5.97543668746948, 4.2749171257019, 3.3301842212677, 4.08597040176392, 5.50307035446167, 5.24326848983765,
+    8.40812492370605, 2.83419919013977, 6.94378805160522, 7.69957494735718, 4.08597040176392
+  };
+  static const double arr2[] =
+  {
+    15.8951349258423, 41.5446395874023, 76.0746307373047, 109.069435119629, 111.90364074707, 169.79216003418,
+    121.043930053711, 63.0136985778809, 44.6150207519531, 21.4926776885986, 7.93575811386108
+  };
+  std::vector<double> data1 (arr1, arr1 + sizeof(arr1) / sizeof(arr1[0]) );
+  std::vector<double> data2 (arr2, arr2 + sizeof(arr2) / sizeof(arr2[0]) );
+
+  // precomputed ranks give the same result as ranking on the fly
+  std::vector<unsigned int> ranks1 = Scoring::computeRank(data1);
+  std::vector<unsigned int> ranks2 = Scoring::computeRank(data2);
+  double result = Scoring::rankedMutualInformation(ranks1, ranks2);
+
+  TEST_REAL_SIMILAR (result, 3.2776);
+}
+END_SECTION
+
 /////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////
 END_TEST
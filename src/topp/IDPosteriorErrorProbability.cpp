@@ -37,6 +37,8 @@
 #include <OpenMS/MATH/STATISTICS/PosteriorErrorProbabilityModel.h>
 #include <OpenMS/FORMAT/IdXMLFile.h>
 
+#include <memory>
+
 using namespace OpenMS;
 using namespace Math; //PosteriorErrorProbabilityModel
 using namespace std;
@@ -168,8 +170,6 @@ protected:
     vector<ProteinIdentification> protein_ids;
     vector<PeptideIdentification> peptide_ids;
     file.load(inputfile_name, protein_ids, peptide_ids);
-    PosteriorErrorProbabilityModel PEP_model;
-    PEP_model.setParameters(fit_algorithm);
     //-------------------------------------------------------------
     // calculations
     //-------------------------------------------------------------
@@ -206,26 +206,51 @@ protected:
 
     String out_plot = fit_algorithm.getValue("out_plot").toString().trim();
 
+    // the models (one per engine, or per engine and charge state) are independent: fit them in parallel
+    // (a single model is fitted outside of a parallel region, so the EM algorithm itself can use all threads).
+    // Plots of different models can share the same 'out_plot' file (e.g. several engines without
+    // split_charge), so models are fitted one after the other if plots are requested.
+    vector<map<String, vector<vector<double> > >::value_type*> scores;
     for (auto & score : all_scores)
     {
-      vector<String> engine_info;
-      score.first.split(',', engine_info);
-      String engine = engine_info[0];
-      Int charge = (engine_info.size() == 2) ? engine_info[1].toInt() : -1;
+      scores.push_back(&score);
+    }
+    vector<std::unique_ptr<PosteriorErrorProbabilityModel> > PEP_models(scores.size());
+    vector<char> fitted(scores.size(), false);
 
-      if (split_charge)
+#pragma omp parallel for schedule(dynamic, 1) if (scores.size() > 1 && out_plot.empty())
+    for (SignedSize i = 0; i < (SignedSize)scores.size(); ++i)
+    {
+      Param model_param = fit_algorithm;
+      if (split_charge && !out_plot.empty())
       {
         // only adapt plot output if plot is requested (this badly violates the output rules and needs to change!)
         // one way to fix this: plot charges into a single file (no renaming of output file needed) - but this requires major code restructuring
-        if (!out_plot.empty()) fit_algorithm.setValue("out_plot", out_plot + "_charge_" + String(charge));
-        PEP_model.setParameters(fit_algorithm);
+        vector<String> engine_info;
+        scores[i]->first.split(',', engine_info);
+        Int charge = (engine_info.size() == 2) ? engine_info[1].toInt() : -1;
+        model_param.setValue("out_plot", out_plot + "_charge_" + String(charge));
       }
+      PEP_models[i] = std::make_unique<PosteriorErrorProbabilityModel>();
+      PEP_models[i]->setParameters(model_param);
 
       // fit to score vector
       //TODO choose outlier handling based on search engine? If not set by user?
       //XTandem is prone to accumulation at min values/censoring
       //OMSSA is prone to outliers
-      bool return_value = PEP_model.fit(score.second[0], outlier_handling);
+      fitted[i] = PEP_models[i]->fit(scores[i]->second[0], outlier_handling);
+    }
+
+    for (Size i = 0; i < scores.size(); ++i)
+    {
+      auto & score = *scores[i];
+      const PosteriorErrorProbabilityModel & PEP_model = *PEP_models[i];
+      vector<String> engine_info;
+      score.first.split(',', engine_info);
+      String engine = engine_info[0];
+      Int charge = (engine_info.size() == 2) ? engine_info[1].toInt() : -1;
+
+      bool return_value = fitted[i];
 
       if (!return_value) 
       {
@@ -241,7 +266,7 @@ protected:
          && target_decoy_available 
          && (!score.second[0].empty()))
         {
-          PEP_model.plotTargetDecoyEstimation(score.second[1], score.second[2]); //target, decoy
+          PEP_models[i]->plotTargetDecoyEstimation(score.second[1], score.second[2]); //target, decoy
         }
         
         bool unable_to_fit_data(true), data_might_not_be_well_fit(true);
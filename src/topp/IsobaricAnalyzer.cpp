@@ -266,15 +266,6 @@ protected:
     String in = getStringOption_("in");
     String out = getStringOption_("out");
 
-    //-------------------------------------------------------------
-    // loading input
-    //-------------------------------------------------------------
-
-    MzMLFile mz_data_file;
-    PeakMap exp;
-    mz_data_file.setLogType(log_type_);
-    mz_data_file.load(in, exp);
-
     //-------------------------------------------------------------
     // init quant method
     //-------------------------------------------------------------
@@ -292,8 +283,12 @@ protected:
 
     ConsensusMap consensus_map_raw, consensus_map_quant;
 
-    // extract channel information
-    channel_extractor.extractChannels(exp, consensus_map_raw);
+    // extract channel information while streaming the input (no need to keep all spectra in memory)
+    IsobaricChannelExtractor::ChannelExtractingConsumer extracting_consumer(channel_extractor, consensus_map_raw);
+    MzMLFile mz_data_file;
+    mz_data_file.setLogType(log_type_);
+    mz_data_file.transform(in, &extracting_consumer);
+    extracting_consumer.finish();
 
     IsobaricQuantifier quantifier(quant_method);
     Param quant_param(getParam_().copy("quantification:", true));
@@ -0,0 +1,290 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/APPLICATIONS/TOPPBase.h>
+#include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/CHEMISTRY/MASSDECOMPOSITION/MassDecompositionAlgorithm.h>
+#include <OpenMS/CHEMISTRY/ProteaseDB.h>
+#include <OpenMS/CHEMISTRY/ProteaseDigestion.h>
+#include <OpenMS/FORMAT/FASTAFile.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
+
+#include <random>
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+using namespace OpenMS;
+using namespace std;
+
+//-------------------------------------------------------------
+//Doxygen docu
+//-------------------------------------------------------------
+
+/**
+    @page UTILS_MassDecompositionBenchmark MassDecompositionBenchmark
+
+    @brief Measures the throughput of amino acid mass decomposition.
+
+    The proteins of a FASTA database are digested in-silico. For every peptide
+    a set of mass differences as seen between the peaks of an MS2 spectrum is
+    generated: all differences of its prefix (b-ion) masses up to '-max_mass',
+    shifted by a random error within the decomposition tolerance, plus
+    '-noise' random differences per peptide (pairs of noise peaks).
+    The mass differences of each peptide are then decomposed with the
+    MassDecompositionAlgorithm (parameters in the 'algorithm' section)
+    using three code paths:
+
+    - @em uncached: one getDecompositions() call per mass difference, memo disabled
+    - @em cached: one getDecompositions() call per mass difference, with memo
+    - @em batch: one batched getDecompositions() call per peptide, with memo
+
+    Peptides are processed in parallel with one MassDecompositionAlgorithm
+    instance per thread; all instances share the same decomposer. For each path
+    the number of mass differences decomposed per second, in total and per
+    thread ('-threads'), is reported.
+
+    <B>The command line parameters of this tool are:</B>
+    @verbinclude UTILS_MassDecompositionBenchmark.cli
+    <B>INI file documentation of this tool:</B>
+    @htmlinclude UTILS_MassDecompositionBenchmark.html
+*/
+
+// We do not want this class to show up in the docu:
+/// @cond TOPPCLASSES
+
+class TOPPMassDecompositionBenchmark :
+  public TOPPBase
+{
+public:
+  TOPPMassDecompositionBenchmark() :
+    TOPPBase("MassDecompositionBenchmark", "Measures the throughput of amino acid mass decomposition.", false)
+  {
+  }
+
+protected:
+  void registerOptionsAndFlags_() override
+  {
+    registerInputFile_("in", "<file>", "", "Protein database");
+    setValidFormats_("in", ListUtils::create<String>("fasta"));
+    registerOutputFile_("out", "<file>", "", "Optional tab-separated report (mode, masses, decompositions, threads, seconds, masses/s, masses/s per thread)", false);
+    setValidFormats_("out", ListUtils::create<String>("tsv"));
+
+    registerStringOption_("enzyme", "<string>", "Trypsin", "The digestion enzyme", false);
+    vector<String> all_enzymes;
+    ProteaseDB::getInstance()->getAllNames(all_enzymes);
+    setValidStrings_("enzyme", all_enzymes);
+    registerIntOption_("missed_cleavages", "<number>", 1, "The number of allowed missed cleavages", false);
+    setMinInt_("missed_cleavages", 0);
+    registerIntOption_("min_length", "<number>", 7, "Minimum length of peptide", false);
+    registerIntOption_("max_length", "<number>", 40, "Maximum length of peptide", false);
+    registerIntOption_("max_peptides", "<number>", 1000, "Use at most this many peptides (0 = all)", false);
+    setMinInt_("max_peptides", 0);
+
+    registerDoubleOption_("max_mass", "<mass>", 400.0, "Maximal mass difference that is decomposed", false);
+    setMinFloat_("max_mass", 0.0);
+    registerIntOption_("noise", "<number>", 20, "Number of random mass differences per peptide", false);
+    setMinInt_("noise", 0);
+    registerIntOption_("repeats", "<number>", 3, "Number of passes over all peptides per mode", false);
+    setMinInt_("repeats", 1);
+    registerStringList_("modes", "<modes>", ListUtils::create<String>("uncached,cached,batch"), "Code paths to benchmark", false);
+    setValidStrings_("modes", ListUtils::create<String>("uncached,cached,batch"));
+
+    registerSubsection_("algorithm", "Parameters of the mass decomposition");
+  }
+
+  Param getSubsectionDefaults_(const String&) const override
+  {
+    return MassDecompositionAlgorithm().getDefaults();
+  }
+
+  struct Result
+  {
+    String mode;
+    Size masses;
+    Size decompositions;
+    double seconds;
+  };
+
+  ExitCodes main_(int, const char**) override
+  {
+    //-------------------------------------------------------------
+    // parsing parameters
+    //-------------------------------------------------------------
+    String in = getStringOption_("in");
+    String out = getStringOption_("out");
+    Size max_peptides = getIntOption_("max_peptides");
+    double max_mass = getDoubleOption_("max_mass");
+    Size noise = getIntOption_("noise");
+    Size repeats = getIntOption_("repeats");
+    StringList modes = getStringList_("modes");
+
+    Param decomp_param = getParam_().copy("algorithm:", true);
+    double tolerance = decomp_param.getValue("tolerance");
+
+    //-------------------------------------------------------------
+    // reading input
+    //-------------------------------------------------------------
+    ProteaseDigestion digestor;
+    digestor.setEnzyme(getStringOption_("enzyme"));
+    digestor.setMissedCleavages(getIntOption_("missed_cleavages"));
+    Size min_length = getIntOption_("min_length");
+    Size max_length = getIntOption_("max_length");
+
+    vector<AASequence> peptides;
+    FASTAFile ff;
+    ff.readStart(in);
+    FASTAFile::FASTAEntry fe;
+    while (ff.readNext(fe) && (max_peptides == 0 || peptides.size() < max_peptides))
+    {
+      vector<AASequence> digest;
+      // skip proteins with unknown residues ('X' has no mass)
+      if (fe.sequence.has('X')) continue;
+      digestor.digest(AASequence::fromString(fe.sequence), digest, min_length, max_length);
+      peptides.insert(peptides.end(), digest.begin(), digest.end());
+    }
+    if (max_peptides != 0 && peptides.size() > max_peptides) peptides.resize(max_peptides);
+
+    // mass differences between the (prefix) fragment peaks of each peptide
+    mt19937 rng(0);
+    uniform_real_distribution<double> error(-0.5 * tolerance, 0.5 * tolerance);
+    uniform_real_distribution<double> random_mass(50.0, max_mass);
+    vector<vector<double> > differences(peptides.size());
+    Size n_masses(0);
+    for (Size p = 0; p != peptides.size(); ++p)
+    {
+      vector<double> prefix(1, 0.0);
+      for (Size i = 0; i != peptides[p].size(); ++i)
+      {
+        prefix.push_back(prefix.back() + peptides[p][i].getMonoWeight(Residue::Internal));
+      }
+      for (Size i = 0; i != prefix.size(); ++i)
+      {
+        for (Size j = i + 1; j != prefix.size() && prefix[j] - prefix[i] <= max_mass; ++j)
+        {
+          differences[p].push_back(prefix[j] - prefix[i] + error(rng));
+        }
+      }
+      for (Size i = 0; i != noise; ++i)
+      {
+        differences[p].push_back(random_mass(rng));
+      }
+      n_masses += differences[p].size();
+    }
+
+    const SignedSize n = (SignedSize) peptides.size();
+    Size threads(1);
+#ifdef _OPENMP
+    threads = omp_get_max_threads();
+#endif
+    OPENMS_LOG_INFO << "Decomposing " << n_masses << " mass differences of " << n << " peptides using " << threads << " thread(s)." << endl;
+
+    //-------------------------------------------------------------
+    // calculations
+    //-------------------------------------------------------------
+    vector<Result> results;
+    for (const String& mode : modes)
+    {
+      Param param(decomp_param);
+      if (mode == "uncached") param.setValue("cache_size", 0);
+
+      Size count(0);
+      StopWatch sw;
+      sw.start();
+      for (Size r = 0; r != repeats; ++r)
+      {
+#pragma omp parallel reduction(+: count)
+        {
+          MassDecompositionAlgorithm decomp_algo; // one per thread, sharing the decomposer
+          decomp_algo.setParameters(param);
+#pragma omp for schedule(dynamic, 16)
+          for (SignedSize p = 0; p < n; ++p)
+          {
+            if (mode == "batch")
+            {
+              vector<vector<MassDecomposition> > decomps;
+              decomp_algo.getDecompositions(decomps, differences[p]);
+              for (const vector<MassDecomposition>& d : decomps) count += d.size();
+            }
+            else
+            {
+              for (double mass : differences[p])
+              {
+                vector<MassDecomposition> decomps;
+                decomp_algo.getDecompositions(decomps, mass);
+                count += decomps.size();
+              }
+            }
+          }
+        }
+      }
+      sw.stop();
+      results.push_back(Result{mode, n_masses * repeats, count, sw.getClockTime()});
+    }
+
+    //-------------------------------------------------------------
+    // writing output
+    //-------------------------------------------------------------
+    ofstream os;
+    if (!out.empty())
+    {
+      os.open(out.c_str());
+      os << "mode\tmasses\tdecompositions\tthreads\tseconds\tmasses_per_second\tmasses_per_second_per_thread\n";
+    }
+    for (const Result& r : results)
+    {
+      double per_second = r.seconds > 0 ? r.masses / r.seconds : 0.0;
+      OPENMS_LOG_INFO << r.mode << ": " << r.masses << " masses (" << r.decompositions << " decompositions) in " << r.seconds << " s: "
+                      << per_second << " masses/s, " << per_second / threads << " masses/s per thread" << endl;
+      if (os.is_open())
+      {
+        os << r.mode << "\t" << r.masses << "\t" << r.decompositions << "\t" << threads << "\t" << r.seconds << "\t"
+           << per_second << "\t" << per_second / threads << "\n";
+      }
+    }
+
+    return EXECUTION_OK;
+  }
+
+};
+
+
+int main(int argc, const char** argv)
+{
+  TOPPMassDecompositionBenchmark tool;
+  return tool.main(argc, argv);
+}
+
+/// @endcond
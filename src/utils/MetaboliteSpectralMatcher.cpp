@@ -100,6 +100,7 @@ protected:
     setValidFormats_("database", ListUtils::create<String>("mzML"));
     registerOutputFile_("out", "<file>", "", "mzTab file");
     setValidFormats_("out", ListUtils::create<String>("mzTab"));
+    registerStringOption_("library_index", "<file>", "", "Binary index of the spectral database (speeds up repeated searches of large databases). Loaded if it exists and belongs to the database, otherwise built and written to this file.", false, true);
 
     registerSubsection_("algorithm", "Algorithm parameters section");
   }
@@ -169,12 +170,41 @@ protected:
       return INCOMPATIBLE_INPUT_DATA;
     }
 
+    MetaboliteSpectralLibraryIndex library_index;
+    String library_index_filename = getStringOption_("library_index");
+    bool index_loaded(false);
+    if (!library_index_filename.empty() && File::exists(library_index_filename))
+    {
+      try
+      {
+        library_index.load(library_index_filename);
+        index_loaded = library_index.isIndexOf(spec_db);
+      }
+      catch (Exception::ParseError&)
+      {
+        // e.g. written by an older version
+        index_loaded = false;
+      }
+      if (!index_loaded)
+      {
+        OPENMS_LOG_WARN << "The library index '" << library_index_filename << "' can not be read or does not belong to the spectral database and is rebuilt." << std::endl;
+      }
+    }
+    if (!index_loaded)
+    {
+      library_index.build(spec_db);
+      if (!library_index_filename.empty())
+      {
+        library_index.store(library_index_filename);
+      }
+    }
+
     //-------------------------------------------------------------
     // run spectral library search
     //-------------------------------------------------------------
     MetaboliteSpectralMatching ams;
     ams.setParameters(ams_param);
-    ams.run(ms_peakmap, spec_db, mztab_output);
+    ams.run(ms_peakmap, spec_db, library_index, mztab_output);
 
     //-------------------------------------------------------------
     // store results
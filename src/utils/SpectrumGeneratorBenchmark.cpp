@@ -0,0 +1,284 @@
+// --------------------------------------------------------------------------
+//                   OpenMS -- Open-Source Mass Spectrometry
+// --------------------------------------------------------------------------
+// Copyright The OpenMS Team -- Eberhard Karls University Tuebingen,
+// ETH Zurich, and Freie Universitaet Berlin 2002-2020.
+//
+// This software is released under a three-clause BSD license:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of any author or any participating institution
+//    may be used to endorse or promote products derived from this software
+//    without specific prior written permission.
+// For a full list of authors, refer to the file AUTHORS.
+// --------------------------------------------------------------------------
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL ANY OF THE AUTHORS OR THE CONTRIBUTING
+// INSTITUTIONS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+// --------------------------------------------------------------------------
+// $Maintainer: $
+// $Authors: $
+// --------------------------------------------------------------------------
+
+#include <OpenMS/APPLICATIONS/TOPPBase.h>
+#include <OpenMS/CHEMISTRY/AASequence.h>
+#include <OpenMS/CHEMISTRY/CompactAASequence.h>
+#include <OpenMS/CHEMISTRY/ProteaseDB.h>
+#include <OpenMS/CHEMISTRY/ProteaseDigestion.h>
+#include <OpenMS/CHEMISTRY/TheoreticalSpectrumGenerator.h>
+#include <OpenMS/FORMAT/FASTAFile.h>
+#include <OpenMS/SYSTEM/StopWatch.h>
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+using namespace OpenMS;
+using namespace std;
+
+//-------------------------------------------------------------
+//Doxygen docu
+//-------------------------------------------------------------
+
+/**
+    @page UTILS_SpectrumGeneratorBenchmark SpectrumGeneratorBenchmark
+
+    @brief Measures the throughput of theoretical spectrum generation.
+
+    The proteins of a FASTA database are digested in-silico and a theoretical
+    spectrum is generated for every peptide using the TheoreticalSpectrumGenerator
+    (parameters in the 'algorithm' section). Three code paths are timed:
+
+    - @em spectrum: getSpectrum() with an AASequence, i.e. full PeakSpectrum output
+    - @em compact: getSpectrum() with a CompactAASequence (ladders from cached prefix masses)
+    - @em fragments: the allocation-free getFragments() fast path with a reused buffer per thread
+
+    For each path the number of spectra generated per second, in total and
+    per thread ('-threads'), is reported. Sequence conversion and digestion
+    are not part of the measured time.
+
+    <B>The command line parameters of this tool are:</B>
+    @verbinclude UTILS_SpectrumGeneratorBenchmark.cli
+    <B>INI file documentation of this tool:</B>
+    @htmlinclude UTILS_SpectrumGeneratorBenchmark.html
+*/
+
+// We do not want this class to show up in the docu:
+/// @cond TOPPCLASSES
+
+class TOPPSpectrumGeneratorBenchmark :
+  public TOPPBase
+{
+public:
+  TOPPSpectrumGeneratorBenchmark() :
+    TOPPBase("SpectrumGeneratorBenchmark", "Measures the throughput of theoretical spectrum generation.", false)
+  {
+  }
+
+protected:
+  void registerOptionsAndFlags_() override
+  {
+    registerInputFile_("in", "<file>", "", "Protein database");
+    setValidFormats_("in", ListUtils::create<String>("fasta"));
+    registerOutputFile_("out", "<file>", "", "Optional tab-separated report (mode, spectra, threads, seconds, spectra/s, spectra/s per thread)", false);
+    setValidFormats_("out", ListUtils::create<String>("tsv"));
+
+    registerStringOption_("enzyme", "<string>", "Trypsin", "The digestion enzyme", false);
+    vector<String> all_enzymes;
+    ProteaseDB::getInstance()->getAllNames(all_enzymes);
+    setValidStrings_("enzyme", all_enzymes);
+    registerIntOption_("missed_cleavages", "<number>", 1, "The number of allowed missed cleavages", false);
+    setMinInt_("missed_cleavages", 0);
+    registerIntOption_("min_length", "<number>", 7, "Minimum length of peptide", false);
+    registerIntOption_("max_length", "<number>", 40, "Maximum length of peptide", false);
+    registerIntOption_("max_peptides", "<number>", 0, "Use at most this many peptides (0 = all)", false);
+    setMinInt_("max_peptides", 0);
+
+    registerIntOption_("max_charge", "<number>", 2, "Fragment charges 1 to max_charge are generated", false);
+    setMinInt_("max_charge", 1);
+    registerIntOption_("repeats", "<number>", 3, "Number of passes over all peptides per mode", false);
+    setMinInt_("repeats", 1);
+    registerStringList_("modes", "<modes>", ListUtils::create<String>("spectrum,compact,fragments"), "Code paths to benchmark", false);
+    setValidStrings_("modes", ListUtils::create<String>("spectrum,compact,fragments"));
+
+    registerSubsection_("algorithm", "Parameters of the theoretical spectrum generator");
+  }
+
+  Param getSubsectionDefaults_(const String&) const override
+  {
+    return TheoreticalSpectrumGenerator().getDefaults();
+  }
+
+  struct Result
+  {
+    String mode;
+    Size spectra;
+    Size peaks;
+    double seconds;
+  };
+
+  template <typename Function>
+  Result run_(const String& mode, Size n_peptides, Size repeats, Function generate)
+  {
+    Size peaks(0);
+    StopWatch sw;
+    sw.start();
+    for (Size r = 0; r != repeats; ++r)
+    {
+      generate(peaks);
+    }
+    sw.stop();
+    return Result{mode, n_peptides * repeats, peaks, sw.getClockTime()};
+  }
+
+  ExitCodes main_(int, const char**) override
+  {
+    //-------------------------------------------------------------
+    // parsing parameters
+    //-------------------------------------------------------------
+    String in = getStringOption_("in");
+    String out = getStringOption_("out");
+    Size max_peptides = getIntOption_("max_peptides");
+    Int max_charge = getIntOption_("max_charge");
+    Size repeats = getIntOption_("repeats");
+    StringList modes = getStringList_("modes");
+
+    TheoreticalSpectrumGenerator tsg;
+    tsg.setParameters(getParam_().copy("algorithm:", true));
+
+    //-------------------------------------------------------------
+    // reading input
+    //-------------------------------------------------------------
+    ProteaseDigestion digestor;
+    digestor.setEnzyme(getStringOption_("enzyme"));
+    digestor.setMissedCleavages(getIntOption_("missed_cleavages"));
+    Size min_length = getIntOption_("min_length");
+    Size max_length = getIntOption_("max_length");
+
+    vector<AASequence> peptides;
+    FASTAFile ff;
+    ff.readStart(in);
+    FASTAFile::FASTAEntry fe;
+    while (ff.readNext(fe) && (max_peptides == 0 || peptides.size() < max_peptides))
+    {
+      vector<AASequence> digest;
+      // skip proteins with unknown residues ('X' has no mass)
+      if (fe.sequence.has('X')) continue;
+      digestor.digest(AASequence::fromString(fe.sequence), digest, min_length, max_length);
+      peptides.insert(peptides.end(), digest.begin(), digest.end());
+    }
+    if (max_peptides != 0 && peptides.size() > max_peptides) peptides.resize(max_peptides);
+
+    vector<CompactAASequence> compact_peptides;
+    compact_peptides.reserve(peptides.size());
+    for (const AASequence& p : peptides) compact_peptides.emplace_back(p);
+
+    const SignedSize n = (SignedSize) peptides.size();
+    Size threads(1);
+#ifdef _OPENMP
+    threads = omp_get_max_threads();
+#endif
+    OPENMS_LOG_INFO << "Generating spectra for " << n << " peptides (charges 1 to " << max_charge << ") using " << threads << " thread(s)." << endl;
+
+    //-------------------------------------------------------------
+    // calculations
+    //-------------------------------------------------------------
+    vector<Result> results;
+    for (const String& mode : modes)
+    {
+      if (mode == "spectrum")
+      {
+        results.push_back(run_(mode, peptides.size(), repeats, [&](Size& peaks)
+        {
+          Size count(0);
+#pragma omp parallel for schedule(static) reduction(+: count)
+          for (SignedSize i = 0; i < n; ++i)
+          {
+            PeakSpectrum spec;
+            tsg.getSpectrum(spec, peptides[i], 1, max_charge);
+            count += spec.size();
+          }
+          peaks += count;
+        }));
+      }
+      else if (mode == "compact")
+      {
+        results.push_back(run_(mode, peptides.size(), repeats, [&](Size& peaks)
+        {
+          Size count(0);
+#pragma omp parallel for schedule(static) reduction(+: count)
+          for (SignedSize i = 0; i < n; ++i)
+          {
+            PeakSpectrum spec;
+            tsg.getSpectrum(spec, compact_peptides[i], 1, max_charge);
+            count += spec.size();
+          }
+          peaks += count;
+        }));
+      }
+      else if (mode == "fragments")
+      {
+        results.push_back(run_(mode, peptides.size(), repeats, [&](Size& peaks)
+        {
+          Size count(0);
+#pragma omp parallel reduction(+: count)
+          {
+            TheoreticalSpectrumGenerator::FragmentBuffer buffer; // one per thread, reused
+#pragma omp for schedule(static)
+            for (SignedSize i = 0; i < n; ++i)
+            {
+              tsg.getFragments(buffer, compact_peptides[i], 1, max_charge);
+              count += buffer.size();
+            }
+          }
+          peaks += count;
+        }));
+      }
+    }
+
+    //-------------------------------------------------------------
+    // writing output
+    //-------------------------------------------------------------
+    ofstream os;
+    if (!out.empty())
+    {
+      os.open(out.c_str());
+      os << "mode\tspectra\tpeaks\tthreads\tseconds\tspectra_per_second\tspectra_per_second_per_thread\n";
+    }
+    for (const Result& r : results)
+    {
+      double per_second = r.seconds > 0 ? r.spectra / r.seconds : 0.0;
+      OPENMS_LOG_INFO << r.mode << ": " << r.spectra << " spectra (" << r.peaks << " peaks) in " << r.seconds << " s: "
+                      << per_second << " spectra/s, " << per_second / threads << " spectra/s per thread" << endl;
+      if (os.is_open())
+      {
+        os << r.mode << "\t" << r.spectra << "\t" << r.peaks << "\t" << threads << "\t" << r.seconds << "\t"
+           << per_second << "\t" << per_second / threads << "\n";
+      }
+    }
+
+    return EXECUTION_OK;
+  }
+
+};
+
+
+int main(int argc, const char** argv)
+{
+  TOPPSpectrumGeneratorBenchmark tool;
+  return tool.main(argc, argv);
+}
+
+/// @endcond
@@ -26,6 +26,7 @@ IDScoreSwitcher
 IDSplitter
 LabeledEval
 MassCalculator
+MassDecompositionBenchmark
 MetaboliteAdductDecharger
 MetaboliteSpectralMatcher
 MetaProSIP
@@ -59,6 +60,7 @@ SimpleSearchEngine
 SiriusAdapter
 SpecLibCreator
 SpectraSTSearchAdapter
+SpectrumGeneratorBenchmark
 StaticModification
 SvmTheoreticalSpectrumGeneratorTrainer
 TICCalculator